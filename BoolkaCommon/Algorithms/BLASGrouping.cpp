@@ -0,0 +1,315 @@
+#include "stdafx.h"
+
+#include "BLASGrouping.h"
+
+namespace Boolka
+{
+
+    static const size_t gs_InvalidCluster = SIZE_MAX;
+
+    static AABB GetEmptyAABB()
+    {
+        return AABB{Vector4{FLT_MAX, FLT_MAX, FLT_MAX, 1.0f},
+                    Vector4{-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.0f}};
+    }
+
+    static float GetHitProbability(const AABB& bounds, float sceneArea)
+    {
+        if (sceneArea <= 0.0f)
+            return 1.0f;
+        return BLASGrouping::SurfaceArea(bounds) / sceneArea;
+    }
+
+    // Spreads lower 10 bits so that there are 2 zero bits between each
+    static uint32_t ExpandMortonBits(uint32_t value)
+    {
+        value = (value * 0x00010001u) & 0xFF0000FFu;
+        value = (value * 0x00000101u) & 0x0F00F00Fu;
+        value = (value * 0x00000011u) & 0xC30C30C3u;
+        value = (value * 0x00000005u) & 0x49249249u;
+        return value;
+    }
+
+    static uint32_t CalculateMortonCode(const AABB& bounds, const AABB& sceneBounds)
+    {
+        Vector4 center = (bounds.GetMin() + bounds.GetMax()) * 0.5f;
+        Vector4 extent = sceneBounds.GetMax() - sceneBounds.GetMin();
+
+        uint32_t result = 0;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            float normalized =
+                extent[axis] > 0.0f ? (center[axis] - sceneBounds.GetMin()[axis]) / extent[axis]
+                                    : 0.0f;
+            normalized = std::clamp(normalized, 0.0f, 1.0f);
+            uint32_t quantized = std::min(static_cast<uint32_t>(normalized * 1024.0f), 1023u);
+            result |= ExpandMortonBits(quantized) << (2 - axis);
+        }
+
+        return result;
+    }
+
+    float BLASGrouping::SurfaceArea(const AABB& bounds)
+    {
+        Vector4 extent = bounds.GetMax() - bounds.GetMin();
+        if (extent.x() < 0.0f || extent.y() < 0.0f || extent.z() < 0.0f)
+            return 0.0f;
+        return 2.0f * (extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x());
+    }
+
+    AABB BLASGrouping::Union(const AABB& left, const AABB& right)
+    {
+        return AABB{Min(left.GetMin(), right.GetMin()), Max(left.GetMax(), right.GetMax())};
+    }
+
+    float BLASGrouping::EstimateBLASCost(const CostModel& costModel, float hitProbability,
+                                         size_t triangleCount)
+    {
+        const float depth = std::log2(static_cast<float>(triangleCount) + 1.0f);
+        return hitProbability * (costModel.instanceCost + costModel.nodeCost * depth) +
+               costModel.blasCost;
+    }
+
+    std::vector<std::vector<uint32_t>> BLASGrouping::MergeObjects(const Settings& settings,
+                                                                  const AABB& sceneBounds,
+                                                                  const ObjectDesc* objects,
+                                                                  size_t objectCount)
+    {
+        const float sceneArea = SurfaceArea(sceneBounds);
+        auto getCost = [&](const AABB& bounds, size_t triangleCount) {
+            return EstimateBLASCost(settings.costModel, GetHitProbability(bounds, sceneArea),
+                                    triangleCount);
+        };
+
+        std::vector<std::vector<uint32_t>> result;
+
+        std::vector<uint32_t> mergeable;
+        std::vector<uint32_t> mortonCodes(objectCount);
+        for (uint32_t i = 0; i < objectCount; ++i)
+        {
+            const ObjectDesc& object = objects[i];
+            if (!object.mergeable || object.triangleCount >= settings.maxMergedTriangleCount)
+            {
+                result.push_back({i});
+                continue;
+            }
+            mergeable.push_back(i);
+            mortonCodes[i] = CalculateMortonCode(object.bounds, sceneBounds);
+        }
+
+        // Neighbours along Morton curve are merge candidates
+        std::sort(mergeable.begin(), mergeable.end(), [&](uint32_t left, uint32_t right) {
+            return std::tie(mortonCodes[left], left) < std::tie(mortonCodes[right], right);
+        });
+
+        struct Cluster
+        {
+            AABB bounds;
+            uint32_t triangleCount;
+            std::vector<uint32_t> objects;
+            size_t previous;
+            size_t next;
+            // Incremented on every merge, so stale candidates can be skipped
+            uint32_t version;
+            bool alive;
+        };
+
+        const size_t clusterCount = mergeable.size();
+        std::vector<Cluster> clusters(clusterCount);
+        for (size_t i = 0; i < clusterCount; ++i)
+        {
+            const ObjectDesc& object = objects[mergeable[i]];
+            clusters[i] = Cluster{object.bounds,
+                                  object.triangleCount,
+                                  {mergeable[i]},
+                                  i == 0 ? gs_InvalidCluster : i - 1,
+                                  i + 1 == clusterCount ? gs_InvalidCluster : i + 1,
+                                  0,
+                                  true};
+        }
+
+        struct Candidate
+        {
+            float costDelta;
+            size_t left;
+            size_t right;
+            uint32_t leftVersion;
+            uint32_t rightVersion;
+
+            bool operator>(const Candidate& other) const
+            {
+                return std::tie(costDelta, left) > std::tie(other.costDelta, other.left);
+            }
+        };
+
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+
+        auto addCandidate = [&](size_t left, size_t right) {
+            if (left == gs_InvalidCluster || right == gs_InvalidCluster)
+                return;
+            const Cluster& leftCluster = clusters[left];
+            const Cluster& rightCluster = clusters[right];
+            const uint32_t triangleCount = leftCluster.triangleCount + rightCluster.triangleCount;
+            if (triangleCount > settings.maxMergedTriangleCount)
+                return;
+            const float costDelta =
+                getCost(Union(leftCluster.bounds, rightCluster.bounds), triangleCount) -
+                getCost(leftCluster.bounds, leftCluster.triangleCount) -
+                getCost(rightCluster.bounds, rightCluster.triangleCount);
+            if (costDelta < 0.0f)
+            {
+                candidates.push(
+                    Candidate{costDelta, left, right, leftCluster.version, rightCluster.version});
+            }
+        };
+
+        for (size_t i = 0; i + 1 < clusterCount; ++i)
+        {
+            addCandidate(i, i + 1);
+        }
+
+        // Greedily merge pair that reduces cost the most
+        while (!candidates.empty())
+        {
+            const Candidate candidate = candidates.top();
+            candidates.pop();
+
+            Cluster& left = clusters[candidate.left];
+            Cluster& right = clusters[candidate.right];
+            if (!left.alive || !right.alive || left.version != candidate.leftVersion ||
+                right.version != candidate.rightVersion)
+                continue;
+
+            left.bounds = Union(left.bounds, right.bounds);
+            left.triangleCount += right.triangleCount;
+            left.objects.insert(left.objects.end(), right.objects.begin(), right.objects.end());
+            left.next = right.next;
+            if (right.next != gs_InvalidCluster)
+                clusters[right.next].previous = candidate.left;
+            ++left.version;
+            right.alive = false;
+            right.objects.clear();
+
+            addCandidate(left.previous, candidate.left);
+            addCandidate(candidate.left, left.next);
+        }
+
+        for (auto& cluster : clusters)
+        {
+            if (!cluster.alive)
+                continue;
+            std::sort(cluster.objects.begin(), cluster.objects.end());
+            result.push_back(std::move(cluster.objects));
+        }
+
+        std::sort(result.begin(), result.end(),
+                  [](const auto& left, const auto& right) { return left[0] < right[0]; });
+
+        return result;
+    }
+
+    std::vector<BLASGrouping::TriangleRange> BLASGrouping::SplitObject(
+        const Settings& settings, const AABB& sceneBounds, const AABB* triangleBounds,
+        size_t triangleCount, std::vector<uint32_t>& triangleOrder)
+    {
+        triangleOrder.resize(triangleCount);
+        std::iota(triangleOrder.begin(), triangleOrder.end(), 0);
+
+        std::vector<TriangleRange> result;
+        if (triangleCount == 0)
+            return result;
+
+        const float sceneArea = SurfaceArea(sceneBounds);
+        auto getCost = [&](float area, size_t count) {
+            return EstimateBLASCost(settings.costModel,
+                                    sceneArea > 0.0f ? area / sceneArea : 1.0f, count);
+        };
+
+        std::vector<Vector4> centroids(triangleCount);
+        for (size_t i = 0; i < triangleCount; ++i)
+        {
+            centroids[i] = (triangleBounds[i].GetMin() + triangleBounds[i].GetMax()) * 0.5f;
+        }
+
+        auto sortByAxis = [&](uint32_t* first, uint32_t* last, size_t axis) {
+            std::sort(first, last, [&](uint32_t left, uint32_t right) {
+                return std::tie(centroids[left][axis], left) <
+                       std::tie(centroids[right][axis], right);
+            });
+        };
+
+        const uint32_t minPiece = std::max(settings.minSplitPieceTriangleCount, 1u);
+        std::vector<float> rightAreas(triangleCount);
+
+        // Left range is always processed before right one, so result stays sorted
+        std::vector<TriangleRange> stack{
+            TriangleRange{0, checked_narrowing_cast<uint32_t>(triangleCount)}};
+        while (!stack.empty())
+        {
+            const TriangleRange range = stack.back();
+            stack.pop_back();
+
+            const uint32_t count = range.triangleCount;
+            if (count < settings.minSplitTriangleCount || count < 2 * minPiece)
+            {
+                result.push_back(range);
+                continue;
+            }
+
+            uint32_t* first = triangleOrder.data() + range.firstTriangle;
+            uint32_t* last = first + count;
+
+            AABB rangeBounds = GetEmptyAABB();
+            for (uint32_t* i = first; i != last; ++i)
+            {
+                rangeBounds = Union(rangeBounds, triangleBounds[*i]);
+            }
+
+            float bestCost = getCost(SurfaceArea(rangeBounds), count);
+            size_t bestAxis = SIZE_MAX;
+            uint32_t bestSplit = 0;
+
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                sortByAxis(first, last, axis);
+
+                AABB bounds = GetEmptyAABB();
+                for (uint32_t i = count - 1; i > 0; --i)
+                {
+                    bounds = Union(bounds, triangleBounds[first[i]]);
+                    rightAreas[i] = SurfaceArea(bounds);
+                }
+
+                bounds = GetEmptyAABB();
+                for (uint32_t i = 1; i < count; ++i)
+                {
+                    bounds = Union(bounds, triangleBounds[first[i - 1]]);
+                    if (i < minPiece || count - i < minPiece)
+                        continue;
+
+                    float cost = getCost(SurfaceArea(bounds), i) +
+                                 getCost(rightAreas[i], count - i);
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = i;
+                    }
+                }
+            }
+
+            if (bestAxis == SIZE_MAX)
+            {
+                result.push_back(range);
+                continue;
+            }
+
+            sortByAxis(first, last, bestAxis);
+            stack.push_back(TriangleRange{range.firstTriangle + bestSplit, count - bestSplit});
+            stack.push_back(TriangleRange{range.firstTriangle, bestSplit});
+        }
+
+        return result;
+    }
+
+} // namespace Boolka
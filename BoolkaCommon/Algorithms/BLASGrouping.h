@@ -0,0 +1,65 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Decides how scene geometry is distributed between raytracing bottom level acceleration
+    // structures. Small neighbouring objects get merged and big ones get split, based on surface
+    // area cost estimate of two level acceleration structure
+    class BLASGrouping
+    {
+    public:
+        struct CostModel
+        {
+            // Cost of entering BLAS from TLAS leaf, includes instance transform
+            float instanceCost = 1.0f;
+            // Cost of visiting single level of BLAS hierarchy
+            float nodeCost = 1.0f;
+            // Fixed build, compaction and memory overhead of single BLAS, in units of cost of ray
+            // that always enters BLAS
+            float blasCost = 0.01f;
+        };
+
+        struct Settings
+        {
+            CostModel costModel;
+            // Merged BLAS never exceeds this
+            uint32_t maxMergedTriangleCount = 1 << 16;
+            // Objects with less triangles are never split
+            uint32_t minSplitTriangleCount = 1 << 17;
+            // Split never produces pieces with less triangles
+            uint32_t minSplitPieceTriangleCount = 1 << 15;
+        };
+
+        struct ObjectDesc
+        {
+            AABB bounds;
+            uint32_t triangleCount;
+            // Instanced objects have to keep their own BLAS
+            bool mergeable;
+        };
+
+        struct TriangleRange
+        {
+            uint32_t firstTriangle;
+            uint32_t triangleCount;
+        };
+
+        [[nodiscard]] static float SurfaceArea(const AABB& bounds);
+        [[nodiscard]] static AABB Union(const AABB& left, const AABB& right);
+        // Expected cost of single BLAS, hit probability is its surface area relative to scene
+        [[nodiscard]] static float EstimateBLASCost(const CostModel& costModel,
+                                                    float hitProbability, size_t triangleCount);
+
+        // Every object ends up in exactly one group, objects in group are sorted by index
+        [[nodiscard]] static std::vector<std::vector<uint32_t>> MergeObjects(
+            const Settings& settings, const AABB& sceneBounds, const ObjectDesc* objects,
+            size_t objectCount);
+
+        // Returns contiguous ranges of triangleOrder, which receives new order of triangles
+        [[nodiscard]] static std::vector<TriangleRange> SplitObject(
+            const Settings& settings, const AABB& sceneBounds, const AABB* triangleBounds,
+            size_t triangleCount, std::vector<uint32_t>& triangleOrder);
+    };
+
+} // namespace Boolka
@@ -0,0 +1,218 @@
+#include "stdafx.h"
+
+#include "BatchCulling.h"
+
+#include "RadixSort.h"
+
+namespace Boolka
+{
+
+    struct BatchCullingViewList
+    {
+        uint32_t* objects;
+        float* distances;
+        uint32_t count;
+    };
+
+    // Appends visible objects of range [firstObject, lastObject) with their distances to near
+    // plane, then sorts them
+    static void BuildBatchCullingViewList(const Frustum& view, const uint32_t* viewMasks,
+                                          uint32_t viewBit, const Vector4* boundingSpheres,
+                                          size_t firstObject, size_t lastObject,
+                                          RadixSort::Order order, BatchCullingViewList& list,
+                                          ScratchArena& scratch)
+    {
+        // Near plane is first plane of frustum
+        const float* nearPlaneData = view.GetBuffer();
+        const Vector4 nearPlane(nearPlaneData, nearPlaneData + 4);
+
+        list.count = 0;
+        for (size_t i = firstObject; i < lastObject; ++i)
+        {
+            if ((viewMasks[i] & viewBit) == 0)
+                continue;
+
+            const Vector4 center(Vector3(boundingSpheres[i]), 1.0f);
+            if (!view.CheckSphereFast(center, boundingSpheres[i].w()))
+                continue;
+
+            list.objects[list.count] = static_cast<uint32_t>(i);
+            list.distances[list.count] = nearPlane.Dot(center);
+            ++list.count;
+        }
+
+        RadixSort::Sort(list.distances, list.objects, list.count, order, scratch);
+    }
+
+    BatchCulling::BatchCulling()
+        : m_ObjectCount(0)
+        , m_OpaqueObjectCount(0)
+        , m_ViewCount(0)
+    {
+    }
+
+    BatchCulling::~BatchCulling()
+    {
+        BLK_ASSERT(m_ObjectCount == 0);
+        BLK_ASSERT(m_OpaqueObjectCount == 0);
+        BLK_ASSERT(m_ViewCount == 0);
+    }
+
+    void BatchCulling::Initialize(const AABB* boundingBoxes, const Vector4* boundingSpheres,
+                                  size_t objectCount, size_t opaqueObjectCount)
+    {
+        BLK_ASSERT(m_ObjectCount == 0);
+        BLK_ASSERT(opaqueObjectCount <= objectCount);
+        BLK_ASSERT(objectCount <= UINT32_MAX);
+
+        m_ObjectCount = objectCount;
+        m_OpaqueObjectCount = opaqueObjectCount;
+
+        m_BoundingBoxes.Reserve(objectCount);
+        for (size_t i = 0; i < objectCount; ++i)
+            m_BoundingBoxes.Add(boundingBoxes[i]);
+        m_BoundingSpheres.assign(boundingSpheres, boundingSpheres + objectCount);
+    }
+
+    void BatchCulling::Unload()
+    {
+        m_ObjectCount = 0;
+        m_OpaqueObjectCount = 0;
+        m_ViewCount = 0;
+        m_BoundingBoxes.Clear();
+        m_BoundingSpheres.clear();
+        m_Objects.clear();
+        m_Distances.clear();
+        m_OpaqueCounts.clear();
+        m_TransparentCounts.clear();
+        m_Tasks.clear();
+        m_TaskScratch.clear();
+    }
+
+    void BatchCulling::Cull(const Frustum* views, size_t viewCount,
+                            const MultiViewCulling::ViewGroup* groups, size_t groupCount)
+    {
+        BLK_ASSERT(viewCount <= MultiViewCulling::ms_MaxViewCount);
+
+        // Storage only grows, so that steady state frames don't allocate
+        m_ViewCount = viewCount;
+        m_Objects.resize(std::max(m_Objects.size(), viewCount * m_ObjectCount));
+        m_Distances.resize(std::max(m_Distances.size(), viewCount * m_ObjectCount));
+        m_OpaqueCounts.resize(std::max(m_OpaqueCounts.size(), viewCount));
+        m_TransparentCounts.resize(std::max(m_TransparentCounts.size(), viewCount));
+
+        m_Tasks.clear();
+        for (size_t view = 0; view < viewCount;)
+        {
+            CullingTask task{};
+            task.group = MultiViewCulling::ViewGroup{Vector4{}, view, 1};
+            for (size_t i = 0; i < groupCount; ++i)
+            {
+                if (groups[i].firstView == view)
+                {
+                    BLK_ASSERT(groups[i].viewCount != 0);
+                    BLK_ASSERT(groups[i].firstView + groups[i].viewCount <= viewCount);
+                    task.group = groups[i];
+                    task.hasBoundingSphere = true;
+                    break;
+                }
+            }
+            m_Tasks.push_back(task);
+            view += task.group.viewCount;
+        }
+
+        while (m_TaskScratch.size() < m_Tasks.size())
+            m_TaskScratch.emplace_back();
+
+        std::for_each(std::execution::par, m_Tasks.begin(), m_Tasks.end(),
+                      [this, views](const CullingTask& task) {
+                          const size_t taskIndex = &task - m_Tasks.data();
+                          RunTask(views, task, m_TaskScratch[taskIndex]);
+                      });
+    }
+
+    size_t BatchCulling::GetObjectCount() const
+    {
+        return m_ObjectCount;
+    }
+
+    size_t BatchCulling::GetOpaqueObjectCount() const
+    {
+        return m_OpaqueObjectCount;
+    }
+
+    size_t BatchCulling::GetViewCount() const
+    {
+        return m_ViewCount;
+    }
+
+    uint32_t BatchCulling::GetOpaqueCount(size_t view) const
+    {
+        BLK_ASSERT(view < m_ViewCount);
+        return m_OpaqueCounts[view];
+    }
+
+    const uint32_t* BatchCulling::GetOpaqueObjects(size_t view) const
+    {
+        BLK_ASSERT(view < m_ViewCount);
+        return m_Objects.data() + view * m_ObjectCount;
+    }
+
+    const float* BatchCulling::GetOpaqueDistances(size_t view) const
+    {
+        BLK_ASSERT(view < m_ViewCount);
+        return m_Distances.data() + view * m_ObjectCount;
+    }
+
+    uint32_t BatchCulling::GetTransparentCount(size_t view) const
+    {
+        BLK_ASSERT(view < m_ViewCount);
+        return m_TransparentCounts[view];
+    }
+
+    const uint32_t* BatchCulling::GetTransparentObjects(size_t view) const
+    {
+        return GetOpaqueObjects(view) + m_OpaqueCounts[view];
+    }
+
+    const float* BatchCulling::GetTransparentDistances(size_t view) const
+    {
+        return GetOpaqueDistances(view) + m_OpaqueCounts[view];
+    }
+
+    void BatchCulling::RunTask(const Frustum* views, const CullingTask& task,
+                               ScratchArena& scratch)
+    {
+        scratch.Reset();
+
+        // Views of task are culled together, group is relative to them
+        const size_t firstView = task.group.firstView;
+        MultiViewCulling::ViewGroup localGroup = task.group;
+        localGroup.firstView = 0;
+        uint32_t* viewMasks = scratch.Allocate<uint32_t>(m_ObjectCount);
+        MultiViewCulling::CullAABBs(views + firstView, task.group.viewCount, &localGroup,
+                                    task.hasBoundingSphere ? 1 : 0, m_BoundingBoxes, viewMasks);
+
+        for (size_t i = 0; i < task.group.viewCount; ++i)
+        {
+            const size_t view = firstView + i;
+            const uint32_t viewBit = 1u << i;
+
+            BatchCullingViewList opaqueList{m_Objects.data() + view * m_ObjectCount,
+                                            m_Distances.data() + view * m_ObjectCount, 0};
+            BuildBatchCullingViewList(views[view], viewMasks, viewBit, m_BoundingSpheres.data(), 0,
+                                      m_OpaqueObjectCount, RadixSort::Order::Ascending, opaqueList,
+                                      scratch);
+
+            BatchCullingViewList transparentList{opaqueList.objects + opaqueList.count,
+                                                 opaqueList.distances + opaqueList.count, 0};
+            BuildBatchCullingViewList(views[view], viewMasks, viewBit, m_BoundingSpheres.data(),
+                                      m_OpaqueObjectCount, m_ObjectCount,
+                                      RadixSort::Order::Descending, transparentList, scratch);
+
+            m_OpaqueCounts[view] = opaqueList.count;
+            m_TransparentCounts[view] = transparentList.count;
+        }
+    }
+
+} // namespace Boolka
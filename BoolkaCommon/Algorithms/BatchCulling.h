@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BoolkaCommon/Structures/ScratchArena.h"
+#include "MultiViewCulling.h"
+
+namespace Boolka
+{
+
+    class Frustum;
+
+    // Device independent part of batch preparation
+    // Objects are culled against every view, visible opaque objects are sorted front to back, so
+    // that depth test rejects more of hidden geometry, and visible transparent objects are sorted
+    // back to front, as blending needs
+    // Objects in range [0, opaqueObjectCount) are opaque and the rest are transparent, same as in
+    // Scene
+    class [[nodiscard]] BatchCulling
+    {
+    public:
+        BatchCulling();
+        ~BatchCulling();
+
+        // boundingSpheres - xyz - center, w - radius
+        void Initialize(const AABB* boundingBoxes, const Vector4* boundingSpheres,
+                        size_t objectCount, size_t opaqueObjectCount);
+        void Unload();
+
+        // Object is visible in view if its bounding box and bounding sphere are not completely
+        // outside of view frustum and, for views of group, its bounding box intersects group
+        // bounding sphere
+        // Each group and each view outside of groups is culled and sorted by separate task, tasks
+        // run in parallel
+        void Cull(const Frustum* views, size_t viewCount, const MultiViewCulling::ViewGroup* groups,
+                  size_t groupCount);
+
+        [[nodiscard]] size_t GetObjectCount() const;
+        [[nodiscard]] size_t GetOpaqueObjectCount() const;
+        [[nodiscard]] size_t GetViewCount() const;
+
+        // Lists of last Cull call, sorted by distance from object bounding sphere center to near
+        // plane of view. Equal distances keep increasing object order
+        [[nodiscard]] uint32_t GetOpaqueCount(size_t view) const;
+        [[nodiscard]] const uint32_t* GetOpaqueObjects(size_t view) const;
+        [[nodiscard]] const float* GetOpaqueDistances(size_t view) const;
+        [[nodiscard]] uint32_t GetTransparentCount(size_t view) const;
+        [[nodiscard]] const uint32_t* GetTransparentObjects(size_t view) const;
+        [[nodiscard]] const float* GetTransparentDistances(size_t view) const;
+
+    private:
+        // Views of one group or single view that is not part of any group
+        struct CullingTask
+        {
+            MultiViewCulling::ViewGroup group;
+            bool hasBoundingSphere;
+        };
+
+        void RunTask(const Frustum* views, const CullingTask& task, ScratchArena& scratch);
+
+        size_t m_ObjectCount;
+        size_t m_OpaqueObjectCount;
+        size_t m_ViewCount;
+        FrustumCulling::AABBArray m_BoundingBoxes;
+        // w is radius
+        std::vector<Vector4> m_BoundingSpheres;
+
+        // Each view has range of m_ObjectCount entries, visible opaque objects are at the start
+        // of it and visible transparent objects follow them
+        std::vector<uint32_t> m_Objects;
+        std::vector<float> m_Distances;
+        std::vector<uint32_t> m_OpaqueCounts;
+        std::vector<uint32_t> m_TransparentCounts;
+
+        std::vector<CullingTask> m_Tasks;
+        std::vector<ScratchArena> m_TaskScratch;
+    };
+
+} // namespace Boolka
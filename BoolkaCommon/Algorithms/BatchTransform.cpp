@@ -0,0 +1,287 @@
+#include "stdafx.h"
+
+#include "BatchTransform.h"
+
+#include "BatchTransformKernels.h"
+#include "Structures/CPUFeatures.h"
+#include "Structures/WideBackends.h"
+
+namespace Boolka
+{
+
+    static_assert(sizeof(Vector3) == sizeof(float) * 3,
+                  "Points are transposed as contiguous array of floats");
+    static_assert(sizeof(Vector4) == sizeof(float) * 4,
+                  "Spheres are transposed as contiguous array of floats");
+    static_assert(sizeof(AABB) == sizeof(float) * 8, "Box is loaded as two vectors");
+
+    using Backend = BatchTransform::Backend;
+
+    // Terms are summed in same order as in Vector4 * Matrix4x4, so that results match bit exactly
+    // w is 1 for points and 0 for directions
+    static void TransformScalar(const Matrix4x4& transform, float w, const Vector3* inputs,
+                                Vector3* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vector3 input = inputs[i];
+            Vector3 result;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                result[axis] = transform[0][axis] * input.x() + transform[1][axis] * input.y() +
+                               transform[2][axis] * input.z() + transform[3][axis] * w;
+            }
+            results[i] = result;
+        }
+    }
+
+    static void TransformAABBsScalar(const Matrix4x4& transform, const AABB* boxes, AABB* results,
+                                     size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vector4 boxMin = boxes[i].GetMin();
+            const Vector4 boxMax = boxes[i].GetMax();
+            Vector4 resultMin = Vector4(Vector3(transform[3]), 1.0f);
+            Vector4 resultMax = resultMin;
+            for (size_t row = 0; row < 3; ++row)
+            {
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    const float first = transform[row][axis] * boxMin[row];
+                    const float second = transform[row][axis] * boxMax[row];
+                    // Same choice as _mm_min_ps and _mm_max_ps when one of values is NaN
+                    resultMin[axis] += first < second ? first : second;
+                    resultMax[axis] += first > second ? first : second;
+                }
+            }
+            results[i] = AABB(resultMin, resultMax);
+        }
+    }
+
+    // Sphere projection by its tangent planes, see "2D Polyhedral Bounds of a Clipped,
+    // Perspective-Projected 3D Sphere" by Mara and McGuire
+    // Projects one axis, center and radius are in view space
+    static void ProjectSphereAxisScalar(float center, float centerZ, float radius, float scale,
+                                        float offset, float& minimum, float& maximum)
+    {
+        const float tangentLength =
+            std::sqrt(center * center + (centerZ * centerZ - radius * radius));
+        const float radiusZ = radius * centerZ;
+        const float radiusAxis = radius * center;
+        minimum = (tangentLength * center - radiusZ) / (tangentLength * centerZ + radiusAxis);
+        maximum = (tangentLength * center + radiusZ) / (tangentLength * centerZ - radiusAxis);
+        minimum = minimum * scale + offset;
+        maximum = maximum * scale + offset;
+    }
+
+    static void ProjectSpheresScalar(const SphereProjection& setup, const Vector4* spheres,
+                                     Vector4* rectangles, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vector4 sphere = spheres[i];
+            float center[3];
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                center[axis] = setup.view[0][axis] * sphere.x() + setup.view[1][axis] * sphere.y() +
+                               setup.view[2][axis] * sphere.z() + setup.view[3][axis];
+            }
+
+            const float radius = sphere.w();
+            if (center[2] - radius < setup.nearZ)
+            {
+                rectangles[i] = Vector4(-1.0f, -1.0f, 1.0f, 1.0f);
+                continue;
+            }
+
+            Vector4 rectangle;
+            ProjectSphereAxisScalar(center[0], center[2], radius, setup.scaleX, setup.offsetX,
+                                    rectangle[0], rectangle[2]);
+            ProjectSphereAxisScalar(center[1], center[2], radius, setup.scaleY, setup.offsetY,
+                                    rectangle[1], rectangle[3]);
+            rectangles[i] = rectangle;
+        }
+    }
+
+#ifdef BLK_USE_SSE
+
+    // Wide backend extended with conversion from and to pairs of SSE registers, so that kernels
+    // in BatchTransformKernels.h use same transposes for it and for AVX2 one
+    struct BatchBackendSSE : WideBackendSSE
+    {
+        [[nodiscard]] static FloatType Combine(__m128 low, __m128 high)
+        {
+            return {low, high};
+        }
+
+        [[nodiscard]] static __m128 GetLow(const FloatType& value)
+        {
+            return value.low;
+        }
+
+        [[nodiscard]] static __m128 GetHigh(const FloatType& value)
+        {
+            return value.high;
+        }
+    };
+
+    static void AddAxisExtentSSE(__m128 row, __m128 boxMin, __m128 boxMax, __m128& resultMin,
+                                 __m128& resultMax)
+    {
+        const __m128 first = _mm_mul_ps(row, boxMin);
+        const __m128 second = _mm_mul_ps(row, boxMax);
+        resultMin = _mm_add_ps(resultMin, _mm_min_ps(first, second));
+        resultMax = _mm_add_ps(resultMax, _mm_max_ps(first, second));
+    }
+
+    static void TransformAABBsSSE(const Matrix4x4& transform, const AABB* boxes, AABB* results,
+                                  size_t count)
+    {
+        const __m128 row0 = transform[0].GetInternal();
+        const __m128 row1 = transform[1].GetInternal();
+        const __m128 row2 = transform[2].GetInternal();
+        // Translation with w of 1, rows above have w of 0 for affine transform
+        const __m128 translation =
+            _mm_insert_ps(transform[3].GetInternal(), _mm_set_ss(1.0f), 0x30);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const __m128 boxMin = boxes[i].GetMin().GetInternal();
+            const __m128 boxMax = boxes[i].GetMax().GetInternal();
+
+            __m128 resultMin = translation;
+            __m128 resultMax = translation;
+            AddAxisExtentSSE(row0, _mm_shuffle_ps(boxMin, boxMin, 0x00),
+                             _mm_shuffle_ps(boxMax, boxMax, 0x00), resultMin, resultMax);
+            AddAxisExtentSSE(row1, _mm_shuffle_ps(boxMin, boxMin, 0x55),
+                             _mm_shuffle_ps(boxMax, boxMax, 0x55), resultMin, resultMax);
+            AddAxisExtentSSE(row2, _mm_shuffle_ps(boxMin, boxMin, 0xAA),
+                             _mm_shuffle_ps(boxMax, boxMax, 0xAA), resultMin, resultMax);
+
+            // Products in w are 0 for affine transform
+            results[i] = AABB(_mm_insert_ps(resultMin, translation, 0xF0),
+                              _mm_insert_ps(resultMax, translation, 0xF0));
+        }
+    }
+
+#endif
+
+    static void TransformVectors(const Matrix4x4& transform, float w, const Vector3* inputs,
+                                 Vector3* results, size_t count, Backend backend)
+    {
+        BLK_ASSERT(FrustumCulling::IsBackendSupported(backend));
+
+        float rows[4][3];
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            for (size_t row = 0; row < 3; ++row)
+                rows[row][axis] = transform[row][axis];
+            rows[3][axis] = transform[3][axis] * w;
+        }
+
+        size_t processed = 0;
+        switch (backend)
+        {
+#ifdef BLK_USE_SSE
+        case Backend::SSE:
+            processed = TransformWide<BatchBackendSSE>(
+                rows, reinterpret_cast<const float*>(inputs), reinterpret_cast<float*>(results),
+                count);
+            break;
+        case Backend::AVX2:
+            processed = TransformVectorsAVX2(rows, reinterpret_cast<const float*>(inputs),
+                                             reinterpret_cast<float*>(results), count);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        TransformScalar(transform, w, inputs + processed, results + processed, count - processed);
+    }
+
+    void BatchTransform::TransformPoints(const Matrix4x4& transform, const Vector3* points,
+                                         Vector3* results, size_t count, Backend backend)
+    {
+        TransformVectors(transform, 1.0f, points, results, count, backend);
+    }
+
+    void BatchTransform::TransformDirections(const Matrix4x4& transform,
+                                             const Vector3* directions, Vector3* results,
+                                             size_t count, Backend backend)
+    {
+        TransformVectors(transform, 0.0f, directions, results, count, backend);
+    }
+
+    void BatchTransform::TransformAABBs(const Matrix4x4& transform, const AABB* boxes,
+                                        AABB* results, size_t count, Backend backend)
+    {
+        BLK_ASSERT(FrustumCulling::IsBackendSupported(backend));
+
+        switch (backend)
+        {
+#ifdef BLK_USE_SSE
+        case Backend::SSE:
+            TransformAABBsSSE(transform, boxes, results, count);
+            break;
+        case Backend::AVX2:
+        {
+            const size_t processed =
+                TransformAABBsAVX2(transform.GetBuffer(), reinterpret_cast<const float*>(boxes),
+                                   reinterpret_cast<float*>(results), count);
+            TransformAABBsSSE(transform, boxes + processed, results + processed,
+                              count - processed);
+            break;
+        }
+#endif
+        default:
+            TransformAABBsScalar(transform, boxes, results, count);
+            break;
+        }
+    }
+
+    void BatchTransform::ProjectSpheres(const Matrix4x4& view, const Matrix4x4& projection,
+                                        float nearZ, const Vector4* spheres, Vector4* rectangles,
+                                        size_t count, Backend backend)
+    {
+        BLK_ASSERT(FrustumCulling::IsBackendSupported(backend));
+        // Perspective projection without skew, clip space w is view space z
+        BLK_ASSERT(projection[1][0] == 0.0f && projection[0][1] == 0.0f);
+        BLK_ASSERT(projection[2][3] == 1.0f && projection[3][3] == 0.0f);
+
+        SphereProjection setup;
+        for (size_t row = 0; row < 4; ++row)
+        {
+            for (size_t axis = 0; axis < 3; ++axis)
+                setup.view[row][axis] = view[row][axis];
+        }
+        setup.scaleX = projection[0][0];
+        setup.scaleY = projection[1][1];
+        setup.offsetX = projection[2][0];
+        setup.offsetY = projection[2][1];
+        setup.nearZ = nearZ;
+
+        size_t processed = 0;
+        switch (backend)
+        {
+#ifdef BLK_USE_SSE
+        case Backend::SSE:
+            processed = ProjectSpheresWide<BatchBackendSSE>(
+                setup, reinterpret_cast<const float*>(spheres),
+                reinterpret_cast<float*>(rectangles), count);
+            break;
+        case Backend::AVX2:
+            processed = ProjectSpheresAVX2(setup, reinterpret_cast<const float*>(spheres),
+                                           reinterpret_cast<float*>(rectangles), count);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        ProjectSpheresScalar(setup, spheres + processed, rectangles + processed,
+                             count - processed);
+    }
+
+} // namespace Boolka
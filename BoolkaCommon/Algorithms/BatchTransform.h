@@ -0,0 +1,53 @@
+#pragma once
+
+#include "FrustumCulling.h"
+
+namespace Boolka
+{
+
+    class AABB;
+
+    // Transforms arrays of points, directions, bounding boxes and spheres by single matrix
+    // SSE and AVX2 backends transform points and spheres 8 at a time as structure of arrays and
+    // boxes one (SSE) or two (AVX2) per iteration, remaining elements are transformed same way
+    // as by Scalar backend
+    // Matrices are applied to row vectors, same as Vector4 * Matrix4x4
+    class BatchTransform
+    {
+    public:
+        using Backend = FrustumCulling::Backend;
+
+        // Points are transformed as (x, y, z, 1), transform should be affine
+        // Results match Vector4 * Matrix4x4 bit exactly for every backend
+        // Input and output may be same array
+        static void TransformPoints(const Matrix4x4& transform, const Vector3* points,
+                                    Vector3* results, size_t count,
+                                    Backend backend = FrustumCulling::GetDefaultBackend());
+        // Directions are transformed as (x, y, z, 0), translation is ignored
+        static void TransformDirections(const Matrix4x4& transform, const Vector3* directions,
+                                        Vector3* results, size_t count,
+                                        Backend backend = FrustumCulling::GetDefaultBackend());
+
+        // Arvo's method: each axis of result is translation plus sum of smallest and largest
+        // products of matrix row and box extent, which gives same box as transforming all 8
+        // corners, but with 3 multiplications per axis instead of 8 matrix products
+        // Transform should be affine, boxes should have w of 1
+        // Results are bit identical between backends
+        static void TransformAABBs(const Matrix4x4& transform, const AABB* boxes, AABB* results,
+                                   size_t count,
+                                   Backend backend = FrustumCulling::GetDefaultBackend());
+
+        // Projects spheres (xyz - world space center, w - radius) to normalized device
+        // coordinates rectangles (x - min x, y - min y, z - max x, w - max y)
+        // Rectangles are tight bounds of sphere projection and aren't clamped to [-1, 1]
+        // View transform should be rigid, projection should be perspective projection without
+        // skew, as made by Matrix4x4::CalculateProjPerspective (jitter offsets are supported)
+        // Spheres that aren't completely in front of nearZ get whole screen rectangle, they
+        // should be culled with frustum before this test
+        static void ProjectSpheres(const Matrix4x4& view, const Matrix4x4& projection,
+                                   float nearZ, const Vector4* spheres, Vector4* rectangles,
+                                   size_t count,
+                                   Backend backend = FrustumCulling::GetDefaultBackend());
+    };
+
+} // namespace Boolka
@@ -0,0 +1,108 @@
+#include "stdafx.h"
+
+#include "BatchTransformKernels.h"
+
+#include "Structures/WideBackends.h"
+
+// Built with /arch:AVX2, so that compiler can use 256 bit registers, and /fp:precise, so that
+// multiplies and adds aren't fused and results match SSE and scalar backends bit exactly
+#if defined(BLK_USE_SSE) && (!defined(__AVX2__) || defined(_M_FP_FAST))
+#error BatchTransformAVX2.cpp should be built with /arch:AVX2 and /fp:precise
+#endif
+
+namespace Boolka
+{
+
+#ifdef BLK_USE_SSE
+
+    namespace
+    {
+
+        struct BatchBackendAVX2 : WideBackendAVX2
+        {
+            [[nodiscard]] static FloatType Combine(__m128 low, __m128 high)
+            {
+                return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+            }
+
+            [[nodiscard]] static __m128 GetLow(const FloatType& value)
+            {
+                return _mm256_castps256_ps128(value);
+            }
+
+            [[nodiscard]] static __m128 GetHigh(const FloatType& value)
+            {
+                return _mm256_extractf128_ps(value, 1);
+            }
+        };
+
+        __m256 BroadcastRow(__m128 row)
+        {
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(row), row, 1);
+        }
+
+        // Low half of registers holds bounds of one box and high half of the next one
+        void AddAxisExtentAVX2(__m256 row, __m256 boxMin, __m256 boxMax, __m256& resultMin,
+                               __m256& resultMax)
+        {
+            const __m256 first = _mm256_mul_ps(row, boxMin);
+            const __m256 second = _mm256_mul_ps(row, boxMax);
+            resultMin = _mm256_add_ps(resultMin, _mm256_min_ps(first, second));
+            resultMax = _mm256_add_ps(resultMax, _mm256_max_ps(first, second));
+        }
+
+    } // namespace
+
+    size_t TransformVectorsAVX2(const float (&rows)[4][3], const float* inputs, float* results,
+                                size_t count)
+    {
+        return TransformWide<BatchBackendAVX2>(rows, inputs, results, count);
+    }
+
+    // Same operations as TransformAABBsSSE in BatchTransform.cpp on two boxes at once
+    size_t TransformAABBsAVX2(const float* transform, const float* boxes, float* results,
+                              size_t count)
+    {
+        const __m256 row0 = BroadcastRow(_mm_loadu_ps(transform));
+        const __m256 row1 = BroadcastRow(_mm_loadu_ps(transform + 4));
+        const __m256 row2 = BroadcastRow(_mm_loadu_ps(transform + 8));
+        const __m256 translation =
+            BroadcastRow(_mm_insert_ps(_mm_loadu_ps(transform + 12), _mm_set_ss(1.0f), 0x30));
+
+        const size_t pairCount = BLK_FLOOR_TO_POWER_OF_TWO(count, size_t(2));
+        for (size_t i = 0; i < pairCount; i += 2)
+        {
+            // Bounds of box i in low half, of box i + 1 in high half
+            const __m256 first = _mm256_loadu_ps(boxes + i * 8);
+            const __m256 second = _mm256_loadu_ps(boxes + (i + 1) * 8);
+            const __m256 boxMin = _mm256_permute2f128_ps(first, second, 0x20);
+            const __m256 boxMax = _mm256_permute2f128_ps(first, second, 0x31);
+
+            __m256 resultMin = translation;
+            __m256 resultMax = translation;
+            AddAxisExtentAVX2(row0, _mm256_permute_ps(boxMin, 0x00),
+                              _mm256_permute_ps(boxMax, 0x00), resultMin, resultMax);
+            AddAxisExtentAVX2(row1, _mm256_permute_ps(boxMin, 0x55),
+                              _mm256_permute_ps(boxMax, 0x55), resultMin, resultMax);
+            AddAxisExtentAVX2(row2, _mm256_permute_ps(boxMin, 0xAA),
+                              _mm256_permute_ps(boxMax, 0xAA), resultMin, resultMax);
+            resultMin = _mm256_blend_ps(resultMin, translation, 0x88);
+            resultMax = _mm256_blend_ps(resultMax, translation, 0x88);
+
+            _mm256_storeu_ps(results + i * 8, _mm256_permute2f128_ps(resultMin, resultMax, 0x20));
+            _mm256_storeu_ps(results + (i + 1) * 8,
+                             _mm256_permute2f128_ps(resultMin, resultMax, 0x31));
+        }
+
+        return pairCount;
+    }
+
+    size_t ProjectSpheresAVX2(const SphereProjection& setup, const float* spheres,
+                              float* rectangles, size_t count)
+    {
+        return ProjectSpheresWide<BatchBackendAVX2>(setup, spheres, rectangles, count);
+    }
+
+#endif
+
+} // namespace Boolka
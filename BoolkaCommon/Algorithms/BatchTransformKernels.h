@@ -0,0 +1,247 @@
+#pragma once
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+// Wide kernels of BatchTransform, only included by BatchTransform.cpp and BatchTransformAVX2.cpp
+// Kernels work on plain floats, so that sources built with /arch:AVX2 don't instantiate inline
+// functions of vector and matrix types
+
+namespace Boolka
+{
+
+    // Rows of view transform and projection terms that ProjectSpheres uses
+    struct SphereProjection
+    {
+        float view[4][3];
+        float scaleX;
+        float scaleY;
+        float offsetX;
+        float offsetY;
+        float nearZ;
+    };
+
+#ifdef BLK_USE_SSE
+    // Implemented in BatchTransformAVX2.cpp, which is built with /arch:AVX2
+    // Should only be called when CPUFeatures::HasAVX2 is true
+    // Return number of processed elements, remaining ones should be transformed by caller
+    // rows are first 3 columns of transform rows, translation row is already multiplied by w
+    [[nodiscard]] size_t TransformVectorsAVX2(const float (&rows)[4][3], const float* inputs,
+                                              float* results, size_t count);
+    // transform is 16 floats of Matrix4x4, boxes are 8 floats of AABB each
+    [[nodiscard]] size_t TransformAABBsAVX2(const float* transform, const float* boxes,
+                                            float* results, size_t count);
+    // spheres and rectangles are 4 floats each
+    [[nodiscard]] size_t ProjectSpheresAVX2(const SphereProjection& setup, const float* spheres,
+                                            float* rectangles, size_t count);
+#endif
+
+#ifdef BLK_USE_SSE
+
+    // Functions have internal linkage, so that copies built with /arch:AVX2 are never picked by
+    // linker for sources that run on any CPU
+    namespace
+    {
+
+        // 4 points x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3 are transposed with blends to
+        // x0 x3 x2 x1, y1 y0 y3 y2, z2 z1 z0 z3 and then shuffled to order
+        // Each of these shuffles is its own inverse, so same ones are used to transpose back
+        const int gs_ShuffleX = _MM_SHUFFLE(1, 2, 3, 0);
+        const int gs_ShuffleY = _MM_SHUFFLE(2, 3, 0, 1);
+        const int gs_ShuffleZ = _MM_SHUFFLE(3, 0, 1, 2);
+
+        void LoadPoints4(const float* data, __m128 (&result)[3])
+        {
+            const __m128 first = _mm_loadu_ps(data);
+            const __m128 second = _mm_loadu_ps(data + 4);
+            const __m128 third = _mm_loadu_ps(data + 8);
+
+            const __m128 x = _mm_blend_ps(_mm_blend_ps(first, second, 0b0100), third, 0b0010);
+            const __m128 y = _mm_blend_ps(_mm_blend_ps(first, second, 0b1001), third, 0b0100);
+            const __m128 z = _mm_blend_ps(_mm_blend_ps(first, second, 0b0010), third, 0b1001);
+            result[0] = _mm_shuffle_ps(x, x, gs_ShuffleX);
+            result[1] = _mm_shuffle_ps(y, y, gs_ShuffleY);
+            result[2] = _mm_shuffle_ps(z, z, gs_ShuffleZ);
+        }
+
+        void StorePoints4(float* data, const __m128 (&values)[3])
+        {
+            const __m128 x = _mm_shuffle_ps(values[0], values[0], gs_ShuffleX);
+            const __m128 y = _mm_shuffle_ps(values[1], values[1], gs_ShuffleY);
+            const __m128 z = _mm_shuffle_ps(values[2], values[2], gs_ShuffleZ);
+
+            _mm_storeu_ps(data, _mm_blend_ps(_mm_blend_ps(x, y, 0b0010), z, 0b0100));
+            _mm_storeu_ps(data + 4, _mm_blend_ps(_mm_blend_ps(y, z, 0b0010), x, 0b0100));
+            _mm_storeu_ps(data + 8, _mm_blend_ps(_mm_blend_ps(z, x, 0b0010), y, 0b0100));
+        }
+
+        void LoadVectors4(const float* data, __m128 (&result)[4])
+        {
+            for (size_t i = 0; i < 4; ++i)
+                result[i] = _mm_loadu_ps(data + i * 4);
+            _MM_TRANSPOSE4_PS(result[0], result[1], result[2], result[3]);
+        }
+
+        void StoreVectors4(float* data, const __m128 (&values)[4])
+        {
+            __m128 transposed[4] = {values[0], values[1], values[2], values[3]};
+            _MM_TRANSPOSE4_PS(transposed[0], transposed[1], transposed[2], transposed[3]);
+            for (size_t i = 0; i < 4; ++i)
+                _mm_storeu_ps(data + i * 4, transposed[i]);
+        }
+
+        // Wide is wide backend extended with conversion from and to pairs of SSE registers, so
+        // that same transposes are used by all of them
+        template <typename Wide, size_t componentCount>
+        void Combine(const __m128 (&low)[componentCount], const __m128 (&high)[componentCount],
+                     typename Wide::FloatType (&result)[componentCount])
+        {
+            for (size_t i = 0; i < componentCount; ++i)
+                result[i] = Wide::Combine(low[i], high[i]);
+        }
+
+        template <typename Wide, size_t componentCount>
+        void Split(const typename Wide::FloatType (&values)[componentCount],
+                   __m128 (&low)[componentCount], __m128 (&high)[componentCount])
+        {
+            for (size_t i = 0; i < componentCount; ++i)
+            {
+                low[i] = Wide::GetLow(values[i]);
+                high[i] = Wide::GetHigh(values[i]);
+            }
+        }
+
+        // Terms are summed in same order as in Vector4 * Matrix4x4, so that results match bit
+        // exactly
+        template <typename Wide>
+        size_t TransformWide(const float (&rows)[4][3], const float* inputs, float* results,
+                             size_t count)
+        {
+            using FloatType = typename Wide::FloatType;
+
+            FloatType wideRows[4][3];
+            for (size_t row = 0; row < 4; ++row)
+            {
+                for (size_t axis = 0; axis < 3; ++axis)
+                    wideRows[row][axis] = Wide::Set(rows[row][axis]);
+            }
+
+            const size_t wideCount = BLK_FLOOR_TO_POWER_OF_TWO(count, Wide::ms_Width);
+            for (size_t i = 0; i < wideCount; i += Wide::ms_Width)
+            {
+                __m128 low[3];
+                __m128 high[3];
+                LoadPoints4(inputs + i * 3, low);
+                LoadPoints4(inputs + (i + 4) * 3, high);
+                FloatType input[3];
+                Combine<Wide>(low, high, input);
+
+                FloatType result[3];
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    FloatType value = Wide::Mul(wideRows[0][axis], input[0]);
+                    value = Wide::Add(value, Wide::Mul(wideRows[1][axis], input[1]));
+                    value = Wide::Add(value, Wide::Mul(wideRows[2][axis], input[2]));
+                    result[axis] = Wide::Add(value, wideRows[3][axis]);
+                }
+
+                Split<Wide>(result, low, high);
+                StorePoints4(results + i * 3, low);
+                StorePoints4(results + (i + 4) * 3, high);
+            }
+
+            return wideCount;
+        }
+
+        // Sphere projection by its tangent planes, see "2D Polyhedral Bounds of a Clipped,
+        // Perspective-Projected 3D Sphere" by Mara and McGuire
+        // Operation order matches scalar version in BatchTransform.cpp
+        template <typename Wide>
+        void ProjectSphereAxisWide(const typename Wide::FloatType& center,
+                                   const typename Wide::FloatType& centerZ,
+                                   const typename Wide::FloatType& radius,
+                                   const typename Wide::FloatType& depthSqr, float scale,
+                                   float offset, typename Wide::FloatType& minimum,
+                                   typename Wide::FloatType& maximum)
+        {
+            using FloatType = typename Wide::FloatType;
+
+            const FloatType tangentLength =
+                Wide::Sqrt(Wide::Add(Wide::Mul(center, center), depthSqr));
+            const FloatType radiusZ = Wide::Mul(radius, centerZ);
+            const FloatType radiusAxis = Wide::Mul(radius, center);
+            const FloatType tangentCenter = Wide::Mul(tangentLength, center);
+            const FloatType tangentCenterZ = Wide::Mul(tangentLength, centerZ);
+            minimum = Wide::Div(Wide::Sub(tangentCenter, radiusZ),
+                                Wide::Add(tangentCenterZ, radiusAxis));
+            maximum = Wide::Div(Wide::Add(tangentCenter, radiusZ),
+                                Wide::Sub(tangentCenterZ, radiusAxis));
+            minimum = Wide::Add(Wide::Mul(minimum, Wide::Set(scale)), Wide::Set(offset));
+            maximum = Wide::Add(Wide::Mul(maximum, Wide::Set(scale)), Wide::Set(offset));
+        }
+
+        template <typename Wide>
+        size_t ProjectSpheresWide(const SphereProjection& setup, const float* spheres,
+                                  float* rectangles, size_t count)
+        {
+            using FloatType = typename Wide::FloatType;
+
+            FloatType view[4][3];
+            for (size_t row = 0; row < 4; ++row)
+            {
+                for (size_t axis = 0; axis < 3; ++axis)
+                    view[row][axis] = Wide::Set(setup.view[row][axis]);
+            }
+            const FloatType nearZ = Wide::Set(setup.nearZ);
+            const FloatType one = Wide::Set(1.0f);
+            const FloatType minusOne = Wide::Set(-1.0f);
+
+            const size_t wideCount = BLK_FLOOR_TO_POWER_OF_TWO(count, Wide::ms_Width);
+            for (size_t i = 0; i < wideCount; i += Wide::ms_Width)
+            {
+                __m128 low[4];
+                __m128 high[4];
+                LoadVectors4(spheres + i * 4, low);
+                LoadVectors4(spheres + (i + 4) * 4, high);
+                FloatType sphere[4];
+                Combine<Wide>(low, high, sphere);
+
+                FloatType center[3];
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    FloatType value = Wide::Mul(view[0][axis], sphere[0]);
+                    value = Wide::Add(value, Wide::Mul(view[1][axis], sphere[1]));
+                    value = Wide::Add(value, Wide::Mul(view[2][axis], sphere[2]));
+                    center[axis] = Wide::Add(value, view[3][axis]);
+                }
+
+                const FloatType& radius = sphere[3];
+                const FloatType depthSqr =
+                    Wide::Sub(Wide::Mul(center[2], center[2]), Wide::Mul(radius, radius));
+
+                FloatType rectangle[4];
+                ProjectSphereAxisWide<Wide>(center[0], center[2], radius, depthSqr, setup.scaleX,
+                                            setup.offsetX, rectangle[0], rectangle[2]);
+                ProjectSphereAxisWide<Wide>(center[1], center[2], radius, depthSqr, setup.scaleY,
+                                            setup.offsetY, rectangle[1], rectangle[3]);
+
+                const FloatType isClipped = Wide::Less(Wide::Sub(center[2], radius), nearZ);
+                rectangle[0] = Wide::Select(rectangle[0], minusOne, isClipped);
+                rectangle[1] = Wide::Select(rectangle[1], minusOne, isClipped);
+                rectangle[2] = Wide::Select(rectangle[2], one, isClipped);
+                rectangle[3] = Wide::Select(rectangle[3], one, isClipped);
+
+                Split<Wide>(rectangle, low, high);
+                StoreVectors4(rectangles + i * 4, low);
+                StoreVectors4(rectangles + (i + 4) * 4, high);
+            }
+
+            return wideCount;
+        }
+
+    } // namespace
+
+#endif
+
+} // namespace Boolka
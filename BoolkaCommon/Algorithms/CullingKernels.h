@@ -0,0 +1,386 @@
+#pragma once
+
+#include "MultiViewCulling.h"
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+// Plane tests shared by FrustumCulling and MultiViewCulling, only included by their sources and
+// by CullingKernelsAVX2.cpp
+
+namespace Boolka
+{
+
+    static const size_t gs_CullingPlaneCount = 6;
+
+    // Bounds of box are kept in this order, so that plane can reference them by index
+    // 0..2 - min x, y, z
+    // 3..5 - max x, y, z
+    static const size_t gs_CullingBoundCount = 6;
+
+    struct CullingPlane
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+        // Bound that is furthest along plane normal, same choice as Frustum::CheckAABBFast
+        size_t boundX;
+        size_t boundY;
+        size_t boundZ;
+    };
+
+    // Bound arrays of boxes in same order as bounds above
+    struct CullingBoundArrays
+    {
+        const float* data[gs_CullingBoundCount];
+    };
+
+    // Continuous range of views, optionally behind bounding sphere
+    struct ViewSegment
+    {
+        bool hasSphere;
+        float centerX;
+        float centerY;
+        float centerZ;
+        float radiusSqr;
+        size_t firstView;
+        size_t viewCount;
+    };
+
+    struct MultiViewSetup
+    {
+        CullingPlane planes[MultiViewCulling::ms_MaxViewCount][gs_CullingPlaneCount];
+        ViewSegment segments[MultiViewCulling::ms_MaxViewCount];
+        size_t segmentCount;
+    };
+
+#ifdef BLK_USE_SSE
+    // Implemented in CullingKernelsAVX2.cpp, which is built with /arch:AVX2
+    // Should only be called when CPUFeatures::HasAVX2 is true
+    [[nodiscard]] uint32_t CullWordAVX2(const CullingPlane (&planes)[gs_CullingPlaneCount],
+                                        const CullingBoundArrays& arrays, size_t begin,
+                                        size_t count);
+    [[nodiscard]] size_t CullBoxesAVX2(const MultiViewSetup& setup,
+                                       const CullingBoundArrays& arrays, size_t boxCount,
+                                       uint32_t* viewMasks);
+#endif
+
+    // Functions and lane wrappers have internal linkage, so that copies built with /arch:AVX2 are
+    // never picked by linker for sources that run on any CPU
+    namespace
+    {
+
+        void SetupCullingPlanes(const Frustum& frustum,
+                                CullingPlane (&planes)[gs_CullingPlaneCount])
+        {
+            const float* planeData = frustum.GetBuffer();
+            for (size_t i = 0; i < gs_CullingPlaneCount; ++i)
+            {
+                const float* plane = planeData + i * 4;
+                CullingPlane& cullingPlane = planes[i];
+                cullingPlane.x = plane[0];
+                cullingPlane.y = plane[1];
+                cullingPlane.z = plane[2];
+                cullingPlane.w = plane[3];
+                cullingPlane.boundX = plane[0] > 0.0f ? 3 : 0;
+                cullingPlane.boundY = plane[1] > 0.0f ? 4 : 1;
+                cullingPlane.boundZ = plane[2] > 0.0f ? 5 : 2;
+            }
+        }
+
+        CullingBoundArrays GetCullingBoundArrays(const FrustumCulling::AABBArray& boxes)
+        {
+            CullingBoundArrays arrays;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                arrays.data[axis] = boxes.GetMin(axis);
+                arrays.data[axis + 3] = boxes.GetMax(axis);
+            }
+            return arrays;
+        }
+
+        void LoadBoundsScalar(const CullingBoundArrays& arrays, size_t index,
+                              float (&bounds)[gs_CullingBoundCount])
+        {
+            for (size_t i = 0; i < gs_CullingBoundCount; ++i)
+                bounds[i] = arrays.data[i][index];
+        }
+
+        // Terms are summed in same order as _mm_dp_ps does in Vector4::Dot, so that results match
+        // bit exactly, SIMD variant below uses same order
+        bool IsVisibleScalar(const CullingPlane (&planes)[gs_CullingPlaneCount],
+                             const float (&bounds)[gs_CullingBoundCount])
+        {
+            for (const CullingPlane& plane : planes)
+            {
+                const float xy = plane.x * bounds[plane.boundX] + plane.y * bounds[plane.boundY];
+                const float zw = plane.z * bounds[plane.boundZ] + plane.w;
+                if (xy + zw < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+#ifdef BLK_USE_SSE
+        struct LanesSSE
+        {
+            using Type = __m128;
+            static constexpr size_t ms_Width = 4;
+
+            static Type Load(const float* data)
+            {
+                return _mm_loadu_ps(data);
+            }
+            static Type Set(float value)
+            {
+                return _mm_set1_ps(value);
+            }
+            static Type SetBits(uint32_t bits)
+            {
+                return _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(bits)));
+            }
+            static Type Zero()
+            {
+                return _mm_setzero_ps();
+            }
+            static Type Add(Type left, Type right)
+            {
+                return _mm_add_ps(left, right);
+            }
+            static Type Sub(Type left, Type right)
+            {
+                return _mm_sub_ps(left, right);
+            }
+            static Type Mul(Type left, Type right)
+            {
+                return _mm_mul_ps(left, right);
+            }
+            static Type Max(Type left, Type right)
+            {
+                return _mm_max_ps(left, right);
+            }
+            static Type Or(Type left, Type right)
+            {
+                return _mm_or_ps(left, right);
+            }
+            static Type And(Type left, Type right)
+            {
+                return _mm_and_ps(left, right);
+            }
+            // ~left & right
+            static Type AndNot(Type left, Type right)
+            {
+                return _mm_andnot_ps(left, right);
+            }
+            static Type Less(Type left, Type right)
+            {
+                return _mm_cmplt_ps(left, right);
+            }
+            static Type LessEqual(Type left, Type right)
+            {
+                return _mm_cmple_ps(left, right);
+            }
+            static uint32_t GetSignMask(Type value)
+            {
+                return static_cast<uint32_t>(_mm_movemask_ps(value));
+            }
+            static void StoreBits(uint32_t* data, Type value)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_castps_si128(value));
+            }
+        };
+#endif
+
+#if defined(BLK_USE_SSE) && defined(__AVX2__)
+        struct LanesAVX2
+        {
+            using Type = __m256;
+            static constexpr size_t ms_Width = 8;
+
+            static Type Load(const float* data)
+            {
+                return _mm256_loadu_ps(data);
+            }
+            static Type Set(float value)
+            {
+                return _mm256_set1_ps(value);
+            }
+            static Type SetBits(uint32_t bits)
+            {
+                return _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(bits)));
+            }
+            static Type Zero()
+            {
+                return _mm256_setzero_ps();
+            }
+            static Type Add(Type left, Type right)
+            {
+                return _mm256_add_ps(left, right);
+            }
+            static Type Sub(Type left, Type right)
+            {
+                return _mm256_sub_ps(left, right);
+            }
+            static Type Mul(Type left, Type right)
+            {
+                return _mm256_mul_ps(left, right);
+            }
+            static Type Max(Type left, Type right)
+            {
+                return _mm256_max_ps(left, right);
+            }
+            static Type Or(Type left, Type right)
+            {
+                return _mm256_or_ps(left, right);
+            }
+            static Type And(Type left, Type right)
+            {
+                return _mm256_and_ps(left, right);
+            }
+            // ~left & right
+            static Type AndNot(Type left, Type right)
+            {
+                return _mm256_andnot_ps(left, right);
+            }
+            static Type Less(Type left, Type right)
+            {
+                return _mm256_cmp_ps(left, right, _CMP_LT_OQ);
+            }
+            static Type LessEqual(Type left, Type right)
+            {
+                return _mm256_cmp_ps(left, right, _CMP_LE_OQ);
+            }
+            static uint32_t GetSignMask(Type value)
+            {
+                return static_cast<uint32_t>(_mm256_movemask_ps(value));
+            }
+            static void StoreBits(uint32_t* data, Type value)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm256_castps_si256(value));
+            }
+        };
+#endif
+
+#ifdef BLK_USE_SSE
+        // Loads bounds of Lanes::ms_Width boxes starting from index
+        template <typename Lanes>
+        void LoadBoundsSIMD(const CullingBoundArrays& arrays, size_t index,
+                            typename Lanes::Type (&bounds)[gs_CullingBoundCount])
+        {
+            for (size_t i = 0; i < gs_CullingBoundCount; ++i)
+                bounds[i] = Lanes::Load(arrays.data[i] + index);
+        }
+
+        // Lane is set if box is completely outside of any plane
+        template <typename Lanes>
+        typename Lanes::Type IsOutsideSIMD(
+            const CullingPlane (&planes)[gs_CullingPlaneCount],
+            const typename Lanes::Type (&bounds)[gs_CullingBoundCount])
+        {
+            using Type = typename Lanes::Type;
+
+            const Type zero = Lanes::Zero();
+            Type outside = zero;
+            for (const CullingPlane& plane : planes)
+            {
+                const Type xy = Lanes::Add(Lanes::Mul(Lanes::Set(plane.x), bounds[plane.boundX]),
+                                           Lanes::Mul(Lanes::Set(plane.y), bounds[plane.boundY]));
+                const Type zw = Lanes::Add(Lanes::Mul(Lanes::Set(plane.z), bounds[plane.boundZ]),
+                                           Lanes::Set(plane.w));
+                outside = Lanes::Or(outside, Lanes::Less(Lanes::Add(xy, zw), zero));
+            }
+            return outside;
+        }
+
+        // Tests boxes [begin, begin + count) in groups of Lanes::ms_Width, returns visibility mask
+        template <typename Lanes>
+        uint32_t CullWordSIMD(const CullingPlane (&planes)[gs_CullingPlaneCount],
+                              const CullingBoundArrays& arrays, size_t begin, size_t count)
+        {
+            const size_t vectorCount = BLK_FLOOR_TO_POWER_OF_TWO(count, Lanes::ms_Width);
+            const uint32_t laneMask = (1u << Lanes::ms_Width) - 1;
+
+            uint32_t result = 0;
+            for (size_t i = 0; i < vectorCount; i += Lanes::ms_Width)
+            {
+                typename Lanes::Type bounds[gs_CullingBoundCount];
+                LoadBoundsSIMD<Lanes>(arrays, begin + i, bounds);
+                const uint32_t outside = Lanes::GetSignMask(IsOutsideSIMD<Lanes>(planes, bounds));
+                result |= (~outside & laneMask) << i;
+            }
+
+            for (size_t i = vectorCount; i < count; ++i)
+            {
+                float bounds[gs_CullingBoundCount];
+                LoadBoundsScalar(arrays, begin + i, bounds);
+                if (IsVisibleScalar(planes, bounds))
+                    result |= 1u << i;
+            }
+            return result;
+        }
+
+        // Tests Lanes::ms_Width boxes at once, returns number of processed boxes
+        template <typename Lanes>
+        size_t CullBoxesSIMD(const MultiViewSetup& setup, const CullingBoundArrays& arrays,
+                             size_t boxCount, uint32_t* viewMasks)
+        {
+            using Type = typename Lanes::Type;
+
+            const size_t vectorCount = BLK_FLOOR_TO_POWER_OF_TWO(boxCount, Lanes::ms_Width);
+            const Type zero = Lanes::Zero();
+            const Type allLanes = Lanes::SetBits(~0u);
+
+            for (size_t i = 0; i < vectorCount; i += Lanes::ms_Width)
+            {
+                // Kept on stack, planes pick from them by index
+                Type bounds[gs_CullingBoundCount];
+                LoadBoundsSIMD<Lanes>(arrays, i, bounds);
+
+                Type mask = zero;
+                for (size_t s = 0; s < setup.segmentCount; ++s)
+                {
+                    const ViewSegment& segment = setup.segments[s];
+
+                    Type active = allLanes;
+                    if (segment.hasSphere)
+                    {
+                        const Type centerX = Lanes::Set(segment.centerX);
+                        const Type centerY = Lanes::Set(segment.centerY);
+                        const Type centerZ = Lanes::Set(segment.centerZ);
+                        const Type dx = Lanes::Max(Lanes::Max(Lanes::Sub(bounds[0], centerX),
+                                                              Lanes::Sub(centerX, bounds[3])),
+                                                   zero);
+                        const Type dy = Lanes::Max(Lanes::Max(Lanes::Sub(bounds[1], centerY),
+                                                              Lanes::Sub(centerY, bounds[4])),
+                                                   zero);
+                        const Type dz = Lanes::Max(Lanes::Max(Lanes::Sub(bounds[2], centerZ),
+                                                              Lanes::Sub(centerZ, bounds[5])),
+                                                   zero);
+                        const Type distanceSqr =
+                            Lanes::Add(Lanes::Add(Lanes::Mul(dx, dx), Lanes::Mul(dy, dy)),
+                                       Lanes::Mul(dz, dz));
+                        active = Lanes::LessEqual(distanceSqr, Lanes::Set(segment.radiusSqr));
+                        if (Lanes::GetSignMask(active) == 0)
+                            continue;
+                    }
+
+                    for (size_t view = segment.firstView;
+                         view < segment.firstView + segment.viewCount; ++view)
+                    {
+                        const Type outside = IsOutsideSIMD<Lanes>(setup.planes[view], bounds);
+                        const Type visible = Lanes::AndNot(outside, active);
+                        mask = Lanes::Or(mask, Lanes::And(visible, Lanes::SetBits(1u << view)));
+                    }
+                }
+                Lanes::StoreBits(viewMasks + i, mask);
+            }
+
+            return vectorCount;
+        }
+#endif
+
+    } // namespace
+
+} // namespace Boolka
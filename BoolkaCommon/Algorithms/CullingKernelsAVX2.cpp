@@ -0,0 +1,30 @@
+#include "stdafx.h"
+
+#include "CullingKernels.h"
+
+// Built with /arch:AVX2, so that compiler can use 256 bit registers, and /fp:precise, so that
+// multiplies and adds aren't fused and results match SSE and scalar backends bit exactly
+#if defined(BLK_USE_SSE) && (!defined(__AVX2__) || defined(_M_FP_FAST))
+#error CullingKernelsAVX2.cpp should be built with /arch:AVX2 and /fp:precise
+#endif
+
+namespace Boolka
+{
+
+#ifdef BLK_USE_SSE
+
+    uint32_t CullWordAVX2(const CullingPlane (&planes)[gs_CullingPlaneCount],
+                          const CullingBoundArrays& arrays, size_t begin, size_t count)
+    {
+        return CullWordSIMD<LanesAVX2>(planes, arrays, begin, count);
+    }
+
+    size_t CullBoxesAVX2(const MultiViewSetup& setup, const CullingBoundArrays& arrays,
+                         size_t boxCount, uint32_t* viewMasks)
+    {
+        return CullBoxesSIMD<LanesAVX2>(setup, arrays, boxCount, viewMasks);
+    }
+
+#endif
+
+} // namespace Boolka
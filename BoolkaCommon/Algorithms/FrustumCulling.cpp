@@ -0,0 +1,209 @@
+#include "stdafx.h"
+
+#include "FrustumCulling.h"
+
+#include "CullingKernels.h"
+#include "Structures/CPUFeatures.h"
+
+namespace Boolka
+{
+
+    static const size_t gs_MaskWordBits = 32;
+    // Boxes culled on stack at once when writing indices
+    static const size_t gs_IndexChunkWords = 64;
+
+    static uint32_t CullWordScalar(const CullingPlane (&planes)[gs_CullingPlaneCount],
+                                   const CullingBoundArrays& arrays, size_t begin, size_t count)
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float bounds[gs_CullingBoundCount];
+            LoadBoundsScalar(arrays, begin + i, bounds);
+            if (IsVisibleScalar(planes, bounds))
+                result |= 1u << i;
+        }
+        return result;
+    }
+
+    using CullWordFunction = uint32_t (*)(const CullingPlane (&)[gs_CullingPlaneCount],
+                                          const CullingBoundArrays&, size_t, size_t);
+
+    static CullWordFunction GetCullWordFunction(FrustumCulling::Backend backend)
+    {
+        BLK_ASSERT(FrustumCulling::IsBackendSupported(backend));
+
+        switch (backend)
+        {
+#ifdef BLK_USE_SSE
+        case FrustumCulling::Backend::SSE:
+            return &CullWordSIMD<LanesSSE>;
+#endif
+#ifdef BLK_USE_SSE
+        case FrustumCulling::Backend::AVX2:
+            return &CullWordAVX2;
+#endif
+        default:
+            return &CullWordScalar;
+        }
+    }
+
+    // Fills mask words for boxes [firstWord * 32, min(boxCount, lastWord * 32))
+    static void CullWords(const CullingPlane (&planes)[gs_CullingPlaneCount],
+                          const CullingBoundArrays& arrays, CullWordFunction cullWord,
+                          size_t boxCount, size_t firstWord, size_t lastWord, uint32_t* words)
+    {
+        for (size_t word = firstWord; word < lastWord; ++word)
+        {
+            const size_t begin = word * gs_MaskWordBits;
+            const size_t count = std::min(gs_MaskWordBits, boxCount - begin);
+            words[word - firstWord] = cullWord(planes, arrays, begin, count);
+        }
+    }
+
+    void FrustumCulling::AABBArray::Clear()
+    {
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            m_Min[axis].clear();
+            m_Max[axis].clear();
+        }
+    }
+
+    void FrustumCulling::AABBArray::Reserve(size_t count)
+    {
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            m_Min[axis].reserve(count);
+            m_Max[axis].reserve(count);
+        }
+    }
+
+    void FrustumCulling::AABBArray::Add(const AABB& boundingBox)
+    {
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            m_Min[axis].push_back(boundingBox.GetMin()[axis]);
+            m_Max[axis].push_back(boundingBox.GetMax()[axis]);
+        }
+    }
+
+    void FrustumCulling::AABBArray::Set(size_t index, const AABB& boundingBox)
+    {
+        BLK_ASSERT(index < GetSize());
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            m_Min[axis][index] = boundingBox.GetMin()[axis];
+            m_Max[axis][index] = boundingBox.GetMax()[axis];
+        }
+    }
+
+    void FrustumCulling::AABBArray::Resize(size_t count)
+    {
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            m_Min[axis].resize(count);
+            m_Max[axis].resize(count);
+        }
+    }
+
+    size_t FrustumCulling::AABBArray::GetSize() const
+    {
+        return m_Min[0].size();
+    }
+
+    const float* FrustumCulling::AABBArray::GetMin(size_t axis) const
+    {
+        BLK_ASSERT(axis < 3);
+        return m_Min[axis].data();
+    }
+
+    const float* FrustumCulling::AABBArray::GetMax(size_t axis) const
+    {
+        BLK_ASSERT(axis < 3);
+        return m_Max[axis].data();
+    }
+
+    bool FrustumCulling::IsBackendSupported(Backend backend)
+    {
+        switch (backend)
+        {
+        case Backend::Scalar:
+            return true;
+        case Backend::SSE:
+#ifdef BLK_USE_SSE
+            return true;
+#else
+            return false;
+#endif
+        case Backend::AVX2:
+#ifdef BLK_USE_SSE
+            return CPUFeatures::HasAVX2();
+#else
+            return false;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    FrustumCulling::Backend FrustumCulling::GetDefaultBackend()
+    {
+        if (IsBackendSupported(Backend::AVX2))
+            return Backend::AVX2;
+        if (IsBackendSupported(Backend::SSE))
+            return Backend::SSE;
+        return Backend::Scalar;
+    }
+
+    size_t FrustumCulling::GetMaskWordCount(size_t boxCount)
+    {
+        return BLK_INT_DIVIDE_CEIL(boxCount, gs_MaskWordBits);
+    }
+
+    void FrustumCulling::CullAABBs(const Frustum& frustum, const AABBArray& boxes,
+                                   uint32_t* visibilityMask, Backend backend)
+    {
+        CullingPlane planes[gs_CullingPlaneCount];
+        SetupCullingPlanes(frustum, planes);
+        const CullingBoundArrays arrays = GetCullingBoundArrays(boxes);
+
+        const size_t boxCount = boxes.GetSize();
+        CullWords(planes, arrays, GetCullWordFunction(backend), boxCount, 0,
+                  GetMaskWordCount(boxCount), visibilityMask);
+    }
+
+    size_t FrustumCulling::CullAABBsToIndices(const Frustum& frustum, const AABBArray& boxes,
+                                              uint32_t* visibleIndices, Backend backend)
+    {
+        CullingPlane planes[gs_CullingPlaneCount];
+        SetupCullingPlanes(frustum, planes);
+        const CullingBoundArrays arrays = GetCullingBoundArrays(boxes);
+        const CullWordFunction cullWord = GetCullWordFunction(backend);
+
+        const size_t boxCount = boxes.GetSize();
+        const size_t wordCount = GetMaskWordCount(boxCount);
+
+        size_t visibleCount = 0;
+        uint32_t words[gs_IndexChunkWords];
+        for (size_t firstWord = 0; firstWord < wordCount; firstWord += gs_IndexChunkWords)
+        {
+            const size_t lastWord = std::min(wordCount, firstWord + gs_IndexChunkWords);
+            CullWords(planes, arrays, cullWord, boxCount, firstWord, lastWord, words);
+
+            for (size_t word = firstWord; word < lastWord; ++word)
+            {
+                uint32_t bits = words[word - firstWord];
+                const uint32_t base = static_cast<uint32_t>(word * gs_MaskWordBits);
+                while (bits)
+                {
+                    visibleIndices[visibleCount++] = base + std::countr_zero(bits);
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        return visibleCount;
+    }
+
+} // namespace Boolka
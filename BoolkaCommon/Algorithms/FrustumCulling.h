@@ -0,0 +1,65 @@
+#pragma once
+
+namespace Boolka
+{
+
+    class AABB;
+    class Frustum;
+
+    // Culls many bounding boxes against frustum at once
+    // Boxes are stored as structure of arrays, so that 4 (SSE) or 8 (AVX2) boxes are tested
+    // against each plane with single instruction
+    class FrustumCulling
+    {
+    public:
+        enum class Backend
+        {
+            Scalar,
+            SSE,
+            AVX2,
+        };
+
+        class [[nodiscard]] AABBArray
+        {
+        public:
+            AABBArray() = default;
+            ~AABBArray() = default;
+
+            void Clear();
+            void Reserve(size_t count);
+            void Add(const AABB& boundingBox);
+            void Set(size_t index, const AABB& boundingBox);
+            void Resize(size_t count);
+
+            [[nodiscard]] size_t GetSize() const;
+            // Axis 0 - x, 1 - y, 2 - z
+            [[nodiscard]] const float* GetMin(size_t axis) const;
+            [[nodiscard]] const float* GetMax(size_t axis) const;
+
+        private:
+            std::vector<float> m_Min[3];
+            std::vector<float> m_Max[3];
+        };
+
+        // AVX2 backend is supported when CPU has AVX2, its kernels are built separately with
+        // /arch:AVX2
+        [[nodiscard]] static bool IsBackendSupported(Backend backend);
+        // Widest backend that current CPU supports
+        [[nodiscard]] static Backend GetDefaultBackend();
+
+        [[nodiscard]] static size_t GetMaskWordCount(size_t boxCount);
+
+        // Bit i of visibilityMask is set if box i is not completely outside of frustum
+        // Results match Frustum::CheckAABBFast for every box
+        // visibilityMask should have at least GetMaskWordCount(boxes.GetSize()) words
+        static void CullAABBs(const Frustum& frustum, const AABBArray& boxes,
+                              uint32_t* visibilityMask, Backend backend = GetDefaultBackend());
+        // Writes indices of visible boxes in increasing order and returns their count
+        // visibleIndices should have space for boxes.GetSize() indices
+        [[nodiscard]] static size_t CullAABBsToIndices(const Frustum& frustum,
+                                                       const AABBArray& boxes,
+                                                       uint32_t* visibleIndices,
+                                                       Backend backend = GetDefaultBackend());
+    };
+
+} // namespace Boolka
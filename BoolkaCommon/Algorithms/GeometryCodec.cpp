@@ -0,0 +1,631 @@
+#include "stdafx.h"
+
+#include "GeometryCodec.h"
+
+namespace Boolka
+{
+
+    // Low 6 bits of block control byte are bit width, high bit marks predicted block
+    static const uint8_t gs_BlockWidthMask = 0x3F;
+    static const uint8_t gs_BlockPredictedFlag = 0x80;
+    static const uint32_t gs_RowsPerBlock = GeometryCodec::BlockSize / 4;
+    // Bit reader loads 8 bytes at a time, so triangle payload is padded
+    static const size_t gs_BitStreamPadding = sizeof(uint64_t);
+    static const uint32_t gs_EdgeCodeBits = 4;
+
+    static uint32_t ZigZagEncode(uint32_t delta)
+    {
+        return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+    }
+
+    static uint32_t GetWidthMask(uint32_t width)
+    {
+        return width == 32 ? UINT32_MAX : (1u << width) - 1;
+    }
+
+    static size_t GetControlSize(size_t blockCount)
+    {
+        return BLK_CEIL_TO_POWER_OF_TWO(blockCount, 16);
+    }
+
+    // Vertex components are separate streams, so every component gets its own bit width
+    static uint32_t GetComponentCount(GeometryCodec::Method method)
+    {
+        return method == GeometryCodec::Method::Vertex ? 4 : 1;
+    }
+
+    static size_t GetBlockCount(size_t elementCount)
+    {
+        return BLK_CEIL_TO_POWER_OF_TWO(elementCount, GeometryCodec::BlockSize) /
+               GeometryCodec::BlockSize;
+    }
+
+    // Last block only stores rows that have values
+    static uint32_t GetRowCount(size_t firstElement, size_t elementCount)
+    {
+        const size_t remaining = elementCount - firstElement;
+        return static_cast<uint32_t>(std::min<size_t>(gs_RowsPerBlock, (remaining + 3) / 4));
+    }
+
+    static size_t GetPackedSize(uint32_t width, uint32_t rowCount)
+    {
+        return 4 * sizeof(uint32_t) * ((rowCount * width + 31) / 32);
+    }
+
+    // Packs up to 128 values as 4 lanes of 32 rows, lane j of row i is value 4 * i + j
+    static void PackBlock(const uint32_t* values, uint32_t width, uint32_t rowCount,
+                          uint32_t* packed)
+    {
+        memset(packed, 0, GetPackedSize(width, rowCount));
+        for (uint32_t row = 0; row < rowCount; ++row)
+        {
+            const uint32_t bit = row * width;
+            const uint32_t word = bit / 32;
+            const uint32_t shift = bit % 32;
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                const uint32_t value = values[row * 4 + lane];
+                packed[word * 4 + lane] |= value << shift;
+                if (shift + width > 32)
+                {
+                    packed[(word + 1) * 4 + lane] |= value >> (32 - shift);
+                }
+            }
+        }
+    }
+
+    // Every element is predicted from previous element of same component
+    static void EncodeBlocks(GeometryCodec::Method method, const uint32_t* values,
+                             size_t valueCount, std::vector<unsigned char>& payload)
+    {
+        const uint32_t componentCount = GetComponentCount(method);
+        const size_t elementCount = valueCount / componentCount;
+        const size_t blockCount = GetBlockCount(elementCount);
+        payload.resize(GetControlSize(blockCount * componentCount));
+
+        uint32_t raw[GeometryCodec::BlockSize];
+        uint32_t predicted[GeometryCodec::BlockSize];
+        uint32_t packed[GeometryCodec::BlockSize];
+
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            const uint32_t rowCount =
+                GetRowCount(block * GeometryCodec::BlockSize, elementCount);
+            for (uint32_t component = 0; component < componentCount; ++component)
+            {
+                uint32_t rawBits = 0;
+                uint32_t predictedBits = 0;
+                for (uint32_t i = 0; i < GeometryCodec::BlockSize; ++i)
+                {
+                    const size_t element = block * GeometryCodec::BlockSize + i;
+                    if (element >= elementCount)
+                    {
+                        raw[i] = 0;
+                        predicted[i] = 0;
+                        continue;
+                    }
+                    const size_t index = element * componentCount + component;
+                    const uint32_t previous = element > 0 ? values[index - componentCount] : 0;
+                    raw[i] = values[index];
+                    predicted[i] = ZigZagEncode(values[index] - previous);
+                    rawBits |= raw[i];
+                    predictedBits |= predicted[i];
+                }
+
+                const uint32_t rawWidth = static_cast<uint32_t>(std::bit_width(rawBits));
+                const uint32_t predictedWidth =
+                    static_cast<uint32_t>(std::bit_width(predictedBits));
+                // Raw block is slightly cheaper to decode, so it wins ties
+                const bool usePrediction = predictedWidth < rawWidth;
+                const uint32_t width = usePrediction ? predictedWidth : rawWidth;
+
+                payload[block * componentCount + component] =
+                    static_cast<uint8_t>(width | (usePrediction ? gs_BlockPredictedFlag : 0));
+
+                PackBlock(usePrediction ? predicted : raw, width, rowCount, packed);
+                const auto* packedBytes = ptr_static_cast<const unsigned char*>(packed);
+                payload.insert(payload.end(), packedBytes,
+                               packedBytes + GetPackedSize(width, rowCount));
+            }
+        }
+    }
+
+#ifdef BLK_USE_SSE
+    static __m128i ZigZagDecode(__m128i value)
+    {
+        const __m128i one = _mm_set1_epi32(1);
+        return _mm_xor_si128(_mm_srli_epi32(value, 1),
+                             _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(value, one)));
+    }
+
+    // Outputs rows of 4 consecutive values, previous holds last row of previous block
+    static void DecodeBlock(const unsigned char* packedBytes, uint8_t control, uint32_t rowCount,
+                            __m128i& previous, __m128i* rows)
+    {
+        const uint32_t width = control & gs_BlockWidthMask;
+        const bool predicted = (control & gs_BlockPredictedFlag) != 0;
+        const auto* packed = ptr_static_cast<const __m128i*>(packedBytes);
+        const __m128i mask = _mm_set1_epi32(static_cast<int>(GetWidthMask(width)));
+
+        for (uint32_t row = 0; row < rowCount; ++row)
+        {
+            __m128i value = _mm_setzero_si128();
+            if (width != 0)
+            {
+                const uint32_t bit = row * width;
+                const uint32_t word = bit / 32;
+                const uint32_t shift = bit % 32;
+                value = _mm_srl_epi32(_mm_loadu_si128(packed + word), _mm_cvtsi32_si128(shift));
+                if (shift + width > 32)
+                {
+                    value = _mm_or_si128(value, _mm_sll_epi32(_mm_loadu_si128(packed + word + 1),
+                                                              _mm_cvtsi32_si128(32 - shift)));
+                }
+                value = _mm_and_si128(value, mask);
+            }
+
+            if (predicted)
+            {
+                // Prefix sum inside row, then add last value of previous row
+                value = ZigZagDecode(value);
+                value = _mm_add_epi32(value, _mm_slli_si128(value, 4));
+                value = _mm_add_epi32(value, _mm_slli_si128(value, 8));
+                value = _mm_add_epi32(value, _mm_shuffle_epi32(previous, 0xFF));
+            }
+
+            rows[row] = value;
+            previous = value;
+        }
+    }
+
+    static void StorePartial(uint32_t* destination, __m128i value, size_t count)
+    {
+        uint32_t tail[4];
+        _mm_storeu_si128(ptr_static_cast<__m128i*>(tail), value);
+        memcpy(destination, tail, count * sizeof(uint32_t));
+    }
+
+    static void StoreBlock(GeometryCodec::Method method, __m128i (*rows)[gs_RowsPerBlock],
+                           uint32_t* values, size_t firstElement, size_t elementCount)
+    {
+        if (method == GeometryCodec::Method::Words)
+        {
+            for (uint32_t row = 0; row < gs_RowsPerBlock; ++row)
+            {
+                const size_t element = firstElement + row * 4;
+                if (element + 4 <= elementCount)
+                {
+                    _mm_storeu_si128(ptr_static_cast<__m128i*>(values + element), rows[0][row]);
+                    continue;
+                }
+                if (element < elementCount)
+                {
+                    StorePartial(values + element, rows[0][row], elementCount - element);
+                }
+                break;
+            }
+            return;
+        }
+
+        // Component rows hold 4 consecutive vertices, transpose them back into vertices
+        for (uint32_t row = 0; row < gs_RowsPerBlock; ++row)
+        {
+            const __m128i xy01 = _mm_unpacklo_epi32(rows[0][row], rows[1][row]);
+            const __m128i xy23 = _mm_unpackhi_epi32(rows[0][row], rows[1][row]);
+            const __m128i zw01 = _mm_unpacklo_epi32(rows[2][row], rows[3][row]);
+            const __m128i zw23 = _mm_unpackhi_epi32(rows[2][row], rows[3][row]);
+            const __m128i vertices[4] = {
+                _mm_unpacklo_epi64(xy01, zw01), _mm_unpackhi_epi64(xy01, zw01),
+                _mm_unpacklo_epi64(xy23, zw23), _mm_unpackhi_epi64(xy23, zw23)};
+
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const size_t element = firstElement + row * 4 + i;
+                if (element >= elementCount)
+                    return;
+                _mm_storeu_si128(ptr_static_cast<__m128i*>(values + element * 4), vertices[i]);
+            }
+        }
+    }
+
+    static bool DecodeBlocks(GeometryCodec::Method method, const unsigned char* payload,
+                             size_t payloadSize, uint32_t* values, size_t valueCount)
+    {
+        const uint32_t componentCount = GetComponentCount(method);
+        const size_t elementCount = valueCount / componentCount;
+        const size_t blockCount = GetBlockCount(elementCount);
+        size_t offset = GetControlSize(blockCount * componentCount);
+        if (offset > payloadSize)
+            return false;
+
+        __m128i rows[4][gs_RowsPerBlock];
+        __m128i previous[4] = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(),
+                               _mm_setzero_si128()};
+
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            const uint32_t rowCount =
+                GetRowCount(block * GeometryCodec::BlockSize, elementCount);
+            for (uint32_t component = 0; component < componentCount; ++component)
+            {
+                const uint8_t control = payload[block * componentCount + component];
+                const uint32_t width = control & gs_BlockWidthMask;
+                if (width > 32)
+                    return false;
+                const size_t packedSize = GetPackedSize(width, rowCount);
+                if (offset + packedSize > payloadSize)
+                    return false;
+
+                DecodeBlock(payload + offset, control, rowCount, previous[component],
+                            rows[component]);
+                offset += packedSize;
+            }
+
+            StoreBlock(method, rows, values, block * GeometryCodec::BlockSize, elementCount);
+        }
+
+        return true;
+    }
+#else
+    static uint32_t ZigZagDecode(uint32_t value)
+    {
+        return (value >> 1) ^ (0u - (value & 1));
+    }
+
+    static uint32_t UnpackValue(const unsigned char* packed, uint32_t width, uint32_t index)
+    {
+        if (width == 0)
+            return 0;
+
+        const uint32_t row = index / 4;
+        const uint32_t lane = index % 4;
+        const uint32_t bit = row * width;
+        const uint32_t word = bit / 32;
+        const uint32_t shift = bit % 32;
+
+        uint32_t packedWord;
+        memcpy(&packedWord, packed + (word * 4 + lane) * sizeof(uint32_t), sizeof(uint32_t));
+        uint32_t value = packedWord >> shift;
+        if (shift + width > 32)
+        {
+            memcpy(&packedWord, packed + ((word + 1) * 4 + lane) * sizeof(uint32_t),
+                   sizeof(uint32_t));
+            value |= packedWord << (32 - shift);
+        }
+        return value & GetWidthMask(width);
+    }
+
+    static bool DecodeBlocks(GeometryCodec::Method method, const unsigned char* payload,
+                             size_t payloadSize, uint32_t* values, size_t valueCount)
+    {
+        const uint32_t componentCount = GetComponentCount(method);
+        const size_t elementCount = valueCount / componentCount;
+        const size_t blockCount = GetBlockCount(elementCount);
+        size_t offset = GetControlSize(blockCount * componentCount);
+        if (offset > payloadSize)
+            return false;
+
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            const uint32_t rowCount =
+                GetRowCount(block * GeometryCodec::BlockSize, elementCount);
+            for (uint32_t component = 0; component < componentCount; ++component)
+            {
+                const uint8_t control = payload[block * componentCount + component];
+                const uint32_t width = control & gs_BlockWidthMask;
+                if (width > 32)
+                    return false;
+                const size_t packedSize = GetPackedSize(width, rowCount);
+                if (offset + packedSize > payloadSize)
+                    return false;
+
+                const unsigned char* packed = payload + offset;
+                offset += packedSize;
+
+                const bool predicted = (control & gs_BlockPredictedFlag) != 0;
+                for (uint32_t i = 0; i < GeometryCodec::BlockSize; ++i)
+                {
+                    const size_t element = block * GeometryCodec::BlockSize + i;
+                    if (element >= elementCount)
+                        break;
+
+                    const size_t index = element * componentCount + component;
+                    uint32_t value = UnpackValue(packed, width, i);
+                    if (predicted)
+                    {
+                        const uint32_t previous =
+                            element > 0 ? values[index - componentCount] : 0;
+                        value = ZigZagDecode(value) + previous;
+                    }
+                    values[index] = value;
+                }
+            }
+        }
+
+        return true;
+    }
+#endif
+
+    class BitWriter
+    {
+    public:
+        BitWriter(std::vector<unsigned char>& output)
+            : m_Output(output)
+            , m_Buffer(0)
+            , m_BufferBits(0)
+        {
+        }
+
+        void Write(uint32_t value, uint32_t bitCount)
+        {
+            BLK_ASSERT(bitCount <= 32);
+            m_Buffer |= static_cast<uint64_t>(value) << m_BufferBits;
+            m_BufferBits += bitCount;
+            while (m_BufferBits >= 8)
+            {
+                m_Output.push_back(static_cast<unsigned char>(m_Buffer));
+                m_Buffer >>= 8;
+                m_BufferBits -= 8;
+            }
+        }
+
+        void Flush()
+        {
+            if (m_BufferBits > 0)
+            {
+                m_Output.push_back(static_cast<unsigned char>(m_Buffer));
+            }
+            m_Buffer = 0;
+            m_BufferBits = 0;
+            m_Output.insert(m_Output.end(), gs_BitStreamPadding, 0);
+        }
+
+    private:
+        std::vector<unsigned char>& m_Output;
+        uint64_t m_Buffer;
+        uint32_t m_BufferBits;
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const unsigned char* data, size_t size)
+            : m_Data(data)
+            , m_Size(size)
+            , m_BitPosition(0)
+            , m_Overflow(false)
+        {
+        }
+
+        // Reads up to 56 bits
+        uint32_t Read(uint32_t bitCount)
+        {
+            const size_t byte = m_BitPosition / 8;
+            if (byte + sizeof(uint64_t) > m_Size)
+            {
+                m_Overflow = true;
+                return 0;
+            }
+
+            uint64_t word;
+            memcpy(&word, m_Data + byte, sizeof(word));
+            const size_t shift = m_BitPosition % 8;
+            m_BitPosition += bitCount;
+            return static_cast<uint32_t>((word >> shift) & ((1ull << bitCount) - 1));
+        }
+
+        [[nodiscard]] bool HasOverflow() const { return m_Overflow; }
+
+    private:
+        const unsigned char* m_Data;
+        size_t m_Size;
+        size_t m_BitPosition;
+        bool m_Overflow;
+    };
+
+    // Prediction of next new vertex, meshlet vertices are numbered in first use order
+    // Explicit zero means that new meshlet has started
+    static void UpdateNextVertex(uint32_t vertex, bool isExplicit, uint32_t& nextVertex)
+    {
+        if (isExplicit && vertex == 0)
+            nextVertex = 1;
+        else
+            nextVertex = std::max(nextVertex, vertex + 1);
+    }
+
+    // Rotation of triangle that places new vertex last, and edge of previous triangle that is
+    // shared, in opposite direction as it is in triangle strips
+    static bool FindSharedEdge(const uint32_t* triangle, const uint32_t* previous,
+                               uint32_t& edgeCode)
+    {
+        for (uint32_t rotation = 0; rotation < 3; ++rotation)
+        {
+            for (uint32_t edge = 0; edge < 3; ++edge)
+            {
+                if (triangle[rotation] == previous[(edge + 1) % 3] &&
+                    triangle[(rotation + 1) % 3] == previous[edge])
+                {
+                    edgeCode = rotation * 3 + edge;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static void EncodeTriangles(const unsigned char* indices, size_t triangleCount,
+                                uint32_t indexBits, std::vector<unsigned char>& payload)
+    {
+        BitWriter writer(payload);
+
+        uint32_t previous[3] = {};
+        uint32_t nextVertex = 0;
+        auto encodeVertex = [&](uint32_t vertex) {
+            const bool isExplicit = vertex != nextVertex;
+            writer.Write(isExplicit ? 0 : 1, 1);
+            if (isExplicit)
+                writer.Write(vertex, indexBits);
+            UpdateNextVertex(vertex, isExplicit, nextVertex);
+        };
+
+        for (size_t i = 0; i < triangleCount; ++i)
+        {
+            const uint32_t triangle[3] = {indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2]};
+
+            uint32_t edgeCode;
+            if (i != 0 && FindSharedEdge(triangle, previous, edgeCode))
+            {
+                writer.Write(1, 1);
+                writer.Write(edgeCode, gs_EdgeCodeBits);
+                encodeVertex(triangle[(edgeCode / 3 + 2) % 3]);
+            }
+            else
+            {
+                writer.Write(0, 1);
+                for (uint32_t vertex : triangle)
+                {
+                    encodeVertex(vertex);
+                }
+            }
+
+            std::copy(std::begin(triangle), std::end(triangle), std::begin(previous));
+        }
+
+        writer.Flush();
+    }
+
+    static bool DecodeTriangles(const unsigned char* payload, size_t payloadSize,
+                                uint32_t indexBits, unsigned char* indices, size_t triangleCount)
+    {
+        BitReader reader(payload, payloadSize);
+
+        uint32_t previous[3] = {};
+        uint32_t nextVertex = 0;
+        auto decodeVertex = [&]() {
+            const bool isExplicit = reader.Read(1) == 0;
+            const uint32_t vertex = isExplicit ? reader.Read(indexBits) : nextVertex;
+            UpdateNextVertex(vertex, isExplicit, nextVertex);
+            return vertex;
+        };
+
+        for (size_t i = 0; i < triangleCount; ++i)
+        {
+            uint32_t triangle[3];
+            if (reader.Read(1) != 0)
+            {
+                const uint32_t edgeCode = reader.Read(gs_EdgeCodeBits);
+                const uint32_t rotation = edgeCode / 3;
+                const uint32_t edge = edgeCode % 3;
+                if (rotation >= 3 || i == 0)
+                    return false;
+                triangle[rotation] = previous[(edge + 1) % 3];
+                triangle[(rotation + 1) % 3] = previous[edge];
+                triangle[(rotation + 2) % 3] = decodeVertex();
+            }
+            else
+            {
+                triangle[0] = decodeVertex();
+                triangle[1] = decodeVertex();
+                triangle[2] = decodeVertex();
+            }
+
+            for (uint32_t j = 0; j < 3; ++j)
+            {
+                // Predicted vertex can overflow byte on malformed data
+                if (triangle[j] > UINT8_MAX)
+                    return false;
+                indices[i * 3 + j] = static_cast<unsigned char>(triangle[j]);
+                previous[j] = triangle[j];
+            }
+        }
+
+        return !reader.HasOverflow();
+    }
+
+    std::vector<unsigned char> GeometryCodec::Encode(Method method, const void* data, size_t size)
+    {
+        BLK_ASSERT(size <= UINT32_MAX);
+
+        Header header{Signature, method, static_cast<uint32_t>(size), 0, 0};
+        std::vector<unsigned char> payload;
+
+        switch (method)
+        {
+        case Method::Vertex:
+        case Method::Words: {
+            BLK_ASSERT(size % (GetComponentCount(method) * sizeof(uint32_t)) == 0);
+            std::vector<uint32_t> values(size / sizeof(uint32_t));
+            memcpy(values.data(), data, size);
+            EncodeBlocks(method, values.data(), values.size(), payload);
+            break;
+        }
+        case Method::Triangles: {
+            BLK_ASSERT(size % 3 == 0);
+            const auto* indices = static_cast<const unsigned char*>(data);
+            const unsigned char maxIndex =
+                size == 0 ? 0 : *std::max_element(indices, indices + size);
+            header.parameter = std::max(static_cast<uint32_t>(std::bit_width(maxIndex)), 1u);
+            EncodeTriangles(indices, size / 3, header.parameter, payload);
+            break;
+        }
+        default:
+            BLK_ASSERT(0);
+            break;
+        }
+
+        header.payloadSize = checked_narrowing_cast<uint32_t>(payload.size());
+
+        std::vector<unsigned char> result(sizeof(Header));
+        memcpy(result.data(), &header, sizeof(Header));
+        result.insert(result.end(), payload.begin(), payload.end());
+        return result;
+    }
+
+    size_t GeometryCodec::GetDecodedSize(const void* encoded, size_t encodedSize)
+    {
+        if (encodedSize < sizeof(Header))
+            return 0;
+
+        Header header;
+        memcpy(&header, encoded, sizeof(Header));
+        if (header.signature != Signature)
+            return 0;
+
+        return header.decodedSize;
+    }
+
+    bool GeometryCodec::Decode(const void* encoded, size_t encodedSize, void* outData,
+                               size_t outSize)
+    {
+        if (encodedSize < sizeof(Header))
+            return false;
+
+        Header header;
+        memcpy(&header, encoded, sizeof(Header));
+        if (header.signature != Signature || header.decodedSize > outSize ||
+            header.payloadSize > encodedSize - sizeof(Header))
+            return false;
+
+        const auto* payload = static_cast<const unsigned char*>(encoded) + sizeof(Header);
+
+        switch (header.method)
+        {
+        case Method::Vertex:
+        case Method::Words: {
+            if (header.decodedSize % (GetComponentCount(header.method) * sizeof(uint32_t)) != 0)
+                return false;
+            return DecodeBlocks(header.method, payload, header.payloadSize,
+                                static_cast<uint32_t*>(outData),
+                                header.decodedSize / sizeof(uint32_t));
+        }
+        case Method::Triangles:
+            if (header.decodedSize % 3 != 0 || header.parameter == 0 || header.parameter > 8)
+                return false;
+            return DecodeTriangles(payload, header.payloadSize, header.parameter,
+                                   static_cast<unsigned char*>(outData), header.decodedSize / 3);
+        default:
+            return false;
+        }
+    }
+
+} // namespace Boolka
@@ -0,0 +1,49 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Lossless codec for scene geometry sections
+    // Vertex components and words are predicted from previous element and bit packed in blocks
+    // of 128 values with 4 interleaved lanes, so they can be decoded with SIMD
+    // Triangles are encoded relative to previous triangle, strips cost few bits per triangle
+    class GeometryCodec
+    {
+    public:
+        enum class Method : uint32_t
+        {
+            // Elements of 4 32-bit components, predicted from previous element
+            // Used for VertexData1 and VertexData2
+            Vertex,
+            // 32-bit words, predicted from previous word
+            // Used for vertex indirection
+            Words,
+            // 3 byte indices per triangle
+            // Used for meshlet triangles
+            Triangles,
+        };
+
+        struct Header
+        {
+            uint32_t signature;
+            Method method;
+            uint32_t decodedSize;
+            uint32_t payloadSize;
+            // Method specific, bit count of explicit index for Triangles
+            uint32_t parameter;
+        };
+
+        static const uint32_t Signature = 0x31434742; // "BGC1"
+        static const uint32_t BlockSize = 128;
+
+        // Output starts with Header
+        [[nodiscard]] static std::vector<unsigned char> Encode(Method method, const void* data,
+                                                               size_t size);
+        // Returns 0 if data is not encoded with GeometryCodec
+        [[nodiscard]] static size_t GetDecodedSize(const void* encoded, size_t encodedSize);
+        // outSize should be at least decoded size
+        [[nodiscard]] static bool Decode(const void* encoded, size_t encodedSize, void* outData,
+                                         size_t outSize);
+    };
+
+} // namespace Boolka
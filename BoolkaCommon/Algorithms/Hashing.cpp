@@ -4,31 +4,226 @@
 
 #include "Structures/MemoryBlock.h"
 
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
 #define BLK_CRC32_POLYNOMIAL 0xEDB88320
+#define BLK_CRC32C_POLYNOMIAL 0x82F63B78
 
 namespace Boolka
 {
 
-    uint32_t Hashing::CRC32(const MemoryBlock& memory)
-    {
-        // Can be significantly optimized
-        const char* start = reinterpret_cast<const char*>(memory.m_Data);
-        const char* end = start + memory.m_Size;
-        uint32_t result = 0xFFFFFFFF;
+    using CRCTables = std::array<std::array<uint32_t, 256>, 8>;
 
-        for (const char* i = start; i < end; ++i)
+    // Table n gives CRC of byte followed by n zero bytes, which allows slicing-by-8 to
+    // process 8 bytes with independent lookups
+    static constexpr CRCTables BuildCRCTables(uint32_t polynomial)
+    {
+        CRCTables tables{};
+        for (uint32_t i = 0; i < 256; ++i)
         {
-            char currentByte = *i;
+            uint32_t crc = i;
             for (size_t j = 0; j < 8; ++j)
+                crc = (crc >> 1) ^ ((crc & 1) * polynomial);
+            tables[0][i] = crc;
+        }
+        for (size_t table = 1; table < tables.size(); ++table)
+        {
+            for (size_t i = 0; i < 256; ++i)
             {
-                uint32_t bit = (currentByte ^ result) & 1;
-                result >>= 1;
-                result = result ^ (bit * BLK_CRC32_POLYNOMIAL);
-                currentByte >>= 1;
+                const uint32_t previous = tables[table - 1][i];
+                tables[table][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
             }
         }
+        return tables;
+    }
+
+    static constexpr CRCTables gs_CRC32Tables = BuildCRCTables(BLK_CRC32_POLYNOMIAL);
+
+    static uint32_t UpdateCRCSlicingBy8(const CRCTables& tables, uint32_t crc,
+                                        const unsigned char* data, size_t size)
+    {
+        for (; size >= 8; size -= 8, data += 8)
+        {
+            uint32_t low;
+            uint32_t high;
+            memcpy(&low, data, sizeof(low));
+            memcpy(&high, data + 4, sizeof(high));
+            low ^= crc;
+            crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+                  tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+                  tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+                  tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+        }
+        for (; size != 0; --size, ++data)
+            crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xFF];
+        return crc;
+    }
+
+    uint32_t Hashing::CRC32(const MemoryBlock& memory, uint32_t previousCRC)
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(memory.m_Data);
+        return ~UpdateCRCSlicingBy8(gs_CRC32Tables, ~previousCRC, data, memory.m_Size);
+    }
+
+#ifdef BLK_USE_SSE
+
+    uint32_t Hashing::CRC32C(const MemoryBlock& memory, uint32_t previousCRC)
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(memory.m_Data);
+        size_t size = memory.m_Size;
+        uint64_t crc = ~previousCRC;
+
+        for (; size >= 8; size -= 8, data += 8)
+        {
+            uint64_t value;
+            memcpy(&value, data, sizeof(value));
+            crc = _mm_crc32_u64(crc, value);
+        }
+        uint32_t result = static_cast<uint32_t>(crc);
+        for (; size != 0; --size, ++data)
+            result = _mm_crc32_u8(result, *data);
 
         return ~result;
     }
 
+#else
+
+    static constexpr CRCTables gs_CRC32CTables = BuildCRCTables(BLK_CRC32C_POLYNOMIAL);
+
+    uint32_t Hashing::CRC32C(const MemoryBlock& memory, uint32_t previousCRC)
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(memory.m_Data);
+        return ~UpdateCRCSlicingBy8(gs_CRC32CTables, ~previousCRC, data, memory.m_Size);
+    }
+
+#endif
+
+    static const uint64_t gs_Hash64Prime1 = 0x9E3779B185EBCA87ull;
+    static const uint64_t gs_Hash64Prime2 = 0xC2B2AE3D27D4EB4Full;
+    static const uint64_t gs_Hash64Prime3 = 0x165667B19E3779F9ull;
+    static const uint64_t gs_Hash64Prime4 = 0x85EBCA77C2B2AE63ull;
+    static const uint64_t gs_Hash64Prime5 = 0x27D4EB2F165667C5ull;
+
+    static uint64_t Hash64Round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * gs_Hash64Prime2;
+        accumulator = std::rotl(accumulator, 31);
+        return accumulator * gs_Hash64Prime1;
+    }
+
+    static uint64_t Hash64MergeRound(uint64_t hash, uint64_t accumulator)
+    {
+        hash ^= Hash64Round(0, accumulator);
+        return hash * gs_Hash64Prime1 + gs_Hash64Prime4;
+    }
+
+    static uint64_t Read64(const unsigned char* data)
+    {
+        uint64_t result;
+        memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    static uint32_t Read32(const unsigned char* data)
+    {
+        uint32_t result;
+        memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    uint64_t Hashing::Hash64(const MemoryBlock& memory, uint64_t seed)
+    {
+        Hash64Stream stream(seed);
+        stream.Update(memory);
+        return stream.Finalize();
+    }
+
+    Hashing::Hash64Stream::Hash64Stream(uint64_t seed)
+        : m_Accumulators{seed + gs_Hash64Prime1 + gs_Hash64Prime2, seed + gs_Hash64Prime2, seed,
+                         seed - gs_Hash64Prime1}
+        , m_Seed(seed)
+        , m_TotalSize(0)
+        , m_Buffer{}
+        , m_BufferSize(0)
+    {
+    }
+
+    void Hashing::Hash64Stream::ProcessStripe(const unsigned char* stripe)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            m_Accumulators[i] = Hash64Round(m_Accumulators[i], Read64(stripe + i * 8));
+    }
+
+    void Hashing::Hash64Stream::Update(const MemoryBlock& memory)
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(memory.m_Data);
+        size_t size = memory.m_Size;
+        m_TotalSize += size;
+
+        if (m_BufferSize != 0)
+        {
+            const size_t copySize = std::min(size, ms_StripeSize - m_BufferSize);
+            memcpy(m_Buffer + m_BufferSize, data, copySize);
+            m_BufferSize += copySize;
+            data += copySize;
+            size -= copySize;
+            if (m_BufferSize < ms_StripeSize)
+                return;
+            ProcessStripe(m_Buffer);
+            m_BufferSize = 0;
+        }
+
+        for (; size >= ms_StripeSize; size -= ms_StripeSize, data += ms_StripeSize)
+            ProcessStripe(data);
+
+        memcpy(m_Buffer, data, size);
+        m_BufferSize = size;
+    }
+
+    uint64_t Hashing::Hash64Stream::Finalize() const
+    {
+        uint64_t hash;
+        if (m_TotalSize >= ms_StripeSize)
+        {
+            hash = std::rotl(m_Accumulators[0], 1) + std::rotl(m_Accumulators[1], 7) +
+                   std::rotl(m_Accumulators[2], 12) + std::rotl(m_Accumulators[3], 18);
+            for (uint64_t accumulator : m_Accumulators)
+                hash = Hash64MergeRound(hash, accumulator);
+        }
+        else
+        {
+            hash = m_Seed + gs_Hash64Prime5;
+        }
+        hash += m_TotalSize;
+
+        const unsigned char* data = m_Buffer;
+        size_t size = m_BufferSize;
+        for (; size >= 8; size -= 8, data += 8)
+        {
+            hash ^= Hash64Round(0, Read64(data));
+            hash = std::rotl(hash, 27) * gs_Hash64Prime1 + gs_Hash64Prime4;
+        }
+        if (size >= 4)
+        {
+            hash ^= Read32(data) * gs_Hash64Prime1;
+            hash = std::rotl(hash, 23) * gs_Hash64Prime2 + gs_Hash64Prime3;
+            size -= 4;
+            data += 4;
+        }
+        for (; size != 0; --size, ++data)
+        {
+            hash ^= *data * gs_Hash64Prime5;
+            hash = std::rotl(hash, 11) * gs_Hash64Prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= gs_Hash64Prime2;
+        hash ^= hash >> 29;
+        hash *= gs_Hash64Prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
 } // namespace Boolka
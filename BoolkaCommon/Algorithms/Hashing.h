@@ -8,7 +8,38 @@ namespace Boolka
     class Hashing
     {
     public:
-        [[nodiscard]] static uint32_t CRC32(const MemoryBlock& memory);
+        // CRC32 with 0xEDB88320 polynomial, same as zip and png
+        // To hash data in parts, pass result of previous parts as previousCRC
+        [[nodiscard]] static uint32_t CRC32(const MemoryBlock& memory, uint32_t previousCRC = 0);
+        // CRC32C with 0x82F63B78 polynomial, uses SSE4.2 crc32 instruction when available
+        // Faster than CRC32 with hardware support, use it when compatibility isn't required
+        [[nodiscard]] static uint32_t CRC32C(const MemoryBlock& memory, uint32_t previousCRC = 0);
+
+        // Fast non-cryptographic 64 bit hash, same results as reference XXH64
+        [[nodiscard]] static uint64_t Hash64(const MemoryBlock& memory, uint64_t seed = 0);
+
+        // Incremental version of Hash64, data can be fed in parts of any size
+        // Finalize doesn't change state, so more data can be added after it
+        class [[nodiscard]] Hash64Stream
+        {
+        public:
+            explicit Hash64Stream(uint64_t seed = 0);
+
+            void Update(const MemoryBlock& memory);
+            [[nodiscard]] uint64_t Finalize() const;
+
+        private:
+            static constexpr size_t ms_StripeSize = 32;
+
+            void ProcessStripe(const unsigned char* stripe);
+
+            uint64_t m_Accumulators[4];
+            uint64_t m_Seed;
+            uint64_t m_TotalSize;
+            // Part of stripe that is not processed yet
+            unsigned char m_Buffer[ms_StripeSize];
+            size_t m_BufferSize;
+        };
     };
 
 } // namespace Boolka
@@ -0,0 +1,262 @@
+#include "stdafx.h"
+
+#include "MeshCleanup.h"
+
+namespace Boolka
+{
+
+    static const uint32_t gs_InvalidElement = UINT32_MAX;
+    // Cell coordinates are clamped, so that huge values don't overflow during neighbour search
+    static const int64_t gs_MaxCellCoordinate = int64_t(1) << 40;
+
+    static uint64_t MixHash(uint64_t hash, uint64_t value)
+    {
+        hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    static int64_t GetCellCoordinate(float value, float inverseCellSize)
+    {
+        const double cell = std::floor(double(value) * double(inverseCellSize));
+        // Written so that NaN ends up in cell 0
+        if (!(cell > -double(gs_MaxCellCoordinate)))
+            return cell < 0.0 ? -gs_MaxCellCoordinate : 0;
+        if (cell > double(gs_MaxCellCoordinate))
+            return gs_MaxCellCoordinate;
+        return static_cast<int64_t>(cell);
+    }
+
+    static uint64_t GetExactKey(const float* element, size_t componentCount)
+    {
+        uint64_t hash = 0;
+        for (size_t i = 0; i < componentCount; ++i)
+        {
+            hash = MixHash(hash, std::bit_cast<uint32_t>(element[i]));
+        }
+        return hash;
+    }
+
+    size_t MeshCleanup::Weld(const float* values, size_t elementCount, size_t componentCount,
+                             float tolerance, std::vector<uint32_t>& remap)
+    {
+        BLK_ASSERT(componentCount > 0);
+        BLK_ASSERT(elementCount < gs_InvalidElement);
+
+        remap.resize(elementCount);
+        if (elementCount == 0)
+            return 0;
+
+        // Only representatives are stored, chained through next
+        std::unordered_map<uint64_t, uint32_t> cellHeads;
+        cellHeads.reserve(elementCount);
+        std::vector<uint32_t> next(elementCount, gs_InvalidElement);
+
+        auto insert = [&](uint64_t key, uint32_t element) {
+            auto [iterator, inserted] = cellHeads.try_emplace(key, element);
+            if (!inserted)
+            {
+                next[element] = iterator->second;
+                iterator->second = element;
+            }
+        };
+
+        size_t uniqueCount = 0;
+
+        if (tolerance <= 0.0f)
+        {
+            for (uint32_t i = 0; i < elementCount; ++i)
+            {
+                const float* element = values + i * componentCount;
+                const uint64_t key = GetExactKey(element, componentCount);
+
+                uint32_t match = gs_InvalidElement;
+                auto iterator = cellHeads.find(key);
+                if (iterator != cellHeads.end())
+                {
+                    for (uint32_t candidate = iterator->second; candidate != gs_InvalidElement;
+                         candidate = next[candidate])
+                    {
+                        if (memcmp(values + candidate * componentCount, element,
+                                   componentCount * sizeof(float)) == 0)
+                        {
+                            match = candidate;
+                            break;
+                        }
+                    }
+                }
+
+                if (match == gs_InvalidElement)
+                {
+                    remap[i] = i;
+                    insert(key, i);
+                    ++uniqueCount;
+                }
+                else
+                {
+                    remap[i] = match;
+                }
+            }
+            return uniqueCount;
+        }
+
+        const size_t hashedCount = std::min<size_t>(componentCount, 3);
+        const float inverseCellSize = 1.0f / tolerance;
+        const float toleranceSquared = tolerance * tolerance;
+
+        size_t neighbourCount = 1;
+        for (size_t i = 0; i < hashedCount; ++i)
+            neighbourCount *= 3;
+
+        for (uint32_t i = 0; i < elementCount; ++i)
+        {
+            const float* element = values + i * componentCount;
+
+            int64_t cell[3] = {};
+            for (size_t component = 0; component < hashedCount; ++component)
+            {
+                cell[component] = GetCellCoordinate(element[component], inverseCellSize);
+            }
+
+            // Cell size equals tolerance, so every match is in one of neighbouring cells
+            uint32_t match = gs_InvalidElement;
+            for (size_t neighbour = 0; neighbour < neighbourCount; ++neighbour)
+            {
+                uint64_t key = 0;
+                size_t offsetIndex = neighbour;
+                for (size_t component = 0; component < hashedCount; ++component)
+                {
+                    const int64_t offset = int64_t(offsetIndex % 3) - 1;
+                    offsetIndex /= 3;
+                    key = MixHash(key, static_cast<uint64_t>(cell[component] + offset));
+                }
+
+                auto iterator = cellHeads.find(key);
+                if (iterator == cellHeads.end())
+                    continue;
+
+                for (uint32_t candidate = iterator->second; candidate != gs_InvalidElement;
+                     candidate = next[candidate])
+                {
+                    if (candidate >= match)
+                        continue;
+
+                    const float* other = values + candidate * componentCount;
+                    float distanceSquared = 0.0f;
+                    for (size_t component = 0; component < componentCount; ++component)
+                    {
+                        const float delta = element[component] - other[component];
+                        distanceSquared += delta * delta;
+                    }
+                    if (distanceSquared <= toleranceSquared)
+                        match = candidate;
+                }
+            }
+
+            if (match == gs_InvalidElement)
+            {
+                uint64_t key = 0;
+                for (size_t component = 0; component < hashedCount; ++component)
+                    key = MixHash(key, static_cast<uint64_t>(cell[component]));
+
+                remap[i] = i;
+                insert(key, i);
+                ++uniqueCount;
+            }
+            else
+            {
+                remap[i] = match;
+            }
+        }
+
+        return uniqueCount;
+    }
+
+    std::vector<uint32_t> MeshCleanup::FilterTriangles(const uint32_t* triangles,
+                                                       size_t triangleCount,
+                                                       const float* positions, float minArea,
+                                                       TriangleStats& stats)
+    {
+        BLK_ASSERT(triangleCount < gs_InvalidElement);
+
+        std::vector<uint32_t> result;
+        result.reserve(triangleCount);
+
+        std::unordered_map<uint64_t, uint32_t> keptHeads;
+        keptHeads.reserve(triangleCount);
+        std::vector<uint32_t> next(triangleCount, gs_InvalidElement);
+        std::vector<std::array<uint32_t, 3>> canonical(triangleCount);
+
+        for (uint32_t i = 0; i < triangleCount; ++i)
+        {
+            const uint32_t* triangle = triangles + i * 3;
+            const uint32_t a = triangle[0];
+            const uint32_t b = triangle[1];
+            const uint32_t c = triangle[2];
+
+            if (a == b || b == c || c == a)
+            {
+                ++stats.degenerateCount;
+                continue;
+            }
+
+            // Doubles, so that small triangles far from origin don't lose all precision
+            const float* pa = positions + size_t(a) * 3;
+            const float* pb = positions + size_t(b) * 3;
+            const float* pc = positions + size_t(c) * 3;
+            double edge0[3];
+            double edge1[3];
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                edge0[axis] = double(pb[axis]) - double(pa[axis]);
+                edge1[axis] = double(pc[axis]) - double(pa[axis]);
+            }
+            const double crossX = edge0[1] * edge1[2] - edge0[2] * edge1[1];
+            const double crossY = edge0[2] * edge1[0] - edge0[0] * edge1[2];
+            const double crossZ = edge0[0] * edge1[1] - edge0[1] * edge1[0];
+            const double area =
+                0.5 * std::sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ);
+            if (area <= double(minArea))
+            {
+                ++stats.zeroAreaCount;
+                continue;
+            }
+
+            // Rotate lowest index to front, it keeps winding so flipped copies are not removed
+            std::array<uint32_t, 3>& key = canonical[i];
+            if (a < b && a < c)
+                key = {a, b, c};
+            else if (b < c)
+                key = {b, c, a};
+            else
+                key = {c, a, b};
+
+            const uint64_t hash = MixHash(MixHash(MixHash(0, key[0]), key[1]), key[2]);
+            auto [iterator, inserted] = keptHeads.try_emplace(hash, i);
+            if (!inserted)
+            {
+                bool duplicate = false;
+                for (uint32_t candidate = iterator->second; candidate != gs_InvalidElement;
+                     candidate = next[candidate])
+                {
+                    if (canonical[candidate] == key)
+                    {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (duplicate)
+                {
+                    ++stats.duplicateCount;
+                    continue;
+                }
+                next[i] = iterator->second;
+                iterator->second = i;
+            }
+
+            result.push_back(i);
+        }
+
+        return result;
+    }
+
+} // namespace Boolka
@@ -0,0 +1,35 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Geometry cleanup helpers for scene conversion
+    class MeshCleanup
+    {
+    public:
+        struct TriangleStats
+        {
+            // References same welded vertex more than once
+            size_t degenerateCount = 0;
+            // Distinct vertices, but area is below threshold
+            size_t zeroAreaCount = 0;
+            // Same vertices with same winding as earlier triangle
+            size_t duplicateCount = 0;
+        };
+
+        // Maps every element to first element that is closer than tolerance, using spatial hash
+        // over first 3 components. Elements that are first in their group map to themselves
+        // Returns number of unique elements
+        static size_t Weld(const float* values, size_t elementCount, size_t componentCount,
+                           float tolerance, std::vector<uint32_t>& remap);
+
+        // Triangles are position indices, 3 per triangle, positions are 3 floats per vertex
+        // Returns indices of triangles that should be kept, in original order
+        [[nodiscard]] static std::vector<uint32_t> FilterTriangles(const uint32_t* triangles,
+                                                                   size_t triangleCount,
+                                                                   const float* positions,
+                                                                   float minArea,
+                                                                   TriangleStats& stats);
+    };
+
+} // namespace Boolka
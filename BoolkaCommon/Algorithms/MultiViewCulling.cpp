@@ -0,0 +1,198 @@
+#include "stdafx.h"
+
+#include "MultiViewCulling.h"
+
+#include "CullingKernels.h"
+
+namespace Boolka
+{
+
+    static void SetupViews(const Frustum* views, size_t viewCount,
+                           const MultiViewCulling::ViewGroup* groups, size_t groupCount,
+                           MultiViewSetup& setup)
+    {
+        BLK_ASSERT(viewCount <= MultiViewCulling::ms_MaxViewCount);
+
+        for (size_t view = 0; view < viewCount; ++view)
+            SetupCullingPlanes(views[view], setup.planes[view]);
+
+        const MultiViewCulling::ViewGroup* groupOfView[MultiViewCulling::ms_MaxViewCount] = {};
+        for (size_t i = 0; i < groupCount; ++i)
+        {
+            const MultiViewCulling::ViewGroup& group = groups[i];
+            BLK_ASSERT(group.viewCount != 0);
+            BLK_ASSERT(group.firstView + group.viewCount <= viewCount);
+            for (size_t view = group.firstView; view < group.firstView + group.viewCount; ++view)
+            {
+                BLK_ASSERT(groupOfView[view] == nullptr);
+                groupOfView[view] = &group;
+            }
+        }
+
+        // Neighbouring views that are not part of any group are merged into single segment
+        setup.segmentCount = 0;
+        size_t view = 0;
+        while (view < viewCount)
+        {
+            ViewSegment& segment = setup.segments[setup.segmentCount++];
+            segment.firstView = view;
+
+            const MultiViewCulling::ViewGroup* group = groupOfView[view];
+            if (group != nullptr)
+            {
+                const float radius = group->boundingSphere.w();
+                segment.hasSphere = true;
+                segment.centerX = group->boundingSphere.x();
+                segment.centerY = group->boundingSphere.y();
+                segment.centerZ = group->boundingSphere.z();
+                segment.radiusSqr = radius * radius;
+                segment.viewCount = group->viewCount;
+            }
+            else
+            {
+                segment.hasSphere = false;
+                segment.viewCount = 0;
+                while (view + segment.viewCount < viewCount &&
+                       groupOfView[view + segment.viewCount] == nullptr)
+                {
+                    ++segment.viewCount;
+                }
+            }
+
+            view += segment.viewCount;
+        }
+    }
+
+    // Operation order is shared with SIMD variants, so that all backends match bit exactly
+
+    static bool IntersectsSphereScalar(const ViewSegment& segment,
+                                       const float (&bounds)[gs_CullingBoundCount])
+    {
+        const float dx =
+            std::max(std::max(bounds[0] - segment.centerX, segment.centerX - bounds[3]), 0.0f);
+        const float dy =
+            std::max(std::max(bounds[1] - segment.centerY, segment.centerY - bounds[4]), 0.0f);
+        const float dz =
+            std::max(std::max(bounds[2] - segment.centerZ, segment.centerZ - bounds[5]), 0.0f);
+        return (dx * dx + dy * dy) + dz * dz <= segment.radiusSqr;
+    }
+
+    static void CullBoxesScalar(const MultiViewSetup& setup, const CullingBoundArrays& arrays,
+                                size_t begin, size_t end, uint32_t* viewMasks)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            float bounds[gs_CullingBoundCount];
+            LoadBoundsScalar(arrays, i, bounds);
+
+            uint32_t mask = 0;
+            for (size_t s = 0; s < setup.segmentCount; ++s)
+            {
+                const ViewSegment& segment = setup.segments[s];
+                if (segment.hasSphere && !IntersectsSphereScalar(segment, bounds))
+                    continue;
+
+                for (size_t view = segment.firstView;
+                     view < segment.firstView + segment.viewCount; ++view)
+                {
+                    if (IsVisibleScalar(setup.planes[view], bounds))
+                        mask |= 1u << view;
+                }
+            }
+            viewMasks[i] = mask;
+        }
+    }
+
+    void MultiViewCulling::ViewLists::Build(const uint32_t* viewMasks, size_t boxCount,
+                                            size_t viewCount)
+    {
+        BLK_ASSERT(viewCount <= ms_MaxViewCount);
+
+        m_Offsets.assign(viewCount + 1, 0);
+        for (size_t i = 0; i < boxCount; ++i)
+        {
+            uint32_t bits = viewMasks[i];
+            BLK_ASSERT(viewCount == ms_MaxViewCount || (bits >> viewCount) == 0);
+            while (bits)
+            {
+                ++m_Offsets[std::countr_zero(bits) + 1];
+                bits &= bits - 1;
+            }
+        }
+        std::partial_sum(m_Offsets.begin(), m_Offsets.end(), m_Offsets.begin());
+
+        m_Indices.resize(m_Offsets[viewCount]);
+
+        uint32_t cursors[ms_MaxViewCount];
+        std::copy(m_Offsets.begin(), m_Offsets.end() - 1, cursors);
+        for (size_t i = 0; i < boxCount; ++i)
+        {
+            uint32_t bits = viewMasks[i];
+            const uint32_t index = checked_narrowing_cast<uint32_t>(i);
+            while (bits)
+            {
+                m_Indices[cursors[std::countr_zero(bits)]++] = index;
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    size_t MultiViewCulling::ViewLists::GetViewCount() const
+    {
+        return m_Offsets.empty() ? 0 : m_Offsets.size() - 1;
+    }
+
+    uint32_t MultiViewCulling::ViewLists::GetOffset(size_t view) const
+    {
+        BLK_ASSERT(view < GetViewCount());
+        return m_Offsets[view];
+    }
+
+    uint32_t MultiViewCulling::ViewLists::GetCount(size_t view) const
+    {
+        BLK_ASSERT(view < GetViewCount());
+        return m_Offsets[view + 1] - m_Offsets[view];
+    }
+
+    const uint32_t* MultiViewCulling::ViewLists::GetIndices(size_t view) const
+    {
+        BLK_ASSERT(view < GetViewCount());
+        return m_Indices.data() + m_Offsets[view];
+    }
+
+    const std::vector<uint32_t>& MultiViewCulling::ViewLists::GetAllIndices() const
+    {
+        return m_Indices;
+    }
+
+    void MultiViewCulling::CullAABBs(const Frustum* views, size_t viewCount,
+                                     const ViewGroup* groups, size_t groupCount,
+                                     const FrustumCulling::AABBArray& boxes, uint32_t* viewMasks,
+                                     FrustumCulling::Backend backend)
+    {
+        BLK_ASSERT(FrustumCulling::IsBackendSupported(backend));
+
+        MultiViewSetup setup;
+        SetupViews(views, viewCount, groups, groupCount, setup);
+        const CullingBoundArrays arrays = GetCullingBoundArrays(boxes);
+        const size_t boxCount = boxes.GetSize();
+
+        size_t processed = 0;
+        switch (backend)
+        {
+#ifdef BLK_USE_SSE
+        case FrustumCulling::Backend::SSE:
+            processed = CullBoxesSIMD<LanesSSE>(setup, arrays, boxCount, viewMasks);
+            break;
+        case FrustumCulling::Backend::AVX2:
+            processed = CullBoxesAVX2(setup, arrays, boxCount, viewMasks);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        CullBoxesScalar(setup, arrays, processed, boxCount, viewMasks);
+    }
+
+} // namespace Boolka
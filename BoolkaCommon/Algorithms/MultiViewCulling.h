@@ -0,0 +1,62 @@
+#pragma once
+
+#include "FrustumCulling.h"
+
+namespace Boolka
+{
+
+    class Frustum;
+
+    // Culls many bounding boxes against up to 32 views at once
+    // Bounds of each box are loaded once for all views and result is a view visibility mask per
+    // box. Views can be grouped under bounding sphere (e.g. 6 cube map faces of point light), so
+    // that boxes outside of sphere skip all plane tests of the group
+    class MultiViewCulling
+    {
+    public:
+        static constexpr size_t ms_MaxViewCount = 32;
+
+        struct [[nodiscard]] ViewGroup
+        {
+            // xyz - center, w - radius
+            // Boxes outside of sphere are culled from every view in group, for point light
+            // shadows light range is enough since such boxes can't cast shadow on lit surfaces
+            Vector4 boundingSphere;
+            size_t firstView;
+            size_t viewCount;
+        };
+
+        // Visible boxes of all views in one buffer, each view occupies continuous range in
+        // increasing box order, ready to be used as offset/count of indirect draws
+        class [[nodiscard]] ViewLists
+        {
+        public:
+            ViewLists() = default;
+            ~ViewLists() = default;
+
+            void Build(const uint32_t* viewMasks, size_t boxCount, size_t viewCount);
+
+            [[nodiscard]] size_t GetViewCount() const;
+            [[nodiscard]] uint32_t GetOffset(size_t view) const;
+            [[nodiscard]] uint32_t GetCount(size_t view) const;
+            [[nodiscard]] const uint32_t* GetIndices(size_t view) const;
+            [[nodiscard]] const std::vector<uint32_t>& GetAllIndices() const;
+
+        private:
+            // viewCount + 1 entries
+            std::vector<uint32_t> m_Offsets;
+            std::vector<uint32_t> m_Indices;
+        };
+
+        // Bit v of viewMasks[i] is set if box i is not completely outside of views[v] and, if v
+        // is part of group, intersects group bounding sphere
+        // Frustum test results match Frustum::CheckAABBFast for every box and view
+        // Groups should not overlap, views that are not part of any group are always tested
+        // viewMasks should have space for boxes.GetSize() masks
+        static void CullAABBs(
+            const Frustum* views, size_t viewCount, const ViewGroup* groups, size_t groupCount,
+            const FrustumCulling::AABBArray& boxes, uint32_t* viewMasks,
+            FrustumCulling::Backend backend = FrustumCulling::GetDefaultBackend());
+    };
+
+} // namespace Boolka
@@ -0,0 +1,537 @@
+#include "stdafx.h"
+
+#include "Packing.h"
+
+#include "Structures/CPUFeatures.h"
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+namespace Boolka
+{
+
+    static const float gs_SnormMax = 32767.0f;
+
+    // Runs kernel on groups of groupSize elements, last incomplete group goes through zero
+    // padded copy, so that all elements are converted by same code
+    template <size_t groupSize, size_t inputStride, size_t outputStride, typename InputType,
+              typename OutputType, typename Kernel>
+    static void ProcessGroups(const InputType* input, OutputType* output, size_t count,
+                              Kernel kernel)
+    {
+        const size_t fullCount = count - count % groupSize;
+        for (size_t i = 0; i < fullCount; i += groupSize)
+            kernel(input + i * inputStride, output + i * outputStride);
+
+        const size_t tailCount = count - fullCount;
+        if (tailCount != 0)
+        {
+            InputType paddedInput[groupSize * inputStride] = {};
+            OutputType paddedOutput[groupSize * outputStride] = {};
+            std::copy(input + fullCount * inputStride, input + count * inputStride, paddedInput);
+            kernel(paddedInput, paddedOutput);
+            std::copy(paddedOutput, paddedOutput + tailCount * outputStride,
+                      output + fullCount * outputStride);
+        }
+    }
+
+    // Based on https://gist.github.com/rygorous/2156668, with NaN handling matching F16C
+    uint16_t Packing::FloatToHalf(float value)
+    {
+        static const uint32_t halfMaxExponent = (127 + 16) << 23;
+        static const uint32_t halfMinNormal = (127 - 14) << 23;
+        // 0.5, its ulp is smallest half denormal
+        static const uint32_t denormalMagic = 126 << 23;
+
+        const uint32_t bits = std::bit_cast<uint32_t>(value);
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        uint32_t absBits = bits & 0x7FFFFFFF;
+
+        if (absBits >= halfMaxExponent)
+        {
+            // Infinity, overflow or NaN
+            if (absBits > 0x7F800000)
+                return sign | 0x7E00 | static_cast<uint16_t>((absBits >> 13) & 0x3FF);
+            return sign | 0x7C00;
+        }
+
+        if (absBits < halfMinNormal)
+        {
+            // Addition rounds mantissa to half denormal precision
+            const float rounded =
+                std::bit_cast<float>(absBits) + std::bit_cast<float>(denormalMagic);
+            return sign | static_cast<uint16_t>(std::bit_cast<uint32_t>(rounded) - denormalMagic);
+        }
+
+        // Rebias exponent and round to nearest even, mantissa overflow carries into exponent
+        const uint32_t mantissaOdd = (absBits >> 13) & 1;
+        absBits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFF + mantissaOdd;
+        return sign | static_cast<uint16_t>(absBits >> 13);
+    }
+
+    float Packing::HalfToFloat(uint16_t value)
+    {
+        static const uint32_t shiftedExponent = 0x7C00 << 13;
+        static const float denormalMagic = std::bit_cast<float>(uint32_t(113) << 23);
+
+        uint32_t bits = static_cast<uint32_t>(value & 0x7FFF) << 13;
+        const uint32_t exponent = bits & shiftedExponent;
+        bits += (127 - 15) << 23;
+
+        if (exponent == shiftedExponent)
+        {
+            // Infinity or NaN, NaN becomes quiet
+            bits += (128 - 16) << 23;
+            if (bits != 0x7F800000)
+                bits |= 0x00400000;
+        }
+        else if (exponent == 0)
+        {
+            // Zero or denormal, renormalized by float subtraction
+            bits += 1 << 23;
+            bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) - denormalMagic);
+        }
+
+        bits |= static_cast<uint32_t>(value & 0x8000) << 16;
+        return std::bit_cast<float>(bits);
+    }
+
+#ifdef BLK_USE_SSE
+
+    // Implemented in PackingF16C.cpp, which is built with /arch:AVX2
+    // Should only be called when CPUFeatures::HasAVX2 and CPUFeatures::HasF16C are true
+    // Convert groups of 8 values and return count of converted values, remaining ones are
+    // converted by caller
+    [[nodiscard]] size_t FloatToHalfF16C(const float* input, uint16_t* output, size_t count);
+    [[nodiscard]] size_t HalfToFloatF16C(const uint16_t* input, float* output, size_t count);
+
+    static __m128i SelectSSE(__m128i condition, __m128i ifTrue, __m128i ifFalse)
+    {
+        return _mm_or_si128(_mm_and_si128(condition, ifTrue), _mm_andnot_si128(condition, ifFalse));
+    }
+
+    // Same algorithm as scalar FloatToHalf, all cases are computed and selected by masks, result
+    // is in low 16 bits of each lane
+    static __m128i FloatToHalfSSE(__m128 value)
+    {
+        const __m128i bits = _mm_castps_si128(value);
+        const __m128i sign = _mm_srli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x80000000)), 16);
+        const __m128i absBits = _mm_and_si128(bits, _mm_set1_epi32(0x7FFFFFFF));
+
+        // Infinity, overflow or NaN
+        const __m128i isSpecial = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(((127 + 16) << 23) - 1));
+        const __m128i isNaN = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x7F800000));
+        const __m128i payload = _mm_and_si128(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(0x3FF));
+        const __m128i nan = _mm_or_si128(_mm_set1_epi32(0x7E00), payload);
+        const __m128i special = SelectSSE(isNaN, nan, _mm_set1_epi32(0x7C00));
+
+        // Addition rounds mantissa to half denormal precision
+        const __m128i isDenormal = _mm_cmplt_epi32(absBits, _mm_set1_epi32((127 - 14) << 23));
+        const __m128i denormalMagic = _mm_set1_epi32(126 << 23);
+        const __m128 rounded =
+            _mm_add_ps(_mm_castsi128_ps(absBits), _mm_castsi128_ps(denormalMagic));
+        const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(rounded), denormalMagic);
+
+        // Rebias exponent and round to nearest even
+        const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(1));
+        const __m128i normal = _mm_srli_epi32(
+            _mm_add_epi32(_mm_add_epi32(absBits, _mm_set1_epi32(((15 - 127) << 23) + 0xFFF)),
+                          mantissaOdd),
+            13);
+
+        const __m128i half = SelectSSE(isSpecial, special, SelectSSE(isDenormal, denormal, normal));
+        return _mm_or_si128(half, sign);
+    }
+
+    // Same algorithm as scalar HalfToFloat, input is in low 16 bits of each lane
+    static __m128 HalfToFloatSSE(__m128i value)
+    {
+        const __m128i shiftedExponent = _mm_set1_epi32(0x7C00 << 13);
+        const __m128 denormalMagic = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));
+
+        __m128i bits = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x7FFF)), 13);
+        const __m128i exponent = _mm_and_si128(bits, shiftedExponent);
+        bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+        // Infinity or NaN, NaN becomes quiet
+        const __m128i infinity = _mm_add_epi32(bits, _mm_set1_epi32((128 - 16) << 23));
+        const __m128i isNaN =
+            _mm_andnot_si128(_mm_cmpeq_epi32(infinity, _mm_set1_epi32(0x7F800000)),
+                             _mm_set1_epi32(0x00400000));
+        const __m128i special = _mm_or_si128(infinity, isNaN);
+
+        // Zero or denormal, renormalized by float subtraction
+        const __m128i denormal = _mm_castps_si128(_mm_sub_ps(
+            _mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))), denormalMagic));
+
+        bits = SelectSSE(_mm_cmpeq_epi32(exponent, shiftedExponent), special,
+                         SelectSSE(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()), denormal, bits));
+        const __m128i sign = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x8000)), 16);
+        return _mm_castsi128_ps(_mm_or_si128(bits, sign));
+    }
+
+    static void FloatsToHalvesSSE(const float* input, uint16_t* output, size_t count)
+    {
+        ProcessGroups<8, 1, 1>(input, output, count, [](const float* in, uint16_t* out) {
+            const __m128i low = FloatToHalfSSE(_mm_loadu_ps(in));
+            const __m128i high = FloatToHalfSSE(_mm_loadu_ps(in + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi32(low, high));
+        });
+    }
+
+    static void HalvesToFloatsSSE(const uint16_t* input, float* output, size_t count)
+    {
+        ProcessGroups<8, 1, 1>(input, output, count, [](const uint16_t* in, float* out) {
+            const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            _mm_storeu_ps(out, HalfToFloatSSE(_mm_unpacklo_epi16(half, _mm_setzero_si128())));
+            _mm_storeu_ps(out + 4, HalfToFloatSSE(_mm_unpackhi_epi16(half, _mm_setzero_si128())));
+        });
+    }
+
+#endif
+
+    bool Packing::IsHalfBackendSupported(HalfBackend backend)
+    {
+        switch (backend)
+        {
+        case HalfBackend::Scalar:
+            return true;
+#ifdef BLK_USE_SSE
+        case HalfBackend::SSE:
+            return true;
+        case HalfBackend::F16C:
+            return CPUFeatures::HasAVX2() && CPUFeatures::HasF16C();
+#endif
+        default:
+            return false;
+        }
+    }
+
+    Packing::HalfBackend Packing::GetDefaultHalfBackend()
+    {
+        if (IsHalfBackendSupported(HalfBackend::F16C))
+            return HalfBackend::F16C;
+        if (IsHalfBackendSupported(HalfBackend::SSE))
+            return HalfBackend::SSE;
+        return HalfBackend::Scalar;
+    }
+
+    void Packing::FloatToHalf(const float* input, uint16_t* output, size_t count,
+                              HalfBackend backend)
+    {
+        BLK_ASSERT(IsHalfBackendSupported(backend));
+
+        switch (backend)
+        {
+#ifdef BLK_USE_SSE
+        case HalfBackend::SSE:
+            FloatsToHalvesSSE(input, output, count);
+            break;
+        case HalfBackend::F16C:
+        {
+            const size_t processed = FloatToHalfF16C(input, output, count);
+            FloatsToHalvesSSE(input + processed, output + processed, count - processed);
+            break;
+        }
+#endif
+        default:
+            for (size_t i = 0; i < count; ++i)
+                output[i] = FloatToHalf(input[i]);
+            break;
+        }
+    }
+
+    void Packing::HalfToFloat(const uint16_t* input, float* output, size_t count,
+                              HalfBackend backend)
+    {
+        BLK_ASSERT(IsHalfBackendSupported(backend));
+
+        switch (backend)
+        {
+#ifdef BLK_USE_SSE
+        case HalfBackend::SSE:
+            HalvesToFloatsSSE(input, output, count);
+            break;
+        case HalfBackend::F16C:
+        {
+            const size_t processed = HalfToFloatF16C(input, output, count);
+            HalvesToFloatsSSE(input + processed, output + processed, count - processed);
+            break;
+        }
+#endif
+        default:
+            for (size_t i = 0; i < count; ++i)
+                output[i] = HalfToFloat(input[i]);
+            break;
+        }
+    }
+
+#ifdef BLK_USE_SSE
+
+    // Octahedral mapping of 4 normals, z < 0 half is folded over diagonals
+    static void EncodeOctahedralSSE(const float* normals, int16_t* encoded)
+    {
+        const __m128 x = _mm_setr_ps(normals[0], normals[3], normals[6], normals[9]);
+        const __m128 y = _mm_setr_ps(normals[1], normals[4], normals[7], normals[10]);
+        const __m128 z = _mm_setr_ps(normals[2], normals[5], normals[8], normals[11]);
+
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 absSum = _mm_add_ps(
+            _mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)),
+            _mm_andnot_ps(signMask, z));
+        const __m128 projectedX = _mm_div_ps(x, absSum);
+        const __m128 projectedY = _mm_div_ps(y, absSum);
+
+        const __m128 foldedX = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, projectedY)),
+                                         _mm_and_ps(signMask, projectedX));
+        const __m128 foldedY = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, projectedX)),
+                                         _mm_and_ps(signMask, projectedY));
+        const __m128 isNegative = _mm_cmplt_ps(z, _mm_setzero_ps());
+        const __m128 octahedralX = _mm_blendv_ps(projectedX, foldedX, isNegative);
+        const __m128 octahedralY = _mm_blendv_ps(projectedY, foldedY, isNegative);
+
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+        const __m128 scale = _mm_set1_ps(gs_SnormMax);
+        const __m128i snormX = _mm_cvtps_epi32(
+            _mm_mul_ps(_mm_min_ps(_mm_max_ps(octahedralX, minusOne), one), scale));
+        const __m128i snormY = _mm_cvtps_epi32(
+            _mm_mul_ps(_mm_min_ps(_mm_max_ps(octahedralY, minusOne), one), scale));
+
+        const __m128i packed = _mm_packs_epi32(_mm_unpacklo_epi32(snormX, snormY),
+                                               _mm_unpackhi_epi32(snormX, snormY));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(encoded), packed);
+    }
+
+    static void DecodeOctahedralSSE(const int16_t* encoded, float* normals)
+    {
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(encoded));
+        const __m128 scale = _mm_set1_ps(gs_SnormMax);
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+        const __m128 x = _mm_max_ps(
+            _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(packed, 16), 16)), scale),
+            minusOne);
+        const __m128 y =
+            _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(packed, 16)), scale), minusOne);
+
+        // Unfold z < 0 half
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 z = _mm_sub_ps(
+            _mm_sub_ps(_mm_set1_ps(1.0f), _mm_andnot_ps(signMask, x)), _mm_andnot_ps(signMask, y));
+        const __m128 fold = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+        const __m128 unfoldedX = _mm_sub_ps(x, _mm_or_ps(fold, _mm_and_ps(signMask, x)));
+        const __m128 unfoldedY = _mm_sub_ps(y, _mm_or_ps(fold, _mm_and_ps(signMask, y)));
+
+        const __m128 lengthSqrXY =
+            _mm_add_ps(_mm_mul_ps(unfoldedX, unfoldedX), _mm_mul_ps(unfoldedY, unfoldedY));
+        const __m128 lengthSqr = _mm_add_ps(lengthSqrXY, _mm_mul_ps(z, z));
+        const __m128 length = _mm_sqrt_ps(lengthSqr);
+
+        alignas(16) float components[3][4];
+        _mm_store_ps(components[0], _mm_div_ps(unfoldedX, length));
+        _mm_store_ps(components[1], _mm_div_ps(unfoldedY, length));
+        _mm_store_ps(components[2], _mm_div_ps(z, length));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            normals[i * 3 + 0] = components[0][i];
+            normals[i * 3 + 1] = components[1][i];
+            normals[i * 3 + 2] = components[2][i];
+        }
+    }
+
+    void Packing::EncodeOctahedral(const float* normals, int16_t* encoded, size_t count)
+    {
+        ProcessGroups<4, 3, 2>(normals, encoded, count, EncodeOctahedralSSE);
+    }
+
+    void Packing::DecodeOctahedral(const int16_t* encoded, float* normals, size_t count)
+    {
+        ProcessGroups<4, 2, 3>(encoded, normals, count, DecodeOctahedralSSE);
+    }
+
+    // Clamps to [0, 1], scales and rounds 4 values, NaN gives 0
+    template <int roundingMode>
+    static __m128i QuantizeUnormSSE(const float* input, __m128 scale)
+    {
+        const __m128 clamped =
+            _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        return _mm_cvttps_epi32(_mm_round_ps(_mm_mul_ps(clamped, scale), roundingMode));
+    }
+
+    template <int roundingMode>
+    static void FloatToUnorm8SSE(const float* input, uint8_t* output, size_t count)
+    {
+        ProcessGroups<16, 1, 1>(input, output, count, [](const float* in, uint8_t* out) {
+            const __m128 scale = _mm_set1_ps(255.0f);
+            const __m128i low = _mm_packus_epi32(QuantizeUnormSSE<roundingMode>(in, scale),
+                                                 QuantizeUnormSSE<roundingMode>(in + 4, scale));
+            const __m128i high = _mm_packus_epi32(QuantizeUnormSSE<roundingMode>(in + 8, scale),
+                                                  QuantizeUnormSSE<roundingMode>(in + 12, scale));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(low, high));
+        });
+    }
+
+    template <int roundingMode>
+    static void FloatToUnorm16SSE(const float* input, uint16_t* output, size_t count)
+    {
+        ProcessGroups<8, 1, 1>(input, output, count, [](const float* in, uint16_t* out) {
+            const __m128 scale = _mm_set1_ps(65535.0f);
+            const __m128i packed = _mm_packus_epi32(QuantizeUnormSSE<roundingMode>(in, scale),
+                                                    QuantizeUnormSSE<roundingMode>(in + 4, scale));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+        });
+    }
+
+    void Packing::FloatToUnorm8(const float* input, uint8_t* output, size_t count,
+                                Rounding rounding)
+    {
+        switch (rounding)
+        {
+        case Rounding::Nearest:
+            FloatToUnorm8SSE<_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC>(input, output, count);
+            break;
+        case Rounding::Down:
+            FloatToUnorm8SSE<_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC>(input, output, count);
+            break;
+        case Rounding::Up:
+            FloatToUnorm8SSE<_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC>(input, output, count);
+            break;
+        default:
+            BLK_ASSERT(0);
+            break;
+        }
+    }
+
+    void Packing::FloatToUnorm16(const float* input, uint16_t* output, size_t count,
+                                 Rounding rounding)
+    {
+        switch (rounding)
+        {
+        case Rounding::Nearest:
+            FloatToUnorm16SSE<_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC>(input, output, count);
+            break;
+        case Rounding::Down:
+            FloatToUnorm16SSE<_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC>(input, output, count);
+            break;
+        case Rounding::Up:
+            FloatToUnorm16SSE<_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC>(input, output, count);
+            break;
+        default:
+            BLK_ASSERT(0);
+            break;
+        }
+    }
+
+    void Packing::Unorm8ToFloat(const uint8_t* input, float* output, size_t count)
+    {
+        ProcessGroups<4, 1, 1>(input, output, count, [](const uint8_t* in, float* out) {
+            int32_t packed;
+            memcpy(&packed, in, sizeof(packed));
+            const __m128i values = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+            _mm_storeu_ps(out, _mm_div_ps(_mm_cvtepi32_ps(values), _mm_set1_ps(255.0f)));
+        });
+    }
+
+    void Packing::Unorm16ToFloat(const uint16_t* input, float* output, size_t count)
+    {
+        ProcessGroups<4, 1, 1>(input, output, count, [](const uint16_t* in, float* out) {
+            const __m128i values =
+                _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)));
+            _mm_storeu_ps(out, _mm_div_ps(_mm_cvtepi32_ps(values), _mm_set1_ps(65535.0f)));
+        });
+    }
+
+#else
+
+    static float CopySignBit(float value, float sign)
+    {
+        return std::bit_cast<float>((std::bit_cast<uint32_t>(value) & 0x7FFFFFFF) |
+                                    (std::bit_cast<uint32_t>(sign) & 0x80000000));
+    }
+
+    // Same operations as SSE version, nearbyint rounds to nearest even like _mm_cvtps_epi32
+    void Packing::EncodeOctahedral(const float* normals, int16_t* encoded, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* normal = normals + i * 3;
+            const float absSum = (::abs(normal[0]) + ::abs(normal[1])) + ::abs(normal[2]);
+            float x = normal[0] / absSum;
+            float y = normal[1] / absSum;
+            if (normal[2] < 0.0f)
+            {
+                const float foldedX = CopySignBit(1.0f - ::abs(y), x);
+                y = CopySignBit(1.0f - ::abs(x), y);
+                x = foldedX;
+            }
+            encoded[i * 2 + 0] = static_cast<int16_t>(
+                std::nearbyint(std::clamp(x, -1.0f, 1.0f) * gs_SnormMax));
+            encoded[i * 2 + 1] = static_cast<int16_t>(
+                std::nearbyint(std::clamp(y, -1.0f, 1.0f) * gs_SnormMax));
+        }
+    }
+
+    void Packing::DecodeOctahedral(const int16_t* encoded, float* normals, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float x = std::max(encoded[i * 2 + 0] / gs_SnormMax, -1.0f);
+            float y = std::max(encoded[i * 2 + 1] / gs_SnormMax, -1.0f);
+            const float z = (1.0f - ::abs(x)) - ::abs(y);
+            const float fold = std::max(-z, 0.0f);
+            x -= CopySignBit(fold, x);
+            y -= CopySignBit(fold, y);
+
+            const float length = ::sqrt((x * x + y * y) + z * z);
+            normals[i * 3 + 0] = x / length;
+            normals[i * 3 + 1] = y / length;
+            normals[i * 3 + 2] = z / length;
+        }
+    }
+
+    static float QuantizeUnorm(float value, float scale, Packing::Rounding rounding)
+    {
+        // Comparison order makes NaN give 0
+        const float clamped = std::min(value > 0.0f ? value : 0.0f, 1.0f);
+        const float scaled = clamped * scale;
+        switch (rounding)
+        {
+        case Packing::Rounding::Down:
+            return ::floor(scaled);
+        case Packing::Rounding::Up:
+            return ::ceil(scaled);
+        default:
+            return std::nearbyint(scaled);
+        }
+    }
+
+    void Packing::FloatToUnorm8(const float* input, uint8_t* output, size_t count,
+                                Rounding rounding)
+    {
+        for (size_t i = 0; i < count; ++i)
+            output[i] = static_cast<uint8_t>(QuantizeUnorm(input[i], 255.0f, rounding));
+    }
+
+    void Packing::FloatToUnorm16(const float* input, uint16_t* output, size_t count,
+                                 Rounding rounding)
+    {
+        for (size_t i = 0; i < count; ++i)
+            output[i] = static_cast<uint16_t>(QuantizeUnorm(input[i], 65535.0f, rounding));
+    }
+
+    void Packing::Unorm8ToFloat(const uint8_t* input, float* output, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            output[i] = input[i] / 255.0f;
+    }
+
+    void Packing::Unorm16ToFloat(const uint16_t* input, float* output, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            output[i] = input[i] / 65535.0f;
+    }
+
+#endif
+
+} // namespace Boolka
@@ -0,0 +1,61 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Bulk conversions of floats to compact formats and back
+    // Bulk functions give bit identical results to single value versions, so data packed on
+    // different machines or with different builds is identical
+    class Packing
+    {
+    public:
+        enum class Rounding
+        {
+            // Halfway cases round to even, same as GPU conversion
+            Nearest,
+            Down,
+            Up,
+        };
+
+        enum class HalfBackend
+        {
+            Scalar,
+            SSE,
+            F16C,
+        };
+
+        // F16C backend is supported when CPU has AVX2 and F16C, its kernels are built separately
+        // with /arch:AVX2
+        [[nodiscard]] static bool IsHalfBackendSupported(HalfBackend backend);
+        // Fastest backend that current CPU supports
+        [[nodiscard]] static HalfBackend GetDefaultHalfBackend();
+
+        // IEEE half, round to nearest even, overflow gives infinity
+        // NaN stays NaN with same sign and upper bits of payload, signaling NaN becomes quiet
+        // Bulk conversion gives same results with every backend
+        [[nodiscard]] static uint16_t FloatToHalf(float value);
+        [[nodiscard]] static float HalfToFloat(uint16_t value);
+        static void FloatToHalf(const float* input, uint16_t* output, size_t count,
+                                HalfBackend backend = GetDefaultHalfBackend());
+        static void HalfToFloat(const uint16_t* input, float* output, size_t count,
+                                HalfBackend backend = GetDefaultHalfBackend());
+
+        // Normals are 3 floats each and should be non zero, encoded normals are 2 snorm16 each
+        // Decoded normal is normalized and within ms_OctahedralMaxAngleError radians of unit
+        // input normal, measured maximum is about 6.5e-5
+        static constexpr float ms_OctahedralMaxAngleError = 1e-4f;
+        static void EncodeOctahedral(const float* normals, int16_t* encoded, size_t count);
+        static void DecodeOctahedral(const int16_t* encoded, float* normals, size_t count);
+
+        // Input is clamped to [0, 1], NaN gives 0
+        // Scaling is done in float, so rounding is relative to float product, not exact value
+        // Decoding divides by 255 or 65535, so every encoded value round trips exactly
+        static void FloatToUnorm8(const float* input, uint8_t* output, size_t count,
+                                  Rounding rounding = Rounding::Nearest);
+        static void FloatToUnorm16(const float* input, uint16_t* output, size_t count,
+                                   Rounding rounding = Rounding::Nearest);
+        static void Unorm8ToFloat(const uint8_t* input, float* output, size_t count);
+        static void Unorm16ToFloat(const uint16_t* input, float* output, size_t count);
+    };
+
+} // namespace Boolka
@@ -0,0 +1,42 @@
+#include "stdafx.h"
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+// Built with /arch:AVX2, so that compiler can use F16C and 256 bit registers
+#if defined(BLK_USE_SSE) && !defined(__AVX2__)
+#error PackingF16C.cpp should be built with /arch:AVX2
+#endif
+
+namespace Boolka
+{
+
+#ifdef BLK_USE_SSE
+
+    size_t FloatToHalfF16C(const float* input, uint16_t* output, size_t count)
+    {
+        const size_t fullCount = count - count % 8;
+        for (size_t i = 0; i < fullCount; i += 8)
+        {
+            const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(input + i),
+                                                 _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), half);
+        }
+        return fullCount;
+    }
+
+    size_t HalfToFloatF16C(const uint16_t* input, float* output, size_t count)
+    {
+        const size_t fullCount = count - count % 8;
+        for (size_t i = 0; i < fullCount; i += 8)
+        {
+            const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            _mm256_storeu_ps(output + i, _mm256_cvtph_ps(half));
+        }
+        return fullCount;
+    }
+
+#endif
+
+} // namespace Boolka
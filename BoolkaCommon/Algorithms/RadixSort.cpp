@@ -0,0 +1,268 @@
+#include "stdafx.h"
+
+#include "RadixSort.h"
+
+#include "BoolkaCommon/Structures/ScratchArena.h"
+
+namespace Boolka
+{
+
+    // Three 11 bit digits cover whole key with histograms that still fit in L1. Four 8 bit
+    // digits, or narrower digits over range of keys between smallest and largest one, measured
+    // slower, extra pass over elements costs more than cache misses it saves
+    static const size_t gs_RadixSortDigitBits = 11;
+    static const size_t gs_RadixSortDigitCount = 3;
+    static const size_t gs_RadixSortBucketCount = size_t(1) << gs_RadixSortDigitBits;
+    static const uint32_t gs_RadixSortDigitMask = uint32_t(gs_RadixSortBucketCount - 1);
+    // Up to that size insertion sort is faster than clearing and scanning histograms
+    static const size_t gs_RadixSortInsertionSortMaxSize = 64;
+    // Smaller inputs are sorted by calling thread only
+    static const size_t gs_RadixSortParallelMinSize = 32 * 1024;
+    // Larger inputs are split in chunks, one per hardware thread up to that many, each chunk is
+    // histogrammed and scattered by its own task
+    static const size_t gs_RadixSortMinChunkSize = 16 * 1024;
+    static const size_t gs_RadixSortMaxChunkCount = 64;
+
+    using RadixSortHistogram =
+        std::array<std::array<uint32_t, gs_RadixSortBucketCount>, gs_RadixSortDigitCount>;
+
+    // Sortable key is stored in high half of element and value in low half, so that each pass
+    // scatters single array
+    static uint64_t PackRadixSortElement(uint32_t sortableKey, uint32_t value)
+    {
+        return (uint64_t(sortableKey) << 32) | value;
+    }
+
+    static uint32_t GetRadixSortDigit(uint64_t element, size_t digit)
+    {
+        return uint32_t(element >> (32 + digit * gs_RadixSortDigitBits)) & gs_RadixSortDigitMask;
+    }
+
+    // Moves elements to positions given by running offsets of their digit buckets
+    template <typename ElementWriter>
+    static void ScatterByDigit(const uint64_t* elements, size_t count, size_t digit,
+                               uint32_t* offsets, ElementWriter writeElement)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t element = elements[i];
+            writeElement(offsets[GetRadixSortDigit(element, digit)]++, element);
+        }
+    }
+
+    // Keys are compared as sortable integers, xor with invertMask flips order for descending
+    // sort
+    static void InsertionSortByKey(float* keys, uint32_t* values, size_t count,
+                                   uint32_t invertMask)
+    {
+        for (size_t i = 1; i < count; ++i)
+        {
+            const float key = keys[i];
+            const uint32_t value = values[i];
+            const uint32_t sortable = RadixSort::FloatToSortable(key) ^ invertMask;
+
+            size_t j = i;
+            for (; j > 0; --j)
+            {
+                if ((RadixSort::FloatToSortable(keys[j - 1]) ^ invertMask) <= sortable)
+                    break;
+                keys[j] = keys[j - 1];
+                values[j] = values[j - 1];
+            }
+            keys[j] = key;
+            values[j] = value;
+        }
+    }
+
+    // Packs elements and counts their digits for all passes at once
+    static void FillRadixSortHistogram(const float* keys, const uint32_t* values,
+                                       uint64_t* elements, size_t count, uint32_t invertMask,
+                                       RadixSortHistogram& histogram)
+    {
+        for (auto& digitHistogram : histogram)
+            digitHistogram.fill(0);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t element =
+                PackRadixSortElement(RadixSort::FloatToSortable(keys[i]) ^ invertMask, values[i]);
+            elements[i] = element;
+            for (size_t digit = 0; digit < gs_RadixSortDigitCount; ++digit)
+                ++histogram[digit][GetRadixSortDigit(element, digit)];
+        }
+    }
+
+    // Consecutive ranges of elements, processed by separate tasks
+    struct RadixSortChunks
+    {
+        size_t count;
+        size_t size;
+        // Digit counts of each chunk, turned into chunk scatter offsets before each pass
+        RadixSortHistogram* histograms;
+        // Chunk indices to iterate over with std::for_each
+        size_t* indices;
+    };
+
+    static RadixSortChunks SplitRadixSortChunks(size_t count, ScratchArena& scratch)
+    {
+        RadixSortChunks chunks;
+        chunks.count = 1;
+        if (count >= gs_RadixSortParallelMinSize)
+        {
+            // Extra chunks only add counting passes when there are no threads to run them
+            static const size_t threadCount =
+                std::max<size_t>(std::thread::hardware_concurrency(), 1);
+            chunks.count = std::min({BLK_INT_DIVIDE_CEIL(count, gs_RadixSortMinChunkSize),
+                                     gs_RadixSortMaxChunkCount, threadCount});
+        }
+        chunks.size = BLK_INT_DIVIDE_CEIL(count, chunks.count);
+        chunks.histograms = scratch.Allocate<RadixSortHistogram>(chunks.count);
+        chunks.indices = scratch.Allocate<size_t>(chunks.count);
+        std::iota(chunks.indices, chunks.indices + chunks.count, size_t(0));
+        return chunks;
+    }
+
+    template <typename Function>
+    static void ForEachRadixSortChunk(const RadixSortChunks& chunks, size_t count,
+                                      Function function)
+    {
+        auto processChunk = [&](size_t chunk) {
+            const size_t first = chunk * chunks.size;
+            function(chunk, first, std::min(chunks.size, count - first));
+        };
+
+        if (chunks.count == 1)
+            processChunk(0);
+        else
+            std::for_each(std::execution::par, chunks.indices, chunks.indices + chunks.count,
+                          processChunk);
+    }
+
+    // Packs elements and counts their digits per chunk, total histogram is summed after
+    static void ComputeRadixSortHistogram(const float* keys, const uint32_t* values,
+                                          uint64_t* elements, size_t count, uint32_t invertMask,
+                                          const RadixSortChunks& chunks,
+                                          RadixSortHistogram& histogram)
+    {
+        ForEachRadixSortChunk(chunks, count, [&](size_t chunk, size_t first, size_t size) {
+            FillRadixSortHistogram(keys + first, values + first, elements + first, size,
+                                   invertMask, chunks.histograms[chunk]);
+        });
+
+        histogram = chunks.histograms[0];
+        for (size_t chunk = 1; chunk < chunks.count; ++chunk)
+        {
+            for (size_t digit = 0; digit < gs_RadixSortDigitCount; ++digit)
+            {
+                for (size_t bucket = 0; bucket < gs_RadixSortBucketCount; ++bucket)
+                    histogram[digit][bucket] += chunks.histograms[chunk][digit][bucket];
+            }
+        }
+    }
+
+    // Each chunk writes its elements of bucket right after elements of same bucket from
+    // previous chunks, so that sort stays stable
+    static void ComputeRadixSortChunkOffsets(const RadixSortChunks& chunks, size_t digit)
+    {
+        uint32_t offset = 0;
+        for (size_t bucket = 0; bucket < gs_RadixSortBucketCount; ++bucket)
+        {
+            for (size_t chunk = 0; chunk < chunks.count; ++chunk)
+            {
+                uint32_t& chunkOffset = chunks.histograms[chunk][digit][bucket];
+                const uint32_t bucketSize = chunkOffset;
+                chunkOffset = offset;
+                offset += bucketSize;
+            }
+        }
+    }
+
+    void RadixSort::Sort(float* keys, uint32_t* values, size_t count, Order order,
+                         ScratchArena& scratch)
+    {
+        BLK_ASSERT(count <= UINT32_MAX);
+
+        // Inverted keys sort in reverse order, and equal keys still keep their relative order
+        const uint32_t invertMask = order == Order::Descending ? 0xFFFFFFFFu : 0u;
+        if (count <= gs_RadixSortInsertionSortMaxSize)
+        {
+            InsertionSortByKey(keys, values, count, invertMask);
+            return;
+        }
+
+        uint64_t* elements[2] = {scratch.Allocate<uint64_t>(count),
+                                 scratch.Allocate<uint64_t>(count)};
+        const RadixSortChunks chunks = SplitRadixSortChunks(count, scratch);
+        RadixSortHistogram histogram;
+        ComputeRadixSortHistogram(keys, values, elements[0], count, invertMask, chunks,
+                                  histogram);
+
+        // Digit that is same for all keys doesn't change order, so its pass is skipped
+        size_t passDigits[gs_RadixSortDigitCount];
+        size_t passCount = 0;
+        for (size_t digit = 0; digit < gs_RadixSortDigitCount; ++digit)
+        {
+            if (histogram[digit][GetRadixSortDigit(elements[0][0], digit)] != count)
+                passDigits[passCount++] = digit;
+        }
+        // All keys are equal
+        if (passCount == 0)
+            return;
+
+        // Passes go back and forth between scratch buffers, last pass unpacks to output arrays
+        for (size_t pass = 0; pass < passCount; ++pass)
+        {
+            const size_t digit = passDigits[pass];
+            const uint64_t* source = elements[pass % 2];
+
+            // Chunk counts of packing pass are only valid for initial order
+            if (pass != 0 && chunks.count != 1)
+            {
+                ForEachRadixSortChunk(chunks, count, [&](size_t chunk, size_t first, size_t size) {
+                    uint32_t* chunkCounts = chunks.histograms[chunk][digit].data();
+                    std::fill_n(chunkCounts, gs_RadixSortBucketCount, 0u);
+                    for (size_t i = first; i < first + size; ++i)
+                        ++chunkCounts[GetRadixSortDigit(source[i], digit)];
+                });
+            }
+            ComputeRadixSortChunkOffsets(chunks, digit);
+
+            ForEachRadixSortChunk(chunks, count, [&](size_t chunk, size_t first, size_t size) {
+                uint32_t* offsets = chunks.histograms[chunk][digit].data();
+                if (pass + 1 == passCount)
+                {
+                    ScatterByDigit(source + first, size, digit, offsets,
+                                   [=](uint32_t position, uint64_t element) {
+                                       const uint32_t sortableKey = uint32_t(element >> 32);
+                                       keys[position] = SortableToFloat(sortableKey ^ invertMask);
+                                       values[position] = uint32_t(element);
+                                   });
+                }
+                else
+                {
+                    uint64_t* destination = elements[(pass + 1) % 2];
+                    ScatterByDigit(source + first, size, digit, offsets,
+                                   [destination](uint32_t position, uint64_t element) {
+                                       destination[position] = element;
+                                   });
+                }
+            });
+        }
+    }
+
+    uint32_t RadixSort::FloatToSortable(float value)
+    {
+        // Positive floats get sign bit set, negative floats are inverted, since their magnitude
+        // grows in opposite direction
+        const uint32_t bits = asuint(value);
+        const uint32_t mask = (0u - (bits >> 31)) | 0x80000000u;
+        return bits ^ mask;
+    }
+
+    float RadixSort::SortableToFloat(uint32_t sortable)
+    {
+        const uint32_t mask = ((sortable >> 31) - 1u) | 0x80000000u;
+        return asfloat(sortable ^ mask);
+    }
+
+} // namespace Boolka
@@ -0,0 +1,34 @@
+#pragma once
+
+namespace Boolka
+{
+
+    class ScratchArena;
+
+    // Stable LSD radix sort of float keys with 32 bit payload
+    // Keys are mapped to unsigned integers with same order and sorted by three 11 bit digits,
+    // digits that are equal for all keys are skipped
+    // Large inputs are split in chunks that are histogrammed and scattered in parallel, each
+    // chunk scatters to its own offsets within digit buckets
+    class RadixSort
+    {
+    public:
+        enum class Order
+        {
+            Ascending,
+            Descending,
+        };
+
+        // Sorts keys and reorders values with them, equal keys keep their relative order
+        // Negative zero is ordered before positive zero, NaNs are ordered past infinity of
+        // same sign
+        // Temporary buffers are allocated from scratch, it is up to caller to reset it
+        static void Sort(float* keys, uint32_t* values, size_t count, Order order,
+                         ScratchArena& scratch);
+
+        // Maps float to unsigned integer, so that integer order matches float order
+        [[nodiscard]] static uint32_t FloatToSortable(float value);
+        [[nodiscard]] static float SortableToFloat(uint32_t sortable);
+    };
+
+} // namespace Boolka
@@ -2,15 +2,14 @@
 
 #include "DebugTimer.h"
 
+#include "BoolkaCommon/Structures/HighResolutionClock.h"
+
 namespace Boolka
 {
 
     DebugTimer::DebugTimer()
-        : m_LastTimestamp{}
-        , m_Frequency{}
+        : m_LastTimestamp(0)
     {
-        BOOL res = ::QueryPerformanceFrequency(&m_Frequency);
-        BLK_CRITICAL_ASSERT(res);
     }
 
     DebugTimer::~DebugTimer()
@@ -19,20 +18,17 @@ namespace Boolka
 
     bool DebugTimer::Start()
     {
-        BOOL res = ::QueryPerformanceCounter(&m_LastTimestamp);
-        BLK_CRITICAL_ASSERT(res);
+        m_LastTimestamp = HighResolutionClock::GetTimestamp();
         return true;
     }
 
     float DebugTimer::Stop()
     {
-        LARGE_INTEGER currentTimestamp;
-        BOOL res = ::QueryPerformanceCounter(&currentTimestamp);
-        BLK_CRITICAL_ASSERT(res);
+        uint64_t currentTimestamp = HighResolutionClock::GetTimestamp();
 
-        LARGE_INTEGER timestampDifference = currentTimestamp - m_LastTimestamp;
+        uint64_t timestampDifference = currentTimestamp - m_LastTimestamp;
 
-        return timestampDifference / m_Frequency;
+        return static_cast<float>(HighResolutionClock::TicksToSeconds(timestampDifference));
     }
 
 } // namespace Boolka
@@ -14,8 +14,7 @@ namespace Boolka
         float Stop();
 
     private:
-        LARGE_INTEGER m_LastTimestamp;
-        LARGE_INTEGER m_Frequency;
+        uint64_t m_LastTimestamp;
     };
 
 } // namespace Boolka
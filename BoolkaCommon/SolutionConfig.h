@@ -18,10 +18,15 @@
 
 #define BLK_FILE_BLOCK_SIZE 4096
 
+// Used to keep data written by different threads on separate cache lines
+#define BLK_CACHE_LINE_SIZE 64
+
 // 126 is not a typo, it's reccomendation by nvidia
 // https://developer.nvidia.com/blog/introduction-turing-mesh-shaders/
 #define BLK_MESHLET_MAX_VERTS 64
 #define BLK_MESHLET_MAX_PRIMS 126
 
 // Enables usage of SSE intrinsics
+// AVX2 and F16C kernels are built in separate sources with /arch:AVX2 and are only called when
+// CPU supports them, see Structures/CPUFeatures.h
 #define BLK_USE_SSE
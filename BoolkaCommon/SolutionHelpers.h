@@ -226,18 +226,6 @@ inline void* OffsetPtr(void* ptr, size_t offset)
 // TODO move everything below to platform specific header
 #define BLK_WINDOWS_DEFAULT_SCREEN_DPI 96
 
-inline LARGE_INTEGER operator-(LARGE_INTEGER a, LARGE_INTEGER b)
-{
-    LARGE_INTEGER res;
-    res.QuadPart = a.QuadPart - b.QuadPart;
-    return res;
-}
-
-inline float operator/(LARGE_INTEGER a, LARGE_INTEGER b)
-{
-    return static_cast<float>(static_cast<double>(a.QuadPart) / static_cast<double>(b.QuadPart));
-}
-
 inline std::string UTF8encode(const std::wstring& wstr)
 {
     if (wstr.empty())
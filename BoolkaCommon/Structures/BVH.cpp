@@ -0,0 +1,1044 @@
+#include "stdafx.h"
+
+#include "BVH.h"
+
+#include "Frustum.h"
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+namespace Boolka
+{
+
+    static const size_t gs_BVHBinCount = 16;
+    // Small ranges use fewer bins, since most of them would be empty anyway
+    static const size_t gs_BVHMinBinCount = 4;
+    // Cost of traversal step relative to cost of primitive intersection
+    static const float gs_BVHTraversalCost = 1.0f;
+    // Subtrees smaller than that are never split between threads
+    static const size_t gs_BVHMinSubtreeTaskSize = 4096;
+    // Ranges at least that large are binned by several threads
+    static const size_t gs_BVHParallelBinningMinSize = 256 * 1024;
+    static const size_t gs_BVHBinningChunkSize = 64 * 1024;
+    // Traversal stack of trees up to (size - 1) / 3 levels deep fits on thread stack
+    static const size_t gs_BVHInlineStackSize = 128;
+    // Direction components smaller than that are clamped, so that slab test doesn't produce NaN
+    static const float gs_BVHMinDirection = 1e-30f;
+    // Far slab distance is scaled to make ray box test conservative despite rounding errors,
+    // 1 + 2 * gamma(3) from "Robust BVH Ray Traversal" by Ize
+    static const float gs_BVHRobustFarScale = 1.0000004f;
+
+    struct BVHBuildPrimitive
+    {
+        Vector4 min;
+        Vector4 max;
+        uint32_t index;
+    };
+
+    static float GetCentroid(const BVHBuildPrimitive& primitive, size_t axis)
+    {
+        return (primitive.min[axis] + primitive.max[axis]) * 0.5f;
+    }
+
+    static float GetHalfArea(const Vector4& min, const Vector4& max)
+    {
+        const Vector4 extent = max - min;
+        return extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x();
+    }
+
+    struct BVHRangeBounds
+    {
+        Vector4 min;
+        Vector4 max;
+        Vector4 centroidMin;
+        Vector4 centroidMax;
+
+        void Reset()
+        {
+            min = Vector4{FLT_MAX, FLT_MAX, FLT_MAX, 1.0f};
+            max = Vector4{-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.0f};
+            centroidMin = min;
+            centroidMax = max;
+        }
+
+        void Add(const BVHBuildPrimitive& primitive, const Vector4& centroid)
+        {
+            min = min.Min(primitive.min);
+            max = max.Max(primitive.max);
+            centroidMin = centroidMin.Min(centroid);
+            centroidMax = centroidMax.Max(centroid);
+        }
+
+        void Add(const BVHBuildPrimitive& primitive)
+        {
+            Add(primitive, (primitive.min + primitive.max) * 0.5f);
+        }
+
+        void Merge(const BVHRangeBounds& other)
+        {
+            min = min.Min(other.min);
+            max = max.Max(other.max);
+            centroidMin = centroidMin.Min(other.centroidMin);
+            centroidMax = centroidMax.Max(other.centroidMax);
+        }
+    };
+
+    struct BVHBin
+    {
+        BVHRangeBounds bounds;
+        size_t count;
+    };
+
+    using BVHBins = std::array<std::array<BVHBin, gs_BVHBinCount>, 3>;
+
+    // Maps centroids to bins uniformly over centroid bounds of range
+    struct BVHBinning
+    {
+        size_t binCount;
+        float origin[3];
+        float scale[3];
+
+        BVHBinning(const BVHRangeBounds& bounds, size_t count)
+            : binCount(std::clamp(count, gs_BVHMinBinCount, gs_BVHBinCount))
+        {
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                const float extent = bounds.centroidMax[axis] - bounds.centroidMin[axis];
+                origin[axis] = bounds.centroidMin[axis];
+                scale[axis] = extent > 0.0f ? binCount * 0.9999f / extent : 0.0f;
+            }
+        }
+
+        size_t GetBin(float centroid, size_t axis) const
+        {
+            const float bin = (centroid - origin[axis]) * scale[axis];
+            return std::min(static_cast<size_t>(std::max(bin, 0.0f)), binCount - 1);
+        }
+
+        size_t GetBin(const BVHBuildPrimitive& primitive, size_t axis) const
+        {
+            return GetBin(GetCentroid(primitive, axis), axis);
+        }
+    };
+
+    static void FillBins(const BVHBinning& binning, const BVHBuildPrimitive* primitives,
+                         size_t count, BVHBins& bins)
+    {
+        for (auto& axisBins : bins)
+        {
+            for (size_t i = 0; i < binning.binCount; ++i)
+            {
+                axisBins[i].bounds.Reset();
+                axisBins[i].count = 0;
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vector4 centroid = (primitives[i].min + primitives[i].max) * 0.5f;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                BVHBin& bin = bins[axis][binning.GetBin(centroid[axis], axis)];
+                bin.bounds.Add(primitives[i], centroid);
+                ++bin.count;
+            }
+        }
+    }
+
+    // Large ranges are binned in chunks by several threads, chunks are merged in fixed order,
+    // so result is same as binning by single thread
+    static void ComputeBins(const BVHBinning& binning, const BVHBuildPrimitive* primitives,
+                            size_t count, BVHBins& bins)
+    {
+        if (count < gs_BVHParallelBinningMinSize)
+        {
+            FillBins(binning, primitives, count, bins);
+            return;
+        }
+
+        const size_t chunkCount = (count + gs_BVHBinningChunkSize - 1) / gs_BVHBinningChunkSize;
+        std::vector<BVHBins> chunkBins(chunkCount);
+        std::vector<size_t> chunks(chunkCount);
+        std::iota(chunks.begin(), chunks.end(), size_t(0));
+        std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](size_t chunk) {
+            const size_t first = chunk * gs_BVHBinningChunkSize;
+            FillBins(binning, primitives + first, std::min(gs_BVHBinningChunkSize, count - first),
+                     chunkBins[chunk]);
+        });
+
+        bins = chunkBins[0];
+        for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+        {
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                for (size_t i = 0; i < binning.binCount; ++i)
+                {
+                    bins[axis][i].bounds.Merge(chunkBins[chunk][axis][i].bounds);
+                    bins[axis][i].count += chunkBins[chunk][axis][i].count;
+                }
+            }
+        }
+    }
+
+    struct BVHSplit
+    {
+        size_t axis;
+        // Last bin of left side
+        size_t bin;
+        // Sum of half areas of children multiplied by their primitive counts
+        float cost;
+        BVHRangeBounds left;
+        BVHRangeBounds right;
+        size_t leftCount;
+    };
+
+    static bool FindSplit(const BVHBinning& binning, const BVHBins& bins, BVHSplit& split)
+    {
+        bool isFound = false;
+        split.cost = FLT_MAX;
+
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const auto& axisBins = bins[axis];
+
+            BVHRangeBounds rightBounds[gs_BVHBinCount];
+            size_t rightCounts[gs_BVHBinCount];
+            BVHRangeBounds accumulated;
+            accumulated.Reset();
+            size_t accumulatedCount = 0;
+            for (size_t i = binning.binCount - 1; i > 0; --i)
+            {
+                // Small ranges leave most bins empty
+                if (axisBins[i].count != 0)
+                    accumulated.Merge(axisBins[i].bounds);
+                accumulatedCount += axisBins[i].count;
+                rightBounds[i] = accumulated;
+                rightCounts[i] = accumulatedCount;
+            }
+
+            accumulated.Reset();
+            accumulatedCount = 0;
+            for (size_t i = 0; i < binning.binCount - 1; ++i)
+            {
+                if (axisBins[i].count == 0)
+                    continue;
+                accumulated.Merge(axisBins[i].bounds);
+                accumulatedCount += axisBins[i].count;
+                if (rightCounts[i + 1] == 0)
+                    continue;
+
+                const float cost =
+                    GetHalfArea(accumulated.min, accumulated.max) * accumulatedCount +
+                    GetHalfArea(rightBounds[i + 1].min, rightBounds[i + 1].max) *
+                        rightCounts[i + 1];
+                if (cost < split.cost)
+                {
+                    isFound = true;
+                    split.axis = axis;
+                    split.bin = i;
+                    split.cost = cost;
+                    split.left = accumulated;
+                    split.right = rightBounds[i + 1];
+                    split.leftCount = accumulatedCount;
+                }
+            }
+        }
+
+        return isFound;
+    }
+
+    struct BVHBuildNode
+    {
+        Vector4 min;
+        Vector4 max;
+        uint32_t first;
+        uint32_t count;
+        uint32_t left;
+        uint32_t right;
+        bool isLeaf;
+    };
+
+    struct BVHBuildTask
+    {
+        // Node allocated for this task
+        uint32_t node;
+        size_t first;
+        size_t count;
+        BVHRangeBounds bounds;
+    };
+
+    static BVHRangeBounds CalculateRangeBounds(const BVHBuildPrimitive* primitives, size_t count)
+    {
+        BVHRangeBounds result;
+        result.Reset();
+        for (size_t i = 0; i < count; ++i)
+            result.Add(primitives[i]);
+        return result;
+    }
+
+    // Builds subtree of rootTask into nodes. If deferredTasks is not null, tasks of at most
+    // deferSize primitives are not built but moved there instead, with their nodes allocated
+    static void BuildSubtree(BVHBuildPrimitive* primitives, const BVHBuildTask& rootTask,
+                             std::vector<BVHBuildNode>& nodes,
+                             std::vector<BVHBuildTask>* deferredTasks, size_t deferSize)
+    {
+        std::vector<BVHBuildTask> stack{rootTask};
+        BVHBins bins;
+
+        while (!stack.empty())
+        {
+            const BVHBuildTask task = stack.back();
+            stack.pop_back();
+            if (deferredTasks != nullptr && task.count <= deferSize)
+            {
+                deferredTasks->push_back(task);
+                continue;
+            }
+
+            BVHBuildNode& node = nodes[task.node];
+            node.min = task.bounds.min;
+            node.max = task.bounds.max;
+            node.first = static_cast<uint32_t>(task.first);
+            node.count = static_cast<uint32_t>(task.count);
+            node.isLeaf = true;
+            if (task.count == 1)
+                continue;
+
+            BVHBuildPrimitive* begin = primitives + task.first;
+            BVHBuildPrimitive* end = begin + task.count;
+            const BVHBinning binning(task.bounds, task.count);
+            ComputeBins(binning, begin, task.count, bins);
+            BVHSplit split;
+            const bool hasSplit = FindSplit(binning, bins, split);
+
+            const float area = GetHalfArea(task.bounds.min, task.bounds.max);
+            if (task.count <= BVH::ms_MaxLeafSize &&
+                (!hasSplit || task.count * area <= gs_BVHTraversalCost * area + split.cost))
+            {
+                continue;
+            }
+
+            BVHBuildTask left{0, task.first, 0, {}};
+            BVHBuildTask right{0, 0, 0, {}};
+            if (hasSplit)
+            {
+                BVHBuildPrimitive* middle =
+                    std::partition(begin, end, [&binning, &split](const BVHBuildPrimitive& p) {
+                        return binning.GetBin(p, split.axis) <= split.bin;
+                    });
+                BLK_ASSERT(static_cast<size_t>(middle - begin) == split.leftCount);
+                BLK_UNUSED_VARIABLE(middle);
+                left.count = split.leftCount;
+                left.bounds = split.left;
+                right.bounds = split.right;
+            }
+            else
+            {
+                // All centroids are same, any split is as good as other
+                left.count = task.count / 2;
+                left.bounds = CalculateRangeBounds(begin, left.count);
+                right.bounds = CalculateRangeBounds(begin + left.count, task.count - left.count);
+            }
+            right.first = task.first + left.count;
+            right.count = task.count - left.count;
+
+            left.node = static_cast<uint32_t>(nodes.size());
+            right.node = left.node + 1;
+            nodes.resize(nodes.size() + 2);
+            nodes[task.node].isLeaf = false;
+            nodes[task.node].left = left.node;
+            nodes[task.node].right = right.node;
+
+            stack.push_back(right);
+            stack.push_back(left);
+        }
+    }
+
+    static uint32_t EncodeLeaf(const BVHBuildNode& node)
+    {
+        BLK_ASSERT(node.count > 0 && node.count <= (1u << (31 - BVH::ms_LeafCountShift)));
+        return BVH::ms_LeafFlag | ((node.count - 1) << BVH::ms_LeafCountShift) | node.first;
+    }
+
+    static uint32_t GetLeafFirst(uint32_t child)
+    {
+        return child & BVH::ms_LeafFirstMask;
+    }
+
+    static uint32_t GetLeafCount(uint32_t child)
+    {
+        return ((child & ~BVH::ms_LeafFlag) >> BVH::ms_LeafCountShift) + 1;
+    }
+
+    BVH::BVH()
+        : m_PrimitiveType(PrimitiveType::Box)
+        , m_MaxDepth(0)
+    {
+    }
+
+    void BVH::BuildHierarchy(const AABB* primitiveBounds, size_t count)
+    {
+        if (count == 0)
+            return;
+        BLK_ASSERT(count <= ms_LeafFirstMask);
+
+        std::vector<BVHBuildPrimitive> primitives(count);
+        BVHBuildTask rootTask{0, 0, count, {}};
+        rootTask.bounds.Reset();
+        for (size_t i = 0; i < count; ++i)
+        {
+            BLK_ASSERT(primitiveBounds[i].GetMin().w() == 1.0f);
+            BLK_ASSERT(primitiveBounds[i].GetMax().w() == 1.0f);
+            primitives[i] = BVHBuildPrimitive{primitiveBounds[i].GetMin(),
+                                              primitiveBounds[i].GetMax(),
+                                              static_cast<uint32_t>(i)};
+            rootTask.bounds.Add(primitives[i]);
+        }
+
+        // Top of tree is built first, subtrees below it are built in parallel
+        // Splits don't depend on which thread builds them, so tree is same for any thread count
+        const size_t threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        const size_t deferSize = std::max(gs_BVHMinSubtreeTaskSize, count / (threadCount * 4));
+        std::vector<BVHBuildNode> buildNodes(1);
+        std::vector<BVHBuildTask> deferredTasks;
+        BuildSubtree(primitives.data(), rootTask, buildNodes, &deferredTasks, deferSize);
+
+        std::vector<std::vector<BVHBuildNode>> subtreeNodes(deferredTasks.size());
+        std::vector<size_t> taskIndices(deferredTasks.size());
+        std::iota(taskIndices.begin(), taskIndices.end(), size_t(0));
+        std::for_each(std::execution::par, taskIndices.begin(), taskIndices.end(),
+                      [&](size_t taskIndex) {
+                          BVHBuildTask task = deferredTasks[taskIndex];
+                          task.node = 0;
+                          subtreeNodes[taskIndex].resize(1);
+                          BuildSubtree(primitives.data(), task, subtreeNodes[taskIndex], nullptr,
+                                       0);
+                      });
+
+        // Subtree root replaces node allocated for task, other nodes are appended
+        size_t nodeCount = buildNodes.size();
+        for (const std::vector<BVHBuildNode>& nodes : subtreeNodes)
+            nodeCount += nodes.size() - 1;
+        buildNodes.reserve(nodeCount);
+        for (size_t taskIndex = 0; taskIndex < deferredTasks.size(); ++taskIndex)
+        {
+            const std::vector<BVHBuildNode>& nodes = subtreeNodes[taskIndex];
+            const uint32_t rootNode = deferredTasks[taskIndex].node;
+            const uint32_t base = static_cast<uint32_t>(buildNodes.size()) - 1;
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                BVHBuildNode node = nodes[i];
+                if (!node.isLeaf)
+                {
+                    node.left += base;
+                    node.right += base;
+                }
+                if (i == 0)
+                    buildNodes[rootNode] = node;
+                else
+                    buildNodes.push_back(node);
+            }
+        }
+
+        m_PrimitiveIndices.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            m_PrimitiveIndices[i] = primitives[i].index;
+
+        // Collapse binary tree into 4 wide nodes, children with largest area are opened first
+        struct CollapseTask
+        {
+            uint32_t buildNode;
+            uint32_t node;
+            size_t depth;
+        };
+        std::vector<CollapseTask> stack{{0, 0, 1}};
+        m_Nodes.resize(1);
+        m_NodeRanges.push_back({buildNodes[0].first, buildNodes[0].count});
+
+        while (!stack.empty())
+        {
+            const CollapseTask task = stack.back();
+            stack.pop_back();
+            m_MaxDepth = std::max(m_MaxDepth, task.depth);
+
+            // Children are kept in leaf order
+            uint32_t children[4];
+            size_t childCount = 0;
+            const BVHBuildNode& buildNode = buildNodes[task.buildNode];
+            if (buildNode.isLeaf)
+            {
+                // Only root can be collapsed leaf
+                children[childCount++] = task.buildNode;
+            }
+            else
+            {
+                children[childCount++] = buildNode.left;
+                children[childCount++] = buildNode.right;
+            }
+
+            while (childCount < 4)
+            {
+                size_t largestChild = childCount;
+                float largestArea = -1.0f;
+                for (size_t i = 0; i < childCount; ++i)
+                {
+                    const BVHBuildNode& child = buildNodes[children[i]];
+                    const float area = GetHalfArea(child.min, child.max);
+                    if (!child.isLeaf && area > largestArea)
+                    {
+                        largestChild = i;
+                        largestArea = area;
+                    }
+                }
+                if (largestChild == childCount)
+                    break;
+
+                const BVHBuildNode& opened = buildNodes[children[largestChild]];
+                std::copy_backward(children + largestChild + 1, children + childCount,
+                                   children + childCount + 1);
+                children[largestChild] = opened.left;
+                children[largestChild + 1] = opened.right;
+                ++childCount;
+            }
+
+            Node node;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                if (i >= childCount)
+                {
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        node.bounds[axis][i] = FLT_MAX;
+                        node.bounds[axis + 3][i] = -FLT_MAX;
+                    }
+                    node.children[i] = ms_EmptyChild;
+                    continue;
+                }
+
+                const BVHBuildNode& child = buildNodes[children[i]];
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    node.bounds[axis][i] = child.min[axis];
+                    node.bounds[axis + 3][i] = child.max[axis];
+                }
+
+                if (child.isLeaf)
+                {
+                    node.children[i] = EncodeLeaf(child);
+                    continue;
+                }
+
+                const uint32_t childNode = static_cast<uint32_t>(m_Nodes.size());
+                node.children[i] = childNode;
+                m_Nodes.emplace_back();
+                m_NodeRanges.push_back({child.first, child.count});
+                stack.push_back({children[i], childNode, task.depth + 1});
+            }
+            m_Nodes[task.node] = node;
+        }
+    }
+
+    void BVH::Build(const AABB* boxes, size_t count)
+    {
+        Clear();
+        m_PrimitiveType = PrimitiveType::Box;
+        BuildHierarchy(boxes, count);
+
+        m_Boxes.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            m_Boxes[i] = boxes[m_PrimitiveIndices[i]];
+    }
+
+    void BVH::Build(const Vector3* positions, const uint32_t* indices, size_t triangleCount)
+    {
+        Clear();
+        m_PrimitiveType = PrimitiveType::Triangle;
+
+        std::vector<AABB> bounds(triangleCount);
+        for (size_t i = 0; i < triangleCount; ++i)
+        {
+            const Vector3& a = positions[indices[i * 3]];
+            const Vector3& b = positions[indices[i * 3 + 1]];
+            const Vector3& c = positions[indices[i * 3 + 2]];
+            const Vector3 min = a.Min(b).Min(c);
+            const Vector3 max = a.Max(b).Max(c);
+            bounds[i] = AABB{Vector4{min.x(), min.y(), min.z(), 1.0f},
+                             Vector4{max.x(), max.y(), max.z(), 1.0f}};
+        }
+        BuildHierarchy(bounds.data(), triangleCount);
+
+        m_Triangles.resize(triangleCount);
+        for (size_t i = 0; i < triangleCount; ++i)
+        {
+            const uint32_t* triangle = indices + m_PrimitiveIndices[i] * 3;
+            const Vector3& vertex = positions[triangle[0]];
+            m_Triangles[i] = Triangle{vertex, positions[triangle[1]] - vertex,
+                                      positions[triangle[2]] - vertex};
+        }
+    }
+
+    void BVH::Clear()
+    {
+        m_Nodes.clear();
+        m_NodeRanges.clear();
+        m_PrimitiveIndices.clear();
+        m_Boxes.clear();
+        m_Triangles.clear();
+        m_MaxDepth = 0;
+    }
+
+    struct BVHRaySetup
+    {
+        // Index of near and far slab in Node::bounds for every axis
+        size_t nearIndex[3];
+        size_t farIndex[3];
+#ifdef BLK_USE_SSE
+        __m128 origin[3];
+        __m128 inverseDirection[3];
+#else
+        float origin[3];
+        float inverseDirection[3];
+#endif
+    };
+
+    static Vector3 CalculateInverseDirection(const Vector3& direction)
+    {
+        Vector3 result;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float component = abs(direction[axis]) < gs_BVHMinDirection
+                                        ? copysign(gs_BVHMinDirection, direction[axis])
+                                        : direction[axis];
+            result[axis] = 1.0f / component;
+        }
+        return result;
+    }
+
+    static BVHRaySetup SetupRay(const Vector3& origin, const Vector3& inverseDirection)
+    {
+        BVHRaySetup result;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const bool isPositive = inverseDirection[axis] >= 0.0f;
+            result.nearIndex[axis] = isPositive ? axis : axis + 3;
+            result.farIndex[axis] = isPositive ? axis + 3 : axis;
+#ifdef BLK_USE_SSE
+            result.origin[axis] = _mm_set1_ps(origin[axis]);
+            result.inverseDirection[axis] = _mm_set1_ps(inverseDirection[axis]);
+#else
+            result.origin[axis] = origin[axis];
+            result.inverseDirection[axis] = inverseDirection[axis];
+#endif
+        }
+        return result;
+    }
+
+    // Returns mask of children hit in [0, maxDistance] and writes their entry distances
+#ifdef BLK_USE_SSE
+    static uint32_t IntersectChildren(const BVH::Node& node, const BVHRaySetup& ray,
+                                      float maxDistance, float (&distances)[4])
+    {
+        __m128 nearDistance[3];
+        __m128 farDistance[3];
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const __m128 nearBound = _mm_load_ps(node.bounds[ray.nearIndex[axis]]);
+            const __m128 farBound = _mm_load_ps(node.bounds[ray.farIndex[axis]]);
+            nearDistance[axis] =
+                _mm_mul_ps(_mm_sub_ps(nearBound, ray.origin[axis]), ray.inverseDirection[axis]);
+            farDistance[axis] =
+                _mm_mul_ps(_mm_sub_ps(farBound, ray.origin[axis]), ray.inverseDirection[axis]);
+        }
+
+        const __m128 entry =
+            _mm_max_ps(_mm_max_ps(nearDistance[0], nearDistance[1]),
+                       _mm_max_ps(nearDistance[2], _mm_setzero_ps()));
+        const __m128 exit =
+            _mm_min_ps(_mm_min_ps(farDistance[0], farDistance[1]),
+                       _mm_min_ps(farDistance[2], _mm_set1_ps(maxDistance)));
+        const __m128 robustExit = _mm_mul_ps(exit, _mm_set1_ps(gs_BVHRobustFarScale));
+
+        _mm_storeu_ps(distances, entry);
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(entry, robustExit)));
+    }
+#else
+    static uint32_t IntersectChildren(const BVH::Node& node, const BVHRaySetup& ray,
+                                      float maxDistance, float (&distances)[4])
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            float entry = 0.0f;
+            float exit = maxDistance;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                const float nearBound = node.bounds[ray.nearIndex[axis]][i];
+                const float farBound = node.bounds[ray.farIndex[axis]][i];
+                entry = std::max(entry, (nearBound - ray.origin[axis]) *
+                                            ray.inverseDirection[axis]);
+                exit = std::min(exit, (farBound - ray.origin[axis]) *
+                                          ray.inverseDirection[axis]);
+            }
+            distances[i] = entry;
+            if (entry <= exit * gs_BVHRobustFarScale)
+                result |= 1u << i;
+        }
+        return result;
+    }
+#endif
+
+    bool BVH::IntersectLeaf(uint32_t child, const Vector3& origin, const Vector3& direction,
+                            const Vector3& inverseDirection, float maxDistance, RayHit& hit,
+                            bool anyHit) const
+    {
+        const uint32_t first = GetLeafFirst(child);
+        const uint32_t last = first + GetLeafCount(child);
+        bool isHit = false;
+
+        for (uint32_t i = first; i < last; ++i)
+        {
+            float distance;
+            float u = 0.0f;
+            float v = 0.0f;
+
+            if (m_PrimitiveType == PrimitiveType::Box)
+            {
+                const AABB& box = m_Boxes[i];
+                float entry = 0.0f;
+                float exit = maxDistance;
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    float nearDistance = (box.GetMin()[axis] - origin[axis]) *
+                                         inverseDirection[axis];
+                    float farDistance = (box.GetMax()[axis] - origin[axis]) *
+                                        inverseDirection[axis];
+                    if (nearDistance > farDistance)
+                        std::swap(nearDistance, farDistance);
+                    entry = std::max(entry, nearDistance);
+                    exit = std::min(exit, farDistance);
+                }
+                if (entry > exit * gs_BVHRobustFarScale)
+                    continue;
+                distance = entry;
+            }
+            else
+            {
+                // Moller-Trumbore, double sided
+                const Triangle& triangle = m_Triangles[i];
+                const Vector3 p = direction.Cross(triangle.edge2);
+                const float determinant = triangle.edge1.Dot(p);
+                if (determinant == 0.0f)
+                    continue;
+                const float inverseDeterminant = 1.0f / determinant;
+                const Vector3 s = origin - triangle.vertex;
+                u = s.Dot(p) * inverseDeterminant;
+                if (u < 0.0f || u > 1.0f)
+                    continue;
+                const Vector3 q = s.Cross(triangle.edge1);
+                v = direction.Dot(q) * inverseDeterminant;
+                if (v < 0.0f || u + v > 1.0f)
+                    continue;
+                distance = triangle.edge2.Dot(q) * inverseDeterminant;
+                if (distance < 0.0f || distance > maxDistance)
+                    continue;
+            }
+
+            hit = RayHit{distance, u, v, m_PrimitiveIndices[i]};
+            maxDistance = distance;
+            isHit = true;
+            if (anyHit)
+                break;
+        }
+
+        return isHit;
+    }
+
+    template <bool anyHit>
+    bool BVH::TraverseRay(const Vector3& origin, const Vector3& direction, float maxDistance,
+                          RayHit& hit) const
+    {
+        if (m_Nodes.empty())
+            return false;
+
+        // Every level pops one entry and pushes at most 4
+        const size_t stackSize = m_MaxDepth * 3 + 1;
+        if (stackSize <= gs_BVHInlineStackSize)
+        {
+            StackEntry stack[gs_BVHInlineStackSize];
+            return TraverseRay<anyHit>(origin, direction, maxDistance, hit, stack);
+        }
+
+        std::vector<StackEntry> stack(stackSize);
+        return TraverseRay<anyHit>(origin, direction, maxDistance, hit, stack.data());
+    }
+
+    template <bool anyHit>
+    bool BVH::TraverseRay(const Vector3& origin, const Vector3& direction, float maxDistance,
+                          RayHit& hit, StackEntry* stack) const
+    {
+        const Vector3 inverseDirection = CalculateInverseDirection(direction);
+        const BVHRaySetup ray = SetupRay(origin, inverseDirection);
+
+        bool isHit = false;
+        size_t stackSize = 0;
+        stack[stackSize++] = StackEntry{0, 0.0f};
+
+        while (stackSize != 0)
+        {
+            const StackEntry entry = stack[--stackSize];
+            if (entry.distance > maxDistance)
+                continue;
+
+            if ((entry.child & ms_LeafFlag) != 0)
+            {
+                if (IntersectLeaf(entry.child, origin, direction, inverseDirection, maxDistance,
+                                  hit, anyHit))
+                {
+                    if (anyHit)
+                        return true;
+                    isHit = true;
+                    maxDistance = hit.distance;
+                }
+                continue;
+            }
+
+            const Node& node = m_Nodes[entry.child];
+            float distances[4];
+            uint32_t hitMask = IntersectChildren(node, ray, maxDistance, distances);
+
+            // Farther children are pushed first, so that closer ones are visited first
+            StackEntry hitChildren[4];
+            size_t hitCount = 0;
+            while (hitMask != 0)
+            {
+                const size_t i = std::countr_zero(hitMask);
+                hitMask &= hitMask - 1;
+                if (node.children[i] == ms_EmptyChild)
+                    continue;
+
+                StackEntry child{node.children[i], distances[i]};
+                size_t position = hitCount++;
+                for (; position > 0 && hitChildren[position - 1].distance < child.distance;
+                     --position)
+                {
+                    hitChildren[position] = hitChildren[position - 1];
+                }
+                hitChildren[position] = child;
+            }
+            for (size_t i = 0; i < hitCount; ++i)
+                stack[stackSize++] = hitChildren[i];
+        }
+
+        return isHit;
+    }
+
+    bool BVH::IntersectRay(const Vector3& origin, const Vector3& direction, float maxDistance,
+                           RayHit& hit) const
+    {
+        return TraverseRay<false>(origin, direction, maxDistance, hit);
+    }
+
+    bool BVH::IsOccluded(const Vector3& origin, const Vector3& direction,
+                         float maxDistance) const
+    {
+        RayHit hit;
+        return TraverseRay<true>(origin, direction, maxDistance, hit);
+    }
+
+    struct BVHFrustumPlane
+    {
+        // Bound that is furthest along plane normal, same choice as Frustum::CheckAABBFast
+        size_t farIndex[3];
+        size_t nearIndex[3];
+#ifdef BLK_USE_SSE
+        __m128 components[4];
+#else
+        float components[4];
+#endif
+    };
+
+    // Sets bit i of visibleMask if child i is not completely outside of frustum, and bit i of
+    // insideMask if it is completely inside
+    // Terms are summed in same order as Vector4::Dot, so that results match
+    // Frustum::CheckAABBFast bit exactly
+#ifdef BLK_USE_SSE
+    static __m128 CalculatePlaneDistance(const BVH::Node& node, const BVHFrustumPlane& plane,
+                                         const size_t (&boundIndex)[3])
+    {
+        const __m128 x = _mm_load_ps(node.bounds[boundIndex[0]]);
+        const __m128 y = _mm_load_ps(node.bounds[boundIndex[1]]);
+        const __m128 z = _mm_load_ps(node.bounds[boundIndex[2]]);
+        const __m128 xy =
+            _mm_add_ps(_mm_mul_ps(plane.components[0], x), _mm_mul_ps(plane.components[1], y));
+        const __m128 zw = _mm_add_ps(_mm_mul_ps(plane.components[2], z), plane.components[3]);
+        return _mm_add_ps(xy, zw);
+    }
+
+    static void TestChildren(const BVH::Node& node, const BVHFrustumPlane (&planes)[6],
+                             uint32_t& visibleMask, uint32_t& insideMask)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        __m128 outside = zero;
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (const BVHFrustumPlane& plane : planes)
+        {
+            const __m128 farDistance = CalculatePlaneDistance(node, plane, plane.farIndex);
+            const __m128 nearDistance = CalculatePlaneDistance(node, plane, plane.nearIndex);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(farDistance, zero));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(nearDistance, zero));
+        }
+
+        visibleMask = ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xF;
+        insideMask = static_cast<uint32_t>(_mm_movemask_ps(inside)) & visibleMask;
+    }
+#else
+    static void TestChildren(const BVH::Node& node, const BVHFrustumPlane (&planes)[6],
+                             uint32_t& visibleMask, uint32_t& insideMask)
+    {
+        visibleMask = 0;
+        insideMask = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            bool isOutside = false;
+            bool isInside = true;
+            for (const BVHFrustumPlane& plane : planes)
+            {
+                const float* p = plane.components;
+                const float farXY = p[0] * node.bounds[plane.farIndex[0]][i] +
+                                    p[1] * node.bounds[plane.farIndex[1]][i];
+                const float farZW = p[2] * node.bounds[plane.farIndex[2]][i] + p[3];
+                isOutside = isOutside || farXY + farZW < 0.0f;
+
+                const float nearXY = p[0] * node.bounds[plane.nearIndex[0]][i] +
+                                     p[1] * node.bounds[plane.nearIndex[1]][i];
+                const float nearZW = p[2] * node.bounds[plane.nearIndex[2]][i] + p[3];
+                isInside = isInside && nearXY + nearZW >= 0.0f;
+            }
+            if (!isOutside)
+            {
+                visibleMask |= 1u << i;
+                if (isInside)
+                    insideMask |= 1u << i;
+            }
+        }
+    }
+#endif
+
+    void BVH::CullFrustum(const Frustum& frustum, std::vector<uint32_t>& visiblePrimitives) const
+    {
+        if (m_Nodes.empty())
+            return;
+
+        BVHFrustumPlane planes[6];
+        const float* planeData = frustum.GetBuffer();
+        for (size_t i = 0; i < 6; ++i)
+        {
+            const float* plane = planeData + i * 4;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                planes[i].farIndex[axis] = plane[axis] > 0.0f ? axis + 3 : axis;
+                planes[i].nearIndex[axis] = plane[axis] > 0.0f ? axis : axis + 3;
+            }
+            for (size_t component = 0; component < 4; ++component)
+            {
+#ifdef BLK_USE_SSE
+                planes[i].components[component] = _mm_set1_ps(plane[component]);
+#else
+                planes[i].components[component] = plane[component];
+#endif
+            }
+        }
+
+        auto appendRange = [this, &visiblePrimitives](uint32_t first, uint32_t count) {
+            visiblePrimitives.insert(visiblePrimitives.end(), m_PrimitiveIndices.begin() + first,
+                                     m_PrimitiveIndices.begin() + first + count);
+        };
+
+        struct CullEntry
+        {
+            uint32_t child;
+            bool isInside;
+        };
+        std::vector<CullEntry> stack;
+        stack.reserve(m_MaxDepth * 3 + 1);
+        stack.push_back(CullEntry{0, false});
+
+        while (!stack.empty())
+        {
+            const CullEntry entry = stack.back();
+            stack.pop_back();
+
+            if ((entry.child & ms_LeafFlag) != 0)
+            {
+                appendRange(GetLeafFirst(entry.child), GetLeafCount(entry.child));
+                continue;
+            }
+            if (entry.isInside)
+            {
+                const NodeRange& range = m_NodeRanges[entry.child];
+                appendRange(range.first, range.count);
+                continue;
+            }
+
+            const Node& node = m_Nodes[entry.child];
+            uint32_t visibleMask;
+            uint32_t insideMask;
+            TestChildren(node, planes, visibleMask, insideMask);
+
+            // Pushed in reverse, so that primitives are appended in leaf order
+            for (size_t i = 4; i-- > 0;)
+            {
+                if ((visibleMask & (1u << i)) == 0 || node.children[i] == ms_EmptyChild)
+                    continue;
+                stack.push_back(CullEntry{node.children[i], (insideMask & (1u << i)) != 0});
+            }
+        }
+    }
+
+    bool BVH::IsEmpty() const
+    {
+        return m_Nodes.empty();
+    }
+
+    AABB BVH::GetBounds() const
+    {
+        BLK_ASSERT(!IsEmpty());
+        Vector4 min{FLT_MAX, FLT_MAX, FLT_MAX, 1.0f};
+        Vector4 max{-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.0f};
+        const Node& root = m_Nodes[0];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            if (root.children[i] == ms_EmptyChild)
+                continue;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                min[axis] = std::min(min[axis], root.bounds[axis][i]);
+                max[axis] = std::max(max[axis], root.bounds[axis + 3][i]);
+            }
+        }
+        return AABB{min, max};
+    }
+
+    size_t BVH::GetPrimitiveCount() const
+    {
+        return m_PrimitiveIndices.size();
+    }
+
+    size_t BVH::GetMaxDepth() const
+    {
+        return m_MaxDepth;
+    }
+
+    const std::vector<BVH::Node>& BVH::GetNodes() const
+    {
+        return m_Nodes;
+    }
+
+    const std::vector<uint32_t>& BVH::GetPrimitiveIndices() const
+    {
+        return m_PrimitiveIndices;
+    }
+
+} // namespace Boolka
@@ -0,0 +1,128 @@
+#pragma once
+#include "AABB.h"
+#include "Vector.h"
+
+namespace Boolka
+{
+
+    class Frustum;
+
+    // Bounding volume hierarchy over boxes or triangles for CPU side queries (picking, visibility
+    // tests, reference checks for ray tracing)
+    // Built with binned SAH. Top of tree is split first and subtrees below it are built in
+    // parallel, result doesn't depend on thread count. Binary tree is collapsed to 4 wide nodes,
+    // so that ray and frustum traversal test all 4 children at once
+    class [[nodiscard]] BVH
+    {
+    public:
+        static constexpr size_t ms_MaxLeafSize = 4;
+
+        // Child of node is inner node index, leaf or empty
+        // Leaf is ms_LeafFlag | (primitive count - 1) << ms_LeafCountShift | first primitive,
+        // where primitives are indices into GetPrimitiveIndices()
+        static constexpr uint32_t ms_LeafFlag = 0x80000000;
+        static constexpr uint32_t ms_LeafCountShift = 28;
+        static constexpr uint32_t ms_LeafFirstMask = (1u << ms_LeafCountShift) - 1;
+        static constexpr uint32_t ms_EmptyChild = 0xFFFFFFFF;
+
+        struct alignas(16) Node
+        {
+            // Bounds of children as structure of arrays: min x, y, z, max x, y, z
+            // Empty children have inverted bounds, so they are never hit
+            float bounds[6][4];
+            uint32_t children[4];
+        };
+
+        struct [[nodiscard]] RayHit
+        {
+            // In units of ray direction length
+            float distance;
+            // Barycentrics of hit point for triangles, 0 for boxes
+            float u;
+            float v;
+            // Index of box or triangle passed to Build
+            uint32_t primitive;
+        };
+
+        BVH();
+        ~BVH() = default;
+
+        // Boxes should have w of 1, same as for Frustum tests
+        void Build(const AABB* boxes, size_t count);
+        // Triangle i is positions[indices[i * 3]], positions[indices[i * 3 + 1]], ...
+        void Build(const Vector3* positions, const uint32_t* indices, size_t triangleCount);
+        void Clear();
+
+        // Closest primitive hit by ray in [0, maxDistance], ray starting inside box hits it at 0
+        // Triangles are double sided. Direction doesn't need to be normalized
+        [[nodiscard]] bool IntersectRay(const Vector3& origin, const Vector3& direction,
+                                        float maxDistance, RayHit& hit) const;
+        // Stops at first hit, faster than IntersectRay for visibility tests
+        [[nodiscard]] bool IsOccluded(const Vector3& origin, const Vector3& direction,
+                                      float maxDistance) const;
+
+        // Appends primitives of every leaf that is not completely outside of frustum, so every
+        // primitive whose box passes Frustum::CheckAABBFast is included. Children that are
+        // completely inside frustum are appended without testing their subtree
+        // Primitives are appended in same order as GetPrimitiveIndices(), each at most once
+        void CullFrustum(const Frustum& frustum, std::vector<uint32_t>& visiblePrimitives) const;
+
+        [[nodiscard]] bool IsEmpty() const;
+        [[nodiscard]] AABB GetBounds() const;
+        [[nodiscard]] size_t GetPrimitiveCount() const;
+        [[nodiscard]] size_t GetMaxDepth() const;
+        // Root is node 0
+        [[nodiscard]] const std::vector<Node>& GetNodes() const;
+        // Primitive indices in leaf order
+        [[nodiscard]] const std::vector<uint32_t>& GetPrimitiveIndices() const;
+
+    private:
+        enum class PrimitiveType
+        {
+            Box,
+            Triangle,
+        };
+
+        // Triangle prepared for Moller-Trumbore intersection
+        struct Triangle
+        {
+            Vector3 vertex;
+            Vector3 edge1;
+            Vector3 edge2;
+        };
+
+        // Primitives of subtree are continuous in leaf order
+        struct NodeRange
+        {
+            uint32_t first;
+            uint32_t count;
+        };
+
+        struct StackEntry
+        {
+            uint32_t child;
+            float distance;
+        };
+
+        void BuildHierarchy(const AABB* primitiveBounds, size_t count);
+        template <bool anyHit>
+        [[nodiscard]] bool TraverseRay(const Vector3& origin, const Vector3& direction,
+                                       float maxDistance, RayHit& hit) const;
+        template <bool anyHit>
+        [[nodiscard]] bool TraverseRay(const Vector3& origin, const Vector3& direction,
+                                       float maxDistance, RayHit& hit, StackEntry* stack) const;
+        [[nodiscard]] bool IntersectLeaf(uint32_t child, const Vector3& origin,
+                                         const Vector3& direction, const Vector3& inverseDirection,
+                                         float maxDistance, RayHit& hit, bool anyHit) const;
+
+        std::vector<Node> m_Nodes;
+        std::vector<NodeRange> m_NodeRanges;
+        std::vector<uint32_t> m_PrimitiveIndices;
+        // In leaf order, only one of them is filled depending on m_PrimitiveType
+        std::vector<AABB> m_Boxes;
+        std::vector<Triangle> m_Triangles;
+        PrimitiveType m_PrimitiveType;
+        size_t m_MaxDepth;
+    };
+
+} // namespace Boolka
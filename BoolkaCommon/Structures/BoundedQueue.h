@@ -0,0 +1,425 @@
+#pragma once
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+namespace Boolka
+{
+
+    // Used by blocking queue operations. Spins first, since other side usually frees slot or
+    // adds element within microseconds, then gives time slice away to other threads
+    // Waiting thread never sleeps in OS, so it is meant for waits between running engine threads
+    class QueueBackoff
+    {
+    public:
+        QueueBackoff();
+
+        void Wait();
+
+    private:
+        // Spin round n pauses 2^n times
+        static constexpr uint32_t ms_SpinRounds = 7;
+
+        uint32_t m_Round;
+    };
+
+    // Bounded ring queue for exactly one producer thread and one consumer thread
+    // TryPush and TryPop are wait-free. Each side keeps copy of other side's index, so that
+    // index written by other thread is only read when queue looks full or empty
+    template <typename T>
+    class [[nodiscard]] SPSCQueue
+    {
+    public:
+        // Capacity is rounded up to power of two
+        explicit SPSCQueue(size_t capacity);
+        ~SPSCQueue();
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        // Producer thread only. Return false if queue is full, arguments are not used then
+        template <typename... Args>
+        [[nodiscard]] bool TryEmplace(Args&&... args);
+        [[nodiscard]] bool TryPush(const T& element);
+        [[nodiscard]] bool TryPush(T&& element);
+        // Producer thread only. Wait while queue is full
+        template <typename... Args>
+        void Emplace(Args&&... args);
+        void Push(const T& element);
+        void Push(T&& element);
+
+        // Consumer thread only. Returns false if queue is empty
+        [[nodiscard]] bool TryPop(T& element);
+        // Consumer thread only. Waits while queue is empty
+        void Pop(T& element);
+
+        // Approximate while other threads push or pop
+        [[nodiscard]] size_t GetSize() const;
+        [[nodiscard]] bool IsEmpty() const;
+        [[nodiscard]] size_t GetCapacity() const;
+
+    private:
+        // Written by consumer
+        alignas(BLK_CACHE_LINE_SIZE) std::atomic<size_t> m_Head;
+        size_t m_CachedTail;
+        // Written by producer
+        alignas(BLK_CACHE_LINE_SIZE) std::atomic<size_t> m_Tail;
+        size_t m_CachedHead;
+        // Constant after construction
+        alignas(BLK_CACHE_LINE_SIZE) T* m_Slots;
+        size_t m_Mask;
+    };
+
+    // Bounded ring queue for any number of producer and consumer threads
+    // Every slot has sequence number that tells whether it is ready to be written or read at
+    // given position, so producers and consumers only contend on their own position counter
+    // TryPush and TryPop are lock-free, they retry only when other thread took same position
+    template <typename T>
+    class [[nodiscard]] MPMCQueue
+    {
+    public:
+        // Capacity is rounded up to power of two
+        explicit MPMCQueue(size_t capacity);
+        ~MPMCQueue();
+
+        MPMCQueue(const MPMCQueue&) = delete;
+        MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+        // Return false if queue is full, arguments are not used then
+        template <typename... Args>
+        [[nodiscard]] bool TryEmplace(Args&&... args);
+        [[nodiscard]] bool TryPush(const T& element);
+        [[nodiscard]] bool TryPush(T&& element);
+        // Wait while queue is full
+        template <typename... Args>
+        void Emplace(Args&&... args);
+        void Push(const T& element);
+        void Push(T&& element);
+
+        // Returns false if queue is empty
+        [[nodiscard]] bool TryPop(T& element);
+        // Waits while queue is empty
+        void Pop(T& element);
+
+        // Approximate while other threads push or pop
+        [[nodiscard]] size_t GetSize() const;
+        [[nodiscard]] bool IsEmpty() const;
+        [[nodiscard]] size_t GetCapacity() const;
+
+    private:
+        struct Slot
+        {
+            // Equals position when slot can be written, position + 1 when it can be read
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            [[nodiscard]] T* GetElement();
+        };
+
+        alignas(BLK_CACHE_LINE_SIZE) std::atomic<size_t> m_PushPosition;
+        alignas(BLK_CACHE_LINE_SIZE) std::atomic<size_t> m_PopPosition;
+        // Constant after construction
+        alignas(BLK_CACHE_LINE_SIZE) Slot* m_Slots;
+        size_t m_Mask;
+    };
+
+    inline QueueBackoff::QueueBackoff()
+        : m_Round(0)
+    {
+    }
+
+    inline void QueueBackoff::Wait()
+    {
+        if (m_Round < ms_SpinRounds)
+        {
+            for (uint32_t i = 0; i < (1u << m_Round); ++i)
+            {
+#ifdef BLK_USE_SSE
+                _mm_pause();
+#endif
+            }
+            ++m_Round;
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    template <typename T>
+    SPSCQueue<T>::SPSCQueue(size_t capacity)
+        : m_Head(0)
+        , m_CachedTail(0)
+        , m_Tail(0)
+        , m_CachedHead(0)
+        , m_Slots(nullptr)
+        , m_Mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+    {
+        m_Slots = std::allocator<T>().allocate(m_Mask + 1);
+    }
+
+    template <typename T>
+    SPSCQueue<T>::~SPSCQueue()
+    {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        for (size_t i = m_Head.load(std::memory_order_relaxed); i != tail; ++i)
+            std::destroy_at(m_Slots + (i & m_Mask));
+        std::allocator<T>().deallocate(m_Slots, m_Mask + 1);
+    }
+
+    template <typename T>
+    template <typename... Args>
+    bool SPSCQueue<T>::TryEmplace(Args&&... args)
+    {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_CachedHead > m_Mask)
+        {
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if (tail - m_CachedHead > m_Mask)
+                return false;
+        }
+
+        std::construct_at(m_Slots + (tail & m_Mask), std::forward<Args>(args)...);
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool SPSCQueue<T>::TryPush(const T& element)
+    {
+        return TryEmplace(element);
+    }
+
+    template <typename T>
+    bool SPSCQueue<T>::TryPush(T&& element)
+    {
+        return TryEmplace(std::move(element));
+    }
+
+    template <typename T>
+    template <typename... Args>
+    void SPSCQueue<T>::Emplace(Args&&... args)
+    {
+        // Arguments are only forwarded to constructor on successful attempt
+        QueueBackoff backoff;
+        while (!TryEmplace(std::forward<Args>(args)...))
+            backoff.Wait();
+    }
+
+    template <typename T>
+    void SPSCQueue<T>::Push(const T& element)
+    {
+        Emplace(element);
+    }
+
+    template <typename T>
+    void SPSCQueue<T>::Push(T&& element)
+    {
+        Emplace(std::move(element));
+    }
+
+    template <typename T>
+    bool SPSCQueue<T>::TryPop(T& element)
+    {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_CachedTail)
+        {
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if (head == m_CachedTail)
+                return false;
+        }
+
+        T* slot = m_Slots + (head & m_Mask);
+        element = std::move(*slot);
+        std::destroy_at(slot);
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    void SPSCQueue<T>::Pop(T& element)
+    {
+        QueueBackoff backoff;
+        while (!TryPop(element))
+            backoff.Wait();
+    }
+
+    template <typename T>
+    size_t SPSCQueue<T>::GetSize() const
+    {
+        // Head is loaded first, so that it is never ahead of tail
+        const size_t head = m_Head.load(std::memory_order_acquire);
+        const size_t tail = m_Tail.load(std::memory_order_acquire);
+        return std::min(tail - head, GetCapacity());
+    }
+
+    template <typename T>
+    bool SPSCQueue<T>::IsEmpty() const
+    {
+        return GetSize() == 0;
+    }
+
+    template <typename T>
+    size_t SPSCQueue<T>::GetCapacity() const
+    {
+        return m_Mask + 1;
+    }
+
+    template <typename T>
+    T* MPMCQueue<T>::Slot::GetElement()
+    {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    template <typename T>
+    MPMCQueue<T>::MPMCQueue(size_t capacity)
+        : m_PushPosition(0)
+        , m_PopPosition(0)
+        , m_Slots(nullptr)
+        , m_Mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+    {
+        m_Slots = new Slot[m_Mask + 1];
+        for (size_t i = 0; i <= m_Mask; ++i)
+            m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    MPMCQueue<T>::~MPMCQueue()
+    {
+        const size_t pushPosition = m_PushPosition.load(std::memory_order_relaxed);
+        for (size_t i = m_PopPosition.load(std::memory_order_relaxed); i != pushPosition; ++i)
+            std::destroy_at(m_Slots[i & m_Mask].GetElement());
+        delete[] m_Slots;
+    }
+
+    template <typename T>
+    template <typename... Args>
+    bool MPMCQueue<T>::TryEmplace(Args&&... args)
+    {
+        size_t position = m_PushPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = m_Slots[position & m_Mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const ptrdiff_t difference =
+                static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (m_PushPosition.compare_exchange_weak(position, position + 1,
+                                                         std::memory_order_relaxed))
+                {
+                    std::construct_at(slot.GetElement(), std::forward<Args>(args)...);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Slot still holds element from previous lap
+                return false;
+            }
+            else
+            {
+                position = m_PushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename T>
+    bool MPMCQueue<T>::TryPush(const T& element)
+    {
+        return TryEmplace(element);
+    }
+
+    template <typename T>
+    bool MPMCQueue<T>::TryPush(T&& element)
+    {
+        return TryEmplace(std::move(element));
+    }
+
+    template <typename T>
+    template <typename... Args>
+    void MPMCQueue<T>::Emplace(Args&&... args)
+    {
+        // Arguments are only forwarded to constructor on successful attempt
+        QueueBackoff backoff;
+        while (!TryEmplace(std::forward<Args>(args)...))
+            backoff.Wait();
+    }
+
+    template <typename T>
+    void MPMCQueue<T>::Push(const T& element)
+    {
+        Emplace(element);
+    }
+
+    template <typename T>
+    void MPMCQueue<T>::Push(T&& element)
+    {
+        Emplace(std::move(element));
+    }
+
+    template <typename T>
+    bool MPMCQueue<T>::TryPop(T& element)
+    {
+        size_t position = m_PopPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = m_Slots[position & m_Mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const ptrdiff_t difference =
+                static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position + 1);
+            if (difference == 0)
+            {
+                if (m_PopPosition.compare_exchange_weak(position, position + 1,
+                                                        std::memory_order_relaxed))
+                {
+                    T* stored = slot.GetElement();
+                    element = std::move(*stored);
+                    std::destroy_at(stored);
+                    // Slot becomes writable for position of next lap
+                    slot.sequence.store(position + m_Mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Slot wasn't written yet
+                return false;
+            }
+            else
+            {
+                position = m_PopPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename T>
+    void MPMCQueue<T>::Pop(T& element)
+    {
+        QueueBackoff backoff;
+        while (!TryPop(element))
+            backoff.Wait();
+    }
+
+    template <typename T>
+    size_t MPMCQueue<T>::GetSize() const
+    {
+        // Pop position is loaded first, so that it is never ahead of push position
+        const size_t popPosition = m_PopPosition.load(std::memory_order_acquire);
+        const size_t pushPosition = m_PushPosition.load(std::memory_order_acquire);
+        return std::min(pushPosition - popPosition, GetCapacity());
+    }
+
+    template <typename T>
+    bool MPMCQueue<T>::IsEmpty() const
+    {
+        return GetSize() == 0;
+    }
+
+    template <typename T>
+    size_t MPMCQueue<T>::GetCapacity() const
+    {
+        return m_Mask + 1;
+    }
+
+} // namespace Boolka
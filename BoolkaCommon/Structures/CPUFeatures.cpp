@@ -0,0 +1,67 @@
+#include "stdafx.h"
+
+#include "CPUFeatures.h"
+
+namespace Boolka
+{
+
+    struct CPUFeatureFlags
+    {
+        bool hasAVX2;
+        bool hasF16C;
+    };
+
+    static CPUFeatureFlags DetectCPUFeatures()
+    {
+        CPUFeatureFlags flags = {};
+
+#ifdef BLK_USE_SSE
+        int registers[4];
+        __cpuid(registers, 0);
+        const uint32_t maxLeaf = uint32_t(registers[0]);
+        if (maxLeaf < 1)
+            return flags;
+
+        // ECX of leaf 1: bit 27 - OSXSAVE, bit 28 - AVX, bit 29 - F16C
+        __cpuid(registers, 1);
+        const bool hasOSXSAVE = (registers[2] & (1 << 27)) != 0;
+        const bool hasAVXInstructions = (registers[2] & (1 << 28)) != 0;
+        const bool hasF16CInstructions = (registers[2] & (1 << 29)) != 0;
+        if (!hasOSXSAVE || !hasAVXInstructions)
+            return flags;
+
+        // XCR0 bits 1 and 2 are set when OS saves xmm and ymm registers on context switch
+        const uint64_t enabledStates = _xgetbv(0);
+        if ((enabledStates & 0x6) != 0x6)
+            return flags;
+
+        flags.hasF16C = hasF16CInstructions;
+
+        // EBX of leaf 7, subleaf 0: bit 5 - AVX2
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(registers, 7, 0);
+            flags.hasAVX2 = (registers[1] & (1 << 5)) != 0;
+        }
+#endif
+
+        return flags;
+    }
+
+    static const CPUFeatureFlags& GetCPUFeatureFlags()
+    {
+        static const CPUFeatureFlags flags = DetectCPUFeatures();
+        return flags;
+    }
+
+    bool CPUFeatures::HasAVX2()
+    {
+        return GetCPUFeatureFlags().hasAVX2;
+    }
+
+    bool CPUFeatures::HasF16C()
+    {
+        return GetCPUFeatureFlags().hasF16C;
+    }
+
+} // namespace Boolka
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Instruction sets that are checked at runtime
+    // Projects are built without /arch, kernels that use AVX2 or F16C are built in their own
+    // sources with /arch:AVX2 and should only be called when CPU supports them.
+    // CPU is queried with cpuid on first use.
+    class CPUFeatures
+    {
+    public:
+        // Also checks that OS saves upper halves of ymm registers
+        [[nodiscard]] static bool HasAVX2();
+        // F16C kernels are built with /arch:AVX2 as well, so they also need HasAVX2
+        [[nodiscard]] static bool HasF16C();
+    };
+
+} // namespace Boolka
@@ -0,0 +1,301 @@
+#include "stdafx.h"
+
+#include "ExactFrustum.h"
+
+#include "AABB.h"
+
+namespace Boolka
+{
+
+    static const size_t gs_PlaneCount = 6;
+    // Tolerance relative to largest corner coordinate
+    static const float gs_RelativeTolerance = 1e-5f;
+    // Axes shorter than that are cross products of parallel vectors and are skipped
+    static const float gs_MinAxisLengthSqr = 1e-12f;
+
+    // Bit of corner index that is selected by pair of opposite planes
+    // Near/far, left/right, top/bottom
+    static const size_t gs_PlanePairCornerBit[3] = {2, 0, 1};
+
+    static Vector4 GetPlane(const Frustum& frustum, size_t index)
+    {
+        const float* plane = frustum.GetBuffer() + index * 4;
+        return Vector4(plane, plane + 4);
+    }
+
+    // Intersection point of 3 planes, calculated in double precision
+    static Vector4 IntersectPlanes(const Vector4& first, const Vector4& second,
+                                   const Vector4& third)
+    {
+        const double n[3][3] = {{first.x(), first.y(), first.z()},
+                                {second.x(), second.y(), second.z()},
+                                {third.x(), third.y(), third.z()}};
+        const double w[3] = {first.w(), second.w(), third.w()};
+
+        auto cross = [](const double(&a)[3], const double(&b)[3], double(&result)[3]) {
+            result[0] = a[1] * b[2] - a[2] * b[1];
+            result[1] = a[2] * b[0] - a[0] * b[2];
+            result[2] = a[0] * b[1] - a[1] * b[0];
+        };
+
+        double cross12[3], cross20[3], cross01[3];
+        cross(n[1], n[2], cross12);
+        cross(n[2], n[0], cross20);
+        cross(n[0], n[1], cross01);
+
+        const double det = n[0][0] * cross12[0] + n[0][1] * cross12[1] + n[0][2] * cross12[2];
+        BLK_ASSERT(det != 0.0);
+
+        double point[3];
+        for (size_t i = 0; i < 3; ++i)
+            point[i] = -(w[0] * cross12[i] + w[1] * cross20[i] + w[2] * cross01[i]) / det;
+
+        return Vector4(static_cast<float>(point[0]), static_cast<float>(point[1]),
+                       static_cast<float>(point[2]), 1.0f);
+    }
+
+    static float CalculateDistanceSqrToSegment(const Vector4& point, const Vector4& start,
+                                               const Vector4& end)
+    {
+        const Vector4 segment = end - start;
+        const float segmentLengthSqr = segment.LengthSqr();
+        float t = 0.0f;
+        if (segmentLengthSqr > 0.0f)
+            t = std::clamp((point - start).Dot(segment) / segmentLengthSqr, 0.0f, 1.0f);
+        return (point - (start + segment * t)).LengthSqr();
+    }
+
+    ExactFrustum::ExactFrustum(const Matrix4x4& viewProj)
+        : ExactFrustum(Frustum(viewProj))
+    {
+    }
+
+    ExactFrustum::ExactFrustum(const Frustum& frustum)
+        : m_Frustum(frustum)
+        , m_AxisCount(0)
+        , m_Tolerance(0.0f)
+    {
+        CalculateCorners();
+        CalculateSeparatingAxes();
+    }
+
+    const Frustum& ExactFrustum::GetFrustum() const
+    {
+        return m_Frustum;
+    }
+
+    const Vector4& ExactFrustum::GetCorner(size_t index) const
+    {
+        BLK_ASSERT(index < ms_CornerCount);
+        return m_Corners[index];
+    }
+
+    bool ExactFrustum::CheckSphere(const Vector4& center, float radius) const
+    {
+        BLK_ASSERT(center.w() == 1.0f);
+
+        // Sphere that crosses at most one plane and is inside of the others intersects frustum
+        float distances[gs_PlaneCount];
+        size_t crossedPlaneCount = 0;
+        bool isCenterInside = true;
+        for (size_t i = 0; i < gs_PlaneCount; ++i)
+        {
+            distances[i] = GetPlane(m_Frustum, i).Dot(center);
+            if (distances[i] < -radius)
+                return false;
+            if (distances[i] < radius)
+                ++crossedPlaneCount;
+            if (distances[i] < 0.0f)
+                isCenterInside = false;
+        }
+
+        if (crossedPlaneCount <= 1 || isCenterInside)
+            return true;
+
+        // Closest point of frustum lies on face, that has center on its outer side
+        float minDistanceSqr = FLT_MAX;
+        for (size_t i = 0; i < gs_PlaneCount; ++i)
+        {
+            if (distances[i] < 0.0f)
+            {
+                minDistanceSqr =
+                    std::min(minDistanceSqr, CalculateDistanceSqrToFace(i, center, distances[i]));
+            }
+        }
+
+        const float maxDistance = radius + m_Tolerance;
+        return minDistanceSqr <= maxDistance * maxDistance;
+    }
+
+    bool ExactFrustum::CheckAABB(const AABB& boundingBox) const
+    {
+        BLK_ASSERT(boundingBox.GetMin().w() == 1.0f);
+        BLK_ASSERT(boundingBox.GetMax().w() == 1.0f);
+
+        const Vector4 zero;
+        const Vector4& aabbMin = boundingBox.GetMin();
+        const Vector4& aabbMax = boundingBox.GetMax();
+
+        // Box that crosses at most one plane and is inside of the others intersects frustum
+        size_t crossedPlaneCount = 0;
+        for (size_t i = 0; i < gs_PlaneCount; ++i)
+        {
+            const Vector4 plane = GetPlane(m_Frustum, i);
+            const Vector4 mask = plane > zero;
+            if (plane.Dot(aabbMin.Select(aabbMax, mask)) < 0.0f)
+                return false;
+            if (plane.Dot(aabbMax.Select(aabbMin, mask)) < 0.0f)
+                ++crossedPlaneCount;
+        }
+
+        if (crossedPlaneCount <= 1)
+            return true;
+
+        const Vector4 center = (aabbMin + aabbMax) * 0.5f;
+        const Vector4 extents = (aabbMax - aabbMin) * 0.5f;
+        for (size_t i = 0; i < m_AxisCount; ++i)
+        {
+            const SeparatingAxis& axis = m_Axes[i];
+            const float projectedCenter = axis.axis.Dot(center);
+            const float projectedExtent = axis.absAxis.Dot(extents);
+            if (projectedCenter - projectedExtent > axis.max ||
+                projectedCenter + projectedExtent < axis.min)
+                return false;
+        }
+
+        return true;
+    }
+
+    void ExactFrustum::CalculateCorners()
+    {
+        const Vector4 planes[gs_PlaneCount] = {
+            GetPlane(m_Frustum, 0), GetPlane(m_Frustum, 1), GetPlane(m_Frustum, 2),
+            GetPlane(m_Frustum, 3), GetPlane(m_Frustum, 4), GetPlane(m_Frustum, 5),
+        };
+
+        float maxCoordinate = 0.0f;
+        for (size_t i = 0; i < ms_CornerCount; ++i)
+        {
+            const size_t leftRight = i & 1;
+            const size_t topBottom = (i >> 1) & 1;
+            const size_t nearFar = (i >> 2) & 1;
+            m_Corners[i] =
+                IntersectPlanes(planes[nearFar], planes[2 + leftRight], planes[4 + topBottom]);
+
+            for (size_t axis = 0; axis < 3; ++axis)
+                maxCoordinate = std::max(maxCoordinate, ::abs(m_Corners[i][axis]));
+        }
+
+        m_Tolerance = maxCoordinate * gs_RelativeTolerance;
+    }
+
+    void ExactFrustum::CalculateSeparatingAxes()
+    {
+        m_AxisCount = 0;
+
+        for (size_t i = 0; i < gs_PlaneCount; ++i)
+        {
+            Vector4 normal = GetPlane(m_Frustum, i);
+            normal.w() = 0.0f;
+            AddSeparatingAxis(normal);
+        }
+
+        const Vector4 boxAxes[3] = {
+            {1.0f, 0.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f, 0.0f},
+        };
+        for (const Vector4& boxAxis : boxAxes)
+            AddSeparatingAxis(boxAxis);
+
+        // Every edge connects corners that differ in single bit
+        for (size_t corner = 0; corner < ms_CornerCount; ++corner)
+        {
+            for (size_t bit = 0; bit < 3; ++bit)
+            {
+                const size_t otherCorner = corner | (size_t(1) << bit);
+                if (otherCorner == corner)
+                    continue;
+
+                const Vector4 edge = m_Corners[otherCorner] - m_Corners[corner];
+                for (const Vector4& boxAxis : boxAxes)
+                    AddSeparatingAxis(boxAxis.Cross(edge));
+            }
+        }
+    }
+
+    void ExactFrustum::AddSeparatingAxis(const Vector4& axis)
+    {
+        BLK_ASSERT(m_AxisCount < ms_MaxAxisCount);
+
+        float lengthSqr = axis.LengthSqr();
+        if (lengthSqr < gs_MinAxisLengthSqr)
+            return;
+
+        const Vector4 normalized = axis / ::sqrt(lengthSqr);
+
+        // Parallel edges give same axes
+        for (size_t i = 0; i < m_AxisCount; ++i)
+        {
+            if (m_Axes[i].axis.Cross(normalized).LengthSqr() < gs_MinAxisLengthSqr)
+                return;
+        }
+
+        SeparatingAxis& result = m_Axes[m_AxisCount++];
+        result.axis = normalized;
+        result.absAxis = Vector4(::abs(normalized.x()), ::abs(normalized.y()),
+                                 ::abs(normalized.z()), 0.0f);
+        result.min = FLT_MAX;
+        result.max = -FLT_MAX;
+        for (const Vector4& corner : m_Corners)
+        {
+            const float projection = normalized.Dot(corner);
+            result.min = std::min(result.min, projection);
+            result.max = std::max(result.max, projection);
+        }
+        result.min -= m_Tolerance;
+        result.max += m_Tolerance;
+    }
+
+    float ExactFrustum::CalculateDistanceSqrToFace(size_t plane, const Vector4& point,
+                                                   float distanceToPlane) const
+    {
+        const size_t pair = plane / 2;
+        const size_t side = plane % 2;
+
+        // Point projected on face plane is inside of face if it is inside of 4 neighbour planes
+        Vector4 normal = GetPlane(m_Frustum, plane);
+        normal.w() = 0.0f;
+        const Vector4 projected = point - normal * distanceToPlane;
+        bool isInsideFace = true;
+        for (size_t i = 0; i < gs_PlaneCount; ++i)
+        {
+            if (i / 2 != pair && GetPlane(m_Frustum, i).Dot(projected) < 0.0f)
+            {
+                isInsideFace = false;
+                break;
+            }
+        }
+
+        if (isInsideFace)
+            return distanceToPlane * distanceToPlane;
+
+        // Corners of face in order around it
+        const size_t fixedBit = gs_PlanePairCornerBit[pair];
+        const size_t firstBit = size_t(1) << ((fixedBit + 1) % 3);
+        const size_t secondBit = size_t(1) << ((fixedBit + 2) % 3);
+        const size_t base = side << fixedBit;
+        const size_t faceCorners[4] = {base, base | firstBit, base | firstBit | secondBit,
+                                       base | secondBit};
+
+        float result = FLT_MAX;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result = std::min(result,
+                              CalculateDistanceSqrToSegment(point, m_Corners[faceCorners[i]],
+                                                            m_Corners[faceCorners[(i + 1) % 4]]));
+        }
+        return result;
+    }
+
+} // namespace Boolka
@@ -0,0 +1,69 @@
+#pragma once
+#include "Frustum.h"
+
+namespace Boolka
+{
+
+    class AABB;
+
+    // Frustum with additional data for exact intersection tests
+    // Plane tests of Frustum accept some geometry that is outside of frustum near its edges and
+    // corners. Here such cases are resolved with separating axis test for boxes and with distance
+    // to frustum faces for spheres. Plane tests run first, so only geometry that crosses at least
+    // 2 planes pays for exact test
+    class [[nodiscard]] ExactFrustum
+    {
+    public:
+        ExactFrustum() = default;
+        ~ExactFrustum() = default;
+
+        ExactFrustum(const Matrix4x4& viewProj);
+        ExactFrustum(const Frustum& frustum);
+
+        [[nodiscard]] const Frustum& GetFrustum() const;
+
+        // Corner is intersection of 3 planes, bits of index select them
+        // bit 0 - left/right
+        // bit 1 - top/bottom
+        // bit 2 - near/far
+        [[nodiscard]] const Vector4& GetCorner(size_t index) const;
+
+        // Return false if tested geometry is completely outside frustum, and true otherwise
+        // Plane tests are same as in Frustum, so geometry rejected by Frustum fast tests is
+        // rejected here too. Exact part uses small tolerance, so that rounding errors never cull
+        // geometry crossing frustum edges
+        [[nodiscard]] bool CheckSphere(const Vector4& center, float radius) const;
+        [[nodiscard]] bool CheckAABB(const AABB& boundingBox) const;
+
+    private:
+        struct SeparatingAxis
+        {
+            Vector4 axis;
+            // Axis with absolute values of components, used to project box extents
+            Vector4 absAxis;
+            // Projection of frustum on axis, extended by tolerance
+            float min;
+            float max;
+        };
+
+        static constexpr size_t ms_CornerCount = 8;
+        static constexpr size_t ms_EdgeCount = 12;
+        // 6 plane normals, 3 box axes and cross products of box axes with frustum edges
+        static constexpr size_t ms_MaxAxisCount = 6 + 3 + 3 * ms_EdgeCount;
+
+        void CalculateCorners();
+        void CalculateSeparatingAxes();
+        void AddSeparatingAxis(const Vector4& axis);
+
+        [[nodiscard]] float CalculateDistanceSqrToFace(size_t plane, const Vector4& point,
+                                                       float distanceToPlane) const;
+
+        Frustum m_Frustum;
+        Vector4 m_Corners[ms_CornerCount];
+        SeparatingAxis m_Axes[ms_MaxAxisCount];
+        size_t m_AxisCount;
+        // Absolute tolerance, proportional to size and distance of frustum from origin
+        float m_Tolerance;
+    };
+
+} // namespace Boolka
@@ -0,0 +1,285 @@
+#include "stdafx.h"
+
+#include "FastMath.h"
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+namespace Boolka
+{
+
+#ifdef BLK_USE_SSE
+
+    // pi / 2 split in 3 parts, first 2 parts have few mantissa bits, so that their products with
+    // quadrant index are exact (Cody-Waite reduction)
+    static const float gs_HalfPiPart1 = 1.5703125f;
+    static const float gs_HalfPiPart2 = 4.837512969970703125e-4f;
+    static const float gs_HalfPiPart3 = 7.54978995489188216e-8f;
+    static const float gs_TwoOverPi = 0.636619772367581343f;
+    // BLK_FLOAT_PI isn't precise enough here
+    static const float gs_HalfPi = 1.57079632679489662f;
+    static const float gs_QuarterPi = 0.785398163397448310f;
+
+    // Minimax polynomials for [-pi / 4, pi / 4], from Cephes library
+    static const float gs_SinCoefficients[3] = {-1.6666654611e-1f, 8.3321608736e-3f,
+                                                -1.9515295891e-4f};
+    static const float gs_CosCoefficients[3] = {4.166664568298827e-2f, -1.388731625493765e-3f,
+                                                2.443315711809948e-5f};
+    // Minimax polynomial for [-tan(pi / 8), tan(pi / 8)], from Cephes library
+    static const float gs_AtanCoefficients[4] = {-3.33329491539e-1f, 1.99777106478e-1f,
+                                                 -1.38776856032e-1f, 8.05374449538e-2f};
+    static const float gs_TanThreeEighthsPi = 2.414213562373095f;
+    static const float gs_TanEighthPi = 0.4142135623730950f;
+
+    static __m128 Set(float value)
+    {
+        return _mm_set1_ps(value);
+    }
+
+    // Hardware estimate has 12 bits of precision, single Newton step doubles that
+    static __m128 RsqrtSSE(__m128 x)
+    {
+        const __m128 estimate = _mm_rsqrt_ps(x);
+        const __m128 halfX = _mm_mul_ps(x, Set(0.5f));
+        const __m128 correction =
+            _mm_sub_ps(Set(1.5f), _mm_mul_ps(halfX, _mm_mul_ps(estimate, estimate)));
+        return _mm_mul_ps(estimate, correction);
+    }
+
+    static __m128 RcpSSE(__m128 x)
+    {
+        const __m128 estimate = _mm_rcp_ps(x);
+        const __m128 error = _mm_sub_ps(Set(1.0f), _mm_mul_ps(x, estimate));
+        return _mm_add_ps(estimate, _mm_mul_ps(estimate, error));
+    }
+
+    static void SinCosSSE(__m128 x, __m128& sin, __m128& cos)
+    {
+        // x = reduced + quadrant * pi / 2, reduced is in [-pi / 4, pi / 4]
+        const __m128 quadrant = _mm_round_ps(_mm_mul_ps(x, Set(gs_TwoOverPi)),
+                                             _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m128 reduced = _mm_sub_ps(x, _mm_mul_ps(quadrant, Set(gs_HalfPiPart1)));
+        reduced = _mm_sub_ps(reduced, _mm_mul_ps(quadrant, Set(gs_HalfPiPart2)));
+        reduced = _mm_sub_ps(reduced, _mm_mul_ps(quadrant, Set(gs_HalfPiPart3)));
+
+        const __m128 reducedSqr = _mm_mul_ps(reduced, reduced);
+
+        __m128 sinPolynomial = Set(gs_SinCoefficients[2]);
+        sinPolynomial =
+            _mm_add_ps(_mm_mul_ps(sinPolynomial, reducedSqr), Set(gs_SinCoefficients[1]));
+        sinPolynomial =
+            _mm_add_ps(_mm_mul_ps(sinPolynomial, reducedSqr), Set(gs_SinCoefficients[0]));
+        const __m128 reducedSin = _mm_add_ps(
+            reduced, _mm_mul_ps(_mm_mul_ps(reduced, reducedSqr), sinPolynomial));
+
+        __m128 cosPolynomial = Set(gs_CosCoefficients[2]);
+        cosPolynomial =
+            _mm_add_ps(_mm_mul_ps(cosPolynomial, reducedSqr), Set(gs_CosCoefficients[1]));
+        cosPolynomial =
+            _mm_add_ps(_mm_mul_ps(cosPolynomial, reducedSqr), Set(gs_CosCoefficients[0]));
+        const __m128 reducedCos =
+            _mm_add_ps(_mm_sub_ps(Set(1.0f), _mm_mul_ps(reducedSqr, Set(0.5f))),
+                       _mm_mul_ps(_mm_mul_ps(reducedSqr, reducedSqr), cosPolynomial));
+
+        // Odd quadrants swap sin and cos, sin is negative in quadrants 2 and 3, cos is negative
+        // in quadrants 1 and 2
+        const __m128i quadrantIndex = _mm_cvtps_epi32(quadrant);
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(
+            _mm_and_si128(quadrantIndex, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        const __m128 sinSign = _mm_castsi128_ps(
+            _mm_slli_epi32(_mm_and_si128(quadrantIndex, _mm_set1_epi32(2)), 30));
+        const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(
+            _mm_and_si128(_mm_add_epi32(quadrantIndex, _mm_set1_epi32(1)), _mm_set1_epi32(2)),
+            30));
+
+        sin = _mm_xor_ps(_mm_blendv_ps(reducedSin, reducedCos, swap), sinSign);
+        cos = _mm_xor_ps(_mm_blendv_ps(reducedCos, reducedSin, swap), cosSign);
+    }
+
+    static __m128 AtanSSE(__m128 x)
+    {
+        const __m128 signMask = Set(-0.0f);
+        const __m128 sign = _mm_and_ps(x, signMask);
+        const __m128 absX = _mm_andnot_ps(signMask, x);
+
+        // atan(x) = pi / 2 + atan(-1 / x) = pi / 4 + atan((x - 1) / (x + 1))
+        const __m128 isLarge = _mm_cmpgt_ps(absX, Set(gs_TanThreeEighthsPi));
+        const __m128 isMedium = _mm_cmpgt_ps(absX, Set(gs_TanEighthPi));
+        const __m128 largeReduced = _mm_div_ps(Set(-1.0f), absX);
+        const __m128 mediumReduced =
+            _mm_div_ps(_mm_sub_ps(absX, Set(1.0f)), _mm_add_ps(absX, Set(1.0f)));
+        __m128 reduced = _mm_blendv_ps(absX, mediumReduced, isMedium);
+        reduced = _mm_blendv_ps(reduced, largeReduced, isLarge);
+        __m128 offset = _mm_and_ps(isMedium, Set(gs_QuarterPi));
+        offset = _mm_blendv_ps(offset, Set(gs_HalfPi), isLarge);
+
+        const __m128 reducedSqr = _mm_mul_ps(reduced, reduced);
+        __m128 polynomial = Set(gs_AtanCoefficients[3]);
+        for (int i = 2; i >= 0; --i)
+        {
+            polynomial =
+                _mm_add_ps(_mm_mul_ps(polynomial, reducedSqr), Set(gs_AtanCoefficients[i]));
+        }
+        const __m128 result = _mm_add_ps(
+            offset,
+            _mm_add_ps(reduced, _mm_mul_ps(_mm_mul_ps(reduced, reducedSqr), polynomial)));
+
+        return _mm_xor_ps(result, sign);
+    }
+
+    float FastMath::Rsqrt(float x)
+    {
+        return _mm_cvtss_f32(RsqrtSSE(_mm_set_ss(x)));
+    }
+
+    float FastMath::Rcp(float x)
+    {
+        return _mm_cvtss_f32(RcpSSE(_mm_set_ss(x)));
+    }
+
+    float FastMath::Sin(float x)
+    {
+        __m128 sin, cos;
+        SinCosSSE(_mm_set_ss(x), sin, cos);
+        return _mm_cvtss_f32(sin);
+    }
+
+    float FastMath::Cos(float x)
+    {
+        __m128 sin, cos;
+        SinCosSSE(_mm_set_ss(x), sin, cos);
+        return _mm_cvtss_f32(cos);
+    }
+
+    void FastMath::SinCos(float x, float& sin, float& cos)
+    {
+        __m128 sinResult, cosResult;
+        SinCosSSE(_mm_set_ss(x), sinResult, cosResult);
+        sin = _mm_cvtss_f32(sinResult);
+        cos = _mm_cvtss_f32(cosResult);
+    }
+
+    float FastMath::Atan(float x)
+    {
+        return _mm_cvtss_f32(AtanSSE(_mm_set_ss(x)));
+    }
+
+    Vector4 FastMath::Rsqrt(const Vector4& x)
+    {
+        return RsqrtSSE(x.GetInternal());
+    }
+
+    Vector4 FastMath::Rcp(const Vector4& x)
+    {
+        return RcpSSE(x.GetInternal());
+    }
+
+    Vector4 FastMath::Sin(const Vector4& x)
+    {
+        __m128 sin, cos;
+        SinCosSSE(x.GetInternal(), sin, cos);
+        return sin;
+    }
+
+    Vector4 FastMath::Cos(const Vector4& x)
+    {
+        __m128 sin, cos;
+        SinCosSSE(x.GetInternal(), sin, cos);
+        return cos;
+    }
+
+    void FastMath::SinCos(const Vector4& x, Vector4& sin, Vector4& cos)
+    {
+        SinCosSSE(x.GetInternal(), sin.GetInternal(), cos.GetInternal());
+    }
+
+    Vector4 FastMath::Atan(const Vector4& x)
+    {
+        return AtanSSE(x.GetInternal());
+    }
+
+#else
+
+    float FastMath::Rsqrt(float x)
+    {
+        return 1.0f / ::sqrt(x);
+    }
+
+    float FastMath::Rcp(float x)
+    {
+        return 1.0f / x;
+    }
+
+    float FastMath::Sin(float x)
+    {
+        return ::sin(x);
+    }
+
+    float FastMath::Cos(float x)
+    {
+        return ::cos(x);
+    }
+
+    void FastMath::SinCos(float x, float& sin, float& cos)
+    {
+        sin = ::sin(x);
+        cos = ::cos(x);
+    }
+
+    float FastMath::Atan(float x)
+    {
+        return ::atan(x);
+    }
+
+    template <typename Function>
+    static Vector4 TransformComponents(const Vector4& x, Function function)
+    {
+        return Vector4(function(x.x()), function(x.y()), function(x.z()), function(x.w()));
+    }
+
+    Vector4 FastMath::Rsqrt(const Vector4& x)
+    {
+        return TransformComponents(x, [](float value) { return Rsqrt(value); });
+    }
+
+    Vector4 FastMath::Rcp(const Vector4& x)
+    {
+        return TransformComponents(x, [](float value) { return Rcp(value); });
+    }
+
+    Vector4 FastMath::Sin(const Vector4& x)
+    {
+        return TransformComponents(x, [](float value) { return Sin(value); });
+    }
+
+    Vector4 FastMath::Cos(const Vector4& x)
+    {
+        return TransformComponents(x, [](float value) { return Cos(value); });
+    }
+
+    void FastMath::SinCos(const Vector4& x, Vector4& sin, Vector4& cos)
+    {
+        sin = Sin(x);
+        cos = Cos(x);
+    }
+
+    Vector4 FastMath::Atan(const Vector4& x)
+    {
+        return TransformComponents(x, [](float value) { return Atan(value); });
+    }
+
+#endif
+
+    float FastMath::Length3(const Vector4& vector)
+    {
+        const float lengthSqr = vector.Length3Sqr();
+        return lengthSqr * Rsqrt(lengthSqr);
+    }
+
+    Vector4 FastMath::Normalize3(const Vector4& vector)
+    {
+        return vector * Rsqrt(vector.Length3Sqr());
+    }
+
+} // namespace Boolka
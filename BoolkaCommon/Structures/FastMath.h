@@ -0,0 +1,42 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Approximate versions of math functions for hot loops that tolerate small error
+    // Exact functions (::sqrt, ::sin, Vector::Length3Slow, etc.) are not affected
+    // Vector4 versions work on every component independently
+    // Without BLK_USE_SSE exact functions are used, which is within same error bounds
+    class FastMath
+    {
+    public:
+        // Relative error, x should be positive normal number
+        static constexpr float ms_RsqrtMaxRelativeError = 5e-7f;
+        // Relative error, |x| should be in [FLT_MIN, 2^126]
+        static constexpr float ms_RcpMaxRelativeError = 3e-7f;
+        // Absolute error for |x| <= ms_SinCosMaxArgument
+        static constexpr float ms_SinCosMaxError = 1.5e-7f;
+        static constexpr float ms_SinCosMaxArgument = 8192.0f;
+        // Absolute error, any x
+        static constexpr float ms_AtanMaxError = 2e-7f;
+
+        [[nodiscard]] static float Rsqrt(float x);
+        [[nodiscard]] static float Rcp(float x);
+        [[nodiscard]] static float Sin(float x);
+        [[nodiscard]] static float Cos(float x);
+        static void SinCos(float x, float& sin, float& cos);
+        [[nodiscard]] static float Atan(float x);
+
+        [[nodiscard]] static Vector4 Rsqrt(const Vector4& x);
+        [[nodiscard]] static Vector4 Rcp(const Vector4& x);
+        [[nodiscard]] static Vector4 Sin(const Vector4& x);
+        [[nodiscard]] static Vector4 Cos(const Vector4& x);
+        static void SinCos(const Vector4& x, Vector4& sin, Vector4& cos);
+        [[nodiscard]] static Vector4 Atan(const Vector4& x);
+
+        // Use rsqrt with error of ms_RsqrtMaxRelativeError, vector length should be positive
+        [[nodiscard]] static float Length3(const Vector4& vector);
+        [[nodiscard]] static Vector4 Normalize3(const Vector4& vector);
+    };
+
+} // namespace Boolka
@@ -0,0 +1,246 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Vector with inline storage for up to capacity elements, never allocates
+    // Adding elements past capacity is an error
+    template <typename T, size_t capacity>
+    class [[nodiscard]] FixedVector
+    {
+    public:
+        FixedVector();
+        ~FixedVector();
+
+        FixedVector(std::initializer_list<T> elements);
+        FixedVector(const FixedVector& other);
+        FixedVector(FixedVector&& other) noexcept;
+        FixedVector& operator=(const FixedVector& other);
+        FixedVector& operator=(FixedVector&& other) noexcept;
+
+        T& Add(const T& element);
+        T& Add(T&& element);
+        template <typename... Args>
+        T& Emplace(Args&&... args);
+        void RemoveLast();
+        // New elements are value initialized
+        void Resize(size_t size);
+        void Clear();
+
+        [[nodiscard]] size_t GetSize() const;
+        [[nodiscard]] static constexpr size_t GetCapacity();
+        [[nodiscard]] bool IsEmpty() const;
+        [[nodiscard]] bool IsFull() const;
+
+        [[nodiscard]] T* GetData();
+        [[nodiscard]] const T* GetData() const;
+        [[nodiscard]] T& operator[](size_t index);
+        [[nodiscard]] const T& operator[](size_t index) const;
+        [[nodiscard]] T& GetLast();
+        [[nodiscard]] const T& GetLast() const;
+
+        [[nodiscard]] T* begin();
+        [[nodiscard]] T* end();
+        [[nodiscard]] const T* begin() const;
+        [[nodiscard]] const T* end() const;
+
+    private:
+        alignas(T) unsigned char m_Storage[sizeof(T) * capacity];
+        size_t m_Size;
+    };
+
+    template <typename T, size_t capacity>
+    FixedVector<T, capacity>::FixedVector()
+        : m_Size(0)
+    {
+    }
+
+    template <typename T, size_t capacity>
+    FixedVector<T, capacity>::~FixedVector()
+    {
+        Clear();
+    }
+
+    template <typename T, size_t capacity>
+    FixedVector<T, capacity>::FixedVector(std::initializer_list<T> elements)
+        : m_Size(0)
+    {
+        for (const T& element : elements)
+            Add(element);
+    }
+
+    template <typename T, size_t capacity>
+    FixedVector<T, capacity>::FixedVector(const FixedVector& other)
+        : m_Size(0)
+    {
+        for (const T& element : other)
+            Add(element);
+    }
+
+    template <typename T, size_t capacity>
+    FixedVector<T, capacity>::FixedVector(FixedVector&& other) noexcept
+        : m_Size(0)
+    {
+        for (T& element : other)
+            Add(std::move(element));
+        other.Clear();
+    }
+
+    template <typename T, size_t capacity>
+    FixedVector<T, capacity>& FixedVector<T, capacity>::operator=(const FixedVector& other)
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        for (const T& element : other)
+            Add(element);
+        return *this;
+    }
+
+    template <typename T, size_t capacity>
+    FixedVector<T, capacity>& FixedVector<T, capacity>::operator=(FixedVector&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        for (T& element : other)
+            Add(std::move(element));
+        other.Clear();
+        return *this;
+    }
+
+    template <typename T, size_t capacity>
+    T& FixedVector<T, capacity>::Add(const T& element)
+    {
+        return Emplace(element);
+    }
+
+    template <typename T, size_t capacity>
+    T& FixedVector<T, capacity>::Add(T&& element)
+    {
+        return Emplace(std::move(element));
+    }
+
+    template <typename T, size_t capacity>
+    template <typename... Args>
+    T& FixedVector<T, capacity>::Emplace(Args&&... args)
+    {
+        BLK_ASSERT(m_Size < capacity);
+        T* element = std::construct_at(GetData() + m_Size, std::forward<Args>(args)...);
+        ++m_Size;
+        return *element;
+    }
+
+    template <typename T, size_t capacity>
+    void FixedVector<T, capacity>::RemoveLast()
+    {
+        BLK_ASSERT(m_Size != 0);
+        std::destroy_at(GetData() + --m_Size);
+    }
+
+    template <typename T, size_t capacity>
+    void FixedVector<T, capacity>::Resize(size_t size)
+    {
+        BLK_ASSERT(size <= capacity);
+        while (m_Size > size)
+            RemoveLast();
+        while (m_Size < size)
+            Emplace();
+    }
+
+    template <typename T, size_t capacity>
+    void FixedVector<T, capacity>::Clear()
+    {
+        std::destroy_n(GetData(), m_Size);
+        m_Size = 0;
+    }
+
+    template <typename T, size_t capacity>
+    size_t FixedVector<T, capacity>::GetSize() const
+    {
+        return m_Size;
+    }
+
+    template <typename T, size_t capacity>
+    constexpr size_t FixedVector<T, capacity>::GetCapacity()
+    {
+        return capacity;
+    }
+
+    template <typename T, size_t capacity>
+    bool FixedVector<T, capacity>::IsEmpty() const
+    {
+        return m_Size == 0;
+    }
+
+    template <typename T, size_t capacity>
+    bool FixedVector<T, capacity>::IsFull() const
+    {
+        return m_Size == capacity;
+    }
+
+    template <typename T, size_t capacity>
+    T* FixedVector<T, capacity>::GetData()
+    {
+        return std::launder(reinterpret_cast<T*>(m_Storage));
+    }
+
+    template <typename T, size_t capacity>
+    const T* FixedVector<T, capacity>::GetData() const
+    {
+        return std::launder(reinterpret_cast<const T*>(m_Storage));
+    }
+
+    template <typename T, size_t capacity>
+    T& FixedVector<T, capacity>::operator[](size_t index)
+    {
+        BLK_ASSERT(index < m_Size);
+        return GetData()[index];
+    }
+
+    template <typename T, size_t capacity>
+    const T& FixedVector<T, capacity>::operator[](size_t index) const
+    {
+        BLK_ASSERT(index < m_Size);
+        return GetData()[index];
+    }
+
+    template <typename T, size_t capacity>
+    T& FixedVector<T, capacity>::GetLast()
+    {
+        return (*this)[m_Size - 1];
+    }
+
+    template <typename T, size_t capacity>
+    const T& FixedVector<T, capacity>::GetLast() const
+    {
+        return (*this)[m_Size - 1];
+    }
+
+    template <typename T, size_t capacity>
+    T* FixedVector<T, capacity>::begin()
+    {
+        return GetData();
+    }
+
+    template <typename T, size_t capacity>
+    T* FixedVector<T, capacity>::end()
+    {
+        return GetData() + m_Size;
+    }
+
+    template <typename T, size_t capacity>
+    const T* FixedVector<T, capacity>::begin() const
+    {
+        return GetData();
+    }
+
+    template <typename T, size_t capacity>
+    const T* FixedVector<T, capacity>::end() const
+    {
+        return GetData() + m_Size;
+    }
+
+} // namespace Boolka
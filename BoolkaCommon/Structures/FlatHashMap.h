@@ -0,0 +1,606 @@
+#pragma once
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+namespace Boolka
+{
+
+    // Control bytes of 16 consecutive slots, that are tested against hash with single SSE compare
+    class FlatHashMapGroup
+    {
+    public:
+        static constexpr size_t ms_Width = 16;
+
+        // Full slots store low 7 bits of hash, so that most mismatching keys are never compared
+        static constexpr int8_t ms_Empty = -128;
+        static constexpr int8_t ms_Deleted = -2;
+
+        // Bit i is set if control byte i equals value
+        [[nodiscard]] static uint32_t Match(const int8_t* control, int8_t value);
+        [[nodiscard]] static uint32_t MatchEmpty(const int8_t* control);
+        [[nodiscard]] static uint32_t MatchEmptyOrDeleted(const int8_t* control);
+        [[nodiscard]] static uint32_t MatchFull(const int8_t* control);
+
+        // std::hash of integers and pointers is identity in some standard libraries, mixing
+        // makes both group index (high bits) and control byte (low bits) depend on all key bits
+        [[nodiscard]] static uint64_t MixHash(uint64_t hash);
+    };
+
+    // Open addressing hash map that stores entries in single array without per entry allocation
+    // Slots are split into groups of 16, control bytes of group are probed at once with SSE and
+    // only keys whose control byte matches hash are compared. Table is grown at 7/8 load
+    // Insertion and rehash invalidate pointers to values and iterators, erase doesn't
+    // Keys shouldn't be modified through iterators
+    template <typename Key, typename Value, typename Hash = std::hash<Key>,
+              typename KeyEqual = std::equal_to<Key>>
+    class [[nodiscard]] FlatHashMap
+    {
+    public:
+        struct Entry
+        {
+            Key key;
+            Value value;
+        };
+
+        template <bool isConst>
+        class [[nodiscard]] Iterator
+        {
+        public:
+            using MapType = std::conditional_t<isConst, const FlatHashMap, FlatHashMap>;
+            using EntryType = std::conditional_t<isConst, const Entry, Entry>;
+
+            Iterator(MapType* map, size_t index)
+                : m_Map(map)
+                , m_Index(index)
+            {
+            }
+
+            [[nodiscard]] EntryType& operator*() const
+            {
+                BLK_ASSERT(m_Index < m_Map->m_Capacity && m_Map->m_Control[m_Index] >= 0);
+                return m_Map->m_Entries[m_Index];
+            }
+
+            [[nodiscard]] EntryType* operator->() const
+            {
+                return &**this;
+            }
+
+            Iterator& operator++()
+            {
+                m_Index = m_Map->FindNextFull(m_Index + 1);
+                return *this;
+            }
+
+            [[nodiscard]] bool operator==(const Iterator& other) const
+            {
+                return m_Index == other.m_Index;
+            }
+
+            [[nodiscard]] bool operator!=(const Iterator& other) const
+            {
+                return m_Index != other.m_Index;
+            }
+
+        private:
+            MapType* m_Map;
+            size_t m_Index;
+        };
+
+        FlatHashMap();
+        ~FlatHashMap();
+
+        FlatHashMap(const FlatHashMap& other);
+        FlatHashMap(FlatHashMap&& other) noexcept;
+        FlatHashMap& operator=(const FlatHashMap& other);
+        FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+
+        // Returns nullptr if key isn't in map
+        [[nodiscard]] Value* Find(const Key& key);
+        [[nodiscard]] const Value* Find(const Key& key) const;
+        [[nodiscard]] bool Contains(const Key& key) const;
+
+        // Constructs value from arguments if key isn't in map yet, otherwise map is not changed
+        // Returns value of key and whether it was inserted
+        template <typename... Args>
+        std::pair<Value*, bool> Emplace(const Key& key, Args&&... args);
+        // Inserts default constructed value if key isn't in map yet
+        Value& operator[](const Key& key);
+        // Returns whether key was in map
+        bool Erase(const Key& key);
+
+        // Keeps allocated memory
+        void Clear();
+        // Frees all memory
+        void Release();
+        // Allocates enough slots to insert count keys without rehash
+        void Reserve(size_t count);
+
+        [[nodiscard]] size_t GetSize() const;
+        [[nodiscard]] bool IsEmpty() const;
+        [[nodiscard]] size_t GetCapacity() const;
+
+        [[nodiscard]] Iterator<false> begin();
+        [[nodiscard]] Iterator<false> end();
+        [[nodiscard]] Iterator<true> begin() const;
+        [[nodiscard]] Iterator<true> end() const;
+
+    private:
+        static constexpr size_t ms_InvalidIndex = SIZE_MAX;
+
+        [[nodiscard]] static size_t GetCapacityLimit(size_t capacity);
+        [[nodiscard]] static size_t GetCapacityForCount(size_t count);
+
+        [[nodiscard]] uint64_t GetHash(const Key& key) const;
+        [[nodiscard]] size_t FindIndex(const Key& key, uint64_t hash) const;
+        // First empty or deleted slot in probe sequence of hash
+        [[nodiscard]] size_t FindInsertIndex(uint64_t hash) const;
+        [[nodiscard]] size_t FindNextFull(size_t index) const;
+        void Rehash(size_t capacity);
+        void Allocate(size_t capacity);
+        void DestroyEntries();
+        void Deallocate();
+
+        int8_t* m_Control;
+        Entry* m_Entries;
+        size_t m_Capacity;
+        size_t m_Size;
+        // Empty slots that can be filled before table reaches maximum load
+        size_t m_GrowthLeft;
+        Hash m_Hash;
+        KeyEqual m_KeyEqual;
+    };
+
+#ifdef BLK_USE_SSE
+
+    inline uint32_t FlatHashMapGroup::Match(const int8_t* control, int8_t value)
+    {
+        const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+        const __m128i matches = _mm_cmpeq_epi8(group, _mm_set1_epi8(value));
+        return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+    }
+
+    inline uint32_t FlatHashMapGroup::MatchEmpty(const int8_t* control)
+    {
+        return Match(control, ms_Empty);
+    }
+
+    inline uint32_t FlatHashMapGroup::MatchEmptyOrDeleted(const int8_t* control)
+    {
+        // Both special values are less than -1, full slots are not negative
+        const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+        const __m128i matches = _mm_cmpgt_epi8(_mm_set1_epi8(-1), group);
+        return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+    }
+
+    inline uint32_t FlatHashMapGroup::MatchFull(const int8_t* control)
+    {
+        const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+        return static_cast<uint32_t>(~_mm_movemask_epi8(group)) & 0xFFFFu;
+    }
+
+#else
+
+    inline uint32_t FlatHashMapGroup::Match(const int8_t* control, int8_t value)
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < ms_Width; ++i)
+            result |= static_cast<uint32_t>(control[i] == value) << i;
+        return result;
+    }
+
+    inline uint32_t FlatHashMapGroup::MatchEmpty(const int8_t* control)
+    {
+        return Match(control, ms_Empty);
+    }
+
+    inline uint32_t FlatHashMapGroup::MatchEmptyOrDeleted(const int8_t* control)
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < ms_Width; ++i)
+            result |= static_cast<uint32_t>(control[i] < -1) << i;
+        return result;
+    }
+
+    inline uint32_t FlatHashMapGroup::MatchFull(const int8_t* control)
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < ms_Width; ++i)
+            result |= static_cast<uint32_t>(control[i] >= 0) << i;
+        return result;
+    }
+
+#endif
+
+    inline uint64_t FlatHashMapGroup::MixHash(uint64_t hash)
+    {
+        // Finalizer of MurmurHash3
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    FlatHashMap<Key, Value, Hash, KeyEqual>::FlatHashMap()
+        : m_Control(nullptr)
+        , m_Entries(nullptr)
+        , m_Capacity(0)
+        , m_Size(0)
+        , m_GrowthLeft(0)
+    {
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    FlatHashMap<Key, Value, Hash, KeyEqual>::~FlatHashMap()
+    {
+        Release();
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    FlatHashMap<Key, Value, Hash, KeyEqual>::FlatHashMap(const FlatHashMap& other)
+        : FlatHashMap()
+    {
+        *this = other;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    FlatHashMap<Key, Value, Hash, KeyEqual>::FlatHashMap(FlatHashMap&& other) noexcept
+        : m_Control(std::exchange(other.m_Control, nullptr))
+        , m_Entries(std::exchange(other.m_Entries, nullptr))
+        , m_Capacity(std::exchange(other.m_Capacity, 0))
+        , m_Size(std::exchange(other.m_Size, 0))
+        , m_GrowthLeft(std::exchange(other.m_GrowthLeft, 0))
+        , m_Hash(other.m_Hash)
+        , m_KeyEqual(other.m_KeyEqual)
+    {
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    auto FlatHashMap<Key, Value, Hash, KeyEqual>::operator=(const FlatHashMap& other)
+        -> FlatHashMap&
+    {
+        if (this == &other)
+            return *this;
+
+        Release();
+        m_Hash = other.m_Hash;
+        m_KeyEqual = other.m_KeyEqual;
+        if (other.m_Size == 0)
+            return *this;
+
+        // Same layout as other, so that entries don't need to be rehashed
+        Allocate(other.m_Capacity);
+        for (size_t i = 0; i < m_Capacity; ++i)
+        {
+            if (other.m_Control[i] >= 0)
+                std::construct_at(m_Entries + i, other.m_Entries[i]);
+        }
+        std::copy(other.m_Control, other.m_Control + m_Capacity, m_Control);
+        m_Size = other.m_Size;
+        m_GrowthLeft = other.m_GrowthLeft;
+        return *this;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    auto FlatHashMap<Key, Value, Hash, KeyEqual>::operator=(FlatHashMap&& other) noexcept
+        -> FlatHashMap&
+    {
+        if (this == &other)
+            return *this;
+
+        Release();
+        m_Control = std::exchange(other.m_Control, nullptr);
+        m_Entries = std::exchange(other.m_Entries, nullptr);
+        m_Capacity = std::exchange(other.m_Capacity, 0);
+        m_Size = std::exchange(other.m_Size, 0);
+        m_GrowthLeft = std::exchange(other.m_GrowthLeft, 0);
+        m_Hash = other.m_Hash;
+        m_KeyEqual = other.m_KeyEqual;
+        return *this;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    Value* FlatHashMap<Key, Value, Hash, KeyEqual>::Find(const Key& key)
+    {
+        const size_t index = FindIndex(key, GetHash(key));
+        return index == ms_InvalidIndex ? nullptr : &m_Entries[index].value;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    const Value* FlatHashMap<Key, Value, Hash, KeyEqual>::Find(const Key& key) const
+    {
+        const size_t index = FindIndex(key, GetHash(key));
+        return index == ms_InvalidIndex ? nullptr : &m_Entries[index].value;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    bool FlatHashMap<Key, Value, Hash, KeyEqual>::Contains(const Key& key) const
+    {
+        return FindIndex(key, GetHash(key)) != ms_InvalidIndex;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    template <typename... Args>
+    std::pair<Value*, bool> FlatHashMap<Key, Value, Hash, KeyEqual>::Emplace(const Key& key,
+                                                                             Args&&... args)
+    {
+        const uint64_t hash = GetHash(key);
+        size_t index = FindIndex(key, hash);
+        if (index != ms_InvalidIndex)
+            return {&m_Entries[index].value, false};
+
+        index = m_Capacity == 0 ? ms_InvalidIndex : FindInsertIndex(hash);
+        if (index == ms_InvalidIndex ||
+            (m_Control[index] == FlatHashMapGroup::ms_Empty && m_GrowthLeft == 0))
+        {
+            // Rehash in place if at least half of limit is taken by deleted slots, so that
+            // repeated erase and insert don't grow table
+            const size_t limit = GetCapacityLimit(m_Capacity);
+            Rehash((m_Size + 1) * 2 <= limit ? m_Capacity : GetCapacityForCount(m_Size + 1));
+            index = FindInsertIndex(hash);
+        }
+
+        Entry* entry = m_Entries + index;
+        ::new (static_cast<void*>(entry)) Entry{key, Value(std::forward<Args>(args)...)};
+        if (m_Control[index] == FlatHashMapGroup::ms_Empty)
+            --m_GrowthLeft;
+        m_Control[index] = static_cast<int8_t>(hash & 0x7F);
+        ++m_Size;
+        return {&entry->value, true};
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    Value& FlatHashMap<Key, Value, Hash, KeyEqual>::operator[](const Key& key)
+    {
+        return *Emplace(key).first;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    bool FlatHashMap<Key, Value, Hash, KeyEqual>::Erase(const Key& key)
+    {
+        const size_t index = FindIndex(key, GetHash(key));
+        if (index == ms_InvalidIndex)
+            return false;
+
+        std::destroy_at(m_Entries + index);
+        --m_Size;
+
+        // Group that has empty slot was never full, so no probe sequence went past it and slot
+        // can become empty. Otherwise it is marked deleted, so that probing continues past it
+        const size_t groupStart = BLK_FLOOR_TO_POWER_OF_TWO(index, FlatHashMapGroup::ms_Width);
+        if (FlatHashMapGroup::MatchEmpty(m_Control + groupStart) != 0)
+        {
+            m_Control[index] = FlatHashMapGroup::ms_Empty;
+            ++m_GrowthLeft;
+        }
+        else
+        {
+            m_Control[index] = FlatHashMapGroup::ms_Deleted;
+        }
+        return true;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    void FlatHashMap<Key, Value, Hash, KeyEqual>::Clear()
+    {
+        if (m_Capacity == 0)
+            return;
+
+        DestroyEntries();
+        std::fill(m_Control, m_Control + m_Capacity, FlatHashMapGroup::ms_Empty);
+        m_Size = 0;
+        m_GrowthLeft = GetCapacityLimit(m_Capacity);
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    void FlatHashMap<Key, Value, Hash, KeyEqual>::Release()
+    {
+        DestroyEntries();
+        Deallocate();
+        m_Size = 0;
+        m_GrowthLeft = 0;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    void FlatHashMap<Key, Value, Hash, KeyEqual>::Reserve(size_t count)
+    {
+        const size_t capacity = GetCapacityForCount(count);
+        if (capacity > m_Capacity)
+            Rehash(capacity);
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    size_t FlatHashMap<Key, Value, Hash, KeyEqual>::GetSize() const
+    {
+        return m_Size;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    bool FlatHashMap<Key, Value, Hash, KeyEqual>::IsEmpty() const
+    {
+        return m_Size == 0;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    size_t FlatHashMap<Key, Value, Hash, KeyEqual>::GetCapacity() const
+    {
+        return m_Capacity;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    auto FlatHashMap<Key, Value, Hash, KeyEqual>::begin() -> Iterator<false>
+    {
+        return Iterator<false>(this, FindNextFull(0));
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    auto FlatHashMap<Key, Value, Hash, KeyEqual>::end() -> Iterator<false>
+    {
+        return Iterator<false>(this, m_Capacity);
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    auto FlatHashMap<Key, Value, Hash, KeyEqual>::begin() const -> Iterator<true>
+    {
+        return Iterator<true>(this, FindNextFull(0));
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    auto FlatHashMap<Key, Value, Hash, KeyEqual>::end() const -> Iterator<true>
+    {
+        return Iterator<true>(this, m_Capacity);
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    size_t FlatHashMap<Key, Value, Hash, KeyEqual>::GetCapacityLimit(size_t capacity)
+    {
+        return capacity - capacity / 8;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    size_t FlatHashMap<Key, Value, Hash, KeyEqual>::GetCapacityForCount(size_t count)
+    {
+        size_t capacity = FlatHashMapGroup::ms_Width;
+        while (GetCapacityLimit(capacity) < count)
+            capacity *= 2;
+        return capacity;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    uint64_t FlatHashMap<Key, Value, Hash, KeyEqual>::GetHash(const Key& key) const
+    {
+        return FlatHashMapGroup::MixHash(static_cast<uint64_t>(m_Hash(key)));
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    size_t FlatHashMap<Key, Value, Hash, KeyEqual>::FindIndex(const Key& key, uint64_t hash) const
+    {
+        if (m_Size == 0)
+            return ms_InvalidIndex;
+
+        const int8_t controlValue = static_cast<int8_t>(hash & 0x7F);
+        const size_t groupMask = m_Capacity / FlatHashMapGroup::ms_Width - 1;
+        size_t group = static_cast<size_t>(hash >> 7) & groupMask;
+        // Triangular probing visits every group when group count is power of two
+        for (size_t step = 1;; ++step)
+        {
+            const size_t groupStart = group * FlatHashMapGroup::ms_Width;
+            const int8_t* control = m_Control + groupStart;
+            uint32_t matches = FlatHashMapGroup::Match(control, controlValue);
+            while (matches)
+            {
+                const size_t index = groupStart + std::countr_zero(matches);
+                if (m_KeyEqual(m_Entries[index].key, key))
+                    return index;
+                matches &= matches - 1;
+            }
+            if (FlatHashMapGroup::MatchEmpty(control) != 0)
+                return ms_InvalidIndex;
+            group = (group + step) & groupMask;
+        }
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    size_t FlatHashMap<Key, Value, Hash, KeyEqual>::FindInsertIndex(uint64_t hash) const
+    {
+        BLK_ASSERT(m_Capacity != 0);
+
+        const size_t groupMask = m_Capacity / FlatHashMapGroup::ms_Width - 1;
+        size_t group = static_cast<size_t>(hash >> 7) & groupMask;
+        for (size_t step = 1;; ++step)
+        {
+            const size_t groupStart = group * FlatHashMapGroup::ms_Width;
+            const uint32_t available =
+                FlatHashMapGroup::MatchEmptyOrDeleted(m_Control + groupStart);
+            if (available != 0)
+                return groupStart + std::countr_zero(available);
+            group = (group + step) & groupMask;
+        }
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    size_t FlatHashMap<Key, Value, Hash, KeyEqual>::FindNextFull(size_t index) const
+    {
+        while (index < m_Capacity)
+        {
+            const size_t groupStart = BLK_FLOOR_TO_POWER_OF_TWO(index, FlatHashMapGroup::ms_Width);
+            const uint32_t full =
+                FlatHashMapGroup::MatchFull(m_Control + groupStart) >> (index - groupStart);
+            if (full != 0)
+                return index + std::countr_zero(full);
+            index = groupStart + FlatHashMapGroup::ms_Width;
+        }
+        return m_Capacity;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    void FlatHashMap<Key, Value, Hash, KeyEqual>::Rehash(size_t capacity)
+    {
+        BLK_ASSERT(GetCapacityLimit(capacity) >= m_Size);
+
+        int8_t* oldControl = m_Control;
+        Entry* oldEntries = m_Entries;
+        const size_t oldCapacity = m_Capacity;
+
+        Allocate(capacity);
+        for (size_t i = 0; i < oldCapacity; ++i)
+        {
+            if (oldControl[i] < 0)
+                continue;
+
+            const uint64_t hash = GetHash(oldEntries[i].key);
+            const size_t index = FindInsertIndex(hash);
+            std::construct_at(m_Entries + index, std::move(oldEntries[i]));
+            std::destroy_at(oldEntries + i);
+            m_Control[index] = static_cast<int8_t>(hash & 0x7F);
+        }
+        m_GrowthLeft = GetCapacityLimit(capacity) - m_Size;
+
+        std::allocator<Entry>().deallocate(oldEntries, oldCapacity);
+        delete[] oldControl;
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    void FlatHashMap<Key, Value, Hash, KeyEqual>::Allocate(size_t capacity)
+    {
+        BLK_ASSERT(capacity % FlatHashMapGroup::ms_Width == 0 && std::has_single_bit(capacity));
+
+        m_Control = new int8_t[capacity];
+        std::fill(m_Control, m_Control + capacity, FlatHashMapGroup::ms_Empty);
+        m_Entries = std::allocator<Entry>().allocate(capacity);
+        m_Capacity = capacity;
+        m_GrowthLeft = GetCapacityLimit(capacity);
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    void FlatHashMap<Key, Value, Hash, KeyEqual>::DestroyEntries()
+    {
+        if constexpr (!std::is_trivially_destructible_v<Entry>)
+        {
+            for (size_t i = 0; i < m_Capacity; ++i)
+            {
+                if (m_Control[i] >= 0)
+                    std::destroy_at(m_Entries + i);
+            }
+        }
+    }
+
+    template <typename Key, typename Value, typename Hash, typename KeyEqual>
+    void FlatHashMap<Key, Value, Hash, KeyEqual>::Deallocate()
+    {
+        if (m_Capacity == 0)
+            return;
+
+        std::allocator<Entry>().deallocate(m_Entries, m_Capacity);
+        delete[] m_Control;
+        m_Entries = nullptr;
+        m_Control = nullptr;
+        m_Capacity = 0;
+    }
+
+} // namespace Boolka
@@ -56,11 +56,12 @@ namespace Boolka
         return result;
     }
 
+    // Can potentially give false positive, in case when tested sphere is close to the edge or
+    // corner of the frustum, use ExactFrustum::CheckSphere to avoid them
     bool Frustum::CheckSphereFast(const Vector4& center, float radius) const
     {
         BLK_ASSERT(center.w() == 1.0f);
 
-        // TODO rewrite, algorithm is incorrect
         for (const auto& plane : m_planes)
         {
             if (plane.Dot(center) < -radius)
@@ -230,7 +231,7 @@ namespace Boolka
     }
 
     // Can potentially give false positive, in case when tested AABB is close to the corner of
-    // the frustum
+    // the frustum, use ExactFrustum::CheckAABB to avoid them
     bool Frustum::CheckAABBFast(const AABB& boundingBox) const
     {
         BLK_ASSERT(boundingBox.GetMin().w() == 1.0f);
@@ -0,0 +1,132 @@
+#include "stdafx.h"
+
+#include "HighResolutionClock.h"
+
+#include <chrono>
+
+namespace Boolka
+{
+
+    // Long enough for steady_clock resolution to be negligible, short enough to not stall startup
+    static const std::chrono::milliseconds gs_ClockCalibrationTime(10);
+    static const size_t gs_ClockOverheadSampleCount = 1000;
+
+    struct ClockCalibration
+    {
+        bool useTSC;
+        double ticksPerSecond;
+        double nanosecondsPerTick;
+        double callOverheadNanoseconds;
+    };
+
+    static bool IsInvariantTSCSupported()
+    {
+#ifdef BLK_USE_SSE
+        int registers[4];
+        __cpuid(registers, 0x80000000);
+        const uint32_t maxExtendedLeaf = uint32_t(registers[0]);
+        if (maxExtendedLeaf < 0x80000007)
+            return false;
+
+        // rdtscp is reported in EDX bit 27 of leaf 0x80000001
+        __cpuid(registers, 0x80000001);
+        const bool hasRDTSCP = (registers[3] & (1 << 27)) != 0;
+
+        // Invariant TSC runs at constant rate regardless of power states and is synchronized
+        // between cores, reported in EDX bit 8 of leaf 0x80000007
+        __cpuid(registers, 0x80000007);
+        const bool hasInvariantTSC = (registers[3] & (1 << 8)) != 0;
+
+        return hasRDTSCP && hasInvariantTSC;
+#else
+        return false;
+#endif
+    }
+
+    static uint64_t ReadClockTicks(bool useTSC)
+    {
+#ifdef BLK_USE_SSE
+        if (useTSC)
+        {
+            // Unlike rdtsc, rdtscp waits for previous instructions to finish
+            unsigned int processorId;
+            return __rdtscp(&processorId);
+        }
+#endif
+        return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    static ClockCalibration CalibrateClock()
+    {
+        ClockCalibration calibration;
+        calibration.useTSC = IsInvariantTSCSupported();
+
+        if (calibration.useTSC)
+        {
+            const auto steadyStart = std::chrono::steady_clock::now();
+            const uint64_t ticksStart = ReadClockTicks(true);
+            auto steadyEnd = steadyStart;
+            while (steadyEnd - steadyStart < gs_ClockCalibrationTime)
+                steadyEnd = std::chrono::steady_clock::now();
+            const uint64_t ticksEnd = ReadClockTicks(true);
+
+            const double seconds = std::chrono::duration<double>(steadyEnd - steadyStart).count();
+            calibration.ticksPerSecond = double(ticksEnd - ticksStart) / seconds;
+        }
+        else
+        {
+            using Period = std::chrono::steady_clock::period;
+            calibration.ticksPerSecond = double(Period::den) / double(Period::num);
+        }
+        calibration.nanosecondsPerTick = 1e9 / calibration.ticksPerSecond;
+
+        uint64_t minOverheadTicks = UINT64_MAX;
+        for (size_t i = 0; i < gs_ClockOverheadSampleCount; ++i)
+        {
+            const uint64_t start = ReadClockTicks(calibration.useTSC);
+            const uint64_t end = ReadClockTicks(calibration.useTSC);
+            minOverheadTicks = std::min(minOverheadTicks, end - start);
+        }
+        calibration.callOverheadNanoseconds =
+            double(minOverheadTicks) * calibration.nanosecondsPerTick;
+
+        return calibration;
+    }
+
+    static const ClockCalibration& GetClockCalibration()
+    {
+        static const ClockCalibration calibration = CalibrateClock();
+        return calibration;
+    }
+
+    uint64_t HighResolutionClock::GetTimestamp()
+    {
+        return ReadClockTicks(GetClockCalibration().useTSC);
+    }
+
+    uint64_t HighResolutionClock::TicksToNanoseconds(uint64_t ticks)
+    {
+        return uint64_t(double(ticks) * GetClockCalibration().nanosecondsPerTick);
+    }
+
+    double HighResolutionClock::TicksToSeconds(uint64_t ticks)
+    {
+        return double(ticks) / GetClockCalibration().ticksPerSecond;
+    }
+
+    double HighResolutionClock::GetTicksPerSecond()
+    {
+        return GetClockCalibration().ticksPerSecond;
+    }
+
+    bool HighResolutionClock::IsUsingTSC()
+    {
+        return GetClockCalibration().useTSC;
+    }
+
+    double HighResolutionClock::GetCallOverheadNanoseconds()
+    {
+        return GetClockCalibration().callOverheadNanoseconds;
+    }
+
+} // namespace Boolka
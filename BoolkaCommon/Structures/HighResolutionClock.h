@@ -0,0 +1,24 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Portable timestamp source for CPU timings
+    // Reads invariant TSC with rdtscp when CPU has one, and falls back to std::chrono::steady_clock
+    // otherwise. TSC frequency is calibrated against steady_clock on first use.
+    // Only differences of timestamps are meaningful, since tick origin depends on source.
+    class HighResolutionClock
+    {
+    public:
+        [[nodiscard]] static uint64_t GetTimestamp();
+
+        [[nodiscard]] static uint64_t TicksToNanoseconds(uint64_t ticks);
+        [[nodiscard]] static double TicksToSeconds(uint64_t ticks);
+        [[nodiscard]] static double GetTicksPerSecond();
+
+        [[nodiscard]] static bool IsUsingTSC();
+        // Smallest measured difference of two back to back GetTimestamp calls
+        [[nodiscard]] static double GetCallOverheadNanoseconds();
+    };
+
+} // namespace Boolka
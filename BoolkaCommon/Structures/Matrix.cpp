@@ -2,6 +2,8 @@
 
 #include "Matrix.h"
 
+#include "CPUFeatures.h"
+
 namespace Boolka
 {
 
@@ -114,6 +116,42 @@ namespace Boolka
         return result;
     }
 
+#ifdef BLK_USE_SSE
+
+    // Implemented in MatrixAVX2.cpp, which is built with /arch:AVX2
+    // Should only be called when CPUFeatures::HasAVX2 is true
+    void MultiplyMatricesAVX2(const float* left, const float* right, float* result);
+
+    Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other) const
+    {
+        Matrix4x4 result;
+        if (CPUFeatures::HasAVX2())
+        {
+            MultiplyMatricesAVX2(GetBuffer(), other.GetBuffer(), result.GetBuffer());
+            return result;
+        }
+
+        const __m128 other0 = other.m_data[0].GetInternal();
+        const __m128 other1 = other.m_data[1].GetInternal();
+        const __m128 other2 = other.m_data[2].GetInternal();
+        const __m128 other3 = other.m_data[3].GetInternal();
+
+        // Terms are summed in same order as in scalar and AVX versions
+        for (size_t i = 0; i < 4; i++)
+        {
+            const __m128 row = m_data[i].GetInternal();
+            __m128 sum = _mm_mul_ps(_mm_shuffle_ps(row, row, 0x00), other0);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(row, row, 0x55), other1));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xAA), other2));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xFF), other3));
+            result.m_data[i] = sum;
+        }
+
+        return result;
+    }
+
+#else
+
     Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other) const
     {
         // Initialized with zeroes
@@ -131,6 +169,8 @@ namespace Boolka
         return result;
     }
 
+#endif // BLK_USE_SSE
+
     bool Matrix4x4::operator==(const Matrix4x4& other) const
     {
         return std::equal(std::begin(m_data), std::end(m_data), std::begin(other.m_data));
@@ -141,6 +181,116 @@ namespace Boolka
         return !operator==(other);
     }
 
+#ifdef BLK_USE_SSE
+
+    // Element i of result is taken from element i of mask argument
+    template <int x, int y, int z, int w>
+    static __m128 Swizzle(__m128 value)
+    {
+        return _mm_shuffle_ps(value, value, x | (y << 2) | (z << 4) | (w << 6));
+    }
+
+    // First two elements are taken from first argument, last two from second
+    template <int x, int y, int z, int w>
+    static __m128 Shuffle(__m128 first, __m128 second)
+    {
+        return _mm_shuffle_ps(first, second, x | (y << 2) | (z << 4) | (w << 6));
+    }
+
+    // 2x2 matrices are stored in single register as row major (m00, m01, m10, m11)
+    // A * B
+    static __m128 Matrix2x2Mul(__m128 first, __m128 second)
+    {
+        return _mm_add_ps(_mm_mul_ps(first, Swizzle<0, 3, 0, 3>(second)),
+                          _mm_mul_ps(Swizzle<1, 0, 3, 2>(first), Swizzle<2, 1, 2, 1>(second)));
+    }
+
+    // adj(A) * B
+    static __m128 Matrix2x2AdjMul(__m128 first, __m128 second)
+    {
+        return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(first), second),
+                          _mm_mul_ps(Swizzle<1, 1, 2, 2>(first), Swizzle<2, 3, 0, 1>(second)));
+    }
+
+    // A * adj(B)
+    static __m128 Matrix2x2MulAdj(__m128 first, __m128 second)
+    {
+        return _mm_sub_ps(_mm_mul_ps(first, Swizzle<3, 0, 3, 0>(second)),
+                          _mm_mul_ps(Swizzle<1, 0, 3, 2>(first), Swizzle<2, 1, 2, 1>(second)));
+    }
+
+    Matrix4x4 Matrix4x4::Inverse(bool& isSuccessfull) const
+    {
+        // Blockwise inversion, matrix is split into 2x2 blocks
+        // | A B |
+        // | C D |
+        // Inverse is 1/det * | X Y |, where adjugates of X, Y, Z, W are calculated from adjugates
+        //                    | Z W |
+        // and determinants of blocks
+        const __m128 row0 = m_data[0].GetInternal();
+        const __m128 row1 = m_data[1].GetInternal();
+        const __m128 row2 = m_data[2].GetInternal();
+        const __m128 row3 = m_data[3].GetInternal();
+
+        const __m128 a = _mm_movelh_ps(row0, row1);
+        const __m128 b = _mm_movehl_ps(row1, row0);
+        const __m128 c = _mm_movelh_ps(row2, row3);
+        const __m128 d = _mm_movehl_ps(row3, row2);
+
+        // (det(A), det(B), det(C), det(D))
+        const __m128 blockDet = _mm_sub_ps(
+            _mm_mul_ps(Shuffle<0, 2, 0, 2>(row0, row2), Shuffle<1, 3, 1, 3>(row1, row3)),
+            _mm_mul_ps(Shuffle<1, 3, 1, 3>(row0, row2), Shuffle<0, 2, 0, 2>(row1, row3)));
+        const __m128 detA = Swizzle<0, 0, 0, 0>(blockDet);
+        const __m128 detB = Swizzle<1, 1, 1, 1>(blockDet);
+        const __m128 detC = Swizzle<2, 2, 2, 2>(blockDet);
+        const __m128 detD = Swizzle<3, 3, 3, 3>(blockDet);
+
+        const __m128 adjDMulC = Matrix2x2AdjMul(d, c);
+        const __m128 adjAMulB = Matrix2x2AdjMul(a, b);
+
+        // adj(X) = det(D) * A - B * adj(D) * C
+        __m128 adjX = _mm_sub_ps(_mm_mul_ps(detD, a), Matrix2x2Mul(b, adjDMulC));
+        // adj(W) = det(A) * D - C * adj(A) * B
+        __m128 adjW = _mm_sub_ps(_mm_mul_ps(detA, d), Matrix2x2Mul(c, adjAMulB));
+        // adj(Y) = det(B) * C - D * adj(adj(A) * B)
+        __m128 adjY = _mm_sub_ps(_mm_mul_ps(detB, c), Matrix2x2MulAdj(d, adjAMulB));
+        // adj(Z) = det(C) * B - A * adj(adj(D) * C)
+        __m128 adjZ = _mm_sub_ps(_mm_mul_ps(detC, b), Matrix2x2MulAdj(a, adjDMulC));
+
+        // det = det(A) * det(D) + det(B) * det(C) - trace(adj(A) * B * adj(D) * C)
+        __m128 trace = _mm_mul_ps(adjAMulB, Swizzle<0, 2, 1, 3>(adjDMulC));
+        trace = _mm_hadd_ps(trace, trace);
+        trace = _mm_hadd_ps(trace, trace);
+        const __m128 det =
+            _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+        if (::abs(_mm_cvtss_f32(det)) < FLT_EPSILON)
+        {
+            isSuccessfull = false;
+            return Matrix4x4{};
+        }
+
+        isSuccessfull = true;
+
+        // Signs of adjugate are applied together with division by determinant
+        const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+        adjX = _mm_mul_ps(adjX, invDet);
+        adjY = _mm_mul_ps(adjY, invDet);
+        adjZ = _mm_mul_ps(adjZ, invDet);
+        adjW = _mm_mul_ps(adjW, invDet);
+
+        // Adjugate swaps diagonal elements, combined with assembling rows from blocks
+        return Matrix4x4{
+            Shuffle<3, 1, 3, 1>(adjX, adjY),
+            Shuffle<2, 0, 2, 0>(adjX, adjY),
+            Shuffle<3, 1, 3, 1>(adjZ, adjW),
+            Shuffle<2, 0, 2, 0>(adjZ, adjW),
+        };
+    }
+
+#else
+
     Matrix4x4 Matrix4x4::Inverse(bool& isSuccessfull) const
     {
         Matrix4x4 result;
@@ -273,6 +423,137 @@ namespace Boolka
         return result;
     }
 
+#endif // BLK_USE_SSE
+
+#ifdef BLK_USE_SSE
+
+    static __m128 Cross(__m128 first, __m128 second)
+    {
+        return _mm_sub_ps(_mm_mul_ps(Swizzle<1, 2, 0, 3>(first), Swizzle<2, 0, 1, 3>(second)),
+                          _mm_mul_ps(Swizzle<2, 0, 1, 3>(first), Swizzle<1, 2, 0, 3>(second)));
+    }
+
+    // Last row of affine inverse is -translation * inverse of upper 3x3 part
+    static __m128 CalculateInverseTranslation(__m128 translation, __m128 row0, __m128 row1,
+                                              __m128 row2)
+    {
+        __m128 result = _mm_mul_ps(row0, Swizzle<0, 0, 0, 0>(translation));
+        result = _mm_add_ps(result, _mm_mul_ps(row1, Swizzle<1, 1, 1, 1>(translation)));
+        result = _mm_add_ps(result, _mm_mul_ps(row2, Swizzle<2, 2, 2, 2>(translation)));
+        // w of rows is zero, so w of result becomes exactly one
+        return _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), result);
+    }
+
+    Matrix4x4 Matrix4x4::InverseAffine(bool& isSuccessfull) const
+    {
+        BLK_ASSERT(m_data[0].w() == 0.0f && m_data[1].w() == 0.0f && m_data[2].w() == 0.0f &&
+                   m_data[3].w() == 1.0f);
+
+        const __m128 row0 = m_data[0].GetInternal();
+        const __m128 row1 = m_data[1].GetInternal();
+        const __m128 row2 = m_data[2].GetInternal();
+
+        // Rows of adjugate of upper 3x3 part are cross products of its rows, transposed
+        __m128 cross0 = Cross(row1, row2);
+        __m128 cross1 = Cross(row2, row0);
+        __m128 cross2 = Cross(row0, row1);
+        __m128 zero = _mm_setzero_ps();
+
+        __m128 det = _mm_mul_ps(row0, cross0);
+        det = _mm_add_ps(_mm_add_ps(det, Swizzle<1, 1, 1, 1>(det)), Swizzle<2, 2, 2, 2>(det));
+        if (::abs(_mm_cvtss_f32(det)) < FLT_EPSILON)
+        {
+            isSuccessfull = false;
+            return Matrix4x4{};
+        }
+
+        isSuccessfull = true;
+
+        _MM_TRANSPOSE4_PS(cross0, cross1, cross2, zero);
+        const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), Swizzle<0, 0, 0, 0>(det));
+        cross0 = _mm_mul_ps(cross0, invDet);
+        cross1 = _mm_mul_ps(cross1, invDet);
+        cross2 = _mm_mul_ps(cross2, invDet);
+
+        return Matrix4x4{
+            cross0,
+            cross1,
+            cross2,
+            CalculateInverseTranslation(m_data[3].GetInternal(), cross0, cross1, cross2),
+        };
+    }
+
+    Matrix4x4 Matrix4x4::InverseRigid() const
+    {
+        BLK_ASSERT(m_data[0].w() == 0.0f && m_data[1].w() == 0.0f && m_data[2].w() == 0.0f &&
+                   m_data[3].w() == 1.0f);
+
+        // Inverse of rotation is its transpose
+        __m128 row0 = m_data[0].GetInternal();
+        __m128 row1 = m_data[1].GetInternal();
+        __m128 row2 = m_data[2].GetInternal();
+        __m128 zero = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(row0, row1, row2, zero);
+
+        return Matrix4x4{
+            row0,
+            row1,
+            row2,
+            CalculateInverseTranslation(m_data[3].GetInternal(), row0, row1, row2),
+        };
+    }
+
+#else
+
+    Matrix4x4 Matrix4x4::InverseAffine(bool& isSuccessfull) const
+    {
+        BLK_ASSERT(m_data[0].w() == 0.0f && m_data[1].w() == 0.0f && m_data[2].w() == 0.0f &&
+                   m_data[3].w() == 1.0f);
+
+        // Rows of adjugate of upper 3x3 part are cross products of its rows, transposed
+        const Vector4 cross0 = m_data[1].Cross(m_data[2]);
+        const Vector4 cross1 = m_data[2].Cross(m_data[0]);
+        const Vector4 cross2 = m_data[0].Cross(m_data[1]);
+
+        const float det = m_data[0].Dot(cross0);
+        if (::abs(det) < FLT_EPSILON)
+        {
+            isSuccessfull = false;
+            return Matrix4x4{};
+        }
+
+        isSuccessfull = true;
+
+        Matrix4x4 result = Matrix4x4{cross0, cross1, cross2, Vector4{}}.Transpose();
+        const float invDet = 1.0f / det;
+        result[0] *= invDet;
+        result[1] *= invDet;
+        result[2] *= invDet;
+
+        const Vector4& translation = m_data[3];
+        result[3] = -(result[0] * translation.x() + result[1] * translation.y() +
+                      result[2] * translation.z());
+        result[3][3] = 1.0f;
+        return result;
+    }
+
+    Matrix4x4 Matrix4x4::InverseRigid() const
+    {
+        BLK_ASSERT(m_data[0].w() == 0.0f && m_data[1].w() == 0.0f && m_data[2].w() == 0.0f &&
+                   m_data[3].w() == 1.0f);
+
+        // Inverse of rotation is its transpose
+        Matrix4x4 result = Matrix4x4{m_data[0], m_data[1], m_data[2], Vector4{}}.Transpose();
+
+        const Vector4& translation = m_data[3];
+        result[3] = -(result[0] * translation.x() + result[1] * translation.y() +
+                      result[2] * translation.z());
+        result[3][3] = 1.0f;
+        return result;
+    }
+
+#endif // BLK_USE_SSE
+
 #ifdef BLK_USE_SSE
 
     Matrix4x4 Matrix4x4::Transpose() const
@@ -489,6 +770,25 @@ namespace Boolka
         };
     }
 
+#ifdef BLK_USE_SSE
+
+    Vector4 operator*(const Vector4& first, const Matrix4x4& second)
+    {
+        const __m128 vector = first.GetInternal();
+
+        // Terms are summed in same order as in scalar version
+        __m128 result = _mm_mul_ps(second[0].GetInternal(), _mm_shuffle_ps(vector, vector, 0x00));
+        result = _mm_add_ps(
+            result, _mm_mul_ps(second[1].GetInternal(), _mm_shuffle_ps(vector, vector, 0x55)));
+        result = _mm_add_ps(
+            result, _mm_mul_ps(second[2].GetInternal(), _mm_shuffle_ps(vector, vector, 0xAA)));
+        result = _mm_add_ps(
+            result, _mm_mul_ps(second[3].GetInternal(), _mm_shuffle_ps(vector, vector, 0xFF)));
+        return result;
+    }
+
+#else
+
     Vector4 operator*(const Vector4& first, const Matrix4x4& second)
     {
         Vector4 result;
@@ -501,4 +801,6 @@ namespace Boolka
         return result;
     }
 
+#endif // BLK_USE_SSE
+
 } // namespace Boolka
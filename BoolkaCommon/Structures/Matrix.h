@@ -45,7 +45,18 @@ namespace Boolka
         [[nodiscard]] bool operator==(const Matrix4x4& other) const;
         [[nodiscard]] bool operator!=(const Matrix4x4& other) const;
 
+        // SSE versions of multiplication sum terms in same order as scalar version, so results
+        // match bit exactly
+        // Inverses are within ms_InverseMaxUlpError ulp of exact result for well conditioned
+        // matrices, ulp is taken of largest element in each row of exact result
+        static constexpr float ms_InverseMaxUlpError = 32.0f;
+
         [[nodiscard]] Matrix4x4 Inverse(bool& isSuccessfull) const;
+        // Faster inverse for matrices with last column (0, 0, 0, 1), e.g. any combination of
+        // scale, rotation and translation
+        [[nodiscard]] Matrix4x4 InverseAffine(bool& isSuccessfull) const;
+        // Fastest inverse for affine matrices with orthonormal upper 3x3 part, e.g. view matrix
+        [[nodiscard]] Matrix4x4 InverseRigid() const;
         [[nodiscard]] Matrix4x4 Transpose() const;
 
         [[nodiscard]] static Matrix4x4 GetIdentity();
@@ -0,0 +1,54 @@
+#include "stdafx.h"
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+// Built with /arch:AVX2, so that compiler can use 256 bit registers, and /fp:precise, so that
+// multiplies and adds aren't fused and results match SSE and scalar versions bit exactly
+#if defined(BLK_USE_SSE) && (!defined(__AVX2__) || defined(_M_FP_FAST))
+#error MatrixAVX2.cpp should be built with /arch:AVX2 and /fp:precise
+#endif
+
+namespace Boolka
+{
+
+#ifdef BLK_USE_SSE
+
+    // Matrices are 16 floats each, result can't alias inputs
+    void MultiplyMatricesAVX2(const float* left, const float* right, float* result)
+    {
+        // Two rows per instruction, each 128 bit half of register holds one row
+        // Terms are summed in same order as in SSE and scalar versions
+        const __m256 rows01 = _mm256_loadu_ps(left);
+        const __m256 rows23 = _mm256_loadu_ps(left + 8);
+
+        __m256 otherRows[4];
+        for (size_t i = 0; i < 4; i++)
+        {
+            const __m128 row = _mm_loadu_ps(right + i * 4);
+            otherRows[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(row), row, 1);
+        }
+
+        __m256 result01 = _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0x00), otherRows[0]);
+        __m256 result23 = _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0x00), otherRows[0]);
+        result01 = _mm256_add_ps(
+            result01, _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0x55), otherRows[1]));
+        result23 = _mm256_add_ps(
+            result23, _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0x55), otherRows[1]));
+        result01 = _mm256_add_ps(
+            result01, _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0xAA), otherRows[2]));
+        result23 = _mm256_add_ps(
+            result23, _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0xAA), otherRows[2]));
+        result01 = _mm256_add_ps(
+            result01, _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0xFF), otherRows[3]));
+        result23 = _mm256_add_ps(
+            result23, _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0xFF), otherRows[3]));
+
+        _mm256_storeu_ps(result, result01);
+        _mm256_storeu_ps(result + 8, result23);
+    }
+
+#endif
+
+} // namespace Boolka
@@ -0,0 +1,123 @@
+#include "stdafx.h"
+
+#include "ScratchArena.h"
+
+namespace Boolka
+{
+
+    ScratchArena::ScratchArena()
+        : m_Offset(0)
+        , m_Capacity(0)
+        , m_AllocationCount(0)
+        , m_HeapAllocationCount(0)
+    {
+    }
+
+    ScratchArena::~ScratchArena()
+    {
+        FreeBlocks();
+    }
+
+    ScratchArena::ScratchArena(ScratchArena&& other) noexcept
+        : m_Blocks(std::move(other.m_Blocks))
+        , m_Offset(other.m_Offset)
+        , m_Capacity(other.m_Capacity)
+        , m_AllocationCount(other.m_AllocationCount)
+        , m_HeapAllocationCount(other.m_HeapAllocationCount)
+    {
+        other.m_Blocks.clear();
+        other.m_Offset = 0;
+        other.m_Capacity = 0;
+    }
+
+    ScratchArena& ScratchArena::operator=(ScratchArena&& other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeBlocks();
+            m_Blocks = std::move(other.m_Blocks);
+            m_Offset = other.m_Offset;
+            m_Capacity = other.m_Capacity;
+            m_AllocationCount = other.m_AllocationCount;
+            m_HeapAllocationCount = other.m_HeapAllocationCount;
+            other.m_Blocks.clear();
+            other.m_Offset = 0;
+            other.m_Capacity = 0;
+        }
+        return *this;
+    }
+
+    void ScratchArena::Reset()
+    {
+        m_Offset = 0;
+        if (m_Blocks.size() <= 1)
+            return;
+
+        const size_t capacity = m_Capacity;
+        FreeBlocks();
+        AddBlock(capacity);
+    }
+
+    void ScratchArena::Release()
+    {
+        FreeBlocks();
+        m_Offset = 0;
+    }
+
+    size_t ScratchArena::GetAllocationCount() const
+    {
+        return m_AllocationCount;
+    }
+
+    size_t ScratchArena::GetHeapAllocationCount() const
+    {
+        return m_HeapAllocationCount;
+    }
+
+    size_t ScratchArena::GetCapacity() const
+    {
+        return m_Capacity;
+    }
+
+    void* ScratchArena::AllocateBytes(size_t size, size_t alignment)
+    {
+        BLK_ASSERT(BLK_IS_POWER_OF_TWO(alignment));
+        BLK_ASSERT(alignment <= ms_BlockAlignment);
+
+        ++m_AllocationCount;
+
+        size_t offset = BLK_CEIL_TO_POWER_OF_TWO(m_Offset, alignment);
+        if (m_Blocks.empty() || offset + size > m_Blocks.back().size)
+        {
+            AddBlock(size);
+            offset = 0;
+        }
+
+        m_Offset = offset + size;
+        return m_Blocks.back().memory + offset;
+    }
+
+    void ScratchArena::AddBlock(size_t minSize)
+    {
+        // Grow geometrically, so that number of blocks stays logarithmic before coalescing
+        const size_t size = std::max({minSize, ms_MinBlockSize, m_Capacity});
+        const size_t alignedSize = BLK_CEIL_TO_POWER_OF_TWO(size, ms_BlockAlignment);
+
+        unsigned char* memory = static_cast<unsigned char*>(
+            ::operator new(alignedSize, std::align_val_t{ms_BlockAlignment}));
+        m_Blocks.push_back(Block{memory, alignedSize});
+        m_Capacity += alignedSize;
+        ++m_HeapAllocationCount;
+    }
+
+    void ScratchArena::FreeBlocks()
+    {
+        for (const Block& block : m_Blocks)
+        {
+            ::operator delete(block.memory, std::align_val_t{ms_BlockAlignment});
+        }
+        m_Blocks.clear();
+        m_Capacity = 0;
+    }
+
+} // namespace Boolka
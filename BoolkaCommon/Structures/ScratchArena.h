@@ -0,0 +1,74 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Linear allocator for temporary data of one worker thread
+    // Allocations live until Reset, memory is kept between resets so that steady state work
+    // doesn't touch heap at all
+    class [[nodiscard]] ScratchArena
+    {
+    public:
+        ScratchArena();
+        ~ScratchArena();
+
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena(ScratchArena&& other) noexcept;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+        ScratchArena& operator=(ScratchArena&& other) noexcept;
+
+        // Returned memory is not initialized
+        template <typename T>
+        [[nodiscard]] T* Allocate(size_t count);
+        template <typename T>
+        [[nodiscard]] T* AllocateZeroed(size_t count);
+
+        // Invalidates all allocations. If previous work didn't fit into single block, blocks are
+        // replaced with one block big enough for all of it
+        void Reset();
+        // Frees all memory
+        void Release();
+
+        [[nodiscard]] size_t GetAllocationCount() const;
+        [[nodiscard]] size_t GetHeapAllocationCount() const;
+        [[nodiscard]] size_t GetCapacity() const;
+
+    private:
+        struct Block
+        {
+            unsigned char* memory;
+            size_t size;
+        };
+
+        [[nodiscard]] void* AllocateBytes(size_t size, size_t alignment);
+        void AddBlock(size_t minSize);
+        void FreeBlocks();
+
+        static constexpr size_t ms_BlockAlignment = 64;
+        static constexpr size_t ms_MinBlockSize = 64 * 1024;
+
+        std::vector<Block> m_Blocks;
+        // Offset in last block
+        size_t m_Offset;
+        // Sum of sizes of all blocks, used to size coalesced block
+        size_t m_Capacity;
+        size_t m_AllocationCount;
+        size_t m_HeapAllocationCount;
+    };
+
+    template <typename T>
+    T* ScratchArena::Allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Destructors are never called");
+        return static_cast<T*>(AllocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    template <typename T>
+    T* ScratchArena::AllocateZeroed(size_t count)
+    {
+        T* result = Allocate<T>(count);
+        memset(result, 0, count * sizeof(T));
+        return result;
+    }
+
+} // namespace Boolka
@@ -0,0 +1,330 @@
+#pragma once
+
+namespace Boolka
+{
+
+    // Vector that keeps up to inlineCapacity elements inside of itself and moves them to heap
+    // when it grows past that, so that short lists don't allocate
+    // Adding elements invalidates pointers to them, same as for std::vector
+    template <typename T, size_t inlineCapacity>
+    class [[nodiscard]] SmallVector
+    {
+    public:
+        static_assert(inlineCapacity > 0, "Use std::vector when there is no inline storage");
+
+        SmallVector();
+        ~SmallVector();
+
+        SmallVector(std::initializer_list<T> elements);
+        SmallVector(const SmallVector& other);
+        SmallVector(SmallVector&& other) noexcept;
+        SmallVector& operator=(const SmallVector& other);
+        SmallVector& operator=(SmallVector&& other) noexcept;
+
+        T& Add(const T& element);
+        T& Add(T&& element);
+        // Arguments shouldn't reference elements of this vector, they may be moved before use
+        template <typename... Args>
+        T& Emplace(Args&&... args);
+        void RemoveLast();
+        // New elements are value initialized
+        void Resize(size_t size);
+        void Reserve(size_t capacity);
+        // Keeps allocated memory
+        void Clear();
+        // Removes all elements and frees heap memory
+        void Release();
+
+        [[nodiscard]] size_t GetSize() const;
+        [[nodiscard]] size_t GetCapacity() const;
+        [[nodiscard]] bool IsEmpty() const;
+        [[nodiscard]] bool IsInline() const;
+
+        [[nodiscard]] T* GetData();
+        [[nodiscard]] const T* GetData() const;
+        [[nodiscard]] T& operator[](size_t index);
+        [[nodiscard]] const T& operator[](size_t index) const;
+        [[nodiscard]] T& GetLast();
+        [[nodiscard]] const T& GetLast() const;
+
+        [[nodiscard]] T* begin();
+        [[nodiscard]] T* end();
+        [[nodiscard]] const T* begin() const;
+        [[nodiscard]] const T* end() const;
+
+    private:
+        [[nodiscard]] T* GetInlineData();
+        // Moves elements to storage of given capacity, which is inline storage if it fits
+        void Reallocate(size_t capacity);
+
+        T* m_Data;
+        size_t m_Size;
+        size_t m_Capacity;
+        alignas(T) unsigned char m_InlineStorage[sizeof(T) * inlineCapacity];
+    };
+
+    template <typename T, size_t inlineCapacity>
+    SmallVector<T, inlineCapacity>::SmallVector()
+        : m_Data(GetInlineData())
+        , m_Size(0)
+        , m_Capacity(inlineCapacity)
+    {
+    }
+
+    template <typename T, size_t inlineCapacity>
+    SmallVector<T, inlineCapacity>::~SmallVector()
+    {
+        Release();
+    }
+
+    template <typename T, size_t inlineCapacity>
+    SmallVector<T, inlineCapacity>::SmallVector(std::initializer_list<T> elements)
+        : SmallVector()
+    {
+        Reserve(elements.size());
+        for (const T& element : elements)
+            Add(element);
+    }
+
+    template <typename T, size_t inlineCapacity>
+    SmallVector<T, inlineCapacity>::SmallVector(const SmallVector& other)
+        : SmallVector()
+    {
+        *this = other;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    SmallVector<T, inlineCapacity>::SmallVector(SmallVector&& other) noexcept
+        : SmallVector()
+    {
+        *this = std::move(other);
+    }
+
+    template <typename T, size_t inlineCapacity>
+    SmallVector<T, inlineCapacity>& SmallVector<T, inlineCapacity>::operator=(
+        const SmallVector& other)
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        Reserve(other.m_Size);
+        std::uninitialized_copy_n(other.m_Data, other.m_Size, m_Data);
+        m_Size = other.m_Size;
+        return *this;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    SmallVector<T, inlineCapacity>& SmallVector<T, inlineCapacity>::operator=(
+        SmallVector&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Release();
+        if (other.IsInline())
+        {
+            std::uninitialized_move_n(other.m_Data, other.m_Size, m_Data);
+            m_Size = other.m_Size;
+            other.Clear();
+        }
+        else
+        {
+            // Heap storage is taken over without touching elements
+            m_Data = std::exchange(other.m_Data, other.GetInlineData());
+            m_Size = std::exchange(other.m_Size, 0);
+            m_Capacity = std::exchange(other.m_Capacity, inlineCapacity);
+        }
+        return *this;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T& SmallVector<T, inlineCapacity>::Add(const T& element)
+    {
+        if (m_Size == m_Capacity)
+        {
+            // Element may be part of this vector, so it is copied before reallocation
+            T copy(element);
+            return Emplace(std::move(copy));
+        }
+        return Emplace(element);
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T& SmallVector<T, inlineCapacity>::Add(T&& element)
+    {
+        if (m_Size == m_Capacity)
+        {
+            T moved(std::move(element));
+            return Emplace(std::move(moved));
+        }
+        return Emplace(std::move(element));
+    }
+
+    template <typename T, size_t inlineCapacity>
+    template <typename... Args>
+    T& SmallVector<T, inlineCapacity>::Emplace(Args&&... args)
+    {
+        if (m_Size == m_Capacity)
+            Reallocate(m_Capacity * 2);
+        T* element = std::construct_at(m_Data + m_Size, std::forward<Args>(args)...);
+        ++m_Size;
+        return *element;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    void SmallVector<T, inlineCapacity>::RemoveLast()
+    {
+        BLK_ASSERT(m_Size != 0);
+        std::destroy_at(m_Data + --m_Size);
+    }
+
+    template <typename T, size_t inlineCapacity>
+    void SmallVector<T, inlineCapacity>::Resize(size_t size)
+    {
+        if (size < m_Size)
+        {
+            std::destroy(m_Data + size, m_Data + m_Size);
+            m_Size = size;
+            return;
+        }
+
+        Reserve(size);
+        std::uninitialized_value_construct(m_Data + m_Size, m_Data + size);
+        m_Size = size;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    void SmallVector<T, inlineCapacity>::Reserve(size_t capacity)
+    {
+        if (capacity > m_Capacity)
+            Reallocate(std::max(capacity, m_Capacity * 2));
+    }
+
+    template <typename T, size_t inlineCapacity>
+    void SmallVector<T, inlineCapacity>::Clear()
+    {
+        std::destroy_n(m_Data, m_Size);
+        m_Size = 0;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    void SmallVector<T, inlineCapacity>::Release()
+    {
+        Clear();
+        if (!IsInline())
+            Reallocate(inlineCapacity);
+    }
+
+    template <typename T, size_t inlineCapacity>
+    size_t SmallVector<T, inlineCapacity>::GetSize() const
+    {
+        return m_Size;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    size_t SmallVector<T, inlineCapacity>::GetCapacity() const
+    {
+        return m_Capacity;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    bool SmallVector<T, inlineCapacity>::IsEmpty() const
+    {
+        return m_Size == 0;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    bool SmallVector<T, inlineCapacity>::IsInline() const
+    {
+        return static_cast<const void*>(m_Data) == static_cast<const void*>(m_InlineStorage);
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T* SmallVector<T, inlineCapacity>::GetData()
+    {
+        return m_Data;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    const T* SmallVector<T, inlineCapacity>::GetData() const
+    {
+        return m_Data;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T& SmallVector<T, inlineCapacity>::operator[](size_t index)
+    {
+        BLK_ASSERT(index < m_Size);
+        return m_Data[index];
+    }
+
+    template <typename T, size_t inlineCapacity>
+    const T& SmallVector<T, inlineCapacity>::operator[](size_t index) const
+    {
+        BLK_ASSERT(index < m_Size);
+        return m_Data[index];
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T& SmallVector<T, inlineCapacity>::GetLast()
+    {
+        return (*this)[m_Size - 1];
+    }
+
+    template <typename T, size_t inlineCapacity>
+    const T& SmallVector<T, inlineCapacity>::GetLast() const
+    {
+        return (*this)[m_Size - 1];
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T* SmallVector<T, inlineCapacity>::begin()
+    {
+        return m_Data;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T* SmallVector<T, inlineCapacity>::end()
+    {
+        return m_Data + m_Size;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    const T* SmallVector<T, inlineCapacity>::begin() const
+    {
+        return m_Data;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    const T* SmallVector<T, inlineCapacity>::end() const
+    {
+        return m_Data + m_Size;
+    }
+
+    template <typename T, size_t inlineCapacity>
+    T* SmallVector<T, inlineCapacity>::GetInlineData()
+    {
+        return std::launder(reinterpret_cast<T*>(m_InlineStorage));
+    }
+
+    template <typename T, size_t inlineCapacity>
+    void SmallVector<T, inlineCapacity>::Reallocate(size_t capacity)
+    {
+        BLK_ASSERT(capacity >= m_Size);
+
+        T* data = capacity <= inlineCapacity ? GetInlineData()
+                                             : std::allocator<T>().allocate(capacity);
+        if (data == m_Data)
+            return;
+
+        std::uninitialized_move_n(m_Data, m_Size, data);
+        std::destroy_n(m_Data, m_Size);
+        if (!IsInline())
+            std::allocator<T>().deallocate(m_Data, m_Capacity);
+
+        m_Data = data;
+        m_Capacity = std::max(capacity, inlineCapacity);
+    }
+
+} // namespace Boolka
@@ -2,6 +2,8 @@
 
 #include "Sphere.h"
 
+#include "FastMath.h"
+
 namespace Boolka
 {
 
@@ -47,10 +49,11 @@ namespace Boolka
         if (distanceToCenterSqr > oldSphereRadiusSqr)
         {
             float oldSphereRadius = ::sqrt(oldSphereRadiusSqr);
-            float distanceToCenter = ::sqrt(distanceToCenterSqr);
+            float inverseDistanceToCenter = FastMath::Rsqrt(distanceToCenterSqr);
+            float distanceToCenter = distanceToCenterSqr * inverseDistanceToCenter;
             float newSphereRadius = (oldSphereRadius + distanceToCenter) / 2.0f;
 
-            Vector4 appPointToCenterVector = (oldSphereCenter - addPoint).Normalize3();
+            Vector4 appPointToCenterVector = (oldSphereCenter - addPoint) * inverseDistanceToCenter;
             Vector4 newSphereCenter = addPoint + appPointToCenterVector * newSphereRadius;
             sphere = Sphere(newSphereCenter, newSphereRadius * newSphereRadius);
         }
@@ -76,9 +79,308 @@ namespace Boolka
         return result;
     }
 
+    // Minimal sphere is calculated in double precision, since circumsphere calculation is
+    // ill conditioned for nearly coplanar points
+    struct MinimalSpherePoint
+    {
+        double x, y, z;
+    };
+
+    struct MinimalSphereBall
+    {
+        MinimalSpherePoint center;
+        double radiusSqr;
+    };
+
+    static const double gs_MinimalSphereRelativeEpsilon = 1e-10;
+    // About 8 float ulps, covers rounding of radius and of float containment tests
+    static const double gs_MinimalSphereRadiusSlack = 1e-6;
+
+    static MinimalSpherePoint ToMinimalSpherePoint(const Vector4& vertex)
+    {
+        return MinimalSpherePoint{vertex.x(), vertex.y(), vertex.z()};
+    }
+
+    static double DistanceSqr(const MinimalSpherePoint& a, const MinimalSpherePoint& b)
+    {
+        double dx = a.x - b.x;
+        double dy = a.y - b.y;
+        double dz = a.z - b.z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    static bool IsInsideBall(const MinimalSphereBall& ball, const MinimalSpherePoint& point)
+    {
+        return DistanceSqr(ball.center, point) <=
+               ball.radiusSqr * (1.0 + gs_MinimalSphereRelativeEpsilon);
+    }
+
+    static MinimalSphereBall BallFrom1(const MinimalSpherePoint& a)
+    {
+        return MinimalSphereBall{a, 0.0};
+    }
+
+    static MinimalSphereBall BallFrom2(const MinimalSpherePoint& a, const MinimalSpherePoint& b)
+    {
+        MinimalSpherePoint center{(a.x + b.x) / 2.0, (a.y + b.y) / 2.0, (a.z + b.z) / 2.0};
+        return MinimalSphereBall{center, DistanceSqr(center, a)};
+    }
+
+    // Smallest sphere with 3 points on its boundary (circumcircle)
+    static MinimalSphereBall BallFrom3(const MinimalSpherePoint& a, const MinimalSpherePoint& b,
+                                       const MinimalSpherePoint& c)
+    {
+        double ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+        double vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+        double wx = uy * vz - uz * vy, wy = uz * vx - ux * vz, wz = ux * vy - uy * vx;
+        double wLengthSqr = wx * wx + wy * wy + wz * wz;
+        double uLengthSqr = ux * ux + uy * uy + uz * uz;
+        double vLengthSqr = vx * vx + vy * vy + vz * vz;
+
+        // Collinear points, widest pair defines the ball
+        if (wLengthSqr <= gs_MinimalSphereRelativeEpsilon * uLengthSqr * vLengthSqr)
+        {
+            MinimalSphereBall ab = BallFrom2(a, b);
+            MinimalSphereBall ac = BallFrom2(a, c);
+            MinimalSphereBall bc = BallFrom2(b, c);
+            MinimalSphereBall result = ab.radiusSqr > ac.radiusSqr ? ab : ac;
+            return result.radiusSqr > bc.radiusSqr ? result : bc;
+        }
+
+        // center = a + (|u|^2 (v x w) + |v|^2 (w x u)) / (2 |w|^2)
+        double vwx = vy * wz - vz * wy, vwy = vz * wx - vx * wz, vwz = vx * wy - vy * wx;
+        double wux = wy * uz - wz * uy, wuy = wz * ux - wx * uz, wuz = wx * uy - wy * ux;
+        double scale = 1.0 / (2.0 * wLengthSqr);
+        MinimalSpherePoint offset{(uLengthSqr * vwx + vLengthSqr * wux) * scale,
+                                  (uLengthSqr * vwy + vLengthSqr * wuy) * scale,
+                                  (uLengthSqr * vwz + vLengthSqr * wuz) * scale};
+
+        MinimalSpherePoint center{a.x + offset.x, a.y + offset.y, a.z + offset.z};
+        return MinimalSphereBall{center, offset.x * offset.x + offset.y * offset.y +
+                                             offset.z * offset.z};
+    }
+
+    // Sphere with 4 points on its boundary (circumsphere)
+    static MinimalSphereBall BallFrom4(const MinimalSpherePoint& a, const MinimalSpherePoint& b,
+                                       const MinimalSpherePoint& c, const MinimalSpherePoint& d)
+    {
+        double m[3][3] = {{b.x - a.x, b.y - a.y, b.z - a.z},
+                          {c.x - a.x, c.y - a.y, c.z - a.z},
+                          {d.x - a.x, d.y - a.y, d.z - a.z}};
+        double rhs[3];
+        for (size_t i = 0; i < 3; ++i)
+        {
+            rhs[i] = (m[i][0] * m[i][0] + m[i][1] * m[i][1] + m[i][2] * m[i][2]) / 2.0;
+        }
+
+        double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                     m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                     m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+
+        double scale = rhs[0] + rhs[1] + rhs[2];
+        // Coplanar points, fall back to best of the 3 point balls that contains all 4 points
+        if (abs(det) <= gs_MinimalSphereRelativeEpsilon * scale * sqrt(scale))
+        {
+            MinimalSphereBall candidates[] = {BallFrom3(a, b, c), BallFrom3(a, b, d),
+                                              BallFrom3(a, c, d), BallFrom3(b, c, d)};
+            const MinimalSphereBall* result = nullptr;
+            for (const auto& candidate : candidates)
+            {
+                bool containsAll = IsInsideBall(candidate, a) && IsInsideBall(candidate, b) &&
+                                   IsInsideBall(candidate, c) && IsInsideBall(candidate, d);
+                if (containsAll && (!result || candidate.radiusSqr < result->radiusSqr))
+                {
+                    result = &candidate;
+                }
+            }
+            // Only possible due to precision issues, largest ball is the safest choice
+            if (!result)
+            {
+                result = &*std::max_element(std::begin(candidates), std::end(candidates),
+                                            [](const auto& first, const auto& second) {
+                                                return first.radiusSqr < second.radiusSqr;
+                                            });
+            }
+            return *result;
+        }
+
+        // Cramer's rule
+        auto solve = [&](size_t column) {
+            double n[3][3];
+            for (size_t i = 0; i < 3; ++i)
+            {
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    n[i][j] = (j == column) ? rhs[i] : m[i][j];
+                }
+            }
+            return (n[0][0] * (n[1][1] * n[2][2] - n[1][2] * n[2][1]) -
+                    n[0][1] * (n[1][0] * n[2][2] - n[1][2] * n[2][0]) +
+                    n[0][2] * (n[1][0] * n[2][1] - n[1][1] * n[2][0])) /
+                   det;
+        };
+
+        MinimalSpherePoint offset{solve(0), solve(1), solve(2)};
+        MinimalSpherePoint center{a.x + offset.x, a.y + offset.y, a.z + offset.z};
+        return MinimalSphereBall{center, offset.x * offset.x + offset.y * offset.y +
+                                             offset.z * offset.z};
+    }
+
+    // Welzl's algorithm in its iterative form, points should be in random order
+    // Every nested loop fixes one more point on the boundary of the ball
+    static MinimalSphereBall CalculateMinimalBall(const std::vector<MinimalSpherePoint>& points)
+    {
+        BLK_ASSERT(!points.empty());
+
+        MinimalSphereBall ball = BallFrom1(points[0]);
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            if (IsInsideBall(ball, points[i]))
+                continue;
+
+            ball = BallFrom1(points[i]);
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (IsInsideBall(ball, points[j]))
+                    continue;
+
+                ball = BallFrom2(points[i], points[j]);
+                for (size_t k = 0; k < j; ++k)
+                {
+                    if (IsInsideBall(ball, points[k]))
+                        continue;
+
+                    ball = BallFrom3(points[i], points[j], points[k]);
+                    for (size_t l = 0; l < k; ++l)
+                    {
+                        if (IsInsideBall(ball, points[l]))
+                            continue;
+
+                        ball = BallFrom4(points[i], points[j], points[k], points[l]);
+                    }
+                }
+            }
+        }
+
+        return ball;
+    }
+
+    static Vector4 RoundMinimalBallCenter(const MinimalSphereBall& ball)
+    {
+        return Vector4{static_cast<float>(ball.center.x), static_cast<float>(ball.center.y),
+                       static_cast<float>(ball.center.z), 0.0f};
+    }
+
+    // Rounded center and radius can leave boundary points slightly outside of exact ball, so
+    // radius is measured from rounded center and expanded, to keep culling conservative
+    static Sphere MakeConservativeSphere(const Vector4& center, double maxDistanceSqr)
+    {
+        const double radius = sqrt(maxDistanceSqr) * (1.0 + gs_MinimalSphereRadiusSlack);
+        return Sphere(Vector3{center.x(), center.y(), center.z()},
+                      static_cast<float>(radius * radius));
+    }
+
+    // Exact algorithm https://en.wikipedia.org/wiki/Bounding_sphere#Welzl's_algorithm
+    // Large point sets are handled by running Welzl's algorithm on small support set and growing
+    // it with the farthest outside point, which is searched for in parallel
+    Sphere Sphere::BuildMinimalBoundingSphere(const Vector4* verticies, size_t vertexCount)
+    {
+        BLK_ASSERT(vertexCount > 0);
+
+        static const size_t maxDirectPointCount = 4096;
+        // Fixed seed, so result is deterministic between runs
+        std::mt19937 randomGenerator(0x426c6b);
+
+        std::vector<MinimalSpherePoint> supportPoints;
+
+        if (vertexCount <= maxDirectPointCount)
+        {
+            supportPoints.resize(vertexCount);
+            std::transform(verticies, verticies + vertexCount, supportPoints.begin(),
+                           ToMinimalSpherePoint);
+            std::shuffle(supportPoints.begin(), supportPoints.end(), randomGenerator);
+
+            const MinimalSphereBall ball = CalculateMinimalBall(supportPoints);
+            const Vector4 center = RoundMinimalBallCenter(ball);
+            const MinimalSpherePoint roundedCenter = ToMinimalSpherePoint(center);
+            double maxDistanceSqr = 0.0;
+            for (const MinimalSpherePoint& point : supportPoints)
+                maxDistanceSqr = std::max(maxDistanceSqr, DistanceSqr(roundedCenter, point));
+            return MakeConservativeSphere(center, maxDistanceSqr);
+        }
+
+        // Start with extreme points along coordinate axes
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            auto [minIter, maxIter] = std::minmax_element(
+                verticies, verticies + vertexCount,
+                [axis](const Vector4& a, const Vector4& b) { return a[axis] < b[axis]; });
+            supportPoints.push_back(ToMinimalSpherePoint(*minIter));
+            supportPoints.push_back(ToMinimalSpherePoint(*maxIter));
+        }
+
+        // Farthest point from exact ball center decides whether ball grows, distance from
+        // rounded center gives radius of result
+        struct FarthestPoint
+        {
+            double distanceSqr;
+            size_t index;
+            double roundedDistanceSqr;
+        };
+
+        std::vector<size_t> indices(vertexCount);
+        std::iota(indices.begin(), indices.end(), 0);
+
+        while (true)
+        {
+            std::shuffle(supportPoints.begin(), supportPoints.end(), randomGenerator);
+            const MinimalSphereBall ball = CalculateMinimalBall(supportPoints);
+            const Vector4 center = RoundMinimalBallCenter(ball);
+            const MinimalSpherePoint roundedCenter = ToMinimalSpherePoint(center);
+
+            const FarthestPoint farthest = std::transform_reduce(
+                std::execution::par_unseq, indices.begin(), indices.end(),
+                FarthestPoint{0.0, 0, 0.0},
+                [](const FarthestPoint& a, const FarthestPoint& b) {
+                    FarthestPoint result = a.distanceSqr >= b.distanceSqr ? a : b;
+                    result.roundedDistanceSqr =
+                        std::max(a.roundedDistanceSqr, b.roundedDistanceSqr);
+                    return result;
+                },
+                [&](size_t index) {
+                    const MinimalSpherePoint point = ToMinimalSpherePoint(verticies[index]);
+                    return FarthestPoint{DistanceSqr(ball.center, point), index,
+                                         DistanceSqr(roundedCenter, point)};
+                });
+
+            const MinimalSpherePoint farthestPoint =
+                ToMinimalSpherePoint(verticies[farthest.index]);
+            if (IsInsideBall(ball, farthestPoint))
+                return MakeConservativeSphere(center, farthest.roundedDistanceSqr);
+
+            supportPoints.push_back(farthestPoint);
+        }
+    }
+
+    bool Sphere::Contains(const Vector4& point, float epsilon) const
+    {
+        float radius = GetRadius() + epsilon;
+        return (m_Sphere - point).Length3Sqr() <= radius * radius;
+    }
+
     const Vector4& Sphere::GetData()
     {
         return m_Sphere;
     }
 
+    const Vector4& Sphere::GetData() const
+    {
+        return m_Sphere;
+    }
+
+    float Sphere::GetRadius() const
+    {
+        return ::sqrt(m_Sphere.w());
+    }
+
 } // namespace Boolka
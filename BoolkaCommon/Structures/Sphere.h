@@ -17,8 +17,15 @@ namespace Boolka
 
         [[nodiscard]] static Sphere BuildBoundingSphere(const Vector4* verticies,
                                                         size_t vertexCount);
+        // Exact minimal enclosing sphere, slower than BuildBoundingSphere
+        [[nodiscard]] static Sphere BuildMinimalBoundingSphere(const Vector4* verticies,
+                                                               size_t vertexCount);
+
+        [[nodiscard]] bool Contains(const Vector4& point, float epsilon = 0.0f) const;
 
         [[nodiscard]] const Vector4& GetData();
+        [[nodiscard]] const Vector4& GetData() const;
+        [[nodiscard]] float GetRadius() const;
 
     private:
         // xyz - center, w - radius squared
@@ -0,0 +1,770 @@
+#pragma once
+
+#ifdef BLK_USE_SSE
+#include <immintrin.h>
+#endif
+
+namespace Boolka
+{
+
+    // Lane operations of 8 wide float and int types
+    // Every backend follows SSE semantics, so results are bit identical between them:
+    // - Min/Max return second argument if either argument is NaN
+    // - Select picks lane by sign bit of mask
+    // - Float to int conversion truncates and gives INT32_MIN for NaN and out of range values
+    // - Integer arithmetic wraps around
+    struct WideBackendScalar
+    {
+        static constexpr size_t ms_Width = 8;
+
+        struct FloatType
+        {
+            float data[ms_Width];
+        };
+
+        struct IntType
+        {
+            int32_t data[ms_Width];
+        };
+
+        template <typename Operation>
+        [[nodiscard]] static FloatType Transform(const FloatType& first, const FloatType& second,
+                                                 Operation operation)
+        {
+            FloatType result;
+            for (size_t i = 0; i < ms_Width; ++i)
+                result.data[i] = operation(first.data[i], second.data[i]);
+            return result;
+        }
+
+        template <typename Operation>
+        [[nodiscard]] static IntType TransformInt(const IntType& first, const IntType& second,
+                                                  Operation operation)
+        {
+            IntType result;
+            for (size_t i = 0; i < ms_Width; ++i)
+                result.data[i] = operation(first.data[i], second.data[i]);
+            return result;
+        }
+
+        template <typename Operation>
+        [[nodiscard]] static FloatType TransformBits(const FloatType& first,
+                                                     const FloatType& second, Operation operation)
+        {
+            return Transform(first, second, [operation](float a, float b) {
+                return std::bit_cast<float>(
+                    operation(std::bit_cast<uint32_t>(a), std::bit_cast<uint32_t>(b)));
+            });
+        }
+
+        template <typename Operation>
+        [[nodiscard]] static FloatType Compare(const FloatType& first, const FloatType& second,
+                                               Operation operation)
+        {
+            return Transform(first, second, [operation](float a, float b) {
+                return std::bit_cast<float>(operation(a, b) ? ~0u : 0u);
+            });
+        }
+
+        [[nodiscard]] static FloatType Set(float value)
+        {
+            FloatType result;
+            std::fill(std::begin(result.data), std::end(result.data), value);
+            return result;
+        }
+
+        [[nodiscard]] static FloatType Load(const float* data)
+        {
+            FloatType result;
+            std::copy(data, data + ms_Width, result.data);
+            return result;
+        }
+
+        static void Store(float* data, const FloatType& value)
+        {
+            std::copy(std::begin(value.data), std::end(value.data), data);
+        }
+
+        [[nodiscard]] static FloatType Add(const FloatType& first, const FloatType& second)
+        {
+            return Transform(first, second, [](float a, float b) { return a + b; });
+        }
+
+        [[nodiscard]] static FloatType Sub(const FloatType& first, const FloatType& second)
+        {
+            return Transform(first, second, [](float a, float b) { return a - b; });
+        }
+
+        [[nodiscard]] static FloatType Mul(const FloatType& first, const FloatType& second)
+        {
+            return Transform(first, second, [](float a, float b) { return a * b; });
+        }
+
+        [[nodiscard]] static FloatType Div(const FloatType& first, const FloatType& second)
+        {
+            return Transform(first, second, [](float a, float b) { return a / b; });
+        }
+
+        [[nodiscard]] static FloatType Min(const FloatType& first, const FloatType& second)
+        {
+            return Transform(first, second, [](float a, float b) { return a < b ? a : b; });
+        }
+
+        [[nodiscard]] static FloatType Max(const FloatType& first, const FloatType& second)
+        {
+            return Transform(first, second, [](float a, float b) { return a > b ? a : b; });
+        }
+
+        [[nodiscard]] static FloatType Sqrt(const FloatType& value)
+        {
+            return Transform(value, value, [](float a, float) { return ::sqrt(a); });
+        }
+
+        [[nodiscard]] static FloatType And(const FloatType& first, const FloatType& second)
+        {
+            return TransformBits(first, second, [](uint32_t a, uint32_t b) { return a & b; });
+        }
+
+        [[nodiscard]] static FloatType Or(const FloatType& first, const FloatType& second)
+        {
+            return TransformBits(first, second, [](uint32_t a, uint32_t b) { return a | b; });
+        }
+
+        [[nodiscard]] static FloatType Xor(const FloatType& first, const FloatType& second)
+        {
+            return TransformBits(first, second, [](uint32_t a, uint32_t b) { return a ^ b; });
+        }
+
+        // ~first & second
+        [[nodiscard]] static FloatType AndNot(const FloatType& first, const FloatType& second)
+        {
+            return TransformBits(first, second, [](uint32_t a, uint32_t b) { return ~a & b; });
+        }
+
+        [[nodiscard]] static FloatType Less(const FloatType& first, const FloatType& second)
+        {
+            return Compare(first, second, [](float a, float b) { return a < b; });
+        }
+
+        [[nodiscard]] static FloatType LessEqual(const FloatType& first, const FloatType& second)
+        {
+            return Compare(first, second, [](float a, float b) { return a <= b; });
+        }
+
+        [[nodiscard]] static FloatType Equal(const FloatType& first, const FloatType& second)
+        {
+            return Compare(first, second, [](float a, float b) { return a == b; });
+        }
+
+        [[nodiscard]] static FloatType NotEqual(const FloatType& first, const FloatType& second)
+        {
+            return Compare(first, second, [](float a, float b) { return !(a == b); });
+        }
+
+        // mask ? second : first
+        [[nodiscard]] static FloatType Select(const FloatType& first, const FloatType& second,
+                                              const FloatType& mask)
+        {
+            FloatType result;
+            for (size_t i = 0; i < ms_Width; ++i)
+                result.data[i] = std::signbit(mask.data[i]) ? second.data[i] : first.data[i];
+            return result;
+        }
+
+        // Bit i is sign bit of lane i
+        [[nodiscard]] static uint32_t GetSignMask(const FloatType& value)
+        {
+            uint32_t result = 0;
+            for (size_t i = 0; i < ms_Width; ++i)
+                result |= static_cast<uint32_t>(std::signbit(value.data[i])) << i;
+            return result;
+        }
+
+        [[nodiscard]] static IntType SetInt(int32_t value)
+        {
+            IntType result;
+            std::fill(std::begin(result.data), std::end(result.data), value);
+            return result;
+        }
+
+        [[nodiscard]] static IntType LoadInt(const int32_t* data)
+        {
+            IntType result;
+            std::copy(data, data + ms_Width, result.data);
+            return result;
+        }
+
+        static void StoreInt(int32_t* data, const IntType& value)
+        {
+            std::copy(std::begin(value.data), std::end(value.data), data);
+        }
+
+        [[nodiscard]] static IntType AddInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) {
+                return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+            });
+        }
+
+        [[nodiscard]] static IntType SubInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) {
+                return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+            });
+        }
+
+        [[nodiscard]] static IntType MulInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) {
+                return static_cast<int32_t>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b));
+            });
+        }
+
+        [[nodiscard]] static IntType MinInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) { return std::min(a, b); });
+        }
+
+        [[nodiscard]] static IntType MaxInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) { return std::max(a, b); });
+        }
+
+        [[nodiscard]] static IntType AndInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) { return a & b; });
+        }
+
+        [[nodiscard]] static IntType OrInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) { return a | b; });
+        }
+
+        [[nodiscard]] static IntType XorInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) { return a ^ b; });
+        }
+
+        [[nodiscard]] static IntType EqualInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second,
+                                [](int32_t a, int32_t b) { return a == b ? -1 : 0; });
+        }
+
+        [[nodiscard]] static IntType GreaterInt(const IntType& first, const IntType& second)
+        {
+            return TransformInt(first, second, [](int32_t a, int32_t b) { return a > b ? -1 : 0; });
+        }
+
+        [[nodiscard]] static IntType ShiftLeft(const IntType& value, int count)
+        {
+            return TransformInt(value, value, [count](int32_t a, int32_t) {
+                return static_cast<int32_t>(static_cast<uint32_t>(a) << count);
+            });
+        }
+
+        [[nodiscard]] static IntType ShiftRightLogical(const IntType& value, int count)
+        {
+            return TransformInt(value, value, [count](int32_t a, int32_t) {
+                return static_cast<int32_t>(static_cast<uint32_t>(a) >> count);
+            });
+        }
+
+        [[nodiscard]] static IntType ShiftRightArithmetic(const IntType& value, int count)
+        {
+            return TransformInt(value, value, [count](int32_t a, int32_t) { return a >> count; });
+        }
+
+        [[nodiscard]] static FloatType ConvertToFloat(const IntType& value)
+        {
+            FloatType result;
+            for (size_t i = 0; i < ms_Width; ++i)
+                result.data[i] = static_cast<float>(value.data[i]);
+            return result;
+        }
+
+        [[nodiscard]] static IntType ConvertToInt(const FloatType& value)
+        {
+            IntType result;
+            for (size_t i = 0; i < ms_Width; ++i)
+            {
+                const float lane = value.data[i];
+                const bool isInRange = lane >= -2147483648.0f && lane < 2147483648.0f;
+                result.data[i] = isInRange ? static_cast<int32_t>(lane) : INT32_MIN;
+            }
+            return result;
+        }
+
+        [[nodiscard]] static FloatType CastToFloat(const IntType& value)
+        {
+            return std::bit_cast<FloatType>(value);
+        }
+
+        [[nodiscard]] static IntType CastToInt(const FloatType& value)
+        {
+            return std::bit_cast<IntType>(value);
+        }
+    };
+
+#ifdef BLK_USE_SSE
+
+    // Each 8 wide value is pair of SSE registers
+    struct WideBackendSSE
+    {
+        static constexpr size_t ms_Width = 8;
+
+        struct FloatType
+        {
+            __m128 low;
+            __m128 high;
+        };
+
+        struct IntType
+        {
+            __m128i low;
+            __m128i high;
+        };
+
+        [[nodiscard]] static FloatType Set(float value)
+        {
+            const __m128 result = _mm_set1_ps(value);
+            return {result, result};
+        }
+
+        [[nodiscard]] static FloatType Load(const float* data)
+        {
+            return {_mm_loadu_ps(data), _mm_loadu_ps(data + 4)};
+        }
+
+        static void Store(float* data, const FloatType& value)
+        {
+            _mm_storeu_ps(data, value.low);
+            _mm_storeu_ps(data + 4, value.high);
+        }
+
+        [[nodiscard]] static FloatType Add(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_add_ps(first.low, second.low), _mm_add_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Sub(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_sub_ps(first.low, second.low), _mm_sub_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Mul(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_mul_ps(first.low, second.low), _mm_mul_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Div(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_div_ps(first.low, second.low), _mm_div_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Min(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_min_ps(first.low, second.low), _mm_min_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Max(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_max_ps(first.low, second.low), _mm_max_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Sqrt(const FloatType& value)
+        {
+            return {_mm_sqrt_ps(value.low), _mm_sqrt_ps(value.high)};
+        }
+
+        [[nodiscard]] static FloatType And(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_and_ps(first.low, second.low), _mm_and_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Or(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_or_ps(first.low, second.low), _mm_or_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Xor(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_xor_ps(first.low, second.low), _mm_xor_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType AndNot(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_andnot_ps(first.low, second.low), _mm_andnot_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Less(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_cmplt_ps(first.low, second.low), _mm_cmplt_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType LessEqual(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_cmple_ps(first.low, second.low), _mm_cmple_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Equal(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_cmpeq_ps(first.low, second.low), _mm_cmpeq_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType NotEqual(const FloatType& first, const FloatType& second)
+        {
+            return {_mm_cmpneq_ps(first.low, second.low),
+                    _mm_cmpneq_ps(first.high, second.high)};
+        }
+
+        [[nodiscard]] static FloatType Select(const FloatType& first, const FloatType& second,
+                                              const FloatType& mask)
+        {
+            return {_mm_blendv_ps(first.low, second.low, mask.low),
+                    _mm_blendv_ps(first.high, second.high, mask.high)};
+        }
+
+        [[nodiscard]] static uint32_t GetSignMask(const FloatType& value)
+        {
+            return static_cast<uint32_t>(_mm_movemask_ps(value.low) |
+                                         (_mm_movemask_ps(value.high) << 4));
+        }
+
+        [[nodiscard]] static IntType SetInt(int32_t value)
+        {
+            const __m128i result = _mm_set1_epi32(value);
+            return {result, result};
+        }
+
+        [[nodiscard]] static IntType LoadInt(const int32_t* data)
+        {
+            return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4))};
+        }
+
+        static void StoreInt(int32_t* data, const IntType& value)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value.low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4), value.high);
+        }
+
+        [[nodiscard]] static IntType AddInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_add_epi32(first.low, second.low), _mm_add_epi32(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType SubInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_sub_epi32(first.low, second.low), _mm_sub_epi32(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType MulInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_mullo_epi32(first.low, second.low),
+                    _mm_mullo_epi32(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType MinInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_min_epi32(first.low, second.low), _mm_min_epi32(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType MaxInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_max_epi32(first.low, second.low), _mm_max_epi32(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType AndInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_and_si128(first.low, second.low), _mm_and_si128(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType OrInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_or_si128(first.low, second.low), _mm_or_si128(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType XorInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_xor_si128(first.low, second.low), _mm_xor_si128(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType EqualInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_cmpeq_epi32(first.low, second.low),
+                    _mm_cmpeq_epi32(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType GreaterInt(const IntType& first, const IntType& second)
+        {
+            return {_mm_cmpgt_epi32(first.low, second.low),
+                    _mm_cmpgt_epi32(first.high, second.high)};
+        }
+
+        [[nodiscard]] static IntType ShiftLeft(const IntType& value, int count)
+        {
+            const __m128i shift = _mm_cvtsi32_si128(count);
+            return {_mm_sll_epi32(value.low, shift), _mm_sll_epi32(value.high, shift)};
+        }
+
+        [[nodiscard]] static IntType ShiftRightLogical(const IntType& value, int count)
+        {
+            const __m128i shift = _mm_cvtsi32_si128(count);
+            return {_mm_srl_epi32(value.low, shift), _mm_srl_epi32(value.high, shift)};
+        }
+
+        [[nodiscard]] static IntType ShiftRightArithmetic(const IntType& value, int count)
+        {
+            const __m128i shift = _mm_cvtsi32_si128(count);
+            return {_mm_sra_epi32(value.low, shift), _mm_sra_epi32(value.high, shift)};
+        }
+
+        [[nodiscard]] static FloatType ConvertToFloat(const IntType& value)
+        {
+            return {_mm_cvtepi32_ps(value.low), _mm_cvtepi32_ps(value.high)};
+        }
+
+        [[nodiscard]] static IntType ConvertToInt(const FloatType& value)
+        {
+            return {_mm_cvttps_epi32(value.low), _mm_cvttps_epi32(value.high)};
+        }
+
+        [[nodiscard]] static FloatType CastToFloat(const IntType& value)
+        {
+            return {_mm_castsi128_ps(value.low), _mm_castsi128_ps(value.high)};
+        }
+
+        [[nodiscard]] static IntType CastToInt(const FloatType& value)
+        {
+            return {_mm_castps_si128(value.low), _mm_castps_si128(value.high)};
+        }
+    };
+
+#endif
+
+#if defined(BLK_USE_SSE) && defined(__AVX2__)
+
+    struct WideBackendAVX2
+    {
+        static constexpr size_t ms_Width = 8;
+
+        using FloatType = __m256;
+        using IntType = __m256i;
+
+        [[nodiscard]] static FloatType Set(float value)
+        {
+            return _mm256_set1_ps(value);
+        }
+
+        [[nodiscard]] static FloatType Load(const float* data)
+        {
+            return _mm256_loadu_ps(data);
+        }
+
+        static void Store(float* data, const FloatType& value)
+        {
+            _mm256_storeu_ps(data, value);
+        }
+
+        [[nodiscard]] static FloatType Add(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_add_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Sub(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_sub_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Mul(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_mul_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Div(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_div_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Min(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_min_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Max(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_max_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Sqrt(const FloatType& value)
+        {
+            return _mm256_sqrt_ps(value);
+        }
+
+        [[nodiscard]] static FloatType And(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_and_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Or(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_or_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Xor(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_xor_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType AndNot(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_andnot_ps(first, second);
+        }
+
+        [[nodiscard]] static FloatType Less(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_cmp_ps(first, second, _CMP_LT_OQ);
+        }
+
+        [[nodiscard]] static FloatType LessEqual(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_cmp_ps(first, second, _CMP_LE_OQ);
+        }
+
+        [[nodiscard]] static FloatType Equal(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_cmp_ps(first, second, _CMP_EQ_OQ);
+        }
+
+        [[nodiscard]] static FloatType NotEqual(const FloatType& first, const FloatType& second)
+        {
+            return _mm256_cmp_ps(first, second, _CMP_NEQ_UQ);
+        }
+
+        [[nodiscard]] static FloatType Select(const FloatType& first, const FloatType& second,
+                                              const FloatType& mask)
+        {
+            return _mm256_blendv_ps(first, second, mask);
+        }
+
+        [[nodiscard]] static uint32_t GetSignMask(const FloatType& value)
+        {
+            return static_cast<uint32_t>(_mm256_movemask_ps(value));
+        }
+
+        [[nodiscard]] static IntType SetInt(int32_t value)
+        {
+            return _mm256_set1_epi32(value);
+        }
+
+        [[nodiscard]] static IntType LoadInt(const int32_t* data)
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        }
+
+        static void StoreInt(int32_t* data, const IntType& value)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), value);
+        }
+
+        [[nodiscard]] static IntType AddInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_add_epi32(first, second);
+        }
+
+        [[nodiscard]] static IntType SubInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_sub_epi32(first, second);
+        }
+
+        [[nodiscard]] static IntType MulInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_mullo_epi32(first, second);
+        }
+
+        [[nodiscard]] static IntType MinInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_min_epi32(first, second);
+        }
+
+        [[nodiscard]] static IntType MaxInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_max_epi32(first, second);
+        }
+
+        [[nodiscard]] static IntType AndInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_and_si256(first, second);
+        }
+
+        [[nodiscard]] static IntType OrInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_or_si256(first, second);
+        }
+
+        [[nodiscard]] static IntType XorInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_xor_si256(first, second);
+        }
+
+        [[nodiscard]] static IntType EqualInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_cmpeq_epi32(first, second);
+        }
+
+        [[nodiscard]] static IntType GreaterInt(const IntType& first, const IntType& second)
+        {
+            return _mm256_cmpgt_epi32(first, second);
+        }
+
+        [[nodiscard]] static IntType ShiftLeft(const IntType& value, int count)
+        {
+            return _mm256_sll_epi32(value, _mm_cvtsi32_si128(count));
+        }
+
+        [[nodiscard]] static IntType ShiftRightLogical(const IntType& value, int count)
+        {
+            return _mm256_srl_epi32(value, _mm_cvtsi32_si128(count));
+        }
+
+        [[nodiscard]] static IntType ShiftRightArithmetic(const IntType& value, int count)
+        {
+            return _mm256_sra_epi32(value, _mm_cvtsi32_si128(count));
+        }
+
+        [[nodiscard]] static FloatType ConvertToFloat(const IntType& value)
+        {
+            return _mm256_cvtepi32_ps(value);
+        }
+
+        [[nodiscard]] static IntType ConvertToInt(const FloatType& value)
+        {
+            return _mm256_cvttps_epi32(value);
+        }
+
+        [[nodiscard]] static FloatType CastToFloat(const IntType& value)
+        {
+            return _mm256_castsi256_ps(value);
+        }
+
+        [[nodiscard]] static IntType CastToInt(const FloatType& value)
+        {
+            return _mm256_castps_si256(value);
+        }
+    };
+
+#endif
+
+    // Widest backend that current source is built for
+    // AVX2 backend is only available in sources built with /arch:AVX2, which should only run
+    // after CPUFeatures::HasAVX2 check
+#if defined(BLK_USE_SSE) && defined(__AVX2__)
+    using WideBackendDefault = WideBackendAVX2;
+#elif defined(BLK_USE_SSE)
+    using WideBackendDefault = WideBackendSSE;
+#else
+    using WideBackendDefault = WideBackendScalar;
+#endif
+
+} // namespace Boolka
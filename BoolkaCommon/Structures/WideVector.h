@@ -0,0 +1,1088 @@
+#pragma once
+#include "WideBackends.h"
+
+namespace Boolka
+{
+
+    template <typename Backend>
+    class Int8T;
+
+    // 8 floats processed at once
+    // Comparisons return masks with all bits of lane set or cleared, masks are consumed by
+    // Select and GetSignMask and can be combined with bitwise operators
+    template <typename Backend>
+    class [[nodiscard]] Float8T
+    {
+    public:
+        using thisType = Float8T<Backend>;
+        using InternalType = typename Backend::FloatType;
+
+        static constexpr size_t ms_Width = Backend::ms_Width;
+
+        Float8T();
+        ~Float8T() = default;
+
+        Float8T(const Float8T&) = default;
+        Float8T(Float8T&&) = default;
+        Float8T& operator=(const Float8T&) = default;
+        Float8T& operator=(Float8T&&) = default;
+
+        // Same value in every lane
+        Float8T(float value);
+        Float8T(const InternalType& data);
+
+        [[nodiscard]] static thisType Load(const float* data);
+        void Store(float* data) const;
+
+        [[nodiscard]] InternalType& GetInternal();
+        [[nodiscard]] const InternalType& GetInternal() const;
+
+        // Slow, use Store to read all lanes
+        [[nodiscard]] float operator[](size_t i) const;
+
+        [[nodiscard]] thisType Min(const thisType& other) const;
+        [[nodiscard]] thisType Max(const thisType& other) const;
+        [[nodiscard]] thisType Abs() const;
+        [[nodiscard]] thisType Sqrt() const;
+
+        // mask ? other : this
+        [[nodiscard]] thisType Select(const thisType& other, const thisType& mask) const;
+        // Bit i is sign bit of lane i
+        [[nodiscard]] uint32_t GetSignMask() const;
+
+        // Truncates, NaN and values out of int range give INT32_MIN
+        [[nodiscard]] Int8T<Backend> ToInt() const;
+        // Reinterprets bits
+        [[nodiscard]] Int8T<Backend> AsInt() const;
+
+        [[nodiscard]] thisType operator-() const;
+
+        thisType& operator*=(const thisType& other);
+        thisType& operator/=(const thisType& other);
+        thisType& operator+=(const thisType& other);
+        thisType& operator-=(const thisType& other);
+        [[nodiscard]] thisType operator*(const thisType& other) const;
+        [[nodiscard]] thisType operator/(const thisType& other) const;
+        [[nodiscard]] thisType operator+(const thisType& other) const;
+        [[nodiscard]] thisType operator-(const thisType& other) const;
+
+        [[nodiscard]] thisType operator&(const thisType& other) const;
+        [[nodiscard]] thisType operator|(const thisType& other) const;
+        [[nodiscard]] thisType operator^(const thisType& other) const;
+        // ~this & other
+        [[nodiscard]] thisType AndNot(const thisType& other) const;
+
+        [[nodiscard]] thisType operator>(const thisType& other) const;
+        [[nodiscard]] thisType operator<(const thisType& other) const;
+        [[nodiscard]] thisType operator>=(const thisType& other) const;
+        [[nodiscard]] thisType operator<=(const thisType& other) const;
+        [[nodiscard]] thisType EqualMask(const thisType& other) const;
+        [[nodiscard]] thisType NotEqualMask(const thisType& other) const;
+
+    private:
+        InternalType m_data;
+    };
+
+    // 8 int32_t processed at once, arithmetic wraps around
+    template <typename Backend>
+    class [[nodiscard]] Int8T
+    {
+    public:
+        using thisType = Int8T<Backend>;
+        using InternalType = typename Backend::IntType;
+
+        static constexpr size_t ms_Width = Backend::ms_Width;
+
+        Int8T();
+        ~Int8T() = default;
+
+        Int8T(const Int8T&) = default;
+        Int8T(Int8T&&) = default;
+        Int8T& operator=(const Int8T&) = default;
+        Int8T& operator=(Int8T&&) = default;
+
+        // Same value in every lane
+        Int8T(int32_t value);
+        Int8T(const InternalType& data);
+
+        [[nodiscard]] static thisType Load(const int32_t* data);
+        void Store(int32_t* data) const;
+
+        [[nodiscard]] InternalType& GetInternal();
+        [[nodiscard]] const InternalType& GetInternal() const;
+
+        // Slow, use Store to read all lanes
+        [[nodiscard]] int32_t operator[](size_t i) const;
+
+        [[nodiscard]] thisType Min(const thisType& other) const;
+        [[nodiscard]] thisType Max(const thisType& other) const;
+
+        // mask ? other : this, every bit of mask lane should be same
+        [[nodiscard]] thisType Select(const thisType& other, const thisType& mask) const;
+        // Bit i is sign bit of lane i
+        [[nodiscard]] uint32_t GetSignMask() const;
+
+        [[nodiscard]] Float8T<Backend> ToFloat() const;
+        // Reinterprets bits
+        [[nodiscard]] Float8T<Backend> AsFloat() const;
+
+        [[nodiscard]] thisType operator-() const;
+
+        thisType& operator*=(const thisType& other);
+        thisType& operator+=(const thisType& other);
+        thisType& operator-=(const thisType& other);
+        [[nodiscard]] thisType operator*(const thisType& other) const;
+        [[nodiscard]] thisType operator+(const thisType& other) const;
+        [[nodiscard]] thisType operator-(const thisType& other) const;
+
+        [[nodiscard]] thisType operator&(const thisType& other) const;
+        [[nodiscard]] thisType operator|(const thisType& other) const;
+        [[nodiscard]] thisType operator^(const thisType& other) const;
+        [[nodiscard]] thisType operator~() const;
+
+        // Count should be less than 32
+        [[nodiscard]] thisType operator<<(int count) const;
+        // Arithmetic shift, use ShiftRightLogical to shift in zeroes
+        [[nodiscard]] thisType operator>>(int count) const;
+        [[nodiscard]] thisType ShiftRightLogical(int count) const;
+
+        [[nodiscard]] thisType operator>(const thisType& other) const;
+        [[nodiscard]] thisType operator<(const thisType& other) const;
+        [[nodiscard]] thisType EqualMask(const thisType& other) const;
+        [[nodiscard]] thisType NotEqualMask(const thisType& other) const;
+
+    private:
+        InternalType m_data;
+    };
+
+    // 8 three component vectors stored as structure of arrays
+    template <typename Backend>
+    class [[nodiscard]] Vector3x8T
+    {
+    public:
+        using thisType = Vector3x8T<Backend>;
+        using FloatType = Float8T<Backend>;
+
+        Vector3x8T() = default;
+        ~Vector3x8T() = default;
+
+        Vector3x8T(const Vector3x8T&) = default;
+        Vector3x8T(Vector3x8T&&) = default;
+        Vector3x8T& operator=(const Vector3x8T&) = default;
+        Vector3x8T& operator=(Vector3x8T&&) = default;
+
+        Vector3x8T(const FloatType& x, const FloatType& y, const FloatType& z);
+        // Same vector in every lane
+        Vector3x8T(const Vector3& value);
+
+        [[nodiscard]] static thisType Load(const float* x, const float* y, const float* z);
+        void Store(float* x, float* y, float* z) const;
+
+        [[nodiscard]] FloatType& x();
+        [[nodiscard]] FloatType& y();
+        [[nodiscard]] FloatType& z();
+        [[nodiscard]] const FloatType& x() const;
+        [[nodiscard]] const FloatType& y() const;
+        [[nodiscard]] const FloatType& z() const;
+
+        // Slow, use Store to read all lanes
+        [[nodiscard]] Vector3 GetLane(size_t i) const;
+
+        // Terms are summed in same order as Vector3::Dot
+        [[nodiscard]] FloatType Dot(const thisType& other) const;
+        [[nodiscard]] thisType Cross(const thisType& other) const;
+        [[nodiscard]] FloatType LengthSqr() const;
+
+        [[nodiscard]] thisType Min(const thisType& other) const;
+        [[nodiscard]] thisType Max(const thisType& other) const;
+        // mask ? other : this, mask is per lane
+        [[nodiscard]] thisType Select(const thisType& other, const FloatType& mask) const;
+
+        [[nodiscard]] thisType operator-() const;
+
+        thisType& operator*=(const FloatType& other);
+        thisType& operator/=(const FloatType& other);
+        [[nodiscard]] thisType operator*(const FloatType& other) const;
+        [[nodiscard]] thisType operator/(const FloatType& other) const;
+
+        thisType& operator*=(const thisType& other);
+        thisType& operator+=(const thisType& other);
+        thisType& operator-=(const thisType& other);
+        [[nodiscard]] thisType operator*(const thisType& other) const;
+        [[nodiscard]] thisType operator+(const thisType& other) const;
+        [[nodiscard]] thisType operator-(const thisType& other) const;
+
+    private:
+        FloatType m_x;
+        FloatType m_y;
+        FloatType m_z;
+    };
+
+    // 8 four component vectors stored as structure of arrays
+    template <typename Backend>
+    class [[nodiscard]] Vector4x8T
+    {
+    public:
+        using thisType = Vector4x8T<Backend>;
+        using FloatType = Float8T<Backend>;
+
+        Vector4x8T() = default;
+        ~Vector4x8T() = default;
+
+        Vector4x8T(const Vector4x8T&) = default;
+        Vector4x8T(Vector4x8T&&) = default;
+        Vector4x8T& operator=(const Vector4x8T&) = default;
+        Vector4x8T& operator=(Vector4x8T&&) = default;
+
+        Vector4x8T(const FloatType& x, const FloatType& y, const FloatType& z,
+                   const FloatType& w);
+        // Same vector in every lane
+        Vector4x8T(const Vector4& value);
+
+        [[nodiscard]] static thisType Load(const float* x, const float* y, const float* z,
+                                           const float* w);
+        void Store(float* x, float* y, float* z, float* w) const;
+
+        [[nodiscard]] FloatType& x();
+        [[nodiscard]] FloatType& y();
+        [[nodiscard]] FloatType& z();
+        [[nodiscard]] FloatType& w();
+        [[nodiscard]] const FloatType& x() const;
+        [[nodiscard]] const FloatType& y() const;
+        [[nodiscard]] const FloatType& z() const;
+        [[nodiscard]] const FloatType& w() const;
+
+        // Slow, use Store to read all lanes
+        [[nodiscard]] Vector4 GetLane(size_t i) const;
+
+        // Terms are summed in same order as Vector4::Dot
+        [[nodiscard]] FloatType Dot(const thisType& other) const;
+        // Same as Vector4::Cross, w is set to 0
+        [[nodiscard]] thisType Cross(const thisType& other) const;
+        [[nodiscard]] FloatType LengthSqr() const;
+
+        [[nodiscard]] thisType Min(const thisType& other) const;
+        [[nodiscard]] thisType Max(const thisType& other) const;
+        // mask ? other : this, mask is per lane
+        [[nodiscard]] thisType Select(const thisType& other, const FloatType& mask) const;
+
+        [[nodiscard]] thisType operator-() const;
+
+        thisType& operator*=(const FloatType& other);
+        thisType& operator/=(const FloatType& other);
+        [[nodiscard]] thisType operator*(const FloatType& other) const;
+        [[nodiscard]] thisType operator/(const FloatType& other) const;
+
+        thisType& operator*=(const thisType& other);
+        thisType& operator+=(const thisType& other);
+        thisType& operator-=(const thisType& other);
+        [[nodiscard]] thisType operator*(const thisType& other) const;
+        [[nodiscard]] thisType operator+(const thisType& other) const;
+        [[nodiscard]] thisType operator-(const thisType& other) const;
+
+    private:
+        FloatType m_x;
+        FloatType m_y;
+        FloatType m_z;
+        FloatType m_w;
+    };
+
+    using Float8 = Float8T<WideBackendDefault>;
+    using Int8 = Int8T<WideBackendDefault>;
+    using Vector3x8 = Vector3x8T<WideBackendDefault>;
+    using Vector4x8 = Vector4x8T<WideBackendDefault>;
+
+    template <typename Backend>
+    Float8T<Backend>::Float8T()
+        : m_data(Backend::Set(0.0f))
+    {
+    }
+
+    template <typename Backend>
+    Float8T<Backend>::Float8T(float value)
+        : m_data(Backend::Set(value))
+    {
+    }
+
+    template <typename Backend>
+    Float8T<Backend>::Float8T(const InternalType& data)
+        : m_data(data)
+    {
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::Load(const float* data)
+    {
+        return Backend::Load(data);
+    }
+
+    template <typename Backend>
+    void Float8T<Backend>::Store(float* data) const
+    {
+        Backend::Store(data, m_data);
+    }
+
+    template <typename Backend>
+    typename Float8T<Backend>::InternalType& Float8T<Backend>::GetInternal()
+    {
+        return m_data;
+    }
+
+    template <typename Backend>
+    const typename Float8T<Backend>::InternalType& Float8T<Backend>::GetInternal() const
+    {
+        return m_data;
+    }
+
+    template <typename Backend>
+    float Float8T<Backend>::operator[](size_t i) const
+    {
+        BLK_ASSERT(i < ms_Width);
+        float lanes[ms_Width];
+        Store(lanes);
+        return lanes[i];
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::Min(const thisType& other) const
+    {
+        return Backend::Min(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::Max(const thisType& other) const
+    {
+        return Backend::Max(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::Abs() const
+    {
+        return Backend::AndNot(Backend::Set(-0.0f), m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::Sqrt() const
+    {
+        return Backend::Sqrt(m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::Select(const thisType& other, const thisType& mask) const
+    {
+        return Backend::Select(m_data, other.m_data, mask.m_data);
+    }
+
+    template <typename Backend>
+    uint32_t Float8T<Backend>::GetSignMask() const
+    {
+        return Backend::GetSignMask(m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Float8T<Backend>::ToInt() const
+    {
+        return Backend::ConvertToInt(m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Float8T<Backend>::AsInt() const
+    {
+        return Backend::CastToInt(m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator-() const
+    {
+        return Backend::Xor(m_data, Backend::Set(-0.0f));
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Float8T<Backend>::operator*=(const thisType& other)
+    {
+        m_data = Backend::Mul(m_data, other.m_data);
+        return *this;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Float8T<Backend>::operator/=(const thisType& other)
+    {
+        m_data = Backend::Div(m_data, other.m_data);
+        return *this;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Float8T<Backend>::operator+=(const thisType& other)
+    {
+        m_data = Backend::Add(m_data, other.m_data);
+        return *this;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Float8T<Backend>::operator-=(const thisType& other)
+    {
+        m_data = Backend::Sub(m_data, other.m_data);
+        return *this;
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator*(const thisType& other) const
+    {
+        return Backend::Mul(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator/(const thisType& other) const
+    {
+        return Backend::Div(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator+(const thisType& other) const
+    {
+        return Backend::Add(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator-(const thisType& other) const
+    {
+        return Backend::Sub(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator&(const thisType& other) const
+    {
+        return Backend::And(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator|(const thisType& other) const
+    {
+        return Backend::Or(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator^(const thisType& other) const
+    {
+        return Backend::Xor(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::AndNot(const thisType& other) const
+    {
+        return Backend::AndNot(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator>(const thisType& other) const
+    {
+        return Backend::Less(other.m_data, m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator<(const thisType& other) const
+    {
+        return Backend::Less(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator>=(const thisType& other) const
+    {
+        return Backend::LessEqual(other.m_data, m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::operator<=(const thisType& other) const
+    {
+        return Backend::LessEqual(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::EqualMask(const thisType& other) const
+    {
+        return Backend::Equal(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Float8T<Backend>::NotEqualMask(const thisType& other) const
+    {
+        return Backend::NotEqual(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend>::Int8T()
+        : m_data(Backend::SetInt(0))
+    {
+    }
+
+    template <typename Backend>
+    Int8T<Backend>::Int8T(int32_t value)
+        : m_data(Backend::SetInt(value))
+    {
+    }
+
+    template <typename Backend>
+    Int8T<Backend>::Int8T(const InternalType& data)
+        : m_data(data)
+    {
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::Load(const int32_t* data)
+    {
+        return Backend::LoadInt(data);
+    }
+
+    template <typename Backend>
+    void Int8T<Backend>::Store(int32_t* data) const
+    {
+        Backend::StoreInt(data, m_data);
+    }
+
+    template <typename Backend>
+    typename Int8T<Backend>::InternalType& Int8T<Backend>::GetInternal()
+    {
+        return m_data;
+    }
+
+    template <typename Backend>
+    const typename Int8T<Backend>::InternalType& Int8T<Backend>::GetInternal() const
+    {
+        return m_data;
+    }
+
+    template <typename Backend>
+    int32_t Int8T<Backend>::operator[](size_t i) const
+    {
+        BLK_ASSERT(i < ms_Width);
+        int32_t lanes[ms_Width];
+        Store(lanes);
+        return lanes[i];
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::Min(const thisType& other) const
+    {
+        return Backend::MinInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::Max(const thisType& other) const
+    {
+        return Backend::MaxInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::Select(const thisType& other, const thisType& mask) const
+    {
+        return Backend::OrInt(Backend::AndInt(other.m_data, mask.m_data),
+                              Backend::AndInt(m_data, (~mask).m_data));
+    }
+
+    template <typename Backend>
+    uint32_t Int8T<Backend>::GetSignMask() const
+    {
+        return Backend::GetSignMask(Backend::CastToFloat(m_data));
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Int8T<Backend>::ToFloat() const
+    {
+        return Backend::ConvertToFloat(m_data);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Int8T<Backend>::AsFloat() const
+    {
+        return Backend::CastToFloat(m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator-() const
+    {
+        return Backend::SubInt(Backend::SetInt(0), m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend>& Int8T<Backend>::operator*=(const thisType& other)
+    {
+        m_data = Backend::MulInt(m_data, other.m_data);
+        return *this;
+    }
+
+    template <typename Backend>
+    Int8T<Backend>& Int8T<Backend>::operator+=(const thisType& other)
+    {
+        m_data = Backend::AddInt(m_data, other.m_data);
+        return *this;
+    }
+
+    template <typename Backend>
+    Int8T<Backend>& Int8T<Backend>::operator-=(const thisType& other)
+    {
+        m_data = Backend::SubInt(m_data, other.m_data);
+        return *this;
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator*(const thisType& other) const
+    {
+        return Backend::MulInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator+(const thisType& other) const
+    {
+        return Backend::AddInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator-(const thisType& other) const
+    {
+        return Backend::SubInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator&(const thisType& other) const
+    {
+        return Backend::AndInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator|(const thisType& other) const
+    {
+        return Backend::OrInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator^(const thisType& other) const
+    {
+        return Backend::XorInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator~() const
+    {
+        return Backend::XorInt(m_data, Backend::SetInt(-1));
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator<<(int count) const
+    {
+        BLK_ASSERT(count >= 0 && count < 32);
+        return Backend::ShiftLeft(m_data, count);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator>>(int count) const
+    {
+        BLK_ASSERT(count >= 0 && count < 32);
+        return Backend::ShiftRightArithmetic(m_data, count);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::ShiftRightLogical(int count) const
+    {
+        BLK_ASSERT(count >= 0 && count < 32);
+        return Backend::ShiftRightLogical(m_data, count);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator>(const thisType& other) const
+    {
+        return Backend::GreaterInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::operator<(const thisType& other) const
+    {
+        return Backend::GreaterInt(other.m_data, m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::EqualMask(const thisType& other) const
+    {
+        return Backend::EqualInt(m_data, other.m_data);
+    }
+
+    template <typename Backend>
+    Int8T<Backend> Int8T<Backend>::NotEqualMask(const thisType& other) const
+    {
+        return ~EqualMask(other);
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend>::Vector3x8T(const FloatType& x, const FloatType& y, const FloatType& z)
+        : m_x(x)
+        , m_y(y)
+        , m_z(z)
+    {
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend>::Vector3x8T(const Vector3& value)
+        : m_x(value.x())
+        , m_y(value.y())
+        , m_z(value.z())
+    {
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::Load(const float* x, const float* y, const float* z)
+    {
+        return thisType(FloatType::Load(x), FloatType::Load(y), FloatType::Load(z));
+    }
+
+    template <typename Backend>
+    void Vector3x8T<Backend>::Store(float* x, float* y, float* z) const
+    {
+        m_x.Store(x);
+        m_y.Store(y);
+        m_z.Store(z);
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Vector3x8T<Backend>::x()
+    {
+        return m_x;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Vector3x8T<Backend>::y()
+    {
+        return m_y;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Vector3x8T<Backend>::z()
+    {
+        return m_z;
+    }
+
+    template <typename Backend>
+    const Float8T<Backend>& Vector3x8T<Backend>::x() const
+    {
+        return m_x;
+    }
+
+    template <typename Backend>
+    const Float8T<Backend>& Vector3x8T<Backend>::y() const
+    {
+        return m_y;
+    }
+
+    template <typename Backend>
+    const Float8T<Backend>& Vector3x8T<Backend>::z() const
+    {
+        return m_z;
+    }
+
+    template <typename Backend>
+    Vector3 Vector3x8T<Backend>::GetLane(size_t i) const
+    {
+        return Vector3{m_x[i], m_y[i], m_z[i]};
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Vector3x8T<Backend>::Dot(const thisType& other) const
+    {
+        return m_x * other.m_x + m_y * other.m_y + m_z * other.m_z;
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::Cross(const thisType& other) const
+    {
+        return thisType(m_y * other.m_z - m_z * other.m_y, m_z * other.m_x - m_x * other.m_z,
+                        m_x * other.m_y - m_y * other.m_x);
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Vector3x8T<Backend>::LengthSqr() const
+    {
+        return Dot(*this);
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::Min(const thisType& other) const
+    {
+        return thisType(m_x.Min(other.m_x), m_y.Min(other.m_y), m_z.Min(other.m_z));
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::Max(const thisType& other) const
+    {
+        return thisType(m_x.Max(other.m_x), m_y.Max(other.m_y), m_z.Max(other.m_z));
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::Select(const thisType& other,
+                                                    const FloatType& mask) const
+    {
+        return thisType(m_x.Select(other.m_x, mask), m_y.Select(other.m_y, mask),
+                        m_z.Select(other.m_z, mask));
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::operator-() const
+    {
+        return thisType(-m_x, -m_y, -m_z);
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend>& Vector3x8T<Backend>::operator*=(const FloatType& other)
+    {
+        return *this = *this * other;
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend>& Vector3x8T<Backend>::operator/=(const FloatType& other)
+    {
+        return *this = *this / other;
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::operator*(const FloatType& other) const
+    {
+        return thisType(m_x * other, m_y * other, m_z * other);
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::operator/(const FloatType& other) const
+    {
+        return thisType(m_x / other, m_y / other, m_z / other);
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend>& Vector3x8T<Backend>::operator*=(const thisType& other)
+    {
+        return *this = *this * other;
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend>& Vector3x8T<Backend>::operator+=(const thisType& other)
+    {
+        return *this = *this + other;
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend>& Vector3x8T<Backend>::operator-=(const thisType& other)
+    {
+        return *this = *this - other;
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::operator*(const thisType& other) const
+    {
+        return thisType(m_x * other.m_x, m_y * other.m_y, m_z * other.m_z);
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::operator+(const thisType& other) const
+    {
+        return thisType(m_x + other.m_x, m_y + other.m_y, m_z + other.m_z);
+    }
+
+    template <typename Backend>
+    Vector3x8T<Backend> Vector3x8T<Backend>::operator-(const thisType& other) const
+    {
+        return thisType(m_x - other.m_x, m_y - other.m_y, m_z - other.m_z);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend>::Vector4x8T(const FloatType& x, const FloatType& y, const FloatType& z,
+                                    const FloatType& w)
+        : m_x(x)
+        , m_y(y)
+        , m_z(z)
+        , m_w(w)
+    {
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend>::Vector4x8T(const Vector4& value)
+        : m_x(value.x())
+        , m_y(value.y())
+        , m_z(value.z())
+        , m_w(value.w())
+    {
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::Load(const float* x, const float* y, const float* z,
+                                                  const float* w)
+    {
+        return thisType(FloatType::Load(x), FloatType::Load(y), FloatType::Load(z),
+                        FloatType::Load(w));
+    }
+
+    template <typename Backend>
+    void Vector4x8T<Backend>::Store(float* x, float* y, float* z, float* w) const
+    {
+        m_x.Store(x);
+        m_y.Store(y);
+        m_z.Store(z);
+        m_w.Store(w);
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Vector4x8T<Backend>::x()
+    {
+        return m_x;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Vector4x8T<Backend>::y()
+    {
+        return m_y;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Vector4x8T<Backend>::z()
+    {
+        return m_z;
+    }
+
+    template <typename Backend>
+    Float8T<Backend>& Vector4x8T<Backend>::w()
+    {
+        return m_w;
+    }
+
+    template <typename Backend>
+    const Float8T<Backend>& Vector4x8T<Backend>::x() const
+    {
+        return m_x;
+    }
+
+    template <typename Backend>
+    const Float8T<Backend>& Vector4x8T<Backend>::y() const
+    {
+        return m_y;
+    }
+
+    template <typename Backend>
+    const Float8T<Backend>& Vector4x8T<Backend>::z() const
+    {
+        return m_z;
+    }
+
+    template <typename Backend>
+    const Float8T<Backend>& Vector4x8T<Backend>::w() const
+    {
+        return m_w;
+    }
+
+    template <typename Backend>
+    Vector4 Vector4x8T<Backend>::GetLane(size_t i) const
+    {
+        return Vector4{m_x[i], m_y[i], m_z[i], m_w[i]};
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Vector4x8T<Backend>::Dot(const thisType& other) const
+    {
+        return (m_x * other.m_x + m_y * other.m_y) + (m_z * other.m_z + m_w * other.m_w);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::Cross(const thisType& other) const
+    {
+        return thisType(m_y * other.m_z - m_z * other.m_y, m_z * other.m_x - m_x * other.m_z,
+                        m_x * other.m_y - m_y * other.m_x, FloatType(0.0f));
+    }
+
+    template <typename Backend>
+    Float8T<Backend> Vector4x8T<Backend>::LengthSqr() const
+    {
+        return Dot(*this);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::Min(const thisType& other) const
+    {
+        return thisType(m_x.Min(other.m_x), m_y.Min(other.m_y), m_z.Min(other.m_z),
+                        m_w.Min(other.m_w));
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::Max(const thisType& other) const
+    {
+        return thisType(m_x.Max(other.m_x), m_y.Max(other.m_y), m_z.Max(other.m_z),
+                        m_w.Max(other.m_w));
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::Select(const thisType& other,
+                                                    const FloatType& mask) const
+    {
+        return thisType(m_x.Select(other.m_x, mask), m_y.Select(other.m_y, mask),
+                        m_z.Select(other.m_z, mask), m_w.Select(other.m_w, mask));
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::operator-() const
+    {
+        return thisType(-m_x, -m_y, -m_z, -m_w);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend>& Vector4x8T<Backend>::operator*=(const FloatType& other)
+    {
+        return *this = *this * other;
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend>& Vector4x8T<Backend>::operator/=(const FloatType& other)
+    {
+        return *this = *this / other;
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::operator*(const FloatType& other) const
+    {
+        return thisType(m_x * other, m_y * other, m_z * other, m_w * other);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::operator/(const FloatType& other) const
+    {
+        return thisType(m_x / other, m_y / other, m_z / other, m_w / other);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend>& Vector4x8T<Backend>::operator*=(const thisType& other)
+    {
+        return *this = *this * other;
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend>& Vector4x8T<Backend>::operator+=(const thisType& other)
+    {
+        return *this = *this + other;
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend>& Vector4x8T<Backend>::operator-=(const thisType& other)
+    {
+        return *this = *this - other;
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::operator*(const thisType& other) const
+    {
+        return thisType(m_x * other.m_x, m_y * other.m_y, m_z * other.m_z, m_w * other.m_w);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::operator+(const thisType& other) const
+    {
+        return thisType(m_x + other.m_x, m_y + other.m_y, m_z + other.m_z, m_w + other.m_w);
+    }
+
+    template <typename Backend>
+    Vector4x8T<Backend> Vector4x8T<Backend>::operator-(const thisType& other) const
+    {
+        return thisType(m_x - other.m_x, m_y - other.m_y, m_z - other.m_z, m_w - other.m_w);
+    }
+
+} // namespace Boolka
@@ -10,12 +10,15 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <execution>
 #include <fstream>
 #include <functional>
 #include <initializer_list>
 #include <map>
 #include <numeric>
+#include <queue>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <thread>
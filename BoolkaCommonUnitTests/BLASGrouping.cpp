@@ -0,0 +1,214 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/BLASGrouping.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static AABB MakeBox(const Vector3& center, float halfSize)
+    {
+        return AABB{Vector4(center - Vector3(halfSize, halfSize, halfSize), 1.0f),
+                    Vector4(center + Vector3(halfSize, halfSize, halfSize), 1.0f)};
+    }
+
+    static bool IsPartition(const std::vector<std::vector<uint32_t>>& groups, size_t objectCount)
+    {
+        std::vector<uint32_t> seen(objectCount, 0);
+        for (const auto& group : groups)
+        {
+            if (group.empty() || !std::is_sorted(group.begin(), group.end()))
+                return false;
+            for (uint32_t object : group)
+            {
+                if (object >= objectCount)
+                    return false;
+                ++seen[object];
+            }
+        }
+        return std::all_of(seen.begin(), seen.end(), [](uint32_t count) { return count == 1; });
+    }
+
+    TEST_CLASS(TestBLASGrouping)
+    {
+    public:
+        TEST_METHOD(CostModel)
+        {
+            BLASGrouping::CostModel costModel{};
+            AABB unitBox = MakeBox(Vector3(0.0f, 0.0f, 0.0f), 0.5f);
+            Assert::IsTrue(ApproxEqual(BLASGrouping::SurfaceArea(unitBox), 6.0f));
+
+            AABB empty{Vector4(1.0f, 1.0f, 1.0f, 1.0f), Vector4(-1.0f, -1.0f, -1.0f, 1.0f)};
+            Assert::IsTrue(BLASGrouping::SurfaceArea(empty) == 0.0f);
+
+            AABB merged = BLASGrouping::Union(unitBox, MakeBox(Vector3(2.0f, 0.0f, 0.0f), 0.5f));
+            Assert::IsTrue(ApproxEqual(Vector3(merged.GetMin()), Vector3(-0.5f, -0.5f, -0.5f)));
+            Assert::IsTrue(ApproxEqual(Vector3(merged.GetMax()), Vector3(2.5f, 0.5f, 0.5f)));
+
+            Assert::IsTrue(BLASGrouping::EstimateBLASCost(costModel, 0.5f, 100) <
+                           BLASGrouping::EstimateBLASCost(costModel, 1.0f, 100));
+            Assert::IsTrue(BLASGrouping::EstimateBLASCost(costModel, 0.5f, 100) <
+                           BLASGrouping::EstimateBLASCost(costModel, 0.5f, 1000));
+            Assert::IsTrue(ApproxEqual(BLASGrouping::EstimateBLASCost(costModel, 0.0f, 1000),
+                                       costModel.blasCost));
+        }
+
+        TEST_METHOD(MergeSmallNeighbours)
+        {
+            // Two tight clusters of small objects far from each other
+            std::vector<BLASGrouping::ObjectDesc> objects;
+            for (uint32_t cluster = 0; cluster < 2; ++cluster)
+            {
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    Vector3 center(cluster * 100.0f + (i % 4) * 0.1f, (i / 4) * 0.1f, 0.0f);
+                    objects.push_back({MakeBox(center, 0.05f), 64, true});
+                }
+            }
+
+            AABB sceneBounds = objects[0].bounds;
+            for (const auto& object : objects)
+                sceneBounds = BLASGrouping::Union(sceneBounds, object.bounds);
+
+            BLASGrouping::Settings settings{};
+            auto groups = BLASGrouping::MergeObjects(settings, sceneBounds, objects.data(),
+                                                     objects.size());
+            Assert::IsTrue(IsPartition(groups, objects.size()));
+            Assert::IsTrue(groups.size() == 2);
+            for (const auto& group : groups)
+            {
+                uint32_t cluster = group[0] / 16;
+                for (uint32_t object : group)
+                    Assert::IsTrue(object / 16 == cluster);
+            }
+        }
+
+        TEST_METHOD(MergeRespectsLimits)
+        {
+            std::vector<BLASGrouping::ObjectDesc> objects;
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                Vector3 center((i % 8) * 0.1f, (i / 8) * 0.1f, 0.0f);
+                // Every 5th object is instanced and can't be merged
+                objects.push_back({MakeBox(center, 0.05f), 100, i % 5 != 0});
+            }
+
+            AABB sceneBounds = objects[0].bounds;
+            for (const auto& object : objects)
+                sceneBounds = BLASGrouping::Union(sceneBounds, object.bounds);
+
+            BLASGrouping::Settings settings{};
+            settings.maxMergedTriangleCount = 1000;
+            auto groups = BLASGrouping::MergeObjects(settings, sceneBounds, objects.data(),
+                                                     objects.size());
+            Assert::IsTrue(IsPartition(groups, objects.size()));
+
+            size_t mergedGroups = 0;
+            for (const auto& group : groups)
+            {
+                uint32_t triangleCount = 0;
+                for (uint32_t object : group)
+                {
+                    triangleCount += objects[object].triangleCount;
+                    if (!objects[object].mergeable)
+                        Assert::IsTrue(group.size() == 1);
+                }
+                Assert::IsTrue(triangleCount <= settings.maxMergedTriangleCount);
+                mergedGroups += group.size() > 1;
+            }
+            Assert::IsTrue(mergedGroups > 0);
+        }
+
+        TEST_METHOD(MergeKeepsDistantObjectsSeparate)
+        {
+            std::vector<BLASGrouping::ObjectDesc> objects = {
+                {MakeBox(Vector3(-100.0f, 0.0f, 0.0f), 1.0f), 1000, true},
+                {MakeBox(Vector3(100.0f, 0.0f, 0.0f), 1.0f), 1000, true},
+            };
+            AABB sceneBounds = BLASGrouping::Union(objects[0].bounds, objects[1].bounds);
+
+            BLASGrouping::Settings settings{};
+            settings.costModel.blasCost = 0.0f;
+            auto groups = BLASGrouping::MergeObjects(settings, sceneBounds, objects.data(),
+                                                     objects.size());
+            Assert::IsTrue(groups.size() == 2);
+        }
+
+        TEST_METHOD(SplitSeparatedParts)
+        {
+            // Object made of two far apart slabs of triangles
+            const uint32_t triangleCount = 4096;
+            std::mt19937 generator(3);
+            std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+            std::vector<AABB> triangleBounds(triangleCount);
+            for (uint32_t i = 0; i < triangleCount; ++i)
+            {
+                float offset = (i % 2) ? 50.0f : -50.0f;
+                Vector3 center(offset + distribution(generator), distribution(generator),
+                               distribution(generator));
+                triangleBounds[i] = MakeBox(center, 0.01f);
+            }
+
+            AABB sceneBounds = triangleBounds[0];
+            for (const auto& bounds : triangleBounds)
+                sceneBounds = BLASGrouping::Union(sceneBounds, bounds);
+
+            BLASGrouping::Settings settings{};
+            settings.minSplitTriangleCount = 1024;
+            settings.minSplitPieceTriangleCount = 256;
+
+            std::vector<uint32_t> triangleOrder;
+            auto ranges = BLASGrouping::SplitObject(settings, sceneBounds, triangleBounds.data(),
+                                                    triangleCount, triangleOrder);
+            Assert::IsTrue(ranges.size() >= 2);
+
+            std::vector<uint32_t> sortedOrder = triangleOrder;
+            std::sort(sortedOrder.begin(), sortedOrder.end());
+            for (uint32_t i = 0; i < triangleCount; ++i)
+                Assert::IsTrue(sortedOrder[i] == i);
+
+            uint32_t expectedFirst = 0;
+            for (const auto& range : ranges)
+            {
+                Assert::IsTrue(range.firstTriangle == expectedFirst);
+                Assert::IsTrue(range.triangleCount >= settings.minSplitPieceTriangleCount);
+                expectedFirst += range.triangleCount;
+
+                // Pieces never mix triangles from both slabs
+                uint32_t side = triangleOrder[range.firstTriangle] % 2;
+                for (uint32_t i = 0; i < range.triangleCount; ++i)
+                    Assert::IsTrue(triangleOrder[range.firstTriangle + i] % 2 == side);
+            }
+            Assert::IsTrue(expectedFirst == triangleCount);
+        }
+
+        TEST_METHOD(SplitKeepsCompactObject)
+        {
+            const uint32_t triangleCount = 4096;
+            std::mt19937 generator(5);
+            std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+            std::vector<AABB> triangleBounds(triangleCount);
+            for (auto& bounds : triangleBounds)
+            {
+                Vector3 center(distribution(generator), distribution(generator),
+                               distribution(generator));
+                bounds = MakeBox(center, 0.01f);
+            }
+
+            AABB sceneBounds = MakeBox(Vector3(0.0f, 0.0f, 0.0f), 10.0f);
+
+            BLASGrouping::Settings settings{};
+            settings.minSplitTriangleCount = 1024;
+            settings.minSplitPieceTriangleCount = 256;
+
+            std::vector<uint32_t> triangleOrder;
+            auto ranges = BLASGrouping::SplitObject(settings, sceneBounds, triangleBounds.data(),
+                                                    triangleCount, triangleOrder);
+            Assert::IsTrue(ranges.size() == 1);
+            Assert::IsTrue(ranges[0].firstTriangle == 0);
+            Assert::IsTrue(ranges[0].triangleCount == triangleCount);
+        }
+    };
+}
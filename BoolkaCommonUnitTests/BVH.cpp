@@ -0,0 +1,313 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/BVH.h"
+
+#include "TestDataHelpers.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static std::vector<AABB> BuildBVHTestBoxes(std::mt19937& generator, size_t count)
+    {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::exponential_distribution<float> size(0.5f);
+
+        std::vector<AABB> result(count);
+        for (auto& box : result)
+        {
+            Vector4 min{position(generator), position(generator), position(generator), 1.0f};
+            Vector4 extent{size(generator), size(generator), size(generator), 0.0f};
+            if (generator() % 16 == 0)
+                extent[generator() % 3] = 0.0f;
+            box = AABB{min, min + extent};
+        }
+        return result;
+    }
+
+    // Same operations as BVH, so that results match exactly
+    static bool IntersectTrianglesBruteForce(const BVHTestMesh& mesh, const Vector3& origin,
+                                             const Vector3& direction, float maxDistance,
+                                             float& distance)
+    {
+        bool isHit = false;
+        for (size_t i = 0; i < mesh.indices.size(); i += 3)
+        {
+            const Vector3& vertex = mesh.positions[mesh.indices[i]];
+            const Vector3 edge1 = mesh.positions[mesh.indices[i + 1]] - vertex;
+            const Vector3 edge2 = mesh.positions[mesh.indices[i + 2]] - vertex;
+            const Vector3 p = direction.Cross(edge2);
+            const float determinant = edge1.Dot(p);
+            if (determinant == 0.0f)
+                continue;
+            const float inverseDeterminant = 1.0f / determinant;
+            const Vector3 s = origin - vertex;
+            const float u = s.Dot(p) * inverseDeterminant;
+            if (u < 0.0f || u > 1.0f)
+                continue;
+            const Vector3 q = s.Cross(edge1);
+            const float v = direction.Dot(q) * inverseDeterminant;
+            if (v < 0.0f || u + v > 1.0f)
+                continue;
+            const float t = edge2.Dot(q) * inverseDeterminant;
+            if (t < 0.0f || t > maxDistance)
+                continue;
+            maxDistance = t;
+            distance = t;
+            isHit = true;
+        }
+        return isHit;
+    }
+
+    // Leaves of tree cover every primitive exactly once and node bounds contain primitives
+    static bool IsValidBVH(const BVH& bvh, const std::vector<AABB>& boxes)
+    {
+        std::vector<uint32_t> leafCoverage(bvh.GetPrimitiveCount(), 0);
+        std::vector<size_t> stack{0};
+        const auto& nodes = bvh.GetNodes();
+        const auto& primitives = bvh.GetPrimitiveIndices();
+        while (!stack.empty())
+        {
+            const BVH::Node& node = nodes[stack.back()];
+            stack.pop_back();
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const uint32_t child = node.children[i];
+                if (child == BVH::ms_EmptyChild)
+                    continue;
+                if ((child & BVH::ms_LeafFlag) == 0)
+                {
+                    stack.push_back(child);
+                    continue;
+                }
+
+                const uint32_t first = child & BVH::ms_LeafFirstMask;
+                const uint32_t count = ((child & ~BVH::ms_LeafFlag) >> BVH::ms_LeafCountShift) + 1;
+                if (count > BVH::ms_MaxLeafSize)
+                    return false;
+                for (uint32_t j = first; j < first + count; ++j)
+                {
+                    ++leafCoverage[j];
+                    const AABB& box = boxes[primitives[j]];
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        if (box.GetMin()[axis] < node.bounds[axis][i] ||
+                            box.GetMax()[axis] > node.bounds[axis + 3][i])
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return std::all_of(leafCoverage.begin(), leafCoverage.end(),
+                           [](uint32_t coverage) { return coverage == 1; });
+    }
+
+    TEST_CLASS(TestBVH)
+    {
+    public:
+        TEST_METHOD(Structure)
+        {
+            std::mt19937 generator(97);
+            for (size_t count : {1, 2, 3, 5, 17, 1000, 20000})
+            {
+                const std::vector<AABB> boxes = BuildBVHTestBoxes(generator, count);
+                BVH bvh;
+                bvh.Build(boxes.data(), boxes.size());
+                Assert::AreEqual(count, bvh.GetPrimitiveCount());
+                Assert::IsTrue(IsValidBVH(bvh, boxes));
+
+                const AABB bounds = bvh.GetBounds();
+                for (const AABB& box : boxes)
+                {
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        Assert::IsTrue(box.GetMin()[axis] >= bounds.GetMin()[axis]);
+                        Assert::IsTrue(box.GetMax()[axis] <= bounds.GetMax()[axis]);
+                    }
+                }
+            }
+
+            // Identical boxes can't be separated by SAH
+            const std::vector<AABB> sameBoxes(1000, AABB{Vector4{0.0f, 0.0f, 0.0f, 1.0f},
+                                                         Vector4{1.0f, 1.0f, 1.0f, 1.0f}});
+            BVH bvh;
+            bvh.Build(sameBoxes.data(), sameBoxes.size());
+            Assert::IsTrue(IsValidBVH(bvh, sameBoxes));
+            Assert::IsTrue(bvh.IsOccluded(Vector3{0.5f, 0.5f, -1.0f}, Vector3{0.0f, 0.0f, 1.0f},
+                                          10.0f));
+
+            BVH emptyBVH;
+            emptyBVH.Build(sameBoxes.data(), 0);
+            Assert::IsTrue(emptyBVH.IsEmpty());
+            BVH::RayHit hit;
+            Assert::IsFalse(emptyBVH.IntersectRay(Vector3{}, Vector3{1.0f, 0.0f, 0.0f}, 1.0f,
+                                                  hit));
+        }
+
+        TEST_METHOD(Deterministic)
+        {
+            // Large enough to be split between threads
+            std::mt19937 generator(101);
+            const std::vector<AABB> boxes = BuildBVHTestBoxes(generator, 300000);
+            BVH first;
+            first.Build(boxes.data(), boxes.size());
+            BVH second;
+            second.Build(boxes.data(), boxes.size());
+            Assert::IsTrue(IsValidBVH(first, boxes));
+            Assert::IsTrue(first.GetPrimitiveIndices() == second.GetPrimitiveIndices());
+            Assert::AreEqual(first.GetNodes().size(), second.GetNodes().size());
+            Assert::IsTrue(memcmp(first.GetNodes().data(), second.GetNodes().data(),
+                                  first.GetNodes().size() * sizeof(BVH::Node)) == 0);
+        }
+
+        TEST_METHOD(RayTriangles)
+        {
+            std::mt19937 generator(103);
+            const BVHTestMesh mesh = BuildBVHTestMesh(generator, 5000);
+            BVH bvh;
+            bvh.Build(mesh.positions.data(), mesh.indices.data(), mesh.indices.size() / 3);
+
+            size_t hitCount = 0;
+            for (size_t i = 0; i < 2000; ++i)
+            {
+                Vector3 origin;
+                Vector3 direction;
+                BuildBVHTestRay(generator, origin, direction);
+                const float maxDistance = i % 2 == 0 ? FLT_MAX : 30.0f;
+
+                float expectedDistance = 0.0f;
+                const bool expectedHit = IntersectTrianglesBruteForce(
+                    mesh, origin, direction, maxDistance, expectedDistance);
+                BVH::RayHit hit;
+                const bool isHit = bvh.IntersectRay(origin, direction, maxDistance, hit);
+                Assert::AreEqual(expectedHit, isHit);
+                Assert::AreEqual(expectedHit, bvh.IsOccluded(origin, direction, maxDistance));
+                if (!expectedHit)
+                    continue;
+
+                ++hitCount;
+                Assert::AreEqual(expectedDistance, hit.distance);
+                // Reported triangle and barycentrics give same point
+                const uint32_t* triangle = mesh.indices.data() + hit.primitive * 3;
+                const Vector3& a = mesh.positions[triangle[0]];
+                const Vector3 point = a + (mesh.positions[triangle[1]] - a) * hit.u +
+                                      (mesh.positions[triangle[2]] - a) * hit.v;
+                const Vector3 expectedPoint = origin + direction * hit.distance;
+                Assert::IsTrue((point - expectedPoint).LengthSlow() < 1e-3f);
+            }
+            Assert::IsTrue(hitCount > 100);
+        }
+
+        TEST_METHOD(RayBoxes)
+        {
+            std::mt19937 generator(107);
+            const std::vector<AABB> boxes = BuildBVHTestBoxes(generator, 5000);
+            BVH bvh;
+            bvh.Build(boxes.data(), boxes.size());
+
+            for (size_t i = 0; i < 2000; ++i)
+            {
+                Vector3 origin;
+                Vector3 direction;
+                BuildBVHTestRay(generator, origin, direction);
+
+                // Reference hit, distance is checked against reported box only
+                bool expectedHit = false;
+                for (const AABB& box : boxes)
+                {
+                    float entry = 0.0f;
+                    float exit = 40.0f;
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        const double first =
+                            (box.GetMin()[axis] - origin[axis]) / double(direction[axis]);
+                        const double second =
+                            (box.GetMax()[axis] - origin[axis]) / double(direction[axis]);
+                        if (direction[axis] == 0.0f)
+                        {
+                            if (origin[axis] < box.GetMin()[axis] ||
+                                origin[axis] > box.GetMax()[axis])
+                            {
+                                exit = -1.0f;
+                            }
+                            continue;
+                        }
+                        entry = std::max(entry, float(std::min(first, second)));
+                        exit = std::min(exit, float(std::max(first, second)));
+                    }
+                    // Skip grazing hits, where rounding may go either way
+                    if (entry < exit - 1e-3f)
+                        expectedHit = true;
+                }
+
+                BVH::RayHit hit;
+                const bool isHit = bvh.IntersectRay(origin, direction, 40.0f, hit);
+                if (expectedHit)
+                    Assert::IsTrue(isHit);
+                if (!isHit)
+                    continue;
+
+                // Hit point is on reported box
+                const AABB& box = boxes[hit.primitive];
+                const Vector3 point = origin + direction * hit.distance;
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    const float epsilon = 1e-3f * (1.0f + abs(point[axis]));
+                    Assert::IsTrue(point[axis] >= box.GetMin()[axis] - epsilon);
+                    Assert::IsTrue(point[axis] <= box.GetMax()[axis] + epsilon);
+                }
+            }
+        }
+
+        TEST_METHOD(FrustumTraversal)
+        {
+            std::mt19937 generator(109);
+            const std::vector<AABB> boxes = BuildBVHTestBoxes(generator, 20000);
+            BVH bvh;
+            bvh.Build(boxes.data(), boxes.size());
+
+            std::vector<uint32_t> leafOrder(boxes.size());
+            for (size_t i = 0; i < boxes.size(); ++i)
+                leafOrder[bvh.GetPrimitiveIndices()[i]] = static_cast<uint32_t>(i);
+
+            std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+            std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+            for (size_t i = 0; i < 100; ++i)
+            {
+                const Matrix4x4 view =
+                    Matrix4x4::GetTranslation(position(generator), position(generator),
+                                              position(generator)) *
+                    Matrix4x4::GetRotationY(angle(generator)) *
+                    Matrix4x4::GetRotationX(angle(generator) * 0.5f);
+                const Frustum frustum(
+                    view * Matrix4x4::CalculateProjPerspective(0.1f, 50.0f, 1.7f, 1.2f));
+
+                std::vector<uint32_t> visible;
+                bvh.CullFrustum(frustum, visible);
+
+                // Leaf order, so no duplicates
+                for (size_t j = 1; j < visible.size(); ++j)
+                    Assert::IsTrue(leafOrder[visible[j - 1]] < leafOrder[visible[j]]);
+
+                std::vector<bool> isVisible(boxes.size(), false);
+                for (uint32_t index : visible)
+                    isVisible[index] = true;
+                size_t expectedCount = 0;
+                for (size_t j = 0; j < boxes.size(); ++j)
+                {
+                    if (frustum.CheckAABBFast(boxes[j]))
+                    {
+                        Assert::IsTrue(isVisible[j]);
+                        ++expectedCount;
+                    }
+                }
+                // Leaves are small, so only few invisible boxes are reported
+                Assert::IsTrue(visible.size() <= expectedCount * 2 + 64);
+            }
+        }
+    };
+}
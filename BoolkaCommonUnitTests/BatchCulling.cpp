@@ -0,0 +1,197 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/BatchCulling.h"
+#include "BoolkaCommon/Algorithms/RadixSort.h"
+
+#include "TestDataHelpers.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static bool IntersectsBatchGroupSphere(const Vector4& sphere, const AABB& box)
+    {
+        float distanceSqr = 0.0f;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float distance = std::max(std::max(box.GetMin()[axis] - sphere[axis],
+                                                     sphere[axis] - box.GetMax()[axis]),
+                                            0.0f);
+            distanceSqr += distance * distance;
+        }
+        return distanceSqr <= sphere.w() * sphere.w();
+    }
+
+    // Reference list of single view, objects are tested one by one and sorted with stable sort
+    static std::vector<uint32_t> BuildExpectedBatchList(const BatchCullingViews& views,
+                                                        size_t view,
+                                                        const BatchCullingObjects& objects,
+                                                        size_t firstObject, size_t lastObject,
+                                                        RadixSort::Order order,
+                                                        std::vector<float>& distances)
+    {
+        const Frustum& frustum = views.views[view];
+        const float* nearPlaneData = frustum.GetBuffer();
+        const Vector4 nearPlane(nearPlaneData, nearPlaneData + 4);
+
+        const Vector4* groupSphere = nullptr;
+        for (const auto& group : views.groups)
+        {
+            if (view >= group.firstView && view < group.firstView + group.viewCount)
+                groupSphere = &group.boundingSphere;
+        }
+
+        std::vector<std::pair<uint32_t, float>> visible;
+        for (size_t i = firstObject; i < lastObject; ++i)
+        {
+            const AABB& box = objects.boundingBoxes[i];
+            const Vector4 center(Vector3(objects.boundingSpheres[i]), 1.0f);
+            if (!frustum.CheckAABBFast(box) ||
+                !frustum.CheckSphereFast(center, objects.boundingSpheres[i].w()))
+                continue;
+            if (groupSphere && !IntersectsBatchGroupSphere(*groupSphere, box))
+                continue;
+            visible.emplace_back(static_cast<uint32_t>(i), nearPlane.Dot(center));
+        }
+
+        // Same key order as RadixSort, negative zero goes before positive zero
+        std::stable_sort(visible.begin(), visible.end(),
+                         [order](const auto& left, const auto& right) {
+                             const uint32_t leftKey = RadixSort::FloatToSortable(left.second);
+                             const uint32_t rightKey = RadixSort::FloatToSortable(right.second);
+                             return order == RadixSort::Order::Ascending ? leftKey < rightKey
+                                                                         : leftKey > rightKey;
+                         });
+
+        std::vector<uint32_t> result;
+        distances.clear();
+        for (const auto& [index, distance] : visible)
+        {
+            result.push_back(index);
+            distances.push_back(distance);
+        }
+        return result;
+    }
+
+    static bool IsBatchListEqual(const std::vector<uint32_t>& expected,
+                                 const std::vector<float>& expectedDistances,
+                                 const uint32_t* objects, const float* distances, uint32_t count)
+    {
+        if (expected.size() != count)
+            return false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (expected[i] != objects[i] || asuint(expectedDistances[i]) != asuint(distances[i]))
+                return false;
+        }
+        return true;
+    }
+
+    static bool MatchesPerViewBatchLists(const BatchCulling& culling,
+                                         const BatchCullingViews& views,
+                                         const BatchCullingObjects& objects, size_t viewCount)
+    {
+        if (culling.GetViewCount() != viewCount)
+            return false;
+
+        const size_t objectCount = objects.boundingBoxes.size();
+        std::vector<float> distances;
+        for (size_t view = 0; view < viewCount; ++view)
+        {
+            std::vector<uint32_t> expected =
+                BuildExpectedBatchList(views, view, objects, 0, objects.opaqueCount,
+                                       RadixSort::Order::Ascending, distances);
+            if (!IsBatchListEqual(expected, distances, culling.GetOpaqueObjects(view),
+                                  culling.GetOpaqueDistances(view), culling.GetOpaqueCount(view)))
+                return false;
+
+            expected = BuildExpectedBatchList(views, view, objects, objects.opaqueCount,
+                                              objectCount, RadixSort::Order::Descending,
+                                              distances);
+            if (!IsBatchListEqual(expected, distances, culling.GetTransparentObjects(view),
+                                  culling.GetTransparentDistances(view),
+                                  culling.GetTransparentCount(view)))
+                return false;
+        }
+        return true;
+    }
+
+    TEST_CLASS(TestBatchCulling)
+    {
+    public:
+        TEST_METHOD(MatchesPerViewCulling)
+        {
+            std::mt19937 generator(50);
+            for (size_t iteration = 0; iteration < 8; ++iteration)
+            {
+                BatchCullingViews views = BuildRandomBatchCullingViews(generator);
+                BatchCullingObjects objects =
+                    BuildRandomBatchCullingObjects(generator, 2000 + iteration, 1500);
+
+                BatchCulling culling;
+                culling.Initialize(objects.boundingBoxes.data(), objects.boundingSpheres.data(),
+                                   objects.boundingBoxes.size(), objects.opaqueCount);
+                culling.Cull(views.views, gs_BatchViewCount, views.groups, gs_BatchLightCount);
+                Assert::IsTrue(
+                    MatchesPerViewBatchLists(culling, views, objects, gs_BatchViewCount));
+                culling.Unload();
+            }
+        }
+
+        TEST_METHOD(ViewCountChanges)
+        {
+            // Lights can be added and removed between frames
+            std::mt19937 generator(500);
+            BatchCullingViews views = BuildRandomBatchCullingViews(generator);
+            BatchCullingObjects objects = BuildRandomBatchCullingObjects(generator, 1000, 600);
+
+            BatchCulling culling;
+            culling.Initialize(objects.boundingBoxes.data(), objects.boundingSpheres.data(),
+                               objects.boundingBoxes.size(), objects.opaqueCount);
+            for (size_t lightCount : {size_t(0), gs_BatchLightCount, size_t(1)})
+            {
+                const size_t viewCount = 2 + lightCount * gs_BatchCubeFaceCount;
+                culling.Cull(views.views, viewCount, views.groups, lightCount);
+                Assert::IsTrue(MatchesPerViewBatchLists(culling, views, objects, viewCount));
+            }
+            culling.Unload();
+        }
+
+        TEST_METHOD(OpaqueOrTransparentOnly)
+        {
+            std::mt19937 generator(5000);
+            BatchCullingViews views = BuildRandomBatchCullingViews(generator);
+            for (size_t opaqueCount : {size_t(0), size_t(700)})
+            {
+                BatchCullingObjects objects =
+                    BuildRandomBatchCullingObjects(generator, 700, opaqueCount);
+
+                BatchCulling culling;
+                culling.Initialize(objects.boundingBoxes.data(), objects.boundingSpheres.data(),
+                                   objects.boundingBoxes.size(), objects.opaqueCount);
+                culling.Cull(views.views, gs_BatchViewCount, views.groups, gs_BatchLightCount);
+                Assert::IsTrue(
+                    MatchesPerViewBatchLists(culling, views, objects, gs_BatchViewCount));
+                culling.Unload();
+            }
+        }
+
+        TEST_METHOD(EmptyScene)
+        {
+            std::mt19937 generator(50000);
+            BatchCullingViews views = BuildRandomBatchCullingViews(generator);
+
+            BatchCulling culling;
+            culling.Initialize(nullptr, nullptr, 0, 0);
+            culling.Cull(views.views, gs_BatchViewCount, views.groups, gs_BatchLightCount);
+            for (size_t view = 0; view < gs_BatchViewCount; ++view)
+            {
+                Assert::AreEqual(0u, culling.GetOpaqueCount(view));
+                Assert::AreEqual(0u, culling.GetTransparentCount(view));
+            }
+            culling.Unload();
+        }
+    };
+}
@@ -0,0 +1,300 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/BatchTransform.h"
+
+#include "TestDataHelpers.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static const BatchTransform::Backend gs_BatchTransformBackends[] = {
+        BatchTransform::Backend::Scalar, BatchTransform::Backend::SSE,
+        BatchTransform::Backend::AVX2};
+
+    static bool IsTransformMatchingMatrixProduct(const Matrix4x4& transform,
+                                                 const std::vector<Vector3>& inputs,
+                                                 BatchTransform::Backend backend, bool isPoint)
+    {
+        // Guard element catches writes past array end
+        const Vector3 guard{-123.0f, 456.0f, -789.0f};
+        std::vector<Vector3> results(inputs.size() + 1, guard);
+        if (isPoint)
+        {
+            BatchTransform::TransformPoints(transform, inputs.data(), results.data(),
+                                            inputs.size(), backend);
+        }
+        else
+        {
+            BatchTransform::TransformDirections(transform, inputs.data(), results.data(),
+                                                inputs.size(), backend);
+        }
+        if (results.back() != guard)
+            return false;
+
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            const Vector4 expected = Vector4(inputs[i], isPoint ? 1.0f : 0.0f) * transform;
+            if (results[i] != Vector3(expected))
+                return false;
+        }
+        return true;
+    }
+
+    // Sum of magnitudes of terms of transformed coordinate, rounding error is relative to it
+    static float GetTransformMagnitude(const AABB& box, const Matrix4x4& transform, size_t axis)
+    {
+        float result = std::abs(transform[3][axis]);
+        for (size_t row = 0; row < 3; ++row)
+        {
+            const float extent = std::max(std::abs(box.GetMin()[row]), std::abs(box.GetMax()[row]));
+            result += std::abs(transform[row][axis]) * extent;
+        }
+        return result;
+    }
+
+    static bool AreBoxesEqual(const AABB& first, const AABB& second)
+    {
+        return first.GetMin() == second.GetMin() && first.GetMax() == second.GetMax();
+    }
+
+    struct SphereProjectionSetup
+    {
+        Matrix4x4 view;
+        Matrix4x4 projection;
+        float nearZ;
+    };
+
+    static SphereProjectionSetup BuildRandomSphereProjection(std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+        std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+        std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+
+        SphereProjectionSetup result;
+        result.nearZ = 0.5f;
+        // Camera transform is rigid, so view matrix is its inverse
+        Matrix4x4 camera = Matrix4x4::GetRotationX(angle(generator) * 0.5f) *
+                           Matrix4x4::GetRotationY(angle(generator));
+        camera[3] = Vector4{position(generator), position(generator), position(generator), 1.0f};
+        result.view = camera.InverseRigid();
+        result.projection =
+            Matrix4x4::CalculateProjPerspective(result.nearZ, 200.0f, 1.7f, 1.1f);
+        // Sub pixel jitter, same as used for temporal antialiasing
+        result.projection[2][0] = jitter(generator);
+        result.projection[2][1] = jitter(generator);
+        return result;
+    }
+
+    // Spheres in world space, most of them in front of camera
+    static std::vector<Vector4> BuildRandomSpheres(std::mt19937& generator,
+                                                   const SphereProjectionSetup& setup,
+                                                   size_t count)
+    {
+        std::uniform_real_distribution<float> side(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> depth(-2.0f, 60.0f);
+        std::exponential_distribution<float> radius(0.5f);
+
+        const Matrix4x4 camera = setup.view.InverseRigid();
+        std::vector<Vector4> result(count);
+        for (auto& sphere : result)
+        {
+            const float z = depth(generator);
+            const Vector4 viewCenter{side(generator) * std::abs(z), side(generator) * std::abs(z),
+                                     z, 1.0f};
+            sphere = Vector4(Vector3(viewCenter * camera), radius(generator));
+        }
+        return result;
+    }
+
+    static const Vector4 gs_SphereGuard{7.0f, 7.0f, 7.0f, 7.0f};
+
+    static Vector4 ProjectToNDC(const SphereProjectionSetup& setup, const Vector4& point)
+    {
+        const Vector4 clip = point * setup.view * setup.projection;
+        return clip / clip.w();
+    }
+
+    TEST_CLASS(TestBatchTransform)
+    {
+    public:
+        TEST_METHOD(PointsAndDirectionsMatchMatrixProduct)
+        {
+            std::mt19937 generator(31);
+            for (size_t iteration = 0; iteration < 16; ++iteration)
+            {
+                const Matrix4x4 transform = BuildRandomAffineTransform(generator);
+                // Covers every combination of full iterations and scalar tail
+                const size_t count = iteration < 15 ? iteration * 3 : 1000;
+                const std::vector<Vector3> points = BuildRandomPoints(generator, count);
+
+                for (auto backend : gs_BatchTransformBackends)
+                {
+                    if (!FrustumCulling::IsBackendSupported(backend))
+                        continue;
+
+                    Assert::IsTrue(IsTransformMatchingMatrixProduct(transform, points, backend,
+                                                                    true));
+                    Assert::IsTrue(IsTransformMatchingMatrixProduct(transform, points, backend,
+                                                                    false));
+                }
+            }
+        }
+
+        TEST_METHOD(TransformPointsInPlace)
+        {
+            std::mt19937 generator(37);
+            const Matrix4x4 transform = BuildRandomAffineTransform(generator);
+            const std::vector<Vector3> points = BuildRandomPoints(generator, 29);
+
+            for (auto backend : gs_BatchTransformBackends)
+            {
+                if (!FrustumCulling::IsBackendSupported(backend))
+                    continue;
+
+                std::vector<Vector3> expected(points.size());
+                BatchTransform::TransformPoints(transform, points.data(), expected.data(),
+                                                points.size(), backend);
+                std::vector<Vector3> results = points;
+                BatchTransform::TransformPoints(transform, results.data(), results.data(),
+                                                results.size(), backend);
+                Assert::IsTrue(results == expected);
+            }
+        }
+
+        TEST_METHOD(TransformAABBsMatchesCorners)
+        {
+            std::mt19937 generator(41);
+            for (size_t iteration = 0; iteration < 16; ++iteration)
+            {
+                const Matrix4x4 transform = BuildRandomAffineTransform(generator);
+                const size_t count = iteration < 15 ? iteration : 1000;
+                const std::vector<AABB> boxes = BuildRandomTransformBoxes(generator, count);
+
+                std::vector<AABB> expected(count);
+                BatchTransform::TransformAABBs(transform, boxes.data(), expected.data(), count,
+                                               BatchTransform::Backend::Scalar);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    // Arvo's method gives same box as corners up to rounding
+                    const AABB corners = TransformAABBCorners(boxes[i], transform);
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        const float tolerance =
+                            1e-6f * GetTransformMagnitude(boxes[i], transform, axis);
+                        Assert::AreEqual(corners.GetMin()[axis], expected[i].GetMin()[axis],
+                                         tolerance);
+                        Assert::AreEqual(corners.GetMax()[axis], expected[i].GetMax()[axis],
+                                         tolerance);
+                    }
+                    Assert::AreEqual(1.0f, expected[i].GetMin().w());
+                    Assert::AreEqual(1.0f, expected[i].GetMax().w());
+                }
+
+                for (auto backend : gs_BatchTransformBackends)
+                {
+                    if (!FrustumCulling::IsBackendSupported(backend))
+                        continue;
+
+                    std::vector<AABB> results(count + 1);
+                    const AABB guard{Vector4{-1.0f, -1.0f, -1.0f, 1.0f},
+                                     Vector4{-2.0f, -2.0f, -2.0f, 1.0f}};
+                    results.back() = guard;
+                    BatchTransform::TransformAABBs(transform, boxes.data(), results.data(), count,
+                                                   backend);
+                    Assert::IsTrue(AreBoxesEqual(results.back(), guard));
+                    for (size_t i = 0; i < count; ++i)
+                        Assert::IsTrue(AreBoxesEqual(results[i], expected[i]));
+                }
+            }
+        }
+
+        TEST_METHOD(ProjectSpheresBoundsSurface)
+        {
+            std::mt19937 generator(43);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+            // Points evenly spread on unit sphere
+            std::vector<Vector4> directions(2048);
+            for (size_t i = 0; i < directions.size(); ++i)
+            {
+                const float z = 1.0f - 2.0f * (i + 0.5f) / directions.size();
+                const float ring = std::sqrt(1.0f - z * z);
+                const float angle = i * 2.39996323f;
+                directions[i] = Vector4(ring * std::cos(angle), ring * std::sin(angle), z, 0.0f);
+            }
+
+            for (size_t iteration = 0; iteration < 8; ++iteration)
+            {
+                const SphereProjectionSetup setup = BuildRandomSphereProjection(generator);
+                const size_t count = iteration < 7 ? iteration * 5 : 500;
+                const std::vector<Vector4> spheres =
+                    BuildRandomSpheres(generator, setup, count);
+
+                std::vector<Vector4> expected(count);
+                BatchTransform::ProjectSpheres(setup.view, setup.projection, setup.nearZ,
+                                               spheres.data(), expected.data(), count,
+                                               BatchTransform::Backend::Scalar);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const Vector4& sphere = spheres[i];
+                    const Vector4& rectangle = expected[i];
+                    const Vector4 center = Vector4(Vector3(sphere), 1.0f);
+                    const float viewZ = (center * setup.view).z();
+                    if (viewZ - sphere.w() < setup.nearZ)
+                    {
+                        Assert::IsTrue(rectangle == Vector4(-1.0f, -1.0f, 1.0f, 1.0f));
+                        continue;
+                    }
+
+                    Vector4 sampledMin{FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX};
+                    Vector4 sampledMax{-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+                    for (const Vector4& direction : directions)
+                    {
+                        const Vector4 ndc = ProjectToNDC(setup, center + direction * sphere.w());
+                        sampledMin = Min(sampledMin, ndc);
+                        sampledMax = Max(sampledMax, ndc);
+                    }
+
+                    // Rectangle contains every point of sphere and is close to sampled bounds
+                    const float size = std::max(rectangle.z() - rectangle.x(),
+                                                rectangle.w() - rectangle.y());
+                    const float epsilon =
+                        1e-5f * (1.0f + std::max(std::abs(rectangle.x()), std::abs(rectangle.z())) +
+                                 std::max(std::abs(rectangle.y()), std::abs(rectangle.w())));
+                    Assert::IsTrue(rectangle.x() <= sampledMin.x() + epsilon);
+                    Assert::IsTrue(rectangle.y() <= sampledMin.y() + epsilon);
+                    Assert::IsTrue(rectangle.z() >= sampledMax.x() - epsilon);
+                    Assert::IsTrue(rectangle.w() >= sampledMax.y() - epsilon);
+                    Assert::IsTrue(sampledMin.x() - rectangle.x() <= size * 0.01f + epsilon);
+                    Assert::IsTrue(sampledMin.y() - rectangle.y() <= size * 0.01f + epsilon);
+                    Assert::IsTrue(rectangle.z() - sampledMax.x() <= size * 0.01f + epsilon);
+                    Assert::IsTrue(rectangle.w() - sampledMax.y() <= size * 0.01f + epsilon);
+                }
+
+                for (auto backend : gs_BatchTransformBackends)
+                {
+                    if (!FrustumCulling::IsBackendSupported(backend))
+                        continue;
+
+                    std::vector<Vector4> results(count + 1, gs_SphereGuard);
+                    BatchTransform::ProjectSpheres(setup.view, setup.projection, setup.nearZ,
+                                                   spheres.data(), results.data(), count,
+                                                   backend);
+                    Assert::IsTrue(results.back() == gs_SphereGuard);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        for (size_t component = 0; component < 4; ++component)
+                        {
+                            Assert::AreEqual(expected[i][component], results[i][component],
+                                             1e-6f * (1.0f + std::abs(expected[i][component])));
+                        }
+                    }
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+
+// Benchmarks only report timings to test log and take much longer than unit tests, so they
+// are ignored unless BLK_RUN_BENCHMARKS is defined
+#ifdef BLK_RUN_BENCHMARKS
+#define BLK_BENCHMARK_METHOD(methodName) TEST_METHOD(methodName)
+#else
+#define BLK_BENCHMARK_METHOD(methodName)     \
+    BEGIN_TEST_METHOD_ATTRIBUTE(methodName) \
+    TEST_IGNORE()                           \
+    END_TEST_METHOD_ATTRIBUTE()             \
+    TEST_METHOD(methodName)
+#endif
+
+namespace Boolka
+{
+
+    // Wall time of single call in milliseconds
+    template <typename Function>
+    double MeasureMilliseconds(Function function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+} // namespace Boolka
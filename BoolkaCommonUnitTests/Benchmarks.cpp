@@ -0,0 +1,648 @@
+#include "pch.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "BoolkaCommon/Algorithms/BatchCulling.h"
+#include "BoolkaCommon/Algorithms/BatchTransform.h"
+#include "BoolkaCommon/Algorithms/Hashing.h"
+#include "BoolkaCommon/Algorithms/MultiViewCulling.h"
+#include "BoolkaCommon/Algorithms/Packing.h"
+#include "BoolkaCommon/Algorithms/RadixSort.h"
+#include "BoolkaCommon/Structures/BVH.h"
+#include "BoolkaCommon/Structures/BoundedQueue.h"
+#include "BoolkaCommon/Structures/FastMath.h"
+#include "BoolkaCommon/Structures/FlatHashMap.h"
+#include "BoolkaCommon/Structures/HighResolutionClock.h"
+#include "BoolkaCommon/Structures/MemoryBlock.h"
+#include "BoolkaCommon/Structures/ScratchArena.h"
+
+#include "BenchmarkHelpers.h"
+#include "TestDataHelpers.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Reference for queue benchmark, same interface as bounded queues
+    class MutexDequeQueue
+    {
+    public:
+        explicit MutexDequeQueue(size_t capacity)
+            : m_Capacity(capacity)
+        {
+        }
+
+        [[nodiscard]] bool TryPush(uint64_t element)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Elements.size() == m_Capacity)
+                return false;
+            m_Elements.push_back(element);
+            return true;
+        }
+
+        [[nodiscard]] bool TryPop(uint64_t& element)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Elements.empty())
+                return false;
+            element = m_Elements.front();
+            m_Elements.pop_front();
+            return true;
+        }
+
+        void Push(uint64_t element)
+        {
+            QueueBackoff backoff;
+            while (!TryPush(element))
+                backoff.Wait();
+        }
+
+        void Pop(uint64_t& element)
+        {
+            QueueBackoff backoff;
+            while (!TryPop(element))
+                backoff.Wait();
+        }
+
+    private:
+        std::mutex m_Mutex;
+        std::deque<uint64_t> m_Elements;
+        size_t m_Capacity;
+    };
+
+    // Returns elements per second passed from producers to consumers
+    template <typename Queue>
+    static double MeasureQueueThroughput(size_t producerCount, size_t consumerCount,
+                                         uint64_t elementsPerProducer)
+    {
+        Queue queue(1024);
+        const uint64_t totalCount = elementsPerProducer * producerCount;
+        const uint64_t elementsPerConsumer = totalCount / consumerCount;
+
+        const double time = MeasureMilliseconds([&] {
+            std::vector<std::thread> threads;
+            for (size_t producer = 0; producer < producerCount; ++producer)
+            {
+                threads.emplace_back([&queue, elementsPerProducer] {
+                    for (uint64_t i = 0; i < elementsPerProducer; ++i)
+                        queue.Push(i);
+                });
+            }
+            for (size_t consumer = 0; consumer < consumerCount; ++consumer)
+            {
+                threads.emplace_back([&queue, elementsPerConsumer] {
+                    uint64_t element = 0;
+                    for (uint64_t i = 0; i < elementsPerConsumer; ++i)
+                        queue.Pop(element);
+                });
+            }
+            for (std::thread& thread : threads)
+                thread.join();
+        });
+
+        return double(totalCount) / time * 1e3;
+    }
+
+    // Returns average time in nanoseconds for element to go to other thread and back
+    template <typename Queue>
+    static double MeasureQueueRoundTrip(uint64_t roundTripCount)
+    {
+        Queue request(16);
+        Queue response(16);
+
+        std::thread echo([&] {
+            uint64_t element = 0;
+            for (uint64_t i = 0; i < roundTripCount; ++i)
+            {
+                request.Pop(element);
+                response.Push(element);
+            }
+        });
+
+        const double time = MeasureMilliseconds([&] {
+            uint64_t element = 0;
+            for (uint64_t i = 0; i < roundTripCount; ++i)
+            {
+                request.Push(i);
+                response.Pop(element);
+            }
+        });
+        echo.join();
+
+        return time * 1e6 / double(roundTripCount);
+    }
+
+    // Only sanity of results is checked here, correctness is covered by unit tests
+    // Timings are reported to test log
+    TEST_CLASS(TestBenchmarks)
+    {
+    public:
+        BLK_BENCHMARK_METHOD(BenchmarkMultiViewCulling)
+        {
+            std::mt19937 generator(47);
+            RenderViews renderViews = BuildRandomRenderViews(generator, 7.0f);
+            std::vector<AABB> boxes = BuildRandomMultiViewBoxes(generator, 100000);
+            FrustumCulling::AABBArray array = BuildMultiViewArray(boxes);
+            const size_t iterationCount = 10;
+
+            std::vector<std::vector<uint32_t>> perViewLists(gs_RenderViewCount,
+                                                            std::vector<uint32_t>(boxes.size()));
+            size_t perViewCounts[gs_RenderViewCount] = {};
+            const double perViewTime = MeasureMilliseconds([&] {
+                for (size_t iteration = 0; iteration < iterationCount; ++iteration)
+                {
+                    for (size_t view = 0; view < gs_RenderViewCount; ++view)
+                    {
+                        perViewCounts[view] = FrustumCulling::CullAABBsToIndices(
+                            renderViews.views[view], array, perViewLists[view].data());
+                    }
+                }
+            });
+
+            std::vector<uint32_t> masks(boxes.size());
+            MultiViewCulling::ViewLists lists;
+            const double multiViewTime = MeasureMilliseconds([&] {
+                for (size_t iteration = 0; iteration < iterationCount; ++iteration)
+                {
+                    MultiViewCulling::CullAABBs(renderViews.views, gs_RenderViewCount,
+                                                renderViews.groups, gs_LightCount, array,
+                                                masks.data());
+                    lists.Build(masks.data(), boxes.size(), gs_RenderViewCount);
+                }
+            });
+
+            // Light sphere only removes boxes, so every list is subset of per view list
+            for (size_t view = 0; view < gs_RenderViewCount; ++view)
+            {
+                const uint32_t* listBegin = perViewLists[view].data();
+                const uint32_t* listEnd = listBegin + perViewCounts[view];
+                Assert::IsTrue(std::includes(listBegin, listEnd, lists.GetIndices(view),
+                                             lists.GetIndices(view) + lists.GetCount(view)));
+            }
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "%zu boxes, %zu views: per view culling %.0fus, multi view culling %.0fus",
+                     boxes.size(), gs_RenderViewCount, perViewTime * 1e3 / iterationCount,
+                     multiViewTime * 1e3 / iterationCount);
+            Logger::WriteMessage(message);
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkFastMath)
+        {
+            std::mt19937 generator(61);
+            std::uniform_real_distribution<float> distribution(0.01f, 100.0f);
+            std::vector<Vector4> input(100000);
+            for (Vector4& x : input)
+            {
+                x = Vector4{distribution(generator), distribution(generator),
+                            distribution(generator), distribution(generator)};
+            }
+
+            // Sum keeps results alive, so that calls aren't optimized out
+            auto measureOverInput = [&input](auto function) {
+                Vector4 sum;
+                const double time = MeasureMilliseconds([&] {
+                    for (const Vector4& x : input)
+                        sum += function(x);
+                });
+                Assert::IsFalse(std::isnan(sum.x()));
+                return time * 1e3;
+            };
+
+            const double exactRsqrt = measureOverInput([](const Vector4& x) {
+                return Vector4{1.0f / ::sqrt(x.x()), 1.0f / ::sqrt(x.y()), 1.0f / ::sqrt(x.z()),
+                               1.0f / ::sqrt(x.w())};
+            });
+            const double fastRsqrt =
+                measureOverInput([](const Vector4& x) { return FastMath::Rsqrt(x); });
+            const double exactSin = measureOverInput([](const Vector4& x) {
+                return Vector4{::sin(x.x()), ::sin(x.y()), ::sin(x.z()), ::sin(x.w())};
+            });
+            const double fastSin =
+                measureOverInput([](const Vector4& x) { return FastMath::Sin(x); });
+            const double exactAtan = measureOverInput([](const Vector4& x) {
+                return Vector4{::atan(x.x()), ::atan(x.y()), ::atan(x.z()), ::atan(x.w())};
+            });
+            const double fastAtan =
+                measureOverInput([](const Vector4& x) { return FastMath::Atan(x); });
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "%zu vectors: rsqrt %.0fus exact %.0fus, sin %.0fus exact %.0fus, "
+                     "atan %.0fus exact %.0fus",
+                     input.size(), fastRsqrt, exactRsqrt, fastSin, exactSin, fastAtan,
+                     exactAtan);
+            Logger::WriteMessage(message);
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkHalfConversion)
+        {
+            const size_t count = 1 << 24;
+            std::vector<float> floats(count);
+            for (size_t i = 0; i < count; ++i)
+                floats[i] = static_cast<float>(i) * 1e-3f;
+            std::vector<uint16_t> halves(count);
+            std::vector<float> roundTrip(count);
+
+            const Packing::HalfBackend backends[] = {
+                Packing::HalfBackend::Scalar, Packing::HalfBackend::SSE,
+                Packing::HalfBackend::F16C};
+            for (Packing::HalfBackend backend : backends)
+            {
+                if (!Packing::IsHalfBackendSupported(backend))
+                    continue;
+
+                const double toHalfTime = MeasureMilliseconds(
+                    [&] { Packing::FloatToHalf(floats.data(), halves.data(), count, backend); });
+                const double toFloatTime = MeasureMilliseconds([&] {
+                    Packing::HalfToFloat(halves.data(), roundTrip.data(), count, backend);
+                });
+                const float middle = floats[count / 2];
+                Assert::IsTrue(roundTrip[count / 2] ==
+                               Packing::HalfToFloat(Packing::FloatToHalf(middle)));
+
+                const double bytes = count * (sizeof(float) + sizeof(uint16_t));
+                char message[256];
+                snprintf(message, sizeof(message),
+                         "Backend %d: %zu values, float to half %.2f GB/s, half to float "
+                         "%.2f GB/s",
+                         int(backend), count, bytes / toHalfTime * 1e-6,
+                         bytes / toFloatTime * 1e-6);
+                Logger::WriteMessage(message);
+            }
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkHashing)
+        {
+            std::mt19937 generator(89);
+            std::vector<unsigned char> data = BuildRandomBytes(generator, 64 * 1024 * 1024);
+            const MemoryBlock memory{data.data(), data.size()};
+
+            uint32_t crc32 = 0;
+            uint32_t crc32c = 0;
+            uint64_t hash64 = 0;
+            const double crc32Time = MeasureMilliseconds([&] { crc32 = Hashing::CRC32(memory); });
+            const double crc32cTime =
+                MeasureMilliseconds([&] { crc32c = Hashing::CRC32C(memory); });
+            const double hash64Time =
+                MeasureMilliseconds([&] { hash64 = Hashing::Hash64(memory); });
+            Assert::AreNotEqual(crc32, crc32c);
+            Assert::AreNotEqual(uint64_t(0), hash64);
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "%zu bytes: CRC32 %.2f GB/s, CRC32C %.2f GB/s, Hash64 %.2f GB/s", data.size(),
+                     data.size() / crc32Time * 1e-6, data.size() / crc32cTime * 1e-6,
+                     data.size() / hash64Time * 1e-6);
+            Logger::WriteMessage(message);
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkBVH)
+        {
+            std::mt19937 generator(113);
+            const BVHTestMesh mesh = BuildBVHTestMesh(generator, 500000);
+
+            BVH bvh;
+            const double buildTime = MeasureMilliseconds([&] {
+                bvh.Build(mesh.positions.data(), mesh.indices.data(), mesh.indices.size() / 3);
+            });
+
+            const size_t rayCount = 200000;
+            std::vector<Vector3> origins(rayCount);
+            std::vector<Vector3> directions(rayCount);
+            for (size_t i = 0; i < rayCount; ++i)
+                BuildBVHTestRay(generator, origins[i], directions[i]);
+
+            size_t hitCount = 0;
+            const double rayTime = MeasureMilliseconds([&] {
+                for (size_t i = 0; i < rayCount; ++i)
+                {
+                    BVH::RayHit hit;
+                    hitCount += bvh.IntersectRay(origins[i], directions[i], FLT_MAX, hit) ? 1 : 0;
+                }
+            });
+
+            size_t occludedCount = 0;
+            const double occlusionTime = MeasureMilliseconds([&] {
+                for (size_t i = 0; i < rayCount; ++i)
+                    occludedCount += bvh.IsOccluded(origins[i], directions[i], FLT_MAX) ? 1 : 0;
+            });
+            Assert::AreEqual(hitCount, occludedCount);
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "%zu triangles: build %.1fms, depth %zu, closest hit %.2f Mrays/s, "
+                     "occlusion %.2f Mrays/s",
+                     mesh.indices.size() / 3, buildTime, bvh.GetMaxDepth(),
+                     rayCount / rayTime * 1e-3, rayCount / occlusionTime * 1e-3);
+            Logger::WriteMessage(message);
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkBatchTransform)
+        {
+            std::mt19937 generator(47);
+            const Matrix4x4 transform = BuildRandomAffineTransform(generator);
+            const std::vector<Vector3> points = BuildRandomPoints(generator, 4 * 1024 * 1024);
+            const std::vector<AABB> boxes = BuildRandomTransformBoxes(generator, 1024 * 1024);
+
+            std::vector<Vector3> pointResults(points.size());
+            std::vector<Vector3> expectedPoints(points.size());
+            const double productTime = MeasureMilliseconds([&] {
+                for (size_t i = 0; i < points.size(); ++i)
+                    expectedPoints[i] = Vector3(Vector4(points[i], 1.0f) * transform);
+            });
+
+            std::vector<AABB> boxResults(boxes.size());
+            std::vector<AABB> expectedBoxes(boxes.size());
+            const double cornersTime = MeasureMilliseconds([&] {
+                for (size_t i = 0; i < boxes.size(); ++i)
+                    expectedBoxes[i] = TransformAABBCorners(boxes[i], transform);
+            });
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "Vector4 * Matrix4x4 %.2fms, 8 corners per box %.2fms", productTime,
+                     cornersTime);
+            Logger::WriteMessage(message);
+
+            const BatchTransform::Backend backends[] = {BatchTransform::Backend::Scalar,
+                                                        BatchTransform::Backend::SSE,
+                                                        BatchTransform::Backend::AVX2};
+            for (BatchTransform::Backend backend : backends)
+            {
+                if (!FrustumCulling::IsBackendSupported(backend))
+                    continue;
+
+                const double pointTime = MeasureMilliseconds([&] {
+                    BatchTransform::TransformPoints(transform, points.data(),
+                                                    pointResults.data(), points.size(), backend);
+                });
+                const double boxTime = MeasureMilliseconds([&] {
+                    BatchTransform::TransformAABBs(transform, boxes.data(), boxResults.data(),
+                                                   boxes.size(), backend);
+                });
+                Assert::IsTrue(pointResults == expectedPoints);
+
+                snprintf(message, sizeof(message),
+                         "Backend %d: %zu points %.2fms, %zu boxes %.2fms", int(backend),
+                         points.size(), pointTime, boxes.size(), boxTime);
+                Logger::WriteMessage(message);
+            }
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkFlatHashMap)
+        {
+            std::mt19937 generator(460);
+            const size_t keyCount = 20000;
+            const size_t lookupCount = 2000000;
+
+            // Inserts all keys and looks up random ones, half of lookups miss
+            auto benchmark = [&](const char* name, const auto& keys, const auto& missingKeys) {
+                std::uniform_int_distribution<size_t> index(0, keys.size() - 1);
+                std::vector<size_t> lookups(lookupCount);
+                for (size_t& lookup : lookups)
+                    lookup = index(generator);
+
+                using KeyType = typename std::decay_t<decltype(keys)>::value_type;
+                size_t flatFound = 0;
+                size_t referenceFound = 0;
+                FlatHashMap<KeyType, size_t> map;
+                std::unordered_map<KeyType, size_t> reference;
+
+                const double flatInsertTime = MeasureMilliseconds([&] {
+                    for (size_t i = 0; i < keys.size(); ++i)
+                        map.Emplace(keys[i], i);
+                });
+                const double referenceInsertTime = MeasureMilliseconds([&] {
+                    for (size_t i = 0; i < keys.size(); ++i)
+                        reference.emplace(keys[i], i);
+                });
+                const double flatFindTime = MeasureMilliseconds([&] {
+                    for (size_t i = 0; i < lookups.size(); ++i)
+                    {
+                        const auto& keySource = i % 2 ? keys : missingKeys;
+                        flatFound += map.Find(keySource[lookups[i]]) != nullptr;
+                    }
+                });
+                const double referenceFindTime = MeasureMilliseconds([&] {
+                    for (size_t i = 0; i < lookups.size(); ++i)
+                    {
+                        const auto& keySource = i % 2 ? keys : missingKeys;
+                        referenceFound += reference.count(keySource[lookups[i]]);
+                    }
+                });
+                Assert::AreEqual(referenceFound, flatFound);
+
+                char message[256];
+                snprintf(message, sizeof(message),
+                         "%s: insert FlatHashMap %.2fms std::unordered_map %.2fms, "
+                         "find FlatHashMap %.2fms std::unordered_map %.2fms",
+                         name, flatInsertTime, referenceInsertTime, flatFindTime,
+                         referenceFindTime);
+                Logger::WriteMessage(message);
+            };
+
+            // Separately allocated objects as in resource state tracking
+            std::vector<std::unique_ptr<uint64_t>> objects(keyCount * 2);
+            std::vector<const uint64_t*> pointers(keyCount);
+            std::vector<const uint64_t*> missingPointers(keyCount);
+            for (size_t i = 0; i < keyCount; ++i)
+            {
+                objects[i * 2] = std::make_unique<uint64_t>(i);
+                objects[i * 2 + 1] = std::make_unique<uint64_t>(i);
+                pointers[i] = objects[i * 2].get();
+                missingPointers[i] = objects[i * 2 + 1].get();
+            }
+            benchmark("Pointer keys", pointers, missingPointers);
+
+            std::vector<uint32_t> ids(keyCount);
+            std::vector<uint32_t> missingIds(keyCount);
+            for (size_t i = 0; i < keyCount; ++i)
+            {
+                ids[i] = uint32_t(i);
+                missingIds[i] = uint32_t(i + keyCount);
+            }
+            benchmark("Integer keys", ids, missingIds);
+
+            std::vector<std::string> names(keyCount);
+            std::vector<std::string> missingNames(keyCount);
+            for (size_t i = 0; i < keyCount; ++i)
+            {
+                names[i] = "Textures/Material_" + std::to_string(i) + "_Diffuse.dds";
+                missingNames[i] = "Textures/Material_" + std::to_string(i) + "_Normal.dds";
+            }
+            benchmark("String keys", names, missingNames);
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkBoundedQueue)
+        {
+            char message[256];
+            const uint64_t elementCount = 1000000;
+            const uint64_t roundTripCount = 100000;
+
+            const double spscThroughput =
+                MeasureQueueThroughput<SPSCQueue<uint64_t>>(1, 1, elementCount);
+            const double spscReferenceThroughput =
+                MeasureQueueThroughput<MutexDequeQueue>(1, 1, elementCount);
+            snprintf(message, sizeof(message),
+                     "1 producer 1 consumer: SPSCQueue %.1fM/s, MPMCQueue %.1fM/s, "
+                     "mutex std::deque %.1fM/s",
+                     spscThroughput / 1e6,
+                     MeasureQueueThroughput<MPMCQueue<uint64_t>>(1, 1, elementCount) / 1e6,
+                     spscReferenceThroughput / 1e6);
+            Logger::WriteMessage(message);
+
+            snprintf(message, sizeof(message),
+                     "4 producers 4 consumers: MPMCQueue %.1fM/s, mutex std::deque %.1fM/s",
+                     MeasureQueueThroughput<MPMCQueue<uint64_t>>(4, 4, elementCount / 4) / 1e6,
+                     MeasureQueueThroughput<MutexDequeQueue>(4, 4, elementCount / 4) / 1e6);
+            Logger::WriteMessage(message);
+
+            snprintf(message, sizeof(message),
+                     "Round trip: SPSCQueue %.0fns, MPMCQueue %.0fns, mutex std::deque %.0fns",
+                     MeasureQueueRoundTrip<SPSCQueue<uint64_t>>(roundTripCount),
+                     MeasureQueueRoundTrip<MPMCQueue<uint64_t>>(roundTripCount),
+                     MeasureQueueRoundTrip<MutexDequeQueue>(roundTripCount));
+            Logger::WriteMessage(message);
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkRadixSort)
+        {
+            using SortPair = std::pair<float, uint32_t>;
+
+            std::mt19937 generator(48000);
+            ScratchArena scratch;
+            for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)})
+            {
+                const std::vector<float> distances = BuildRandomDistances(generator, count);
+
+                std::vector<SortPair> pairs(count);
+                for (size_t i = 0; i < count; ++i)
+                    pairs[i] = SortPair{distances[i], uint32_t(i)};
+                const double stdSortTime = MeasureMilliseconds([&] {
+                    std::sort(pairs.begin(), pairs.end(),
+                              [](const SortPair& left, const SortPair& right) {
+                                  return left.first < right.first;
+                              });
+                });
+
+                // Scratch memory is reused between frames, so first sort only warms it up
+                std::vector<float> keys;
+                std::vector<uint32_t> values(count);
+                double radixSortTime = 0.0;
+                for (int run = 0; run < 2; ++run)
+                {
+                    keys = distances;
+                    std::iota(values.begin(), values.end(), 0u);
+                    scratch.Reset();
+                    radixSortTime = MeasureMilliseconds([&] {
+                        RadixSort::Sort(keys.data(), values.data(), count,
+                                        RadixSort::Order::Ascending, scratch);
+                    });
+                }
+
+                for (size_t i = 0; i < count; ++i)
+                    Assert::AreEqual(pairs[i].first, keys[i]);
+
+                char message[256];
+                snprintf(message, sizeof(message),
+                         "%zu keys: std::sort %.3fms, RadixSort %.3fms on %u threads", count,
+                         stdSortTime, radixSortTime, std::thread::hardware_concurrency());
+                Logger::WriteMessage(message);
+            }
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkHighResolutionClock)
+        {
+            const int callCount = 1000000;
+
+            uint64_t timestampSum = 0;
+            const double clockTime = MeasureMilliseconds([&] {
+                for (int i = 0; i < callCount; ++i)
+                    timestampSum += HighResolutionClock::GetTimestamp();
+            });
+            int64_t steadySum = 0;
+            const double steadyTime = MeasureMilliseconds([&] {
+                for (int i = 0; i < callCount; ++i)
+                    steadySum += std::chrono::steady_clock::now().time_since_epoch().count();
+            });
+            Assert::IsTrue(timestampSum != 0 && steadySum != 0);
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "Source %s at %.3fGHz, measured overhead %.1fns, "
+                     "GetTimestamp %.1fns per call, steady_clock %.1fns per call",
+                     HighResolutionClock::IsUsingTSC() ? "TSC" : "steady_clock",
+                     HighResolutionClock::GetTicksPerSecond() / 1e9,
+                     HighResolutionClock::GetCallOverheadNanoseconds(), clockTime * 1e6 / callCount,
+                     steadyTime * 1e6 / callCount);
+            Logger::WriteMessage(message);
+        }
+
+        BLK_BENCHMARK_METHOD(BenchmarkBatchCulling)
+        {
+            std::mt19937 generator(500000);
+            BatchCullingViews views = BuildRandomBatchCullingViews(generator);
+            // Same limit as Scene::MaxObjectCount
+            BatchCullingObjects objects = BuildRandomBatchCullingObjects(generator, 2048, 1800);
+            const size_t objectCount = objects.boundingBoxes.size();
+            const int frameCount = 100;
+
+            // Reference tests every object against every view and sorts with std::sort
+            std::vector<std::pair<float, uint32_t>> referenceList(objectCount);
+            size_t referenceVisibleCount = 0;
+            const double referenceTime = MeasureMilliseconds([&] {
+                for (int frame = 0; frame < frameCount; ++frame)
+                {
+                    referenceVisibleCount = 0;
+                    for (const Frustum& frustum : views.views)
+                    {
+                        const float* nearPlaneData = frustum.GetBuffer();
+                        const Vector4 nearPlane(nearPlaneData, nearPlaneData + 4);
+                        size_t count = 0;
+                        for (size_t i = 0; i < objectCount; ++i)
+                        {
+                            const Vector4 center(Vector3(objects.boundingSpheres[i]), 1.0f);
+                            if (frustum.CheckSphereFast(center, objects.boundingSpheres[i].w()) &&
+                                frustum.CheckAABBFast(objects.boundingBoxes[i]))
+                                referenceList[count++] = {nearPlane.Dot(center), uint32_t(i)};
+                        }
+                        std::sort(referenceList.begin(), referenceList.begin() + count);
+                        referenceVisibleCount += count;
+                    }
+                }
+            });
+
+            BatchCulling culling;
+            culling.Initialize(objects.boundingBoxes.data(), objects.boundingSpheres.data(),
+                               objectCount, objects.opaqueCount);
+            // First frame allocates storage
+            culling.Cull(views.views, gs_BatchViewCount, views.groups, gs_BatchLightCount);
+            const double cullingTime = MeasureMilliseconds([&] {
+                for (int frame = 0; frame < frameCount; ++frame)
+                    culling.Cull(views.views, gs_BatchViewCount, views.groups, gs_BatchLightCount);
+            });
+
+            size_t visibleCount = 0;
+            for (size_t view = 0; view < gs_BatchViewCount; ++view)
+                visibleCount += culling.GetOpaqueCount(view) + culling.GetTransparentCount(view);
+            culling.Unload();
+            // Light spheres only remove objects
+            Assert::IsTrue(visibleCount <= referenceVisibleCount);
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "%zu objects, %zu views: per view loop %.1fus, BatchCulling %.1fus per frame, "
+                     "%zu visible from %zu",
+                     objectCount, gs_BatchViewCount, referenceTime * 1e3 / frameCount,
+                     cullingTime * 1e3 / frameCount, visibleCount, referenceVisibleCount);
+            Logger::WriteMessage(message);
+        }
+    };
+}
@@ -0,0 +1,218 @@
+#include "pch.h"
+
+#include <memory>
+
+#include "BoolkaCommon/Structures/BoundedQueue.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Counts live instances, so that leaked or double destroyed elements are detected
+    struct BoundedQueueTrackedElement
+    {
+        static std::atomic<int> ms_LiveCount;
+
+        BoundedQueueTrackedElement()
+            : value(0)
+        {
+            ++ms_LiveCount;
+        }
+
+        explicit BoundedQueueTrackedElement(int value)
+            : value(value)
+        {
+            ++ms_LiveCount;
+        }
+
+        BoundedQueueTrackedElement(const BoundedQueueTrackedElement& other)
+            : value(other.value)
+        {
+            ++ms_LiveCount;
+        }
+
+        ~BoundedQueueTrackedElement()
+        {
+            --ms_LiveCount;
+        }
+
+        BoundedQueueTrackedElement& operator=(const BoundedQueueTrackedElement& other) = default;
+
+        int value;
+    };
+
+    std::atomic<int> BoundedQueueTrackedElement::ms_LiveCount = 0;
+
+    template <typename Queue>
+    static void TestQueueSingleThread()
+    {
+        Queue queue(5);
+        Assert::AreEqual(size_t(8), queue.GetCapacity());
+        Assert::IsTrue(queue.IsEmpty());
+
+        uint64_t element = 0;
+        Assert::IsFalse(queue.TryPop(element));
+
+        // Several laps around ring
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        for (int lap = 0; lap < 10; ++lap)
+        {
+            while (queue.TryPush(pushed))
+                ++pushed;
+            Assert::AreEqual(size_t(8), queue.GetSize());
+
+            for (int i = 0; i < 5; ++i)
+            {
+                Assert::IsTrue(queue.TryPop(element));
+                Assert::AreEqual(popped++, element);
+            }
+            Assert::AreEqual(size_t(3), queue.GetSize());
+        }
+
+        while (queue.TryPop(element))
+            Assert::AreEqual(popped++, element);
+        Assert::AreEqual(pushed, popped);
+        Assert::IsTrue(queue.IsEmpty());
+    }
+
+    template <typename Queue>
+    static void TestQueueElementLifetime()
+    {
+        {
+            Queue queue(16);
+            for (int i = 0; i < 10; ++i)
+                Assert::IsTrue(queue.TryEmplace(i));
+            Assert::AreEqual(10, BoundedQueueTrackedElement::ms_LiveCount.load());
+
+            BoundedQueueTrackedElement element;
+            for (int i = 0; i < 4; ++i)
+            {
+                Assert::IsTrue(queue.TryPop(element));
+                Assert::AreEqual(i, element.value);
+            }
+            Assert::AreEqual(7, BoundedQueueTrackedElement::ms_LiveCount.load());
+        }
+        // Elements left in queue are destroyed with it
+        Assert::AreEqual(0, BoundedQueueTrackedElement::ms_LiveCount.load());
+    }
+
+    // Producers push their index in high bits and increasing number in low bits
+    template <typename Queue>
+    static void TestQueueStress(size_t producerCount, size_t consumerCount, size_t capacity,
+                                uint64_t elementsPerProducer)
+    {
+        Queue queue(capacity);
+        std::atomic<uint64_t> poppedCount = 0;
+        std::atomic<uint64_t> poppedSum = 0;
+        std::atomic<bool> isOrdered = true;
+        const uint64_t totalCount = elementsPerProducer * producerCount;
+
+        std::vector<std::thread> threads;
+        for (size_t producer = 0; producer < producerCount; ++producer)
+        {
+            threads.emplace_back([&queue, producer, elementsPerProducer] {
+                for (uint64_t i = 0; i < elementsPerProducer; ++i)
+                {
+                    const uint64_t element = (uint64_t(producer) << 32) | i;
+                    // Mix both paths, so that blocking and non-blocking push are exercised
+                    if (i % 2 == 0)
+                        queue.Push(element);
+                    else
+                        while (!queue.TryPush(element))
+                            std::this_thread::yield();
+                }
+            });
+        }
+        for (size_t consumer = 0; consumer < consumerCount; ++consumer)
+        {
+            threads.emplace_back([&, producerCount] {
+                // Elements of single producer come out in order they were pushed
+                std::vector<uint64_t> nextExpected(producerCount, 0);
+                uint64_t sum = 0;
+                uint64_t element = 0;
+                while (poppedCount.load(std::memory_order_relaxed) < totalCount)
+                {
+                    if (!queue.TryPop(element))
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    const size_t producer = size_t(element >> 32);
+                    const uint64_t index = element & 0xFFFFFFFFull;
+                    if (producer >= producerCount || index < nextExpected[producer])
+                        isOrdered = false;
+                    else
+                        nextExpected[producer] = index + 1;
+                    sum += element;
+                    poppedCount.fetch_add(1, std::memory_order_relaxed);
+                }
+                poppedSum += sum;
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        uint64_t expectedSum = 0;
+        for (size_t producer = 0; producer < producerCount; ++producer)
+            expectedSum += (uint64_t(producer) << 32) * elementsPerProducer +
+                           elementsPerProducer * (elementsPerProducer - 1) / 2;
+
+        Assert::IsTrue(isOrdered.load());
+        Assert::AreEqual(totalCount, poppedCount.load());
+        Assert::AreEqual(expectedSum, poppedSum.load());
+        Assert::IsTrue(queue.IsEmpty());
+    }
+
+    // Returns elements per second
+    TEST_CLASS(TestBoundedQueue)
+    {
+    public:
+        TEST_METHOD(SPSCSingleThread)
+        {
+            TestQueueSingleThread<SPSCQueue<uint64_t>>();
+        }
+
+        TEST_METHOD(MPMCSingleThread)
+        {
+            TestQueueSingleThread<MPMCQueue<uint64_t>>();
+        }
+
+        TEST_METHOD(ElementLifetime)
+        {
+            TestQueueElementLifetime<SPSCQueue<BoundedQueueTrackedElement>>();
+            TestQueueElementLifetime<MPMCQueue<BoundedQueueTrackedElement>>();
+        }
+
+        TEST_METHOD(MoveOnlyElements)
+        {
+            SPSCQueue<std::unique_ptr<int>> spscQueue(4);
+            MPMCQueue<std::unique_ptr<int>> mpmcQueue(4);
+            Assert::IsTrue(spscQueue.TryPush(std::make_unique<int>(1)));
+            Assert::IsTrue(mpmcQueue.TryPush(std::make_unique<int>(2)));
+
+            std::unique_ptr<int> element;
+            Assert::IsTrue(spscQueue.TryPop(element));
+            Assert::AreEqual(1, *element);
+            Assert::IsTrue(mpmcQueue.TryPop(element));
+            Assert::AreEqual(2, *element);
+        }
+
+        TEST_METHOD(SPSCStress)
+        {
+            TestQueueStress<SPSCQueue<uint64_t>>(1, 1, 64, 1000000);
+            // Capacity of 2 makes almost every operation hit full or empty queue
+            TestQueueStress<SPSCQueue<uint64_t>>(1, 1, 2, 100000);
+        }
+
+        TEST_METHOD(MPMCStress)
+        {
+            TestQueueStress<MPMCQueue<uint64_t>>(4, 4, 64, 200000);
+            TestQueueStress<MPMCQueue<uint64_t>>(1, 4, 64, 400000);
+            TestQueueStress<MPMCQueue<uint64_t>>(4, 1, 64, 100000);
+            TestQueueStress<MPMCQueue<uint64_t>>(3, 3, 2, 50000);
+        }
+    };
+}
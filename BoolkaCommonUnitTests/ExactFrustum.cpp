@@ -0,0 +1,342 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/ExactFrustum.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Perspective frustum looking along +z with 90 degree field of view, so that side planes
+    // are x = +-z and y = +-z
+    static Matrix4x4 GetAxisAlignedPerspective()
+    {
+        return Matrix4x4::CalculateProjPerspective(1.0f, 10.0f, 1.0f, BLK_FLOAT_PI / 2.0f);
+    }
+
+    static Matrix4x4 BuildRandomViewProj(std::mt19937& generator, bool perspective)
+    {
+        std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+        std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+
+        Matrix4x4 rotation = Matrix4x4::GetRotationY(angle(generator)) *
+                             Matrix4x4::GetRotationX(angle(generator) * 0.5f);
+        Matrix4x4 view = Matrix4x4::CalculateView(
+            rotation[0], rotation[1], rotation[2],
+            Vector4{position(generator), position(generator), position(generator), 1.0f});
+        Matrix4x4 proj = perspective
+                             ? Matrix4x4::CalculateProjPerspective(0.5f, 30.0f, 1.5f, 1.0f)
+                             : Matrix4x4::CalculateProjOrtographic(0.5f, 30.0f, 20.0f, 10.0f);
+        return view * proj;
+    }
+
+    // Separating axis test done independently in double precision by projecting all corners of
+    // both shapes, returns largest gap between projections over all axes
+    static double CalculateSeparation(const ExactFrustum& frustum, const AABB& box)
+    {
+        double boxCorners[8][3];
+        double frustumCorners[8][3];
+        for (size_t i = 0; i < 8; ++i)
+        {
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                boxCorners[i][axis] =
+                    ((i >> axis) & 1) ? box.GetMax()[axis] : box.GetMin()[axis];
+                frustumCorners[i][axis] = frustum.GetCorner(i)[axis];
+            }
+        }
+
+        std::vector<std::array<double, 3>> axes;
+        const double boxAxes[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+        for (const auto& boxAxis : boxAxes)
+            axes.push_back({boxAxis[0], boxAxis[1], boxAxis[2]});
+
+        std::vector<std::array<double, 3>> edges;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            for (size_t bit = 0; bit < 3; ++bit)
+            {
+                const size_t j = i | (size_t(1) << bit);
+                if (j == i)
+                    continue;
+                edges.push_back({frustumCorners[j][0] - frustumCorners[i][0],
+                                 frustumCorners[j][1] - frustumCorners[i][1],
+                                 frustumCorners[j][2] - frustumCorners[i][2]});
+            }
+        }
+
+        for (size_t plane = 0; plane < 6; ++plane)
+        {
+            const float* data = frustum.GetFrustum().GetBuffer() + plane * 4;
+            axes.push_back({data[0], data[1], data[2]});
+        }
+        for (const auto& edge : edges)
+        {
+            for (const auto& boxAxis : boxAxes)
+            {
+                axes.push_back({boxAxis[1] * edge[2] - boxAxis[2] * edge[1],
+                                boxAxis[2] * edge[0] - boxAxis[0] * edge[2],
+                                boxAxis[0] * edge[1] - boxAxis[1] * edge[0]});
+            }
+        }
+
+        double result = -DBL_MAX;
+        for (const auto& axis : axes)
+        {
+            const double length = sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            if (length < 1e-9)
+                continue;
+
+            double boxMin = DBL_MAX, boxMax = -DBL_MAX, frustumMin = DBL_MAX,
+                   frustumMax = -DBL_MAX;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                const double boxProjection = (boxCorners[i][0] * axis[0] +
+                                              boxCorners[i][1] * axis[1] +
+                                              boxCorners[i][2] * axis[2]) / length;
+                const double frustumProjection = (frustumCorners[i][0] * axis[0] +
+                                                  frustumCorners[i][1] * axis[1] +
+                                                  frustumCorners[i][2] * axis[2]) / length;
+                boxMin = std::min(boxMin, boxProjection);
+                boxMax = std::max(boxMax, boxProjection);
+                frustumMin = std::min(frustumMin, frustumProjection);
+                frustumMax = std::max(frustumMax, frustumProjection);
+            }
+            result = std::max({result, boxMin - frustumMax, frustumMin - boxMax});
+        }
+        return result;
+    }
+
+    // Distance from point to frustum, calculated with Dykstra's projection onto intersection of
+    // half spaces in double precision
+    static double CalculateDistanceToFrustum(const Frustum& frustum, const Vector4& point)
+    {
+        const float* planes = frustum.GetBuffer();
+        double current[3] = {point.x(), point.y(), point.z()};
+        double corrections[6][3] = {};
+
+        for (size_t iteration = 0; iteration < 2000; ++iteration)
+        {
+            for (size_t i = 0; i < 6; ++i)
+            {
+                const float* plane = planes + i * 4;
+                double shifted[3];
+                for (size_t axis = 0; axis < 3; ++axis)
+                    shifted[axis] = current[axis] + corrections[i][axis];
+
+                const double distance = shifted[0] * plane[0] + shifted[1] * plane[1] +
+                                        shifted[2] * plane[2] + plane[3];
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    const double projected =
+                        distance < 0.0 ? shifted[axis] - distance * plane[axis] : shifted[axis];
+                    corrections[i][axis] = shifted[axis] - projected;
+                    current[axis] = projected;
+                }
+            }
+        }
+
+        double distanceSqr = 0.0;
+        for (size_t axis = 0; axis < 3; ++axis)
+            distanceSqr += (current[axis] - point[axis]) * (current[axis] - point[axis]);
+        return sqrt(distanceSqr);
+    }
+
+    // Random box in bounding box of frustum extended by half of its size in every direction,
+    // box size is proportional to frustum size
+    static AABB BuildRandomBoxNearFrustum(std::mt19937& generator, const ExactFrustum& frustum)
+    {
+        Vector4 frustumMin = frustum.GetCorner(0);
+        Vector4 frustumMax = frustum.GetCorner(0);
+        for (size_t i = 1; i < 8; ++i)
+        {
+            frustumMin = frustumMin.Min(frustum.GetCorner(i));
+            frustumMax = frustumMax.Max(frustum.GetCorner(i));
+        }
+        const Vector4 frustumSize = frustumMax - frustumMin;
+
+        std::uniform_real_distribution<float> unit(-0.5f, 1.5f);
+        std::exponential_distribution<float> size(20.0f);
+
+        Vector4 center = frustumMin;
+        Vector4 extent;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            center[axis] += frustumSize[axis] * unit(generator);
+            extent[axis] = frustumSize.LengthSlow() * size(generator);
+        }
+        return AABB{center - extent, center + extent};
+    }
+
+    TEST_CLASS(TestExactFrustum)
+    {
+    public:
+        TEST_METHOD(Corners)
+        {
+            ExactFrustum frustum(GetAxisAlignedPerspective());
+
+            // Corner of first plane in each pair of planes, that is z = 10, x = z and y = z
+            Assert::IsTrue(ApproxEqual(frustum.GetCorner(0), Vector4{10.0f, 10.0f, 10.0f, 1.0f},
+                                       1e-4f));
+            for (size_t i = 0; i < 8; ++i)
+            {
+                for (size_t plane = 0; plane < 6; ++plane)
+                {
+                    // Corner lies on plane that is selected by its index and inside the others
+                    const float* data = frustum.GetFrustum().GetBuffer() + plane * 4;
+                    const float distance = Vector4(data, data + 4).Dot(frustum.GetCorner(i));
+                    const size_t bit = plane < 2 ? 2 : (plane < 4 ? 0 : 1);
+                    if (((i >> bit) & 1) == plane % 2)
+                        Assert::IsTrue(ApproxEqual(distance, 0.0f, 1e-4f));
+                    else
+                        Assert::IsTrue(distance > 0.0f);
+                }
+            }
+        }
+
+        TEST_METHOD(BoxNearEdge)
+        {
+            ExactFrustum frustum(GetAxisAlignedPerspective());
+
+            // Outside of far and right planes near the edge between them, each plane alone
+            // doesn't reject the box
+            AABB outside{{10.6f, -1.0f, 9.6f, 1.0f}, {12.4f, 1.0f, 11.4f, 1.0f}};
+            Assert::IsTrue(frustum.GetFrustum().CheckAABBFast(outside));
+            Assert::IsFalse(frustum.CheckAABB(outside));
+
+            // Same box moved to cross the edge
+            AABB crossing{{9.4f, -1.0f, 9.6f, 1.0f}, {11.2f, 1.0f, 11.4f, 1.0f}};
+            Assert::IsTrue(frustum.CheckAABB(crossing));
+
+            // Barely crosses the edge
+            AABB touching{{9.99f, -1.0f, 9.99f, 1.0f}, {11.0f, 1.0f, 11.0f, 1.0f}};
+            Assert::IsTrue(frustum.CheckAABB(touching));
+        }
+
+        TEST_METHOD(BoxNearCorner)
+        {
+            ExactFrustum frustum(GetAxisAlignedPerspective());
+
+            // Diagonally outside of far right top corner
+            AABB outside{{10.3f, 10.3f, 9.0f, 1.0f}, {12.0f, 12.0f, 11.0f, 1.0f}};
+            Assert::IsTrue(frustum.GetFrustum().CheckAABBFast(outside));
+            Assert::IsFalse(frustum.CheckAABB(outside));
+
+            // Contains the corner
+            AABB inside{{9.5f, 9.5f, 9.5f, 1.0f}, {12.0f, 12.0f, 11.0f, 1.0f}};
+            Assert::IsTrue(frustum.CheckAABB(inside));
+
+            // Box containing whole frustum and box inside of it
+            Assert::IsTrue(frustum.CheckAABB(
+                AABB{{-20.0f, -20.0f, -20.0f, 1.0f}, {20.0f, 20.0f, 20.0f, 1.0f}}));
+            Assert::IsTrue(
+                frustum.CheckAABB(AABB{{-0.5f, -0.5f, 4.0f, 1.0f}, {0.5f, 0.5f, 5.0f, 1.0f}}));
+        }
+
+        TEST_METHOD(SphereNearEdge)
+        {
+            ExactFrustum frustum(GetAxisAlignedPerspective());
+
+            // Distance from center to far right edge is sqrt(2)
+            Vector4 center{11.0f, 0.0f, 11.0f, 1.0f};
+            Assert::IsTrue(frustum.GetFrustum().CheckSphereFast(center, 1.2f));
+            Assert::IsFalse(frustum.CheckSphere(center, 1.2f));
+            Assert::IsTrue(frustum.CheckSphere(center, 1.42f));
+
+            // Distance from center to corner is sqrt(3)
+            Vector4 cornerCenter{11.0f, 11.0f, 11.0f, 1.0f};
+            Assert::IsTrue(frustum.GetFrustum().CheckSphereFast(cornerCenter, 1.7f));
+            Assert::IsFalse(frustum.CheckSphere(cornerCenter, 1.7f));
+            Assert::IsTrue(frustum.CheckSphere(cornerCenter, 1.74f));
+
+            // Center inside, and sphere that contains whole frustum
+            Assert::IsTrue(frustum.CheckSphere(Vector4{0.0f, 0.0f, 5.0f, 1.0f}, 0.1f));
+            Assert::IsTrue(frustum.CheckSphere(Vector4{0.0f, 0.0f, 5.0f, 1.0f}, 100.0f));
+            // Crosses single plane
+            Assert::IsTrue(frustum.CheckSphere(Vector4{0.0f, 0.0f, 10.5f, 1.0f}, 0.6f));
+            Assert::IsFalse(frustum.CheckSphere(Vector4{0.0f, 0.0f, 10.5f, 1.0f}, 0.4f));
+        }
+
+        TEST_METHOD(RandomBoxes)
+        {
+            // Measured false positive rate of Frustum::CheckAABBFast for these boxes is about
+            // 1.7% of all boxes (about 1.9% of boxes that are outside of frustum),
+            // ExactFrustum::CheckAABB has no false positives other than within tolerance
+            std::mt19937 generator(71);
+            size_t boxCount = 0;
+            size_t fastFalsePositiveCount = 0;
+            size_t outsideCount = 0;
+            for (size_t iteration = 0; iteration < 64; ++iteration)
+            {
+                ExactFrustum frustum(BuildRandomViewProj(generator, iteration % 2 == 0));
+                for (size_t i = 0; i < 1000; ++i)
+                {
+                    const AABB box = BuildRandomBoxNearFrustum(generator, frustum);
+                    const double separation = CalculateSeparation(frustum, box);
+                    const bool fast = frustum.GetFrustum().CheckAABBFast(box);
+                    const bool exact = frustum.CheckAABB(box);
+
+                    // Exact test never accepts what plane test rejects
+                    Assert::IsTrue(fast || !exact);
+                    // Cases very close to touching are ambiguous in float precision
+                    if (abs(separation) > 1e-3)
+                        Assert::IsTrue(exact == (separation < 0.0));
+
+                    ++boxCount;
+                    outsideCount += separation > 0.0;
+                    fastFalsePositiveCount += fast && separation > 0.0;
+                }
+            }
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "CheckAABBFast false positives: %.2f%% of all boxes, %.2f%% of boxes outside",
+                     100.0 * fastFalsePositiveCount / boxCount,
+                     100.0 * fastFalsePositiveCount / outsideCount);
+            Logger::WriteMessage(message);
+        }
+
+        TEST_METHOD(RandomSpheres)
+        {
+            // Measured false positive rate of Frustum::CheckSphereFast for these spheres is
+            // about 0.25% of all spheres (about 0.25% of spheres that are outside of frustum),
+            // ExactFrustum::CheckSphere has no false positives other than within tolerance
+            std::mt19937 generator(73);
+            std::exponential_distribution<float> radiusDistribution(0.5f);
+            size_t sphereCount = 0;
+            size_t fastFalsePositiveCount = 0;
+            size_t outsideCount = 0;
+            for (size_t iteration = 0; iteration < 32; ++iteration)
+            {
+                ExactFrustum frustum(BuildRandomViewProj(generator, iteration % 2 == 0));
+                for (size_t i = 0; i < 500; ++i)
+                {
+                    const AABB box = BuildRandomBoxNearFrustum(generator, frustum);
+                    const Vector4 center = (box.GetMin() + box.GetMax()) * 0.5f;
+                    const float radius = radiusDistribution(generator);
+                    const double distance = CalculateDistanceToFrustum(frustum.GetFrustum(),
+                                                                       center);
+                    const bool fast = frustum.GetFrustum().CheckSphereFast(center, radius);
+                    const bool exact = frustum.CheckSphere(center, radius);
+
+                    Assert::IsTrue(fast || !exact);
+                    if (abs(distance - radius) > 1e-3)
+                        Assert::IsTrue(exact == (distance < radius));
+
+                    ++sphereCount;
+                    outsideCount += distance > radius;
+                    fastFalsePositiveCount += fast && distance > radius;
+                }
+            }
+
+            char message[256];
+            snprintf(message, sizeof(message),
+                     "CheckSphereFast false positives: %.2f%% of all spheres, %.2f%% of spheres "
+                     "outside",
+                     100.0 * fastFalsePositiveCount / sphereCount,
+                     100.0 * fastFalsePositiveCount / outsideCount);
+            Logger::WriteMessage(message);
+        }
+    };
+}
@@ -0,0 +1,136 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/FastMath.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Every 1021st float between given bounds, every exponent gets about 8000 samples, that is
+    // more than entries in hardware estimate tables
+    template <typename Function>
+    static void ForEachSampledFloat(float first, float last, Function function)
+    {
+        BLK_ASSERT(first >= 0.0f && first <= last);
+        const uint32_t lastBits = std::bit_cast<uint32_t>(last);
+        for (uint32_t bits = std::bit_cast<uint32_t>(first); bits <= lastBits; bits += 1021)
+        {
+            function(std::bit_cast<float>(bits));
+            if (lastBits - bits < 1021)
+                break;
+        }
+    }
+
+    TEST_CLASS(TestFastMath)
+    {
+    public:
+        TEST_METHOD(RsqrtError)
+        {
+            double maxError = 0.0;
+            ForEachSampledFloat(FLT_MIN, FLT_MAX, [&maxError](float x) {
+                const double error = abs(FastMath::Rsqrt(x) * sqrt(double(x)) - 1.0);
+                maxError = std::max(maxError, error);
+            });
+            Assert::IsTrue(maxError <= FastMath::ms_RsqrtMaxRelativeError);
+        }
+
+        TEST_METHOD(RcpError)
+        {
+            double maxError = 0.0;
+            ForEachSampledFloat(FLT_MIN, ldexp(1.0f, 126), [&maxError](float x) {
+                const double positiveError = abs(FastMath::Rcp(x) * double(x) - 1.0);
+                const double negativeError = abs(FastMath::Rcp(-x) * -double(x) - 1.0);
+                maxError = std::max({maxError, positiveError, negativeError});
+            });
+            Assert::IsTrue(maxError <= FastMath::ms_RcpMaxRelativeError);
+        }
+
+        TEST_METHOD(SinCosError)
+        {
+            double maxError = 0.0;
+            ForEachSampledFloat(0.0f, FastMath::ms_SinCosMaxArgument, [&maxError](float x) {
+                for (float argument : {x, -x})
+                {
+                    float sin, cos;
+                    FastMath::SinCos(argument, sin, cos);
+                    Assert::AreEqual(sin, FastMath::Sin(argument));
+                    Assert::AreEqual(cos, FastMath::Cos(argument));
+                    maxError = std::max({maxError, abs(sin - ::sin(double(argument))),
+                                         abs(cos - ::cos(double(argument)))});
+                }
+            });
+            Assert::IsTrue(maxError <= FastMath::ms_SinCosMaxError);
+        }
+
+        TEST_METHOD(AtanError)
+        {
+            double maxError = 0.0;
+            ForEachSampledFloat(0.0f, FLT_MAX, [&maxError](float x) {
+                maxError = std::max({maxError, abs(FastMath::Atan(x) - ::atan(double(x))),
+                                     abs(FastMath::Atan(-x) - ::atan(-double(x)))});
+            });
+            Assert::IsTrue(maxError <= FastMath::ms_AtanMaxError);
+
+            const float infinity = std::numeric_limits<float>::infinity();
+            Assert::IsTrue(ApproxEqual(FastMath::Atan(infinity), BLK_FLOAT_PI / 2.0f));
+            Assert::IsTrue(ApproxEqual(FastMath::Atan(-infinity), -BLK_FLOAT_PI / 2.0f));
+        }
+
+        TEST_METHOD(ExactValues)
+        {
+            Assert::AreEqual(0.0f, FastMath::Sin(0.0f));
+            Assert::AreEqual(1.0f, FastMath::Cos(0.0f));
+            Assert::AreEqual(0.0f, FastMath::Atan(0.0f));
+            Assert::IsTrue(ApproxEqual(FastMath::Rsqrt(4.0f), 0.5f,
+                                       0.5f * FastMath::ms_RsqrtMaxRelativeError));
+            Assert::IsTrue(ApproxEqual(FastMath::Rcp(-4.0f), -0.25f,
+                                       0.25f * FastMath::ms_RcpMaxRelativeError));
+        }
+
+        TEST_METHOD(VectorMatchesScalar)
+        {
+            std::mt19937 generator(53);
+            std::uniform_real_distribution<float> distribution(0.01f, 100.0f);
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                const Vector4 x{distribution(generator), -distribution(generator),
+                                distribution(generator), -distribution(generator)};
+                const Vector4 positive{x.x(), -x.y(), x.z(), -x.w()};
+
+                const Vector4 rsqrt = FastMath::Rsqrt(positive);
+                const Vector4 rcp = FastMath::Rcp(x);
+                const Vector4 atan = FastMath::Atan(x);
+                Vector4 sin, cos;
+                FastMath::SinCos(x, sin, cos);
+                Assert::IsTrue(sin == FastMath::Sin(x));
+                Assert::IsTrue(cos == FastMath::Cos(x));
+
+                for (size_t component = 0; component < 4; ++component)
+                {
+                    Assert::AreEqual(FastMath::Rsqrt(positive[component]), rsqrt[component]);
+                    Assert::AreEqual(FastMath::Rcp(x[component]), rcp[component]);
+                    Assert::AreEqual(FastMath::Atan(x[component]), atan[component]);
+                    Assert::AreEqual(FastMath::Sin(x[component]), sin[component]);
+                    Assert::AreEqual(FastMath::Cos(x[component]), cos[component]);
+                }
+            }
+        }
+
+        TEST_METHOD(Normalize3)
+        {
+            std::mt19937 generator(59);
+            std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                const Vector4 vector{distribution(generator), distribution(generator),
+                                     distribution(generator), 0.0f};
+                const float length = vector.Length3Slow();
+                Assert::IsTrue(abs(FastMath::Length3(vector) - length) <=
+                               length * 2.0f * FastMath::ms_RsqrtMaxRelativeError);
+                Assert::IsTrue(ApproxEqual(FastMath::Normalize3(vector), vector / length));
+            }
+        }
+    };
+}
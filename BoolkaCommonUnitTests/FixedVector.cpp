@@ -0,0 +1,114 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/FixedVector.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Counts live instances, so that leaked or double destroyed elements are detected
+    struct FixedVectorTrackedElement
+    {
+        static int ms_LiveCount;
+
+        FixedVectorTrackedElement()
+            : value(0)
+        {
+            ++ms_LiveCount;
+        }
+
+        explicit FixedVectorTrackedElement(int value)
+            : value(value)
+        {
+            ++ms_LiveCount;
+        }
+
+        FixedVectorTrackedElement(const FixedVectorTrackedElement& other)
+            : value(other.value)
+        {
+            ++ms_LiveCount;
+        }
+
+        ~FixedVectorTrackedElement()
+        {
+            --ms_LiveCount;
+        }
+
+        FixedVectorTrackedElement& operator=(const FixedVectorTrackedElement& other) = default;
+
+        int value;
+    };
+
+    int FixedVectorTrackedElement::ms_LiveCount = 0;
+
+    TEST_CLASS(TestFixedVector)
+    {
+    public:
+        TEST_METHOD(AddAndRemove)
+        {
+            FixedVector<int, 8> vector;
+            Assert::IsTrue(vector.IsEmpty());
+            Assert::AreEqual(size_t(8), vector.GetCapacity());
+
+            for (int i = 0; i < 8; ++i)
+                vector.Add(i * 2);
+            Assert::IsTrue(vector.IsFull());
+            Assert::AreEqual(14, vector.GetLast());
+
+            int sum = 0;
+            for (int value : vector)
+                sum += value;
+            Assert::AreEqual(56, sum);
+
+            vector.RemoveLast();
+            Assert::IsFalse(vector.IsFull());
+            Assert::AreEqual(size_t(7), vector.GetSize());
+            Assert::AreEqual(4, vector[2]);
+
+            vector.Resize(3);
+            Assert::AreEqual(size_t(3), vector.GetSize());
+            vector.Resize(5);
+            Assert::AreEqual(0, vector[4]);
+        }
+
+        TEST_METHOD(CopyAndMove)
+        {
+            FixedVector<std::string, 4> vector = {"a", "b", "c"};
+
+            FixedVector<std::string, 4> copy(vector);
+            Assert::AreEqual(size_t(3), copy.GetSize());
+            Assert::AreEqual(std::string("c"), copy[2]);
+
+            FixedVector<std::string, 4> moved(std::move(copy));
+            Assert::AreEqual(std::string("b"), moved[1]);
+            Assert::IsTrue(copy.IsEmpty());
+
+            copy = moved;
+            copy.Add("d");
+            moved = std::move(copy);
+            Assert::AreEqual(size_t(4), moved.GetSize());
+            Assert::AreEqual(std::string("d"), moved.GetLast());
+        }
+
+        TEST_METHOD(ElementLifetime)
+        {
+            {
+                FixedVector<FixedVectorTrackedElement, 16> vector;
+                for (int i = 0; i < 10; ++i)
+                    vector.Emplace(i);
+                Assert::AreEqual(10, FixedVectorTrackedElement::ms_LiveCount);
+
+                FixedVector<FixedVectorTrackedElement, 16> copy = vector;
+                Assert::AreEqual(20, FixedVectorTrackedElement::ms_LiveCount);
+
+                copy.Resize(4);
+                vector.Clear();
+                Assert::AreEqual(4, FixedVectorTrackedElement::ms_LiveCount);
+                Assert::AreEqual(3, copy.GetLast().value);
+            }
+            Assert::AreEqual(0, FixedVectorTrackedElement::ms_LiveCount);
+        }
+    };
+}
@@ -0,0 +1,288 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/FlatHashMap.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Counts live instances, so that leaked or double destroyed values are detected
+    struct FlatHashMapTrackedValue
+    {
+        static int ms_LiveCount;
+
+        FlatHashMapTrackedValue()
+            : value(0)
+        {
+            ++ms_LiveCount;
+        }
+
+        explicit FlatHashMapTrackedValue(int value)
+            : value(value)
+        {
+            ++ms_LiveCount;
+        }
+
+        FlatHashMapTrackedValue(const FlatHashMapTrackedValue& other)
+            : value(other.value)
+        {
+            ++ms_LiveCount;
+        }
+
+        FlatHashMapTrackedValue(FlatHashMapTrackedValue&& other) noexcept
+            : value(other.value)
+        {
+            ++ms_LiveCount;
+        }
+
+        ~FlatHashMapTrackedValue()
+        {
+            --ms_LiveCount;
+        }
+
+        FlatHashMapTrackedValue& operator=(const FlatHashMapTrackedValue& other) = default;
+
+        int value;
+    };
+
+    int FlatHashMapTrackedValue::ms_LiveCount = 0;
+
+    // All keys share bucket, so that probing past full groups is exercised
+    struct FlatHashMapCollidingHash
+    {
+        size_t operator()(uint32_t) const
+        {
+            return 0;
+        }
+    };
+
+    template <typename Map, typename Reference>
+    static bool FlatHashMapEquals(const Map& map, const Reference& reference)
+    {
+        if (map.GetSize() != reference.size())
+            return false;
+
+        size_t iterated = 0;
+        for (const auto& [key, value] : map)
+        {
+            auto found = reference.find(key);
+            if (found == reference.end() || found->second != value)
+                return false;
+            ++iterated;
+        }
+        if (iterated != reference.size())
+            return false;
+
+        for (const auto& [key, value] : reference)
+        {
+            const auto* found = map.Find(key);
+            if (found == nullptr || *found != value)
+                return false;
+        }
+        return true;
+    }
+
+    TEST_CLASS(TestFlatHashMap)
+    {
+    public:
+        TEST_METHOD(InsertFindErase)
+        {
+            FlatHashMap<uint32_t, int> map;
+            Assert::IsTrue(map.IsEmpty());
+            Assert::IsTrue(map.Find(1) == nullptr);
+            Assert::IsFalse(map.Erase(1));
+
+            auto [value, isInserted] = map.Emplace(1, 10);
+            Assert::IsTrue(isInserted);
+            Assert::AreEqual(10, *value);
+
+            // Existing value isn't overwritten
+            auto [existing, isInsertedAgain] = map.Emplace(1, 20);
+            Assert::IsFalse(isInsertedAgain);
+            Assert::AreEqual(10, *existing);
+
+            map[2] = 30;
+            Assert::AreEqual(size_t(2), map.GetSize());
+            Assert::AreEqual(30, *map.Find(2));
+            Assert::IsTrue(map.Contains(1));
+
+            Assert::IsTrue(map.Erase(1));
+            Assert::IsFalse(map.Contains(1));
+            Assert::AreEqual(size_t(1), map.GetSize());
+
+            map.Clear();
+            Assert::IsTrue(map.IsEmpty());
+            Assert::IsFalse(map.Contains(2));
+        }
+
+        TEST_METHOD(MatchesUnorderedMap)
+        {
+            std::mt19937 generator(46);
+            // Small key range makes inserts of existing keys and erases of present keys common
+            std::uniform_int_distribution<uint32_t> keyDistribution(0, 4000);
+            std::uniform_int_distribution<int> operationDistribution(0, 9);
+
+            FlatHashMap<uint32_t, int> map;
+            std::unordered_map<uint32_t, int> reference;
+            for (int i = 0; i < 200000; ++i)
+            {
+                const uint32_t key = keyDistribution(generator);
+                const int operation = operationDistribution(generator);
+                if (operation < 5)
+                {
+                    const bool isInserted = map.Emplace(key, i).second;
+                    Assert::AreEqual(reference.emplace(key, i).second, isInserted);
+                }
+                else if (operation < 9)
+                {
+                    Assert::AreEqual(reference.erase(key) != 0, map.Erase(key));
+                }
+                else
+                {
+                    const int* value = map.Find(key);
+                    auto found = reference.find(key);
+                    Assert::AreEqual(found != reference.end(), value != nullptr);
+                    if (value)
+                        Assert::AreEqual(found->second, *value);
+                }
+
+                if (i % 10000 == 0)
+                    Assert::IsTrue(FlatHashMapEquals(map, reference));
+            }
+            Assert::IsTrue(FlatHashMapEquals(map, reference));
+        }
+
+        TEST_METHOD(CollidingKeys)
+        {
+            FlatHashMap<uint32_t, uint32_t, FlatHashMapCollidingHash> map;
+            std::unordered_map<uint32_t, uint32_t> reference;
+            for (uint32_t i = 0; i < 300; ++i)
+            {
+                map[i] = i * 3;
+                reference[i] = i * 3;
+            }
+            for (uint32_t i = 0; i < 300; i += 3)
+            {
+                Assert::IsTrue(map.Erase(i));
+                reference.erase(i);
+            }
+            Assert::IsTrue(FlatHashMapEquals(map, reference));
+
+            // Deleted slots are reused and don't hide keys that were probed past them
+            for (uint32_t i = 0; i < 300; i += 6)
+            {
+                map[i] = i;
+                reference[i] = i;
+            }
+            Assert::IsTrue(FlatHashMapEquals(map, reference));
+        }
+
+        TEST_METHOD(EraseInsertDoesNotGrow)
+        {
+            FlatHashMap<uint32_t, uint32_t> map;
+            map.Reserve(1000);
+            const size_t capacity = map.GetCapacity();
+            for (uint32_t i = 0; i < 1000; ++i)
+                map[i] = i;
+
+            // Sliding window of keys leaves deleted slots behind, they are cleaned by rehash
+            for (uint32_t i = 1000; i < 100000; ++i)
+            {
+                Assert::IsTrue(map.Erase(i - 1000));
+                map[i] = i;
+            }
+            Assert::AreEqual(capacity, map.GetCapacity());
+            Assert::AreEqual(size_t(1000), map.GetSize());
+            for (uint32_t i = 99000; i < 100000; ++i)
+                Assert::AreEqual(i, *map.Find(i));
+        }
+
+        TEST_METHOD(ReserveKeepsValues)
+        {
+            FlatHashMap<uint32_t, uint32_t> map;
+            for (uint32_t i = 0; i < 100; ++i)
+                map[i] = i + 1;
+            map.Reserve(10000);
+            Assert::IsTrue(map.GetCapacity() * 7 / 8 >= 10000);
+            for (uint32_t i = 0; i < 100; ++i)
+                Assert::AreEqual(i + 1, *map.Find(i));
+
+            const size_t capacity = map.GetCapacity();
+            for (uint32_t i = 100; i < 10000; ++i)
+                map[i] = i + 1;
+            Assert::AreEqual(capacity, map.GetCapacity());
+        }
+
+        TEST_METHOD(StringKeys)
+        {
+            FlatHashMap<std::string, int> map;
+            std::unordered_map<std::string, int> reference;
+            for (int i = 0; i < 5000; ++i)
+            {
+                std::string key = "Textures/Material_" + std::to_string(i) + "_Diffuse.dds";
+                map.Emplace(key, i);
+                reference.emplace(key, i);
+            }
+            for (int i = 0; i < 5000; i += 2)
+            {
+                std::string key = "Textures/Material_" + std::to_string(i) + "_Diffuse.dds";
+                map.Erase(key);
+                reference.erase(key);
+            }
+            Assert::IsTrue(FlatHashMapEquals(map, reference));
+        }
+
+        TEST_METHOD(CopyAndMove)
+        {
+            FlatHashMap<uint32_t, std::string> map;
+            for (uint32_t i = 0; i < 100; ++i)
+                map[i] = std::to_string(i);
+            map.Erase(50);
+
+            FlatHashMap<uint32_t, std::string> copy(map);
+            Assert::AreEqual(size_t(99), copy.GetSize());
+            Assert::AreEqual(std::string("42"), *copy.Find(42));
+            Assert::IsFalse(copy.Contains(50));
+
+            FlatHashMap<uint32_t, std::string> moved(std::move(copy));
+            Assert::AreEqual(size_t(99), moved.GetSize());
+            Assert::IsTrue(copy.IsEmpty());
+            Assert::IsTrue(copy.Find(42) == nullptr);
+
+            // Moved from map is still usable
+            copy[7] = "7";
+            Assert::AreEqual(std::string("7"), *copy.Find(7));
+
+            copy = moved;
+            Assert::AreEqual(size_t(99), copy.GetSize());
+            moved = std::move(copy);
+            Assert::AreEqual(std::string("99"), *moved.Find(99));
+        }
+
+        TEST_METHOD(ValueLifetime)
+        {
+            {
+                FlatHashMap<uint32_t, FlatHashMapTrackedValue> map;
+                for (uint32_t i = 0; i < 1000; ++i)
+                    map.Emplace(i, int(i));
+                Assert::AreEqual(1000, FlatHashMapTrackedValue::ms_LiveCount);
+
+                for (uint32_t i = 0; i < 1000; i += 2)
+                    map.Erase(i);
+                Assert::AreEqual(500, FlatHashMapTrackedValue::ms_LiveCount);
+
+                FlatHashMap<uint32_t, FlatHashMapTrackedValue> copy = map;
+                Assert::AreEqual(1000, FlatHashMapTrackedValue::ms_LiveCount);
+                copy.Clear();
+                Assert::AreEqual(500, FlatHashMapTrackedValue::ms_LiveCount);
+
+                map.Reserve(100000);
+                Assert::AreEqual(500, FlatHashMapTrackedValue::ms_LiveCount);
+                Assert::AreEqual(7, map.Find(7)->value);
+            }
+            Assert::AreEqual(0, FlatHashMapTrackedValue::ms_LiveCount);
+        }
+    };
+}
@@ -0,0 +1,190 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/FrustumCulling.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static const FrustumCulling::Backend gs_Backends[] = {
+        FrustumCulling::Backend::Scalar, FrustumCulling::Backend::SSE,
+        FrustumCulling::Backend::AVX2};
+
+    static Frustum BuildRandomFrustum(std::mt19937& generator, bool perspective)
+    {
+        std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+        std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+
+        Matrix4x4 view = Matrix4x4::GetTranslation(position(generator), position(generator),
+                                                   position(generator)) *
+                         Matrix4x4::GetRotationY(angle(generator)) *
+                         Matrix4x4::GetRotationX(angle(generator) * 0.5f);
+        Matrix4x4 proj = perspective
+                             ? Matrix4x4::CalculateProjPerspective(0.1f, 60.0f, 1.7f, 1.2f)
+                             : Matrix4x4::CalculateProjOrtographic(0.1f, 60.0f, 30.0f, 20.0f);
+        return Frustum(view * proj);
+    }
+
+    static std::vector<AABB> BuildRandomBoxes(std::mt19937& generator, size_t count)
+    {
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::exponential_distribution<float> size(0.5f);
+
+        std::vector<AABB> result(count);
+        for (auto& box : result)
+        {
+            Vector4 min{position(generator), position(generator), position(generator), 1.0f};
+            Vector4 extent{size(generator), size(generator), size(generator), 0.0f};
+            // Some boxes are flat or single points
+            if (generator() % 8 == 0)
+                extent[generator() % 3] = 0.0f;
+            if (generator() % 32 == 0)
+                extent = Vector4{};
+            box = AABB{min, min + extent};
+        }
+        return result;
+    }
+
+    static FrustumCulling::AABBArray BuildArray(const std::vector<AABB>& boxes)
+    {
+        FrustumCulling::AABBArray result;
+        result.Reserve(boxes.size());
+        for (const auto& box : boxes)
+            result.Add(box);
+        return result;
+    }
+
+    static bool IsEquivalentToCheckAABBFast(const Frustum& frustum,
+                                            const std::vector<AABB>& boxes,
+                                            FrustumCulling::Backend backend,
+                                            size_t* visibleCount = nullptr)
+    {
+        FrustumCulling::AABBArray array = BuildArray(boxes);
+
+        // Guard word catches writes past mask end
+        const size_t wordCount = FrustumCulling::GetMaskWordCount(boxes.size());
+        std::vector<uint32_t> mask(wordCount + 1, 0xCDCDCDCDu);
+        FrustumCulling::CullAABBs(frustum, array, mask.data(), backend);
+        if (mask[wordCount] != 0xCDCDCDCDu)
+            return false;
+
+        std::vector<uint32_t> indices(boxes.size());
+        size_t indexCount =
+            FrustumCulling::CullAABBsToIndices(frustum, array, indices.data(), backend);
+
+        std::vector<uint32_t> expectedIndices;
+        for (uint32_t i = 0; i < boxes.size(); ++i)
+        {
+            const bool expected = frustum.CheckAABBFast(boxes[i]);
+            const bool actual = (mask[i / 32] >> (i % 32)) & 1;
+            if (expected != actual)
+                return false;
+            if (expected)
+                expectedIndices.push_back(i);
+        }
+
+        // Padding bits of last word stay clear
+        if (boxes.size() % 32 != 0 && (mask[wordCount - 1] >> (boxes.size() % 32)) != 0)
+            return false;
+
+        if (visibleCount)
+            *visibleCount = indexCount;
+
+        return indexCount == expectedIndices.size() &&
+               std::equal(expectedIndices.begin(), expectedIndices.end(), indices.begin());
+    }
+
+    TEST_CLASS(TestFrustumCulling)
+    {
+    public:
+        TEST_METHOD(DefaultBackendIsSupported)
+        {
+            Assert::IsTrue(FrustumCulling::IsBackendSupported(FrustumCulling::Backend::Scalar));
+            Assert::IsTrue(
+                FrustumCulling::IsBackendSupported(FrustumCulling::GetDefaultBackend()));
+        }
+
+        TEST_METHOD(MatchesCheckAABBFast)
+        {
+            std::mt19937 generator(23);
+            for (size_t iteration = 0; iteration < 64; ++iteration)
+            {
+                Frustum frustum = BuildRandomFrustum(generator, iteration % 2 == 0);
+                std::vector<AABB> boxes = BuildRandomBoxes(generator, 1000 + iteration);
+
+                for (auto backend : gs_Backends)
+                {
+                    if (!FrustumCulling::IsBackendSupported(backend))
+                        continue;
+
+                    size_t visibleCount = 0;
+                    Assert::IsTrue(
+                        IsEquivalentToCheckAABBFast(frustum, boxes, backend, &visibleCount));
+                    Assert::IsTrue(visibleCount < boxes.size());
+                }
+            }
+        }
+
+        TEST_METHOD(AllBoxCounts)
+        {
+            // Covers every combination of full vectors, scalar tail and partial mask word
+            std::mt19937 generator(29);
+            Frustum frustum = BuildRandomFrustum(generator, true);
+            std::vector<AABB> allBoxes = BuildRandomBoxes(generator, 80);
+            for (size_t count = 0; count <= allBoxes.size(); ++count)
+            {
+                std::vector<AABB> boxes(allBoxes.begin(), allBoxes.begin() + count);
+                for (auto backend : gs_Backends)
+                {
+                    if (FrustumCulling::IsBackendSupported(backend))
+                        Assert::IsTrue(IsEquivalentToCheckAABBFast(frustum, boxes, backend));
+                }
+            }
+        }
+
+        TEST_METHOD(BoxesTouchingPlanes)
+        {
+            // Planes of axis aligned orthographic frustum go through whole numbers, so distances
+            // to box faces are exactly zero
+            Matrix4x4 proj = Matrix4x4::CalculateProjOrtographic(1.0f, 9.0f, 4.0f, 4.0f);
+            Frustum frustum(proj);
+
+            std::vector<AABB> boxes;
+            for (int x = -4; x <= 4; ++x)
+            {
+                for (int y = -4; y <= 4; ++y)
+                {
+                    for (int z = -1; z <= 11; ++z)
+                    {
+                        Vector4 point{float(x), float(y), float(z), 1.0f};
+                        boxes.push_back(AABB{point, point});
+                        boxes.push_back(AABB{point, point + Vector4{1.0f, 1.0f, 1.0f, 0.0f}});
+                    }
+                }
+            }
+
+            for (auto backend : gs_Backends)
+            {
+                if (FrustumCulling::IsBackendSupported(backend))
+                    Assert::IsTrue(IsEquivalentToCheckAABBFast(frustum, boxes, backend));
+            }
+        }
+
+        TEST_METHOD(AABBArrayAccess)
+        {
+            FrustumCulling::AABBArray array;
+            array.Add(AABB{{1.0f, 2.0f, 3.0f, 1.0f}, {4.0f, 5.0f, 6.0f, 1.0f}});
+            array.Resize(3);
+            array.Set(2, AABB{{-1.0f, -2.0f, -3.0f, 1.0f}, {7.0f, 8.0f, 9.0f, 1.0f}});
+
+            Assert::IsTrue(array.GetSize() == 3);
+            Assert::IsTrue(array.GetMin(1)[0] == 2.0f && array.GetMax(2)[0] == 6.0f);
+            Assert::IsTrue(array.GetMin(0)[2] == -1.0f && array.GetMax(1)[2] == 8.0f);
+
+            array.Clear();
+            Assert::IsTrue(array.GetSize() == 0);
+        }
+    };
+}
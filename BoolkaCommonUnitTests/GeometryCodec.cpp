@@ -0,0 +1,200 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/GeometryCodec.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static bool RoundTrip(GeometryCodec::Method method, const void* data, size_t size,
+                          size_t* encodedSize = nullptr)
+    {
+        std::vector<unsigned char> encoded = GeometryCodec::Encode(method, data, size);
+        if (encodedSize)
+            *encodedSize = encoded.size();
+
+        if (GeometryCodec::GetDecodedSize(encoded.data(), encoded.size()) != size)
+            return false;
+
+        // Guard bytes catch writes past decoded size
+        std::vector<unsigned char> decoded(size + 16, 0xCD);
+        if (!GeometryCodec::Decode(encoded.data(), encoded.size(), decoded.data(), size))
+            return false;
+
+        for (size_t i = size; i < decoded.size(); ++i)
+        {
+            if (decoded[i] != 0xCD)
+                return false;
+        }
+
+        return memcmp(decoded.data(), data, size) == 0;
+    }
+
+    // Vertices of tessellated wavy surface placed away from origin, row by row
+    static std::vector<Vector4> BuildSurfaceVertices(uint32_t width, uint32_t height)
+    {
+        std::vector<Vector4> vertices;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                float u = float(x) / float(width - 1);
+                float v = float(y) / float(height - 1);
+                vertices.push_back(Vector4(100.0f + u * 10.0f,
+                                           20.0f + std::sin(u * 6.0f) * std::cos(v * 4.0f),
+                                           100.0f + v * 10.0f, 0.25f + u * 0.25f));
+            }
+        }
+        return vertices;
+    }
+
+    // Triangle strips over grid, local indices restart every meshlet
+    static std::vector<unsigned char> BuildStripTriangles(uint32_t meshletCount)
+    {
+        std::vector<unsigned char> indices;
+        for (uint32_t meshlet = 0; meshlet < meshletCount; ++meshlet)
+        {
+            const uint32_t columns = 31;
+            for (uint32_t i = 0; i < columns; ++i)
+            {
+                unsigned char top0 = static_cast<unsigned char>(i * 2);
+                unsigned char bottom0 = static_cast<unsigned char>(i * 2 + 1);
+                unsigned char top1 = static_cast<unsigned char>(i * 2 + 2);
+                unsigned char bottom1 = static_cast<unsigned char>(i * 2 + 3);
+                indices.insert(indices.end(), {top0, bottom0, top1});
+                indices.insert(indices.end(), {top1, bottom0, bottom1});
+            }
+        }
+        return indices;
+    }
+
+    TEST_CLASS(TestGeometryCodec)
+    {
+    public:
+        TEST_METHOD(VertexRoundTrip)
+        {
+            std::vector<Vector4> vertices = BuildSurfaceVertices(64, 64);
+            size_t encodedSize = 0;
+            Assert::IsTrue(RoundTrip(GeometryCodec::Method::Vertex, vertices.data(),
+                                     vertices.size() * sizeof(Vector4), &encodedSize));
+            // Neighbouring floats share sign and exponent, so deltas need less bits
+            Assert::IsTrue(encodedSize < vertices.size() * sizeof(Vector4) * 3 / 4);
+        }
+
+        TEST_METHOD(VertexPartialBlock)
+        {
+            for (uint32_t width : {2, 5, 37})
+            {
+                std::vector<Vector4> vertices = BuildSurfaceVertices(width, 29);
+                Assert::IsTrue(RoundTrip(GeometryCodec::Method::Vertex, vertices.data(),
+                                         vertices.size() * sizeof(Vector4)));
+            }
+        }
+
+        TEST_METHOD(VertexRandomData)
+        {
+            std::mt19937 generator(7);
+            std::vector<uint32_t> values(4 * 1001);
+            for (auto& value : values)
+                value = generator();
+
+            size_t encodedSize = 0;
+            Assert::IsTrue(RoundTrip(GeometryCodec::Method::Vertex, values.data(),
+                                     values.size() * sizeof(uint32_t), &encodedSize));
+            // Incompressible data only pays for header, block control bytes and padding of last
+            // block
+            const size_t paddedSize = BLK_CEIL_TO_POWER_OF_TWO(values.size(), 4 * 128);
+            Assert::IsTrue(encodedSize <= paddedSize * sizeof(uint32_t) + 64);
+        }
+
+        TEST_METHOD(WordsRoundTrip)
+        {
+            std::mt19937 generator(11);
+            for (size_t count : {0, 1, 3, 4, 127, 128, 129, 1000, 4099})
+            {
+                std::vector<uint32_t> values(count);
+                uint32_t current = 1000000;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    // Mix of sequential runs, jumps and negative deltas
+                    if (generator() % 16 == 0)
+                        current = generator();
+                    else
+                        current += (generator() % 5) - 2;
+                    values[i] = current;
+                }
+                Assert::IsTrue(RoundTrip(GeometryCodec::Method::Words, values.data(),
+                                         values.size() * sizeof(uint32_t)));
+            }
+        }
+
+        TEST_METHOD(WordsSequentialCompress)
+        {
+            std::vector<uint32_t> values(4096);
+            std::iota(values.begin(), values.end(), 123456u);
+
+            size_t encodedSize = 0;
+            Assert::IsTrue(RoundTrip(GeometryCodec::Method::Words, values.data(),
+                                     values.size() * sizeof(uint32_t), &encodedSize));
+            // Every delta is 1, so it takes 2 bits per value after zigzag
+            Assert::IsTrue(encodedSize < values.size() * sizeof(uint32_t) / 8);
+        }
+
+        TEST_METHOD(WordsExtremeValues)
+        {
+            std::vector<uint32_t> values = {0, UINT32_MAX, 0, UINT32_MAX, 0x80000000u,
+                                            0x7FFFFFFFu, 1, UINT32_MAX - 1};
+            values.resize(300, UINT32_MAX);
+            Assert::IsTrue(RoundTrip(GeometryCodec::Method::Words, values.data(),
+                                     values.size() * sizeof(uint32_t)));
+            Assert::IsTrue(RoundTrip(GeometryCodec::Method::Vertex, values.data(),
+                                     values.size() * sizeof(uint32_t)));
+        }
+
+        TEST_METHOD(TrianglesStrips)
+        {
+            std::vector<unsigned char> indices = BuildStripTriangles(20);
+            size_t encodedSize = 0;
+            Assert::IsTrue(RoundTrip(GeometryCodec::Method::Triangles, indices.data(),
+                                     indices.size(), &encodedSize));
+            // Strip triangles should take less than a byte each
+            Assert::IsTrue(encodedSize < indices.size() / 3 + sizeof(GeometryCodec::Header) + 64);
+        }
+
+        TEST_METHOD(TrianglesRandom)
+        {
+            std::mt19937 generator(13);
+            for (uint32_t maxIndex : {1, 63, 255})
+            {
+                std::vector<unsigned char> indices(3 * 777);
+                for (auto& index : indices)
+                    index = static_cast<unsigned char>(generator() % (maxIndex + 1));
+                Assert::IsTrue(RoundTrip(GeometryCodec::Method::Triangles, indices.data(),
+                                         indices.size()));
+            }
+
+            Assert::IsTrue(RoundTrip(GeometryCodec::Method::Triangles, nullptr, 0));
+        }
+
+        TEST_METHOD(RejectsMalformedData)
+        {
+            std::vector<Vector4> vertices = BuildSurfaceVertices(16, 16);
+            std::vector<unsigned char> encoded = GeometryCodec::Encode(
+                GeometryCodec::Method::Vertex, vertices.data(), vertices.size() * sizeof(Vector4));
+            std::vector<unsigned char> decoded(vertices.size() * sizeof(Vector4));
+
+            // Output is too small
+            Assert::IsFalse(GeometryCodec::Decode(encoded.data(), encoded.size(), decoded.data(),
+                                                  decoded.size() - 1));
+            // Truncated payload
+            Assert::IsFalse(GeometryCodec::Decode(encoded.data(), encoded.size() - 1,
+                                                  decoded.data(), decoded.size()));
+            // Not encoded data
+            Assert::IsTrue(GeometryCodec::GetDecodedSize(vertices.data(), 64) == 0);
+            Assert::IsFalse(GeometryCodec::Decode(vertices.data(), 64, decoded.data(),
+                                                  decoded.size()));
+        }
+    };
+}
@@ -4,12 +4,43 @@
 
 #include "BoolkaCommon/Structures/MemoryBlock.h"
 
+#include "TestDataHelpers.h"
+
 // clang-format mess up formating due to preprocessor class definition
 // clang-format off
 
 namespace Boolka
 {
 
+    // Bit by bit CRC, used as reference for table and hardware implementations
+    static uint32_t CalculateBitwiseCRC(const std::vector<unsigned char>& data,
+                                        uint32_t polynomial)
+    {
+        uint32_t result = 0xFFFFFFFF;
+        for (unsigned char currentByte : data)
+        {
+            result ^= currentByte;
+            for (size_t j = 0; j < 8; ++j)
+                result = (result >> 1) ^ ((result & 1) * polynomial);
+        }
+        return ~result;
+    }
+
+    // 256 byte ramp repeated 4 times and 3 more bytes, exercises long and tail paths
+    static std::vector<unsigned char> BuildHashingRamp()
+    {
+        std::vector<unsigned char> result;
+        for (size_t i = 0; i < 256 * 4; ++i)
+            result.push_back(static_cast<unsigned char>(i));
+        result.insert(result.end(), {1, 2, 3});
+        return result;
+    }
+
+    static MemoryBlock GetStringMemory(const char* string)
+    {
+        return MemoryBlock{const_cast<char*>(string), strlen(string)};
+    }
+
     TEST_CLASS(TestHashing)
     {
     public:
@@ -75,6 +106,98 @@ namespace Boolka
                 uint32_t hash = Hashing::CRC32(memory);
                 Assert::IsTrue(hash == 0xC4CAC4EF);
             }
+            {
+                Assert::AreEqual(0xCBF43926u, Hashing::CRC32(GetStringMemory("123456789")));
+                Assert::AreEqual(0u, Hashing::CRC32(GetStringMemory("")));
+                std::vector<unsigned char> ramp = BuildHashingRamp();
+                const MemoryBlock memory{ramp.data(), ramp.size()};
+                Assert::AreEqual(0xA2626379u, Hashing::CRC32(memory));
+            }
+        }
+
+        TEST_METHOD(CRC32C)
+        {
+            Assert::AreEqual(0xE3069283u, Hashing::CRC32C(GetStringMemory("123456789")));
+            Assert::AreEqual(0u, Hashing::CRC32C(GetStringMemory("")));
+
+            // iSCSI test vectors
+            std::vector<unsigned char> data(32, 0x00);
+            Assert::AreEqual(0x8A9136AAu, Hashing::CRC32C(MemoryBlock{data.data(), data.size()}));
+            std::fill(data.begin(), data.end(), 0xFF);
+            Assert::AreEqual(0x62A8AB43u, Hashing::CRC32C(MemoryBlock{data.data(), data.size()}));
+            std::iota(data.begin(), data.end(), 0);
+            Assert::AreEqual(0x46DD794Eu, Hashing::CRC32C(MemoryBlock{data.data(), data.size()}));
+
+            std::vector<unsigned char> ramp = BuildHashingRamp();
+            Assert::AreEqual(0xCF31B5DEu, Hashing::CRC32C(MemoryBlock{ramp.data(), ramp.size()}));
+        }
+
+        TEST_METHOD(CRCMatchesBitwise)
+        {
+            std::mt19937 generator(73);
+            for (size_t size = 0; size < 100; ++size)
+            {
+                std::vector<unsigned char> data = BuildRandomBytes(generator, size);
+                const MemoryBlock memory{data.data(), data.size()};
+                Assert::AreEqual(CalculateBitwiseCRC(data, 0xEDB88320), Hashing::CRC32(memory));
+                Assert::AreEqual(CalculateBitwiseCRC(data, 0x82F63B78), Hashing::CRC32C(memory));
+            }
+        }
+
+        TEST_METHOD(CRCStreaming)
+        {
+            std::mt19937 generator(79);
+            std::vector<unsigned char> data = BuildRandomBytes(generator, 1000);
+            const uint32_t crc32 = Hashing::CRC32(MemoryBlock{data.data(), data.size()});
+            const uint32_t crc32c = Hashing::CRC32C(MemoryBlock{data.data(), data.size()});
+            for (size_t split = 0; split <= data.size(); split += 7)
+            {
+                const MemoryBlock first{data.data(), split};
+                const MemoryBlock second{data.data() + split, data.size() - split};
+                Assert::AreEqual(crc32, Hashing::CRC32(second, Hashing::CRC32(first)));
+                Assert::AreEqual(crc32c, Hashing::CRC32C(second, Hashing::CRC32C(first)));
+            }
+        }
+
+        TEST_METHOD(Hash64)
+        {
+            // Reference XXH64 results
+            Assert::AreEqual(0xEF46DB3751D8E999ull, Hashing::Hash64(GetStringMemory("")));
+            Assert::AreEqual(0x44BC2CF5AD770999ull, Hashing::Hash64(GetStringMemory("abc")));
+            const char* longString = "Nobody inspects the spammish repetition";
+            Assert::AreEqual(0xFBCEA83C8A378BF1ull, Hashing::Hash64(GetStringMemory(longString)));
+            Assert::AreEqual(0xB559B98D844E0635ull,
+                             Hashing::Hash64(GetStringMemory("xxhash"), 20141025));
+
+            std::vector<unsigned char> ramp = BuildHashingRamp();
+            Assert::AreEqual(0x0073B0C77C26EB23ull,
+                             Hashing::Hash64(MemoryBlock{ramp.data(), ramp.size()}));
+            Assert::AreEqual(0x31DA36536B451675ull,
+                             Hashing::Hash64(MemoryBlock{ramp.data(), 100}, 0x123456789ABCDEF0ull));
+        }
+
+        TEST_METHOD(Hash64Streaming)
+        {
+            std::mt19937 generator(83);
+            std::vector<unsigned char> data = BuildRandomBytes(generator, 1000);
+            std::uniform_int_distribution<size_t> partSize(0, 70);
+            for (size_t size = 0; size <= data.size(); size += 13)
+            {
+                const uint64_t expected = Hashing::Hash64(MemoryBlock{data.data(), size}, size);
+
+                Hashing::Hash64Stream stream(size);
+                size_t offset = 0;
+                while (offset < size)
+                {
+                    const size_t part = std::min(partSize(generator), size - offset);
+                    stream.Update(MemoryBlock{data.data() + offset, part});
+                    offset += part;
+                    if (offset == size / 2)
+                        Assert::AreEqual(Hashing::Hash64(MemoryBlock{data.data(), offset}, size),
+                                         stream.Finalize());
+                }
+                Assert::AreEqual(expected, stream.Finalize());
+            }
         }
     };
 
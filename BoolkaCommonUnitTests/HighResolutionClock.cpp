@@ -0,0 +1,58 @@
+#include "pch.h"
+
+#include <chrono>
+
+#include "BoolkaCommon/Structures/HighResolutionClock.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    TEST_CLASS(TestHighResolutionClock)
+    {
+    public:
+        TEST_METHOD(Monotonic)
+        {
+            uint64_t previous = HighResolutionClock::GetTimestamp();
+            for (int i = 0; i < 100000; ++i)
+            {
+                const uint64_t current = HighResolutionClock::GetTimestamp();
+                Assert::IsTrue(current >= previous);
+                previous = current;
+            }
+        }
+
+        TEST_METHOD(MatchesSteadyClock)
+        {
+            const auto steadyStart = std::chrono::steady_clock::now();
+            const uint64_t start = HighResolutionClock::GetTimestamp();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            const uint64_t end = HighResolutionClock::GetTimestamp();
+            const auto steadyEnd = std::chrono::steady_clock::now();
+
+            const double steadyNanoseconds =
+                std::chrono::duration<double, std::nano>(steadyEnd - steadyStart).count();
+            const double nanoseconds = double(HighResolutionClock::TicksToNanoseconds(end - start));
+            // Calibration error is well below 1%, rest is slack for preemption between reads
+            Assert::IsTrue(nanoseconds <= steadyNanoseconds * 1.02);
+            Assert::IsTrue(nanoseconds >= steadyNanoseconds * 0.98 - 1e6);
+
+            const double seconds = HighResolutionClock::TicksToSeconds(end - start);
+            Assert::IsTrue(std::abs(seconds * 1e9 - nanoseconds) < 2.0);
+        }
+
+        TEST_METHOD(Conversions)
+        {
+            const double ticksPerSecond = HighResolutionClock::GetTicksPerSecond();
+            Assert::IsTrue(ticksPerSecond >= 1e6);
+            const uint64_t oneSecondTicks = uint64_t(ticksPerSecond);
+            const uint64_t oneSecondNanoseconds =
+                HighResolutionClock::TicksToNanoseconds(oneSecondTicks);
+            Assert::IsTrue(oneSecondNanoseconds <= 1000000000ull);
+            Assert::IsTrue(oneSecondNanoseconds >= 999999000ull);
+            Assert::AreEqual(uint64_t(0), HighResolutionClock::TicksToNanoseconds(0));
+        }
+    };
+}
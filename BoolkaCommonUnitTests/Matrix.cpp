@@ -6,6 +6,84 @@
 namespace Boolka
 {
 
+    // Gauss-Jordan elimination with partial pivoting in double precision
+    static bool CalculateReferenceInverse(const Matrix4x4& matrix, double (&inverse)[4][4])
+    {
+        double augmented[4][8];
+        for (size_t i = 0; i < 4; i++)
+        {
+            for (size_t j = 0; j < 4; j++)
+            {
+                augmented[i][j] = matrix[i][j];
+                augmented[i][j + 4] = i == j ? 1.0 : 0.0;
+            }
+        }
+
+        for (size_t column = 0; column < 4; column++)
+        {
+            size_t pivot = column;
+            for (size_t row = column + 1; row < 4; row++)
+            {
+                if (abs(augmented[row][column]) > abs(augmented[pivot][column]))
+                    pivot = row;
+            }
+            if (augmented[pivot][column] == 0.0)
+                return false;
+            std::swap(augmented[column], augmented[pivot]);
+
+            const double scale = 1.0 / augmented[column][column];
+            for (double& element : augmented[column])
+                element *= scale;
+
+            for (size_t row = 0; row < 4; row++)
+            {
+                if (row == column)
+                    continue;
+                const double factor = augmented[row][column];
+                for (size_t j = 0; j < 8; j++)
+                    augmented[row][j] -= factor * augmented[column][j];
+            }
+        }
+
+        for (size_t i = 0; i < 4; i++)
+        {
+            for (size_t j = 0; j < 4; j++)
+                inverse[i][j] = augmented[i][j + 4];
+        }
+        return true;
+    }
+
+    // Error in ulp of largest element in the row of expected matrix
+    static double CalculateMaxUlpError(const Matrix4x4& actual, const double (&expected)[4][4])
+    {
+        double result = 0.0;
+        for (size_t i = 0; i < 4; i++)
+        {
+            double rowMax = 0.0;
+            for (size_t j = 0; j < 4; j++)
+                rowMax = std::max(rowMax, abs(expected[i][j]));
+
+            const float rowMaxFloat = static_cast<float>(rowMax);
+            const double ulp = std::nextafter(rowMaxFloat, FLT_MAX) - rowMaxFloat;
+            for (size_t j = 0; j < 4; j++)
+                result = std::max(result, abs(actual[i][j] - expected[i][j]) / ulp);
+        }
+        return result;
+    }
+
+    static Matrix4x4 BuildRandomRigidMatrix(std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+        const Matrix4x4 rotation = Matrix4x4::GetRotationX(angle(generator)) *
+                                   Matrix4x4::GetRotationY(angle(generator)) *
+                                   Matrix4x4::GetRotationZ(angle(generator));
+        return Matrix4x4::CalculateView(
+            rotation[0], rotation[1], rotation[2],
+            Vector4{position(generator), position(generator), position(generator), 1.0f});
+    }
+
     TEST_CLASS(TestMatrix)
     {
     public:
@@ -234,5 +312,138 @@ namespace Boolka
                 Assert::IsTrue(ApproxEqual(mult, Matrix4x4::GetIdentity()));
             }
         }
+
+        TEST_METHOD(MultiplyMatchesScalarOrder)
+        {
+            std::mt19937 generator(53);
+            std::uniform_real_distribution<float> element(-10.0f, 10.0f);
+
+            for (size_t iteration = 0; iteration < 1000; ++iteration)
+            {
+                Matrix4x4 m1;
+                Matrix4x4 m2;
+                Vector4 v1;
+                for (size_t i = 0; i < 4; i++)
+                {
+                    v1[i] = element(generator);
+                    for (size_t j = 0; j < 4; j++)
+                    {
+                        m1[i][j] = element(generator);
+                        m2[i][j] = element(generator);
+                    }
+                }
+
+                const Matrix4x4 product = m1 * m2;
+                const Vector4 vectorProduct = v1 * m2;
+                for (size_t i = 0; i < 4; i++)
+                {
+                    for (size_t j = 0; j < 4; j++)
+                    {
+                        float expected = m1[i][0] * m2[0][j];
+                        expected += m1[i][1] * m2[1][j];
+                        expected += m1[i][2] * m2[2][j];
+                        expected += m1[i][3] * m2[3][j];
+                        Assert::IsTrue(product[i][j] == expected);
+                    }
+
+                    float expectedVector = v1[0] * m2[0][i];
+                    expectedVector += v1[1] * m2[1][i];
+                    expectedVector += v1[2] * m2[2][i];
+                    expectedVector += v1[3] * m2[3][i];
+                    Assert::IsTrue(vectorProduct[i] == expectedVector);
+                }
+            }
+        }
+
+        TEST_METHOD(InverseRandom)
+        {
+            std::mt19937 generator(59);
+            std::uniform_real_distribution<float> element(-1.0f, 1.0f);
+
+            for (size_t iteration = 0; iteration < 10000; ++iteration)
+            {
+                // Diagonally dominant, so that matrix is well conditioned
+                Matrix4x4 m1;
+                for (size_t i = 0; i < 4; i++)
+                {
+                    for (size_t j = 0; j < 4; j++)
+                        m1[i][j] = element(generator) + (i == j ? 4.0f : 0.0f);
+                }
+
+                double expected[4][4];
+                Assert::IsTrue(CalculateReferenceInverse(m1, expected));
+
+                bool isSuccessfull;
+                const Matrix4x4 m2 = m1.Inverse(isSuccessfull);
+                Assert::IsTrue(isSuccessfull);
+                Assert::IsTrue(CalculateMaxUlpError(m2, expected) <=
+                               Matrix4x4::ms_InverseMaxUlpError);
+            }
+        }
+
+        TEST_METHOD(InverseProjection)
+        {
+            const Matrix4x4 matrices[] = {
+                Matrix4x4::CalculateProjPerspective(0.2f, 1000.0f, 1.7f, 1.2f),
+                Matrix4x4::CalculateProjOrtographic(-80.0f, 80.0f, 50.0f, 30.0f),
+                Matrix4x4::CalculateCubeMapView(3, Vector4{1.0f, 2.0f, 3.0f, 1.0f}) *
+                    Matrix4x4::CalculateProjPerspective(0.5f, 7.0f, 1.0f, BLK_FLOAT_PI / 2.0f),
+            };
+
+            for (const Matrix4x4& m1 : matrices)
+            {
+                bool isSuccessfull;
+                const Matrix4x4 m2 = m1.Inverse(isSuccessfull);
+                Assert::IsTrue(isSuccessfull);
+                Assert::IsTrue(ApproxEqual(m1 * m2, Matrix4x4::GetIdentity()));
+            }
+        }
+
+        TEST_METHOD(InverseAffine)
+        {
+            std::mt19937 generator(61);
+            std::uniform_real_distribution<float> scale(0.2f, 5.0f);
+
+            for (size_t iteration = 0; iteration < 10000; ++iteration)
+            {
+                const Matrix4x4 m1 =
+                    Matrix4x4::GetScale(scale(generator), scale(generator), scale(generator)) *
+                    BuildRandomRigidMatrix(generator);
+
+                double expected[4][4];
+                Assert::IsTrue(CalculateReferenceInverse(m1, expected));
+
+                bool isSuccessfull;
+                const Matrix4x4 m2 = m1.InverseAffine(isSuccessfull);
+                Assert::IsTrue(isSuccessfull);
+                Assert::IsTrue(CalculateMaxUlpError(m2, expected) <=
+                               Matrix4x4::ms_InverseMaxUlpError);
+                Assert::IsTrue(m2[0][3] == 0.0f && m2[1][3] == 0.0f && m2[2][3] == 0.0f &&
+                               m2[3][3] == 1.0f);
+            }
+
+            bool isSuccessfull;
+            const Matrix4x4 m3 = Matrix4x4::GetScale(1.0f, 0.0f, 1.0f).InverseAffine(isSuccessfull);
+            Assert::IsFalse(isSuccessfull);
+        }
+
+        TEST_METHOD(InverseRigid)
+        {
+            std::mt19937 generator(67);
+
+            for (size_t iteration = 0; iteration < 10000; ++iteration)
+            {
+                const Matrix4x4 m1 = BuildRandomRigidMatrix(generator);
+
+                double expected[4][4];
+                Assert::IsTrue(CalculateReferenceInverse(m1, expected));
+
+                const Matrix4x4 m2 = m1.InverseRigid();
+                Assert::IsTrue(CalculateMaxUlpError(m2, expected) <=
+                               Matrix4x4::ms_InverseMaxUlpError);
+                Assert::IsTrue(m2[0][3] == 0.0f && m2[1][3] == 0.0f && m2[2][3] == 0.0f &&
+                               m2[3][3] == 1.0f);
+            }
+        }
     };
 }
@@ -0,0 +1,177 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/MeshCleanup.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Checks that every element is within tolerance of its representative, representatives map to
+    // themselves and no two representatives are within tolerance
+    static bool IsValidWeld(const std::vector<float>& values, size_t componentCount,
+                            float tolerance, const std::vector<uint32_t>& remap,
+                            size_t uniqueCount)
+    {
+        const size_t elementCount = values.size() / componentCount;
+        auto distanceSquared = [&](size_t left, size_t right) {
+            float result = 0.0f;
+            for (size_t i = 0; i < componentCount; ++i)
+            {
+                const float delta = values[left * componentCount + i] -
+                                    values[right * componentCount + i];
+                result += delta * delta;
+            }
+            return result;
+        };
+
+        std::vector<uint32_t> representatives;
+        for (uint32_t i = 0; i < elementCount; ++i)
+        {
+            const uint32_t target = remap[i];
+            if (target > i || remap[target] != target)
+                return false;
+            if (target == i)
+                representatives.push_back(i);
+            else if (distanceSquared(i, target) > tolerance * tolerance)
+                return false;
+        }
+
+        for (size_t i = 0; i < representatives.size(); ++i)
+        {
+            for (size_t j = i + 1; j < representatives.size(); ++j)
+            {
+                if (distanceSquared(representatives[i], representatives[j]) <=
+                    tolerance * tolerance)
+                    return false;
+            }
+        }
+
+        return representatives.size() == uniqueCount;
+    }
+
+    TEST_CLASS(TestMeshCleanup)
+    {
+    public:
+        TEST_METHOD(WeldExact)
+        {
+            std::vector<float> values = {0.0f, 1.0f, 2.0f,
+                                         0.0f, 1.0f, 2.0f,
+                                         0.0f, 1.0f, 2.0001f,
+                                         -0.0f, 1.0f, 2.0f,
+                                         0.0f, 1.0f, 2.0001f};
+            std::vector<uint32_t> remap;
+            size_t uniqueCount = MeshCleanup::Weld(values.data(), 5, 3, 0.0f, remap);
+
+            // Bit patterns are compared, so negative zero is kept separately
+            Assert::IsTrue(uniqueCount == 3);
+            Assert::IsTrue(remap == std::vector<uint32_t>{0, 0, 2, 3, 2});
+        }
+
+        TEST_METHOD(WeldTolerance)
+        {
+            const float tolerance = 0.001f;
+            std::vector<float> values = {10.0f, 10.0f, 10.0f,
+                                         10.0005f, 10.0f, 10.0f,
+                                         10.0f, 9.9995f, 10.0003f,
+                                         10.002f, 10.0f, 10.0f,
+                                         -5.0f, 0.0f, 0.0f};
+            std::vector<uint32_t> remap;
+            size_t uniqueCount = MeshCleanup::Weld(values.data(), 5, 3, tolerance, remap);
+
+            Assert::IsTrue(uniqueCount == 3);
+            Assert::IsTrue(remap == std::vector<uint32_t>{0, 0, 0, 3, 4});
+        }
+
+        TEST_METHOD(WeldAcrossCellBorder)
+        {
+            // Both points are next to cell border, but land in different cells
+            const float tolerance = 0.5f;
+            std::vector<float> values = {0.99f, 0.0f, 0.0f, 1.01f, 0.0f, 0.0f};
+            std::vector<uint32_t> remap;
+            size_t uniqueCount = MeshCleanup::Weld(values.data(), 2, 3, tolerance, remap);
+
+            Assert::IsTrue(uniqueCount == 1);
+            Assert::IsTrue(remap[1] == 0);
+        }
+
+        TEST_METHOD(WeldRandomClusters)
+        {
+            std::mt19937 generator(17);
+            std::uniform_real_distribution<float> position(-4.0f, 4.0f);
+            std::uniform_real_distribution<float> jitter(-0.002f, 0.002f);
+
+            for (size_t componentCount : {2, 3, 4})
+            {
+                const float tolerance = 0.01f;
+                std::vector<float> centers(200 * componentCount);
+                for (auto& value : centers)
+                    value = position(generator);
+
+                std::vector<float> values;
+                for (size_t i = 0; i < 2000; ++i)
+                {
+                    const size_t center = generator() % 200;
+                    for (size_t component = 0; component < componentCount; ++component)
+                        values.push_back(centers[center * componentCount + component] +
+                                         jitter(generator));
+                }
+
+                std::vector<uint32_t> remap;
+                size_t uniqueCount = MeshCleanup::Weld(values.data(), 2000, componentCount,
+                                                       tolerance, remap);
+                Assert::IsTrue(IsValidWeld(values, componentCount, tolerance, remap,
+                                           uniqueCount));
+                // Points of one cluster are closer than tolerance even in 4 dimensions
+                Assert::IsTrue(uniqueCount <= 200);
+            }
+        }
+
+        TEST_METHOD(WeldEmpty)
+        {
+            std::vector<uint32_t> remap = {1, 2, 3};
+            Assert::IsTrue(MeshCleanup::Weld(nullptr, 0, 3, 0.1f, remap) == 0);
+            Assert::IsTrue(remap.empty());
+        }
+
+        TEST_METHOD(FilterTriangles)
+        {
+            std::vector<float> positions = {0.0f, 0.0f, 0.0f,
+                                            1.0f, 0.0f, 0.0f,
+                                            0.0f, 1.0f, 0.0f,
+                                            2.0f, 0.0f, 0.0f,
+                                            1.0f, 1.0f, 0.0f};
+            std::vector<uint32_t> triangles = {0, 1, 2,
+                                               1, 2, 0,  // Same triangle, rotated
+                                               2, 1, 0,  // Flipped winding is kept
+                                               0, 0, 2,  // Repeated vertex
+                                               0, 1, 3,  // Collinear
+                                               1, 3, 4,
+                                               3, 4, 1}; // Same triangle, rotated
+            MeshCleanup::TriangleStats stats;
+            std::vector<uint32_t> kept = MeshCleanup::FilterTriangles(
+                triangles.data(), triangles.size() / 3, positions.data(), 0.0f, stats);
+
+            Assert::IsTrue(kept == std::vector<uint32_t>{0, 2, 5});
+            Assert::IsTrue(stats.degenerateCount == 1);
+            Assert::IsTrue(stats.zeroAreaCount == 1);
+            Assert::IsTrue(stats.duplicateCount == 2);
+        }
+
+        TEST_METHOD(FilterTrianglesMinArea)
+        {
+            std::vector<float> positions = {0.0f, 0.0f, 0.0f,
+                                            1.0f, 0.0f, 0.0f,
+                                            0.0f, 1.0f, 0.0f,
+                                            0.0f, 0.001f, 0.0f};
+            std::vector<uint32_t> triangles = {0, 1, 2, 0, 1, 3};
+            MeshCleanup::TriangleStats stats;
+            std::vector<uint32_t> kept = MeshCleanup::FilterTriangles(
+                triangles.data(), 2, positions.data(), 0.01f, stats);
+
+            Assert::IsTrue(kept == std::vector<uint32_t>{0});
+            Assert::IsTrue(stats.zeroAreaCount == 1);
+        }
+    };
+}
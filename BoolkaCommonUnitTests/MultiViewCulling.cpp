@@ -0,0 +1,183 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/MultiViewCulling.h"
+
+#include "TestDataHelpers.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static const FrustumCulling::Backend gs_MultiViewBackends[] = {
+        FrustumCulling::Backend::Scalar, FrustumCulling::Backend::SSE,
+        FrustumCulling::Backend::AVX2};
+
+    static bool IntersectsGroupSphere(const MultiViewCulling::ViewGroup& group, const AABB& box)
+    {
+        const Vector4& center = group.boundingSphere;
+        float distance[3];
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            distance[axis] = std::max(std::max(box.GetMin()[axis] - center[axis],
+                                               center[axis] - box.GetMax()[axis]),
+                                      0.0f);
+        }
+        const float distanceSqr =
+            (distance[0] * distance[0] + distance[1] * distance[1]) + distance[2] * distance[2];
+        return distanceSqr <= center.w() * center.w();
+    }
+
+    static uint32_t CalculateExpectedMask(const Frustum* views, size_t viewCount,
+                                          const MultiViewCulling::ViewGroup* groups,
+                                          size_t groupCount, const AABB& box)
+    {
+        uint32_t result = 0;
+        for (size_t view = 0; view < viewCount; ++view)
+        {
+            if (views[view].CheckAABBFast(box))
+                result |= 1u << view;
+        }
+        for (size_t i = 0; i < groupCount; ++i)
+        {
+            if (IntersectsGroupSphere(groups[i], box))
+                continue;
+            const uint32_t groupBits = ((1u << groups[i].viewCount) - 1) << groups[i].firstView;
+            result &= ~groupBits;
+        }
+        return result;
+    }
+
+    static bool IsEquivalentToPerViewCulling(const Frustum* views, size_t viewCount,
+                                             const MultiViewCulling::ViewGroup* groups,
+                                             size_t groupCount, const std::vector<AABB>& boxes,
+                                             FrustumCulling::Backend backend)
+    {
+        FrustumCulling::AABBArray array = BuildMultiViewArray(boxes);
+
+        // Guard mask catches writes past the end
+        std::vector<uint32_t> masks(boxes.size() + 1, 0xCDCDCDCDu);
+        MultiViewCulling::CullAABBs(views, viewCount, groups, groupCount, array, masks.data(),
+                                    backend);
+        if (masks[boxes.size()] != 0xCDCDCDCDu)
+            return false;
+
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            if (masks[i] != CalculateExpectedMask(views, viewCount, groups, groupCount, boxes[i]))
+                return false;
+        }
+        return true;
+    }
+
+    TEST_CLASS(TestMultiViewCulling)
+    {
+    public:
+        TEST_METHOD(MatchesPerViewCulling)
+        {
+            std::mt19937 generator(31);
+            for (size_t iteration = 0; iteration < 16; ++iteration)
+            {
+                RenderViews renderViews = BuildRandomRenderViews(generator, 7.0f + iteration);
+                std::vector<AABB> boxes = BuildRandomMultiViewBoxes(generator, 2000 + iteration);
+
+                for (auto backend : gs_MultiViewBackends)
+                {
+                    if (!FrustumCulling::IsBackendSupported(backend))
+                        continue;
+
+                    Assert::IsTrue(IsEquivalentToPerViewCulling(
+                        renderViews.views, gs_RenderViewCount, renderViews.groups, gs_LightCount,
+                        boxes, backend));
+                }
+            }
+        }
+
+        TEST_METHOD(AllBoxCounts)
+        {
+            std::mt19937 generator(37);
+            RenderViews renderViews = BuildRandomRenderViews(generator, 20.0f);
+            std::vector<AABB> allBoxes = BuildRandomMultiViewBoxes(generator, 40);
+            for (size_t count = 0; count <= allBoxes.size(); ++count)
+            {
+                std::vector<AABB> boxes(allBoxes.begin(), allBoxes.begin() + count);
+                for (auto backend : gs_MultiViewBackends)
+                {
+                    if (!FrustumCulling::IsBackendSupported(backend))
+                        continue;
+
+                    Assert::IsTrue(IsEquivalentToPerViewCulling(
+                        renderViews.views, gs_RenderViewCount, renderViews.groups, gs_LightCount,
+                        boxes, backend));
+                }
+            }
+        }
+
+        TEST_METHOD(ViewsWithoutGroups)
+        {
+            // Without groups every view matches single view culling
+            std::mt19937 generator(41);
+            RenderViews renderViews = BuildRandomRenderViews(generator, 10.0f);
+            std::vector<AABB> boxes = BuildRandomMultiViewBoxes(generator, 1001);
+            FrustumCulling::AABBArray array = BuildMultiViewArray(boxes);
+
+            std::vector<uint32_t> masks(boxes.size());
+            MultiViewCulling::CullAABBs(renderViews.views, gs_RenderViewCount, nullptr, 0, array,
+                                        masks.data());
+
+            std::vector<uint32_t> viewMask(FrustumCulling::GetMaskWordCount(boxes.size()));
+            for (size_t view = 0; view < gs_RenderViewCount; ++view)
+            {
+                FrustumCulling::CullAABBs(renderViews.views[view], array, viewMask.data());
+                for (size_t i = 0; i < boxes.size(); ++i)
+                {
+                    const bool expected = (viewMask[i / 32] >> (i % 32)) & 1;
+                    Assert::IsTrue(expected == bool((masks[i] >> view) & 1));
+                }
+            }
+        }
+
+        TEST_METHOD(GroupInMiddle)
+        {
+            // Ungrouped views on both sides of group, group of single view
+            std::mt19937 generator(43);
+            RenderViews renderViews = BuildRandomRenderViews(generator, 12.0f);
+            MultiViewCulling::ViewGroup groups[] = {
+                {renderViews.groups[1].boundingSphere, 8, 6},
+                {renderViews.groups[3].boundingSphere, 25, 1}};
+            std::vector<AABB> boxes = BuildRandomMultiViewBoxes(generator, 503);
+
+            for (auto backend : gs_MultiViewBackends)
+            {
+                if (!FrustumCulling::IsBackendSupported(backend))
+                    continue;
+
+                Assert::IsTrue(IsEquivalentToPerViewCulling(renderViews.views,
+                                                            gs_RenderViewCount, groups, 2, boxes,
+                                                            backend));
+            }
+        }
+
+        TEST_METHOD(BuildViewLists)
+        {
+            std::vector<uint32_t> masks = {0b101, 0b000, 0b110, 0b111, 0b001};
+            MultiViewCulling::ViewLists lists;
+            lists.Build(masks.data(), masks.size(), 4);
+
+            Assert::IsTrue(lists.GetViewCount() == 4);
+            Assert::IsTrue(lists.GetOffset(0) == 0 && lists.GetCount(0) == 3);
+            Assert::IsTrue(lists.GetOffset(1) == 3 && lists.GetCount(1) == 2);
+            Assert::IsTrue(lists.GetOffset(2) == 5 && lists.GetCount(2) == 3);
+            Assert::IsTrue(lists.GetOffset(3) == 8 && lists.GetCount(3) == 0);
+            Assert::IsTrue(lists.GetAllIndices() ==
+                           std::vector<uint32_t>{0, 3, 4, 2, 3, 0, 2, 3});
+            Assert::IsTrue(lists.GetIndices(2)[0] == 0 && lists.GetIndices(2)[2] == 3);
+
+            lists.Build(masks.data(), 0, 2);
+            Assert::IsTrue(lists.GetViewCount() == 2);
+            Assert::IsTrue(lists.GetCount(0) == 0 && lists.GetCount(1) == 0);
+            Assert::IsTrue(lists.GetAllIndices().empty());
+        }
+    };
+}
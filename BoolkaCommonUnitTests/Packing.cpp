@@ -0,0 +1,270 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/Packing.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static const Packing::HalfBackend gs_HalfBackends[] = {
+        Packing::HalfBackend::Scalar, Packing::HalfBackend::SSE, Packing::HalfBackend::F16C};
+
+    static bool IsSignalingHalfNaN(uint16_t value)
+    {
+        return (value & 0x7C00) == 0x7C00 && (value & 0x3FF) != 0 && (value & 0x200) == 0;
+    }
+
+    // Exact value of half, calculated from its fields
+    static double CalculateHalfValue(uint16_t value)
+    {
+        const int exponent = (value >> 10) & 0x1F;
+        const int mantissa = value & 0x3FF;
+        const double sign = (value & 0x8000) ? -1.0 : 1.0;
+        if (exponent == 0)
+            return sign * ldexp(double(mantissa), -24);
+        return sign * ldexp(double(mantissa + 0x400), exponent - 25);
+    }
+
+    static std::vector<float> BuildRandomNormals(std::mt19937& generator, size_t count)
+    {
+        std::normal_distribution<float> distribution;
+        std::vector<float> result;
+        result.reserve(count * 3);
+
+        // Axes, diagonals and random directions
+        const float axes[] = {1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+                              0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, -1.0f};
+        result.insert(result.end(), std::begin(axes), std::end(axes));
+        for (int x = -1; x <= 1; x += 2)
+        {
+            for (int y = -1; y <= 1; y += 2)
+            {
+                for (int z = -1; z <= 1; z += 2)
+                {
+                    const float length = sqrt(3.0f);
+                    result.insert(result.end(), {x / length, y / length, z / length});
+                }
+            }
+        }
+
+        while (result.size() < count * 3)
+        {
+            const Vector3 normal = Vector3{distribution(generator), distribution(generator),
+                                           distribution(generator)};
+            if (normal.LengthSqr() < 1e-6f)
+                continue;
+            const Vector3 unitNormal = normal / normal.LengthSlow();
+            result.insert(result.end(), unitNormal.begin(), unitNormal.end());
+        }
+        return result;
+    }
+
+    TEST_CLASS(TestPacking)
+    {
+    public:
+        TEST_METHOD(DefaultHalfBackendIsSupported)
+        {
+            Assert::IsTrue(Packing::IsHalfBackendSupported(Packing::HalfBackend::Scalar));
+            Assert::IsTrue(Packing::IsHalfBackendSupported(Packing::GetDefaultHalfBackend()));
+        }
+
+        TEST_METHOD(HalfRoundTripAllValues)
+        {
+            std::vector<uint16_t> halves(0x10000);
+            std::iota(halves.begin(), halves.end(), uint16_t(0));
+
+            for (Packing::HalfBackend backend : gs_HalfBackends)
+            {
+                if (!Packing::IsHalfBackendSupported(backend))
+                    continue;
+
+                std::vector<float> floats(halves.size());
+                Packing::HalfToFloat(halves.data(), floats.data(), halves.size(), backend);
+                std::vector<uint16_t> roundTrip(halves.size());
+                Packing::FloatToHalf(floats.data(), roundTrip.data(), floats.size(), backend);
+
+                for (size_t i = 0; i < halves.size(); ++i)
+                {
+                    const uint16_t half = halves[i];
+                    const float value = floats[i];
+                    Assert::AreEqual(std::bit_cast<uint32_t>(Packing::HalfToFloat(half)),
+                                     std::bit_cast<uint32_t>(value));
+
+                    if ((half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0)
+                        Assert::IsTrue(std::isnan(value));
+                    else if ((half & 0x7FFF) == 0x7C00)
+                        Assert::IsTrue(std::isinf(value));
+                    else
+                        Assert::IsTrue(double(value) == CalculateHalfValue(half));
+
+                    // Signaling NaN becomes quiet, everything else round trips exactly
+                    const uint16_t expected = IsSignalingHalfNaN(half) ? half | 0x200 : half;
+                    Assert::AreEqual(expected, roundTrip[i]);
+                    Assert::AreEqual(expected, Packing::FloatToHalf(value));
+                }
+            }
+        }
+
+        TEST_METHOD(FloatToHalfRounding)
+        {
+            // Bit patterns spread over all floats, including NaN and infinity
+            // Count is not multiple of 8, so that incomplete last group is converted too
+            std::vector<float> floats;
+            for (uint64_t bits = 0; bits <= 0xFFFFFFFF; bits += 4093)
+                floats.push_back(std::bit_cast<float>(static_cast<uint32_t>(bits)));
+            floats.push_back(65504.0f);
+            floats.push_back(65519.99f);
+            floats.push_back(65520.0f);
+            floats.push_back(std::numeric_limits<float>::infinity());
+            if (floats.size() % 8 == 0)
+                floats.push_back(-0.0f);
+
+            for (Packing::HalfBackend backend : gs_HalfBackends)
+            {
+                if (!Packing::IsHalfBackendSupported(backend))
+                    continue;
+
+                std::vector<uint16_t> halves(floats.size());
+                Packing::FloatToHalf(floats.data(), halves.data(), floats.size(), backend);
+
+                for (size_t i = 0; i < floats.size(); ++i)
+                {
+                    const float value = floats[i];
+                    const uint16_t half = halves[i];
+                    Assert::AreEqual(Packing::FloatToHalf(value), half);
+                    Assert::AreEqual(std::signbit(value), (half & 0x8000) != 0);
+
+                    if (std::isnan(value))
+                    {
+                        Assert::IsTrue(std::isnan(Packing::HalfToFloat(half)));
+                        continue;
+                    }
+                    if ((half & 0x7FFF) == 0x7C00)
+                    {
+                        // Overflow, halfway between largest half and next power of two rounds up
+                        Assert::IsTrue(abs(value) >= 65520.0f);
+                        continue;
+                    }
+
+                    // Nearest half, ties go to even mantissa
+                    const double error = abs(CalculateHalfValue(half) - value);
+                    const double ulp = CalculateHalfValue((half & 0x7FFF) | 1) -
+                                       CalculateHalfValue((half & 0x7FFF) & ~1);
+                    Assert::IsTrue(error <= abs(ulp) * 0.5 || (half & 0x7FFF) == 0x7BFF);
+                    if (error == abs(ulp) * 0.5)
+                        Assert::AreEqual(0, half & 1);
+                }
+            }
+        }
+
+        TEST_METHOD(OctahedralPrecision)
+        {
+            // Count isn't multiple of SIMD width, so that tail is tested too
+            std::mt19937 generator(67);
+            const size_t count = 100003;
+            const std::vector<float> normals = BuildRandomNormals(generator, count);
+            std::vector<int16_t> encoded(count * 2);
+            Packing::EncodeOctahedral(normals.data(), encoded.data(), count);
+            std::vector<float> decoded(count * 3);
+            Packing::DecodeOctahedral(encoded.data(), decoded.data(), count);
+
+            double maxAngle = 0.0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Vector3 normal{normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]};
+                const Vector3 result{decoded[i * 3], decoded[i * 3 + 1], decoded[i * 3 + 2]};
+                Assert::IsTrue(ApproxEqual(result.LengthSqr(), 1.0f));
+                const double angle = ::atan2(double(normal.Cross(result).LengthSlow()),
+                                             double(normal.Dot(result)));
+                maxAngle = std::max(maxAngle, angle);
+
+                // Single normal goes through padded path
+                int16_t single[2];
+                float singleDecoded[3];
+                Packing::EncodeOctahedral(&normals[i * 3], single, 1);
+                Packing::DecodeOctahedral(single, singleDecoded, 1);
+                Assert::AreEqual(encoded[i * 2], single[0]);
+                Assert::AreEqual(encoded[i * 2 + 1], single[1]);
+                Assert::IsTrue(memcmp(singleDecoded, &decoded[i * 3], sizeof(singleDecoded)) == 0);
+            }
+            Assert::IsTrue(maxAngle <= Packing::ms_OctahedralMaxAngleError);
+
+            // Axes are exact
+            for (size_t i = 0; i < 6 * 3; ++i)
+                Assert::AreEqual(normals[i], decoded[i]);
+
+            char message[128];
+            snprintf(message, sizeof(message), "Octahedral snorm16 max angle error %g radians",
+                     maxAngle);
+            Logger::WriteMessage(message);
+        }
+
+        TEST_METHOD(UnormRoundTripAllValues)
+        {
+            std::vector<uint16_t> unorm16(0x10000);
+            std::iota(unorm16.begin(), unorm16.end(), uint16_t(0));
+            std::vector<float> floats(unorm16.size());
+            Packing::Unorm16ToFloat(unorm16.data(), floats.data(), unorm16.size());
+            std::vector<uint16_t> roundTrip16(unorm16.size());
+            Packing::FloatToUnorm16(floats.data(), roundTrip16.data(), floats.size());
+            Assert::IsTrue(unorm16 == roundTrip16);
+            for (size_t i = 0; i < unorm16.size(); ++i)
+                Assert::AreEqual(i / 65535.0f, floats[i]);
+
+            std::vector<uint8_t> unorm8(0x100);
+            std::iota(unorm8.begin(), unorm8.end(), uint8_t(0));
+            Packing::Unorm8ToFloat(unorm8.data(), floats.data(), unorm8.size());
+            std::vector<uint8_t> roundTrip8(unorm8.size());
+            for (Packing::Rounding rounding :
+                 {Packing::Rounding::Nearest, Packing::Rounding::Down, Packing::Rounding::Up})
+            {
+                Packing::FloatToUnorm8(floats.data(), roundTrip8.data(), unorm8.size(), rounding);
+                Assert::IsTrue(unorm8 == roundTrip8);
+            }
+            for (size_t i = 0; i < unorm8.size(); ++i)
+                Assert::AreEqual(i / 255.0f, floats[i]);
+        }
+
+        TEST_METHOD(UnormRounding)
+        {
+            std::mt19937 generator(71);
+            std::uniform_real_distribution<float> distribution(-0.1f, 1.1f);
+            std::vector<float> input(1001);
+            for (float& value : input)
+                value = distribution(generator);
+            input[0] = std::numeric_limits<float>::quiet_NaN();
+            input[1] = std::numeric_limits<float>::infinity();
+            input[2] = -std::numeric_limits<float>::infinity();
+
+            std::vector<uint16_t> nearest(input.size());
+            std::vector<uint16_t> down(input.size());
+            std::vector<uint16_t> up(input.size());
+            std::vector<uint8_t> nearest8(input.size());
+            Packing::FloatToUnorm16(input.data(), nearest.data(), input.size());
+            Packing::FloatToUnorm16(input.data(), down.data(), input.size(),
+                                    Packing::Rounding::Down);
+            Packing::FloatToUnorm16(input.data(), up.data(), input.size(), Packing::Rounding::Up);
+            Packing::FloatToUnorm8(input.data(), nearest8.data(), input.size());
+
+            Assert::AreEqual(uint16_t(0), nearest[0]);
+            Assert::AreEqual(uint16_t(65535), nearest[1]);
+            Assert::AreEqual(uint16_t(0), nearest[2]);
+            Assert::AreEqual(uint8_t(0), nearest8[0]);
+            Assert::AreEqual(uint8_t(255), nearest8[1]);
+
+            // Scaling is done in float, so allow error of float product
+            const double epsilon = 65535.0 * FLT_EPSILON;
+            for (size_t i = 3; i < input.size(); ++i)
+            {
+                const double clamped = std::clamp(double(input[i]), 0.0, 1.0);
+                const double scaled = clamped * 65535.0;
+                Assert::IsTrue(abs(nearest[i] - scaled) <= 0.5 + epsilon);
+                Assert::IsTrue(down[i] <= scaled + epsilon && scaled < down[i] + 1.0 + epsilon);
+                Assert::IsTrue(up[i] >= scaled - epsilon && scaled > up[i] - 1.0 - epsilon);
+                Assert::IsTrue(abs(nearest8[i] - clamped * 255.0) <= 0.5 + epsilon);
+            }
+        }
+    };
+}
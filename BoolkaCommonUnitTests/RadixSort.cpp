@@ -0,0 +1,149 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Algorithms/RadixSort.h"
+#include "BoolkaCommon/Structures/ScratchArena.h"
+
+#include "TestDataHelpers.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    struct RadixSortPair
+    {
+        float key;
+        uint32_t value;
+    };
+
+    // Reference result, keys are compared by value except for zeros, same as radix sort
+    static std::vector<RadixSortPair> StableSortPairs(const std::vector<float>& keys,
+                                                      RadixSort::Order order)
+    {
+        std::vector<RadixSortPair> pairs(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            pairs[i] = RadixSortPair{keys[i], uint32_t(i)};
+
+        std::stable_sort(pairs.begin(), pairs.end(),
+                         [order](const RadixSortPair& left, const RadixSortPair& right) {
+                             const uint32_t leftKey = RadixSort::FloatToSortable(left.key);
+                             const uint32_t rightKey = RadixSort::FloatToSortable(right.key);
+                             return order == RadixSort::Order::Ascending ? leftKey < rightKey
+                                                                         : leftKey > rightKey;
+                         });
+        return pairs;
+    }
+
+    static bool RadixSortMatchesStableSort(const std::vector<float>& input,
+                                           RadixSort::Order order)
+    {
+        std::vector<float> keys = input;
+        std::vector<uint32_t> values(keys.size());
+        std::iota(values.begin(), values.end(), 0u);
+
+        ScratchArena scratch;
+        RadixSort::Sort(keys.data(), values.data(), keys.size(), order, scratch);
+
+        const std::vector<RadixSortPair> expected = StableSortPairs(input, order);
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            if (asuint(keys[i]) != asuint(expected[i].key) || values[i] != expected[i].value)
+                return false;
+        }
+        return true;
+    }
+
+    TEST_CLASS(TestRadixSort)
+    {
+    public:
+        TEST_METHOD(SortableKeyOrder)
+        {
+            const float values[] = {-std::numeric_limits<float>::infinity(),
+                                    -1e30f,
+                                    -1.0f,
+                                    -std::numeric_limits<float>::denorm_min(),
+                                    -0.0f,
+                                    0.0f,
+                                    std::numeric_limits<float>::denorm_min(),
+                                    1.0f,
+                                    1e30f,
+                                    std::numeric_limits<float>::infinity()};
+            for (size_t i = 0; i < std::size(values); ++i)
+            {
+                const uint32_t sortable = RadixSort::FloatToSortable(values[i]);
+                Assert::AreEqual(asuint(values[i]), asuint(RadixSort::SortableToFloat(sortable)));
+                if (i != 0)
+                    Assert::IsTrue(RadixSort::FloatToSortable(values[i - 1]) < sortable);
+            }
+        }
+
+        TEST_METHOD(MatchesStableSort)
+        {
+            std::mt19937 generator(48);
+            std::uniform_real_distribution<float> anyValue(-1e6f, 1e6f);
+            // Sizes around insertion sort threshold and above parallel threshold
+            const size_t sizes[] = {0, 1, 2, 63, 64, 65, 1000, 100000, 300000};
+            for (size_t size : sizes)
+            {
+                std::vector<float> keys(size);
+                for (float& key : keys)
+                    key = anyValue(generator);
+                Assert::IsTrue(RadixSortMatchesStableSort(keys, RadixSort::Order::Ascending));
+                Assert::IsTrue(RadixSortMatchesStableSort(keys, RadixSort::Order::Descending));
+            }
+        }
+
+        TEST_METHOD(DuplicateKeysAreStable)
+        {
+            std::mt19937 generator(480);
+            std::uniform_int_distribution<int> smallValue(-8, 8);
+            std::vector<float> keys(20000);
+            for (float& key : keys)
+                key = float(smallValue(generator)) * 0.5f;
+            // Zeros of both signs
+            keys[10] = -0.0f;
+            keys[20] = 0.0f;
+            Assert::IsTrue(RadixSortMatchesStableSort(keys, RadixSort::Order::Ascending));
+            Assert::IsTrue(RadixSortMatchesStableSort(keys, RadixSort::Order::Descending));
+        }
+
+        TEST_METHOD(SkippedDigits)
+        {
+            // Keys that differ only in low or only in high digit skip other passes
+            std::vector<float> lowDigits(5000);
+            std::vector<float> highDigits(5000);
+            for (size_t i = 0; i < lowDigits.size(); ++i)
+            {
+                lowDigits[i] = asfloat(0x3F800000u + uint32_t((i * 7919) % 2048));
+                highDigits[i] = asfloat(uint32_t((i * 7919) % 512) << 22);
+            }
+            Assert::IsTrue(RadixSortMatchesStableSort(lowDigits, RadixSort::Order::Ascending));
+            Assert::IsTrue(RadixSortMatchesStableSort(highDigits, RadixSort::Order::Descending));
+
+            std::vector<float> sameKeys(1000, 42.0f);
+            Assert::IsTrue(RadixSortMatchesStableSort(sameKeys, RadixSort::Order::Ascending));
+        }
+
+        TEST_METHOD(ScratchIsReused)
+        {
+            std::mt19937 generator(4800);
+            std::vector<float> keys = BuildRandomDistances(generator, 100000);
+            std::vector<uint32_t> values(keys.size());
+
+            // After first frame arena has single block big enough for every following frame
+            ScratchArena scratch;
+            size_t heapAllocations = 0;
+            for (int frame = 0; frame < 4; ++frame)
+            {
+                scratch.Reset();
+                if (frame == 1)
+                    heapAllocations = scratch.GetHeapAllocationCount();
+                RadixSort::Sort(keys.data(), values.data(), keys.size(),
+                                RadixSort::Order::Ascending, scratch);
+            }
+            Assert::AreEqual(heapAllocations, scratch.GetHeapAllocationCount());
+            Assert::IsTrue(std::is_sorted(keys.begin(), keys.end()));
+        }
+    };
+}
@@ -0,0 +1,107 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/ScratchArena.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    TEST_CLASS(TestScratchArena)
+    {
+    public:
+        TEST_METHOD(Alignment)
+        {
+            ScratchArena arena;
+            unsigned char* byte = arena.Allocate<unsigned char>(3);
+            Vector4* vectors = arena.Allocate<Vector4>(5);
+            uint64_t* words = arena.Allocate<uint64_t>(7);
+
+            Assert::IsTrue(byte != nullptr);
+            Assert::IsTrue(reinterpret_cast<uintptr_t>(vectors) % alignof(Vector4) == 0);
+            Assert::IsTrue(reinterpret_cast<uintptr_t>(words) % alignof(uint64_t) == 0);
+            // Allocations don't overlap
+            Assert::IsTrue(ptr_static_cast<unsigned char*>(vectors) >= byte + 3);
+            Assert::IsTrue(ptr_static_cast<unsigned char*>(words) >=
+                           ptr_static_cast<unsigned char*>(vectors + 5));
+        }
+
+        TEST_METHOD(AllocateZeroed)
+        {
+            ScratchArena arena;
+            uint32_t* values = arena.Allocate<uint32_t>(100);
+            std::fill(values, values + 100, 0xFFFFFFFFu);
+            arena.Reset();
+
+            uint32_t* zeroed = arena.AllocateZeroed<uint32_t>(100);
+            Assert::IsTrue(std::all_of(zeroed, zeroed + 100, [](uint32_t v) { return v == 0; }));
+        }
+
+        TEST_METHOD(ReuseAfterReset)
+        {
+            ScratchArena arena;
+            for (size_t iteration = 0; iteration < 100; ++iteration)
+            {
+                // Different sizes on every iteration, peak is reached on first one
+                const size_t count = 100000 - iteration * 100;
+                uint32_t* values = arena.Allocate<uint32_t>(count);
+                uint16_t* halfs = arena.Allocate<uint16_t>(count);
+                values[count - 1] = 1;
+                halfs[count - 1] = 2;
+                arena.Reset();
+            }
+
+            // Heap is only touched until memory is enough for whole iteration
+            Assert::IsTrue(arena.GetAllocationCount() == 200);
+            Assert::IsTrue(arena.GetHeapAllocationCount() <= 3);
+        }
+
+        TEST_METHOD(GrowsPastBlock)
+        {
+            ScratchArena arena;
+            std::vector<uint64_t*> allocations;
+            for (uint64_t i = 0; i < 1000; ++i)
+            {
+                uint64_t* values = arena.Allocate<uint64_t>(1000);
+                std::fill(values, values + 1000, i);
+                allocations.push_back(values);
+            }
+
+            // Growing doesn't move earlier allocations
+            for (uint64_t i = 0; i < 1000; ++i)
+            {
+                Assert::IsTrue(allocations[i][0] == i && allocations[i][999] == i);
+            }
+
+            const size_t capacity = arena.GetCapacity();
+            const size_t heapAllocations = arena.GetHeapAllocationCount();
+            Assert::IsTrue(capacity >= 1000 * 1000 * sizeof(uint64_t));
+
+            // Blocks are coalesced into one on reset
+            arena.Reset();
+            Assert::IsTrue(arena.GetHeapAllocationCount() == heapAllocations + 1);
+            for (uint64_t i = 0; i < 1000; ++i)
+            {
+                uint64_t* values = arena.Allocate<uint64_t>(1000);
+                values[0] = i;
+            }
+            Assert::IsTrue(arena.GetHeapAllocationCount() == heapAllocations + 1);
+
+            arena.Release();
+            Assert::IsTrue(arena.GetCapacity() == 0);
+        }
+
+        TEST_METHOD(Move)
+        {
+            ScratchArena arena;
+            uint32_t* value = arena.Allocate<uint32_t>(1);
+            *value = 42;
+
+            ScratchArena moved = std::move(arena);
+            Assert::IsTrue(*value == 42);
+            Assert::IsTrue(arena.GetCapacity() == 0);
+            Assert::IsTrue(moved.GetCapacity() > 0);
+        }
+    };
+}
@@ -0,0 +1,170 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/SmallVector.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    // Counts live instances, so that leaked or double destroyed elements are detected
+    struct SmallVectorTrackedElement
+    {
+        static int ms_LiveCount;
+
+        SmallVectorTrackedElement()
+            : value(0)
+        {
+            ++ms_LiveCount;
+        }
+
+        explicit SmallVectorTrackedElement(int value)
+            : value(value)
+        {
+            ++ms_LiveCount;
+        }
+
+        SmallVectorTrackedElement(const SmallVectorTrackedElement& other)
+            : value(other.value)
+        {
+            ++ms_LiveCount;
+        }
+
+        SmallVectorTrackedElement(SmallVectorTrackedElement&& other) noexcept
+            : value(other.value)
+        {
+            ++ms_LiveCount;
+        }
+
+        ~SmallVectorTrackedElement()
+        {
+            --ms_LiveCount;
+        }
+
+        SmallVectorTrackedElement& operator=(const SmallVectorTrackedElement& other) = default;
+
+        int value;
+    };
+
+    int SmallVectorTrackedElement::ms_LiveCount = 0;
+
+    TEST_CLASS(TestSmallVector)
+    {
+    public:
+        TEST_METHOD(InlineStorage)
+        {
+            SmallVector<int, 4> vector;
+            Assert::IsTrue(vector.IsEmpty());
+            Assert::IsTrue(vector.IsInline());
+            Assert::AreEqual(size_t(4), vector.GetCapacity());
+
+            for (int i = 0; i < 4; ++i)
+                vector.Add(i);
+            Assert::IsTrue(vector.IsInline());
+            Assert::AreEqual(size_t(4), vector.GetSize());
+            // Inline storage is part of object itself
+            Assert::IsTrue(ptr_static_cast<unsigned char*>(vector.GetData()) >=
+                           ptr_static_cast<unsigned char*>(&vector));
+            Assert::IsTrue(ptr_static_cast<unsigned char*>(vector.GetData()) <
+                           ptr_static_cast<unsigned char*>(&vector + 1));
+
+            vector.RemoveLast();
+            Assert::AreEqual(2, vector.GetLast());
+        }
+
+        TEST_METHOD(SpillToHeap)
+        {
+            SmallVector<int, 4> vector = {0, 1, 2};
+            for (int i = 3; i < 100; ++i)
+                vector.Add(i);
+            Assert::IsFalse(vector.IsInline());
+            Assert::AreEqual(size_t(100), vector.GetSize());
+            for (int i = 0; i < 100; ++i)
+                Assert::AreEqual(i, vector[i]);
+
+            int sum = 0;
+            for (int value : vector)
+                sum += value;
+            Assert::AreEqual(99 * 100 / 2, sum);
+
+            // Element of vector itself can be added while it reallocates
+            while (vector.GetSize() != vector.GetCapacity())
+                vector.Add(0);
+            vector.Add(vector[1]);
+            Assert::AreEqual(1, vector.GetLast());
+
+            vector.Release();
+            Assert::IsTrue(vector.IsInline());
+            Assert::IsTrue(vector.IsEmpty());
+        }
+
+        TEST_METHOD(Resize)
+        {
+            SmallVector<uint32_t, 2> vector;
+            vector.Resize(10);
+            Assert::AreEqual(size_t(10), vector.GetSize());
+            Assert::IsTrue(std::all_of(vector.begin(), vector.end(),
+                                       [](uint32_t value) { return value == 0; }));
+            vector.Resize(1);
+            Assert::AreEqual(size_t(1), vector.GetSize());
+
+            vector.Reserve(50);
+            Assert::IsTrue(vector.GetCapacity() >= 50);
+        }
+
+        TEST_METHOD(CopyAndMove)
+        {
+            SmallVector<std::string, 2> small = {"a", "b"};
+            SmallVector<std::string, 2> large = {"a", "b", "c", "d"};
+
+            SmallVector<std::string, 2> smallCopy(small);
+            SmallVector<std::string, 2> largeCopy(large);
+            Assert::IsTrue(smallCopy.IsInline());
+            Assert::AreEqual(size_t(4), largeCopy.GetSize());
+            Assert::AreEqual(std::string("d"), largeCopy[3]);
+
+            const std::string* largeData = largeCopy.GetData();
+            SmallVector<std::string, 2> largeMoved(std::move(largeCopy));
+            // Heap storage is taken over
+            Assert::IsTrue(largeMoved.GetData() == largeData);
+            Assert::IsTrue(largeCopy.IsEmpty());
+            Assert::IsTrue(largeCopy.IsInline());
+
+            SmallVector<std::string, 2> smallMoved(std::move(smallCopy));
+            Assert::IsTrue(smallMoved.IsInline());
+            Assert::AreEqual(std::string("b"), smallMoved[1]);
+
+            smallMoved = large;
+            Assert::AreEqual(size_t(4), smallMoved.GetSize());
+            smallMoved = std::move(small);
+            Assert::AreEqual(size_t(2), smallMoved.GetSize());
+            Assert::IsTrue(smallMoved.IsInline());
+        }
+
+        TEST_METHOD(ElementLifetime)
+        {
+            {
+                SmallVector<SmallVectorTrackedElement, 4> vector;
+                for (int i = 0; i < 3; ++i)
+                    vector.Emplace(i);
+                Assert::AreEqual(3, SmallVectorTrackedElement::ms_LiveCount);
+
+                for (int i = 3; i < 40; ++i)
+                    vector.Emplace(i);
+                Assert::AreEqual(40, SmallVectorTrackedElement::ms_LiveCount);
+
+                SmallVector<SmallVectorTrackedElement, 4> copy = vector;
+                Assert::AreEqual(80, SmallVectorTrackedElement::ms_LiveCount);
+                copy.Resize(2);
+                Assert::AreEqual(42, SmallVectorTrackedElement::ms_LiveCount);
+
+                vector.Clear();
+                Assert::AreEqual(2, SmallVectorTrackedElement::ms_LiveCount);
+                vector = std::move(copy);
+                Assert::AreEqual(1, vector[1].value);
+            }
+            Assert::AreEqual(0, SmallVectorTrackedElement::ms_LiveCount);
+        }
+    };
+}
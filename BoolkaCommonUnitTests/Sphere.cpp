@@ -0,0 +1,188 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/Sphere.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static std::vector<Vector4> GenerateRandomPoints(std::mt19937& generator, size_t count)
+    {
+        std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+        std::vector<Vector4> result(count);
+        for (auto& point : result)
+        {
+            point = Vector4(distribution(generator), distribution(generator),
+                            distribution(generator), 1.0f);
+        }
+        return result;
+    }
+
+    static bool ContainsAll(const Sphere& sphere, const std::vector<Vector4>& points)
+    {
+        const float epsilon = 1e-4f * (1.0f + sphere.GetRadius());
+        return std::all_of(points.begin(), points.end(),
+                           [&](const Vector4& point) { return sphere.Contains(point, epsilon); });
+    }
+
+    TEST_CLASS(TestSphere)
+    {
+    public:
+        TEST_METHOD(MinimalSingleAndTwoPoints)
+        {
+            {
+                Vector4 points[] = {{1.0f, 2.0f, 3.0f, 1.0f}};
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points, std::size(points));
+                Assert::IsTrue(ApproxEqual(Vector3(sphere.GetData()), Vector3(1.0f, 2.0f, 3.0f)));
+                Assert::IsTrue(ApproxEqual(sphere.GetRadius(), 0.0f));
+            }
+            {
+                Vector4 points[] = {{-1.0f, 0.0f, 0.0f, 1.0f}, {3.0f, 0.0f, 0.0f, 1.0f}};
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points, std::size(points));
+                Assert::IsTrue(ApproxEqual(Vector3(sphere.GetData()), Vector3(1.0f, 0.0f, 0.0f)));
+                Assert::IsTrue(ApproxEqual(sphere.GetRadius(), 2.0f));
+            }
+        }
+
+        TEST_METHOD(MinimalKnownShapes)
+        {
+            {
+                // Equilateral triangle, circumcircle is minimal
+                const float height = sqrt(3.0f) / 2.0f;
+                Vector4 points[] = {{-0.5f, 0.0f, 0.0f, 1.0f},
+                                    {0.5f, 0.0f, 0.0f, 1.0f},
+                                    {0.0f, height, 0.0f, 1.0f}};
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points, std::size(points));
+                Assert::IsTrue(ApproxEqual(sphere.GetRadius(), 1.0f / sqrt(3.0f)));
+            }
+            {
+                // Obtuse triangle, longest edge defines sphere
+                Vector4 points[] = {{-1.0f, 0.0f, 0.0f, 1.0f},
+                                    {1.0f, 0.0f, 0.0f, 1.0f},
+                                    {0.0f, 0.1f, 0.0f, 1.0f}};
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points, std::size(points));
+                Assert::IsTrue(ApproxEqual(Vector3(sphere.GetData()), Vector3(0.0f, 0.0f, 0.0f)));
+                Assert::IsTrue(ApproxEqual(sphere.GetRadius(), 1.0f));
+            }
+            {
+                // Regular tetrahedron
+                Vector4 points[] = {{1.0f, 1.0f, 1.0f, 1.0f},
+                                    {1.0f, -1.0f, -1.0f, 1.0f},
+                                    {-1.0f, 1.0f, -1.0f, 1.0f},
+                                    {-1.0f, -1.0f, 1.0f, 1.0f}};
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points, std::size(points));
+                Assert::IsTrue(ApproxEqual(Vector3(sphere.GetData()), Vector3(0.0f, 0.0f, 0.0f)));
+                Assert::IsTrue(ApproxEqual(sphere.GetRadius(), sqrt(3.0f)));
+            }
+            {
+                // Cube corners with inner points and duplicates
+                std::vector<Vector4> points;
+                for (int i = 0; i < 8; ++i)
+                {
+                    points.push_back(Vector4((i & 1) ? 3.0f : 1.0f, (i & 2) ? 3.0f : 1.0f,
+                                             (i & 4) ? 3.0f : 1.0f, 1.0f));
+                    points.push_back(Vector4(2.0f, 2.0f, 2.0f, 1.0f));
+                    points.push_back(points.front());
+                }
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points.data(), points.size());
+                Assert::IsTrue(ApproxEqual(Vector3(sphere.GetData()), Vector3(2.0f, 2.0f, 2.0f)));
+                Assert::IsTrue(ApproxEqual(sphere.GetRadius(), sqrt(3.0f)));
+            }
+            {
+                // Coplanar points on a circle
+                std::vector<Vector4> points;
+                for (int i = 0; i < 32; ++i)
+                {
+                    float angle = BLK_FLOAT_PI * 2.0f * i / 32.0f;
+                    points.push_back(Vector4(5.0f * cos(angle), 5.0f * sin(angle), 1.0f, 1.0f));
+                }
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points.data(), points.size());
+                Assert::IsTrue(ApproxEqual(Vector3(sphere.GetData()), Vector3(0.0f, 0.0f, 1.0f),
+                                           1e-4f));
+                Assert::IsTrue(ApproxEqual(sphere.GetRadius(), 5.0f, 1e-4f));
+            }
+        }
+
+        TEST_METHOD(MinimalContainsAllPoints)
+        {
+            std::mt19937 generator(42);
+            for (size_t count : {3, 10, 64, 1000, 20000})
+            {
+                std::vector<Vector4> points = GenerateRandomPoints(generator, count);
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points.data(), points.size());
+                Assert::IsTrue(ContainsAll(sphere, points));
+            }
+        }
+
+        TEST_METHOD(MinimalIsConservative)
+        {
+            // Points far from origin, so that rounding of center is large relative to radius
+            std::mt19937 generator(29);
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+            for (size_t count : {4, 100, 5000})
+            {
+                std::vector<Vector4> points(count);
+                for (auto& point : points)
+                {
+                    point = Vector4(1000.0f + distribution(generator),
+                                    -3000.0f + distribution(generator),
+                                    500.0f + distribution(generator), 1.0f);
+                }
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points.data(), points.size());
+                Assert::IsTrue(std::all_of(points.begin(), points.end(), [&](const Vector4& point) {
+                    return (sphere.GetData() - point).Length3Sqr() <= sphere.GetData().w();
+                }));
+            }
+        }
+
+        TEST_METHOD(MinimalNotLargerThanApproximate)
+        {
+            std::mt19937 generator(7);
+            for (size_t i = 0; i < 32; ++i)
+            {
+                std::vector<Vector4> points = GenerateRandomPoints(generator, 100);
+                Sphere minimal = Sphere::BuildMinimalBoundingSphere(points.data(), points.size());
+                Sphere approximate = Sphere::BuildBoundingSphere(points.data(), points.size());
+                Assert::IsTrue(ContainsAll(approximate, points));
+                Assert::IsTrue(minimal.GetRadius() <= approximate.GetRadius() * (1.0f + 1e-5f));
+            }
+        }
+
+        TEST_METHOD(MinimalIsMinimal)
+        {
+            // Minimal sphere has at least 2 points on its boundary, and moving center in any
+            // direction can't shrink it
+            std::mt19937 generator(1234);
+            for (size_t i = 0; i < 16; ++i)
+            {
+                std::vector<Vector4> points = GenerateRandomPoints(generator, 50);
+                Sphere sphere = Sphere::BuildMinimalBoundingSphere(points.data(), points.size());
+                const float radius = sphere.GetRadius();
+
+                size_t boundaryPoints = 0;
+                for (const auto& point : points)
+                {
+                    if (!sphere.Contains(point, -1e-3f * radius))
+                        ++boundaryPoints;
+                }
+                Assert::IsTrue(boundaryPoints >= 2);
+
+                const Vector4 offsets[] = {{1.0f, 0.0f, 0.0f, 0.0f},  {-1.0f, 0.0f, 0.0f, 0.0f},
+                                           {0.0f, 1.0f, 0.0f, 0.0f},  {0.0f, -1.0f, 0.0f, 0.0f},
+                                           {0.0f, 0.0f, 1.0f, 0.0f},  {0.0f, 0.0f, -1.0f, 0.0f}};
+                for (const auto& offset : offsets)
+                {
+                    Vector4 center = sphere.GetData() + offset * (radius * 1e-2f);
+                    float maxDistanceSqr = 0.0f;
+                    for (const auto& point : points)
+                    {
+                        maxDistanceSqr = std::max(maxDistanceSqr, (point - center).Length3Sqr());
+                    }
+                    Assert::IsTrue(sqrt(maxDistanceSqr) >= radius * (1.0f - 1e-5f));
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "BoolkaCommon/Algorithms/MultiViewCulling.h"
+
+// Random test data and reference implementations shared by unit tests and benchmarks
+
+namespace Boolka
+{
+
+    static const size_t gs_LightCount = 4;
+    static const size_t gs_CubeFaceCount = 6;
+    // Main view, sun and cube map faces of every light, same layout as BatchManager::ViewType
+    static const size_t gs_RenderViewCount = 2 + gs_LightCount * gs_CubeFaceCount;
+
+    struct RenderViews
+    {
+        Frustum views[gs_RenderViewCount];
+        MultiViewCulling::ViewGroup groups[gs_LightCount];
+    };
+
+    inline RenderViews BuildRandomRenderViews(std::mt19937& generator, float lightRange)
+    {
+        std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+        std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+
+        RenderViews result;
+
+        Matrix4x4 view = Matrix4x4::GetTranslation(position(generator), position(generator),
+                                                   position(generator)) *
+                         Matrix4x4::GetRotationY(angle(generator)) *
+                         Matrix4x4::GetRotationX(angle(generator) * 0.5f);
+        result.views[0] =
+            Frustum(view * Matrix4x4::CalculateProjPerspective(0.1f, 60.0f, 1.7f, 1.2f));
+
+        Matrix4x4 sunView = Matrix4x4::GetRotationY(angle(generator)) *
+                            Matrix4x4::GetRotationX(angle(generator) * 0.5f);
+        result.views[1] =
+            Frustum(sunView * Matrix4x4::CalculateProjOrtographic(-80.0f, 80.0f, 50.0f, 50.0f));
+
+        Matrix4x4 lightProj =
+            Matrix4x4::CalculateProjPerspective(0.1f, lightRange, 1.0f, BLK_FLOAT_PI / 2.0f);
+        for (size_t light = 0; light < gs_LightCount; ++light)
+        {
+            Vector4 lightPos{position(generator), position(generator), position(generator), 1.0f};
+            const size_t firstView = 2 + light * gs_CubeFaceCount;
+            for (size_t face = 0; face < gs_CubeFaceCount; ++face)
+            {
+                result.views[firstView + face] =
+                    Frustum(Matrix4x4::CalculateCubeMapView(face, lightPos) * lightProj);
+            }
+
+            Vector4 sphere = lightPos;
+            sphere.w() = lightRange;
+            result.groups[light] =
+                MultiViewCulling::ViewGroup{sphere, firstView, gs_CubeFaceCount};
+        }
+
+        return result;
+    }
+
+    inline std::vector<AABB> BuildRandomMultiViewBoxes(std::mt19937& generator, size_t count)
+    {
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::exponential_distribution<float> size(0.5f);
+
+        std::vector<AABB> result(count);
+        for (auto& box : result)
+        {
+            Vector4 min{position(generator), position(generator), position(generator), 1.0f};
+            Vector4 extent{size(generator), size(generator), size(generator), 0.0f};
+            if (generator() % 32 == 0)
+                extent = Vector4{};
+            box = AABB{min, min + extent};
+        }
+        return result;
+    }
+
+    inline FrustumCulling::AABBArray BuildMultiViewArray(const std::vector<AABB>& boxes)
+    {
+        FrustumCulling::AABBArray result;
+        result.Reserve(boxes.size());
+        for (const auto& box : boxes)
+            result.Add(box);
+        return result;
+    }
+
+    inline std::vector<unsigned char> BuildRandomBytes(std::mt19937& generator, size_t size)
+    {
+        std::uniform_int_distribution<int> distribution(0, 255);
+        std::vector<unsigned char> result(size);
+        for (unsigned char& value : result)
+            value = static_cast<unsigned char>(distribution(generator));
+        return result;
+    }
+
+    struct BVHTestMesh
+    {
+        std::vector<Vector3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // Small random triangles in a cube with a few large ones crossing it, like scene with
+    // detailed objects on top of large walls
+    inline BVHTestMesh BuildBVHTestMesh(std::mt19937& generator, size_t triangleCount)
+    {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> offset(-1.5f, 1.5f);
+
+        BVHTestMesh result;
+        for (size_t i = 0; i < triangleCount; ++i)
+        {
+            const float scale = i % 1000 == 0 ? 10.0f : 1.0f;
+            const Vector3 center{position(generator), position(generator), position(generator)};
+            for (size_t vertex = 0; vertex < 3; ++vertex)
+            {
+                result.indices.push_back(static_cast<uint32_t>(result.positions.size()));
+                result.positions.push_back(
+                    center + Vector3{offset(generator), offset(generator), offset(generator)} *
+                                 scale);
+            }
+        }
+        return result;
+    }
+
+    inline void BuildBVHTestRay(std::mt19937& generator, Vector3& origin, Vector3& direction)
+    {
+        std::uniform_real_distribution<float> position(-70.0f, 70.0f);
+        std::normal_distribution<float> component;
+        origin = Vector3{position(generator), position(generator), position(generator)};
+        direction = Vector3{component(generator), component(generator), component(generator)};
+        // Some rays are parallel to axis planes
+        if (generator() % 8 == 0)
+            direction[generator() % 3] = 0.0f;
+    }
+
+    inline Matrix4x4 BuildRandomAffineTransform(std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+        std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+        Matrix4x4 result = Matrix4x4::GetScale(scale(generator), scale(generator),
+                                               scale(generator)) *
+                           Matrix4x4::GetRotationX(angle(generator)) *
+                           Matrix4x4::GetRotationY(angle(generator));
+        // GetTranslation is meant for column vectors, translation row is set directly instead
+        result[3] = Vector4{position(generator), position(generator), position(generator), 1.0f};
+        return result;
+    }
+
+    inline std::vector<Vector3> BuildRandomPoints(std::mt19937& generator, size_t count)
+    {
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+        std::vector<Vector3> result(count);
+        for (auto& point : result)
+            point = Vector3{position(generator), position(generator), position(generator)};
+        return result;
+    }
+
+    inline AABB TransformAABBCorners(const AABB& box, const Matrix4x4& transform)
+    {
+        Vector4 resultMin{FLT_MAX, FLT_MAX, FLT_MAX, 1.0f};
+        Vector4 resultMax{-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.0f};
+        for (size_t corner = 0; corner < 8; ++corner)
+        {
+            Vector4 point{(corner & 1) ? box.GetMax().x() : box.GetMin().x(),
+                          (corner & 2) ? box.GetMax().y() : box.GetMin().y(),
+                          (corner & 4) ? box.GetMax().z() : box.GetMin().z(), 1.0f};
+            point = point * transform;
+            resultMin = Min(resultMin, point);
+            resultMax = Max(resultMax, point);
+        }
+        return AABB{resultMin, resultMax};
+    }
+
+    inline std::vector<AABB> BuildRandomTransformBoxes(std::mt19937& generator, size_t count)
+    {
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::exponential_distribution<float> size(0.2f);
+
+        std::vector<AABB> result(count);
+        for (auto& box : result)
+        {
+            Vector4 min{position(generator), position(generator), position(generator), 1.0f};
+            Vector4 extent{size(generator), size(generator), size(generator), 0.0f};
+            if (generator() % 8 == 0)
+                extent = Vector4{};
+            box = AABB{min, min + extent};
+        }
+        return result;
+    }
+
+    inline std::vector<float> BuildRandomDistances(std::mt19937& generator, size_t count)
+    {
+        std::uniform_real_distribution<float> distance(0.1f, 5000.0f);
+        std::vector<float> keys(count);
+        for (float& key : keys)
+            key = distance(generator);
+        return keys;
+    }
+
+    static const size_t gs_BatchLightCount = 4;
+    static const size_t gs_BatchCubeFaceCount = 6;
+    // Main view, sun and cube map faces of every light, same layout as BatchManager::ViewType
+    static const size_t gs_BatchViewCount = 2 + gs_BatchLightCount * gs_BatchCubeFaceCount;
+
+    struct BatchCullingViews
+    {
+        Frustum views[gs_BatchViewCount];
+        MultiViewCulling::ViewGroup groups[gs_BatchLightCount];
+    };
+
+    struct BatchCullingObjects
+    {
+        std::vector<AABB> boundingBoxes;
+        std::vector<Vector4> boundingSpheres;
+        size_t opaqueCount;
+    };
+
+    inline BatchCullingViews BuildRandomBatchCullingViews(std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+        std::uniform_real_distribution<float> angle(-BLK_FLOAT_PI, BLK_FLOAT_PI);
+        std::uniform_real_distribution<float> lightRange(5.0f, 25.0f);
+
+        BatchCullingViews result;
+
+        Matrix4x4 view = Matrix4x4::GetTranslation(position(generator), position(generator),
+                                                   position(generator)) *
+                         Matrix4x4::GetRotationY(angle(generator)) *
+                         Matrix4x4::GetRotationX(angle(generator) * 0.5f);
+        result.views[0] =
+            Frustum(view * Matrix4x4::CalculateProjPerspective(0.1f, 60.0f, 1.7f, 1.2f));
+
+        Matrix4x4 sunView = Matrix4x4::GetRotationY(angle(generator)) *
+                            Matrix4x4::GetRotationX(angle(generator) * 0.5f);
+        result.views[1] =
+            Frustum(sunView * Matrix4x4::CalculateProjOrtographic(-80.0f, 80.0f, 50.0f, 50.0f));
+
+        for (size_t light = 0; light < gs_BatchLightCount; ++light)
+        {
+            const float range = lightRange(generator);
+            Matrix4x4 lightProj =
+                Matrix4x4::CalculateProjPerspective(0.1f, range, 1.0f, BLK_FLOAT_PI / 2.0f);
+            Vector4 lightPos{position(generator), position(generator), position(generator), 1.0f};
+            const size_t firstView = 2 + light * gs_BatchCubeFaceCount;
+            for (size_t face = 0; face < gs_BatchCubeFaceCount; ++face)
+            {
+                result.views[firstView + face] =
+                    Frustum(Matrix4x4::CalculateCubeMapView(face, lightPos) * lightProj);
+            }
+
+            Vector4 sphere = lightPos;
+            sphere.w() = range;
+            result.groups[light] =
+                MultiViewCulling::ViewGroup{sphere, firstView, gs_BatchCubeFaceCount};
+        }
+
+        return result;
+    }
+
+    inline BatchCullingObjects BuildRandomBatchCullingObjects(std::mt19937& generator,
+                                                              size_t count, size_t opaqueCount)
+    {
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::exponential_distribution<float> size(0.5f);
+
+        BatchCullingObjects result;
+        result.boundingBoxes.resize(count);
+        result.boundingSpheres.resize(count);
+        result.opaqueCount = opaqueCount;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector4 min{position(generator), position(generator), position(generator), 1.0f};
+            Vector4 extent{size(generator), size(generator), size(generator), 0.0f};
+            // Some objects share position, so that sorting has equal keys
+            if (i != 0 && generator() % 16 == 0)
+            {
+                result.boundingBoxes[i] = result.boundingBoxes[i - 1];
+                result.boundingSpheres[i] = result.boundingSpheres[i - 1];
+                continue;
+            }
+            result.boundingBoxes[i] = AABB{min, min + extent};
+            Vector4 center = min + extent * 0.5f;
+            center.w() = extent.Length3Slow() * 0.5f;
+            result.boundingSpheres[i] = center;
+        }
+        return result;
+    }
+
+} // namespace Boolka
@@ -0,0 +1,434 @@
+#include "pch.h"
+
+#include "BoolkaCommon/Structures/WideVector.h"
+
+// clang-format mess up formating due to preprocessor class definition
+// clang-format off
+
+namespace Boolka
+{
+
+    static const size_t gs_WideLaneCount = 8;
+    static const size_t gs_WideInputCount = 1024;
+
+    // Calls function with every backend that current build supports
+    template <typename Function>
+    static void ForEachWideBackend(Function function)
+    {
+        function(WideBackendScalar{});
+#ifdef BLK_USE_SSE
+        function(WideBackendSSE{});
+#endif
+#if defined(BLK_USE_SSE) && defined(__AVX2__)
+        function(WideBackendAVX2{});
+#endif
+    }
+
+    static bool IsSameWideResult(float first, float second)
+    {
+        if (std::isnan(first) || std::isnan(second))
+            return std::isnan(first) && std::isnan(second);
+        return std::bit_cast<uint32_t>(first) == std::bit_cast<uint32_t>(second);
+    }
+
+    static float GetMaskLane(bool value)
+    {
+        return std::bit_cast<float>(value ? ~0u : 0u);
+    }
+
+    // Random values of different magnitudes mixed with special values
+    static std::vector<float> BuildWideFloatInput(std::mt19937& generator)
+    {
+        const float specialValues[] = {0.0f,
+                                       -0.0f,
+                                       1.0f,
+                                       -1.0f,
+                                       std::numeric_limits<float>::infinity(),
+                                       -std::numeric_limits<float>::infinity(),
+                                       std::numeric_limits<float>::quiet_NaN(),
+                                       std::numeric_limits<float>::denorm_min(),
+                                       std::numeric_limits<float>::max(),
+                                       -std::numeric_limits<float>::max(),
+                                       3e9f,
+                                       -3e9f};
+
+        std::uniform_real_distribution<float> mantissa(-1.0f, 1.0f);
+        std::uniform_int_distribution<int> exponent(-30, 30);
+        std::uniform_int_distribution<size_t> special(0, std::size(specialValues) * 8);
+
+        std::vector<float> result(gs_WideInputCount);
+        for (float& value : result)
+        {
+            const size_t specialIndex = special(generator);
+            if (specialIndex < std::size(specialValues))
+                value = specialValues[specialIndex];
+            else
+                value = ::ldexp(mantissa(generator), exponent(generator));
+        }
+        return result;
+    }
+
+    static std::vector<int32_t> BuildWideIntInput(std::mt19937& generator)
+    {
+        const int32_t specialValues[] = {0, 1, -1, INT32_MIN, INT32_MAX};
+        std::uniform_int_distribution<int32_t> value(INT32_MIN, INT32_MAX);
+        std::uniform_int_distribution<int32_t> smallValue(-1000, 1000);
+        std::uniform_int_distribution<size_t> kind(0, 15);
+
+        std::vector<int32_t> result(gs_WideInputCount);
+        for (int32_t& element : result)
+        {
+            const size_t elementKind = kind(generator);
+            if (elementKind < std::size(specialValues))
+                element = specialValues[elementKind];
+            else if (elementKind < 10)
+                element = smallValue(generator);
+            else
+                element = value(generator);
+        }
+        return result;
+    }
+
+    // Results of every float operation, lane by lane, calculated without wide types
+    static std::vector<float> CalculateReferenceFloatResults(const std::vector<float>& first,
+                                                             const std::vector<float>& second)
+    {
+        std::vector<float> result;
+        for (size_t i = 0; i < first.size(); ++i)
+        {
+            const float a = first[i];
+            const float b = second[i];
+            const uint32_t aBits = std::bit_cast<uint32_t>(a);
+            const uint32_t bBits = std::bit_cast<uint32_t>(b);
+            const bool isInIntRange = a >= -2147483648.0f && a < 2147483648.0f;
+
+            const float lanes[] = {
+                a + b,
+                a - b,
+                a * b,
+                a / b,
+                a < b ? a : b,
+                a > b ? a : b,
+                std::bit_cast<float>(aBits & 0x7FFFFFFFu),
+                ::sqrt(a),
+                std::bit_cast<float>(aBits ^ 0x80000000u),
+                GetMaskLane(a > b),
+                GetMaskLane(a < b),
+                GetMaskLane(a >= b),
+                GetMaskLane(a <= b),
+                GetMaskLane(a == b),
+                GetMaskLane(!(a == b)),
+                std::bit_cast<float>(aBits & bBits),
+                std::bit_cast<float>(aBits | bBits),
+                std::bit_cast<float>(aBits ^ bBits),
+                std::bit_cast<float>(~aBits & bBits),
+                std::signbit(b) ? a : b,
+                std::bit_cast<float>(isInIntRange ? static_cast<int32_t>(a) : INT32_MIN),
+            };
+            result.insert(result.end(), std::begin(lanes), std::end(lanes));
+        }
+        return result;
+    }
+
+    // Same operations and layout as CalculateReferenceFloatResults
+    template <typename Backend>
+    static std::vector<float> CalculateWideFloatResults(const std::vector<float>& first,
+                                                        const std::vector<float>& second)
+    {
+        using Float8 = Float8T<Backend>;
+
+        std::vector<float> result;
+        for (size_t i = 0; i < first.size(); i += gs_WideLaneCount)
+        {
+            const Float8 a = Float8::Load(first.data() + i);
+            const Float8 b = Float8::Load(second.data() + i);
+
+            const Float8 wideResults[] = {
+                a + b,
+                a - b,
+                a * b,
+                a / b,
+                a.Min(b),
+                a.Max(b),
+                a.Abs(),
+                a.Sqrt(),
+                -a,
+                a > b,
+                a < b,
+                a >= b,
+                a <= b,
+                a.EqualMask(b),
+                a.NotEqualMask(b),
+                a & b,
+                a | b,
+                a ^ b,
+                a.AndNot(b),
+                b.Select(a, b),
+                a.ToInt().AsFloat(),
+            };
+
+            float lanes[std::size(wideResults)][gs_WideLaneCount];
+            for (size_t j = 0; j < std::size(wideResults); ++j)
+                wideResults[j].Store(lanes[j]);
+            for (size_t lane = 0; lane < gs_WideLaneCount; ++lane)
+            {
+                for (size_t j = 0; j < std::size(wideResults); ++j)
+                    result.push_back(lanes[j][lane]);
+            }
+        }
+        return result;
+    }
+
+    static std::vector<int32_t> CalculateReferenceIntResults(const std::vector<int32_t>& first,
+                                                             const std::vector<int32_t>& second,
+                                                             int shift)
+    {
+        std::vector<int32_t> result;
+        for (size_t i = 0; i < first.size(); ++i)
+        {
+            const int32_t a = first[i];
+            const int32_t b = second[i];
+            const uint32_t aBits = static_cast<uint32_t>(a);
+            const uint32_t bBits = static_cast<uint32_t>(b);
+
+            const int32_t lanes[] = {
+                static_cast<int32_t>(aBits + bBits),
+                static_cast<int32_t>(aBits - bBits),
+                static_cast<int32_t>(aBits * bBits),
+                static_cast<int32_t>(0u - aBits),
+                std::min(a, b),
+                std::max(a, b),
+                a & b,
+                a | b,
+                a ^ b,
+                ~a,
+                static_cast<int32_t>(aBits << shift),
+                a >> shift,
+                static_cast<int32_t>(aBits >> shift),
+                a > b ? -1 : 0,
+                a < b ? -1 : 0,
+                a == b ? -1 : 0,
+                a != b ? -1 : 0,
+                b < 0 ? a : b,
+                std::bit_cast<int32_t>(static_cast<float>(a)),
+            };
+            result.insert(result.end(), std::begin(lanes), std::end(lanes));
+        }
+        return result;
+    }
+
+    template <typename Backend>
+    static std::vector<int32_t> CalculateWideIntResults(const std::vector<int32_t>& first,
+                                                        const std::vector<int32_t>& second,
+                                                        int shift)
+    {
+        using Int8 = Int8T<Backend>;
+
+        std::vector<int32_t> result;
+        for (size_t i = 0; i < first.size(); i += gs_WideLaneCount)
+        {
+            const Int8 a = Int8::Load(first.data() + i);
+            const Int8 b = Int8::Load(second.data() + i);
+
+            const Int8 wideResults[] = {
+                a + b,
+                a - b,
+                a * b,
+                -a,
+                a.Min(b),
+                a.Max(b),
+                a & b,
+                a | b,
+                a ^ b,
+                ~a,
+                a << shift,
+                a >> shift,
+                a.ShiftRightLogical(shift),
+                a > b,
+                a < b,
+                a.EqualMask(b),
+                a.NotEqualMask(b),
+                b.Select(a, b >> 31),
+                a.ToFloat().AsInt(),
+            };
+
+            int32_t lanes[std::size(wideResults)][gs_WideLaneCount];
+            for (size_t j = 0; j < std::size(wideResults); ++j)
+                wideResults[j].Store(lanes[j]);
+            for (size_t lane = 0; lane < gs_WideLaneCount; ++lane)
+            {
+                for (size_t j = 0; j < std::size(wideResults); ++j)
+                    result.push_back(lanes[j][lane]);
+            }
+        }
+        return result;
+    }
+
+    // Dot, cross and length of every lane, in Vector3x8 and Vector4x8 order
+    template <typename Backend>
+    static std::vector<float> CalculateWideVectorResults(const std::vector<float>& input)
+    {
+        using Vector3x8 = Vector3x8T<Backend>;
+        using Vector4x8 = Vector4x8T<Backend>;
+
+        std::vector<float> result;
+        const size_t stride = input.size() / 8;
+        for (size_t i = 0; i + gs_WideLaneCount <= stride; i += gs_WideLaneCount)
+        {
+            const float* data = input.data() + i;
+            const Vector4x8 a = Vector4x8::Load(data, data + stride, data + stride * 2,
+                                                data + stride * 3);
+            const Vector4x8 b = Vector4x8::Load(data + stride * 4, data + stride * 5,
+                                                data + stride * 6, data + stride * 7);
+            const Vector3x8 a3(a.x(), a.y(), a.z());
+            const Vector3x8 b3(b.x(), b.y(), b.z());
+
+            const Vector4x8 cross = a.Cross(b);
+            const Vector3x8 cross3 = a3.Cross(b3);
+            const Float8T<Backend> wideResults[] = {
+                a.Dot(b), a.LengthSqr(), cross.x(), cross.y(), cross.z(), cross.w(),
+                a3.Dot(b3), a3.LengthSqr(), cross3.x(), cross3.y(), cross3.z()};
+
+            float lanes[std::size(wideResults)][gs_WideLaneCount];
+            for (size_t j = 0; j < std::size(wideResults); ++j)
+                wideResults[j].Store(lanes[j]);
+            for (size_t lane = 0; lane < gs_WideLaneCount; ++lane)
+            {
+                for (size_t j = 0; j < std::size(wideResults); ++j)
+                    result.push_back(lanes[j][lane]);
+            }
+        }
+        return result;
+    }
+
+    TEST_CLASS(TestWideVector)
+    {
+    public:
+        TEST_METHOD(FloatOperationsMatchReference)
+        {
+            std::mt19937 generator(31);
+            const std::vector<float> first = BuildWideFloatInput(generator);
+            const std::vector<float> second = BuildWideFloatInput(generator);
+            const std::vector<float> reference = CalculateReferenceFloatResults(first, second);
+
+            ForEachWideBackend([&](auto backend) {
+                const std::vector<float> wide =
+                    CalculateWideFloatResults<decltype(backend)>(first, second);
+                Assert::AreEqual(reference.size(), wide.size());
+                for (size_t i = 0; i < reference.size(); ++i)
+                    Assert::IsTrue(IsSameWideResult(reference[i], wide[i]));
+            });
+        }
+
+        TEST_METHOD(IntOperationsMatchReference)
+        {
+            std::mt19937 generator(37);
+            const std::vector<int32_t> first = BuildWideIntInput(generator);
+            const std::vector<int32_t> second = BuildWideIntInput(generator);
+
+            for (int shift : {0, 1, 7, 31})
+            {
+                const std::vector<int32_t> reference =
+                    CalculateReferenceIntResults(first, second, shift);
+
+                ForEachWideBackend([&](auto backend) {
+                    Assert::IsTrue(reference ==
+                                   CalculateWideIntResults<decltype(backend)>(first, second,
+                                                                               shift));
+                });
+            }
+        }
+
+        TEST_METHOD(VectorOperationsMatchAcrossBackends)
+        {
+            std::mt19937 generator(41);
+            const std::vector<float> input = BuildWideFloatInput(generator);
+            const std::vector<float> reference =
+                CalculateWideVectorResults<WideBackendScalar>(input);
+
+            ForEachWideBackend([&](auto backend) {
+                const std::vector<float> wide =
+                    CalculateWideVectorResults<decltype(backend)>(input);
+                Assert::AreEqual(reference.size(), wide.size());
+                for (size_t i = 0; i < reference.size(); ++i)
+                    Assert::IsTrue(IsSameWideResult(reference[i], wide[i]));
+            });
+        }
+
+        TEST_METHOD(VectorOperationsMatchVector)
+        {
+            std::mt19937 generator(43);
+            std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+            ForEachWideBackend([&](auto backend) {
+                using Backend = decltype(backend);
+
+                Vector4 first[gs_WideLaneCount];
+                Vector4 second[gs_WideLaneCount];
+                float lanes[8][gs_WideLaneCount];
+                for (size_t i = 0; i < gs_WideLaneCount; ++i)
+                {
+                    for (size_t component = 0; component < 4; ++component)
+                    {
+                        first[i][component] = lanes[component][i] = distribution(generator);
+                        second[i][component] = lanes[component + 4][i] = distribution(generator);
+                    }
+                }
+
+                const Vector4x8T<Backend> a =
+                    Vector4x8T<Backend>::Load(lanes[0], lanes[1], lanes[2], lanes[3]);
+                const Vector4x8T<Backend> b =
+                    Vector4x8T<Backend>::Load(lanes[4], lanes[5], lanes[6], lanes[7]);
+                const Vector3x8T<Backend> a3(a.x(), a.y(), a.z());
+                const Vector3x8T<Backend> b3(b.x(), b.y(), b.z());
+                const Float8T<Backend> mask = a.x() < b.x();
+
+                for (size_t i = 0; i < gs_WideLaneCount; ++i)
+                {
+                    const Vector3 first3(first[i]);
+                    const Vector3 second3(second[i]);
+
+                    Assert::IsTrue(ApproxEqual(a.Dot(b)[i], first[i].Dot(second[i])));
+                    Assert::IsTrue(a.Cross(b).GetLane(i) == first[i].Cross(second[i]));
+                    Assert::IsTrue((a + b).GetLane(i) == first[i] + second[i]);
+                    Assert::IsTrue((a - b).GetLane(i) == first[i] - second[i]);
+                    Assert::IsTrue((a * b).GetLane(i) == first[i] * second[i]);
+                    Assert::IsTrue((a * b.x()).GetLane(i) == first[i] * second[i].x());
+                    Assert::IsTrue(a.Min(b).GetLane(i) == first[i].Min(second[i]));
+                    Assert::IsTrue(a.Max(b).GetLane(i) == first[i].Max(second[i]));
+
+                    const bool isFirstLess = first[i].x() < second[i].x();
+                    Assert::IsTrue(((mask.GetSignMask() >> i) & 1) == isFirstLess);
+                    Assert::IsTrue(a.Select(b, mask).GetLane(i) ==
+                                   (isFirstLess ? second[i] : first[i]));
+
+                    Assert::IsTrue(a3.Dot(b3)[i] == first3.Dot(second3));
+                    Assert::IsTrue(a3.Cross(b3).GetLane(i) == first3.Cross(second3));
+                    Assert::IsTrue((a3 - b3).GetLane(i) == first3 - second3);
+                    Assert::IsTrue(a3.Max(b3).GetLane(i) == first3.Max(second3));
+                }
+            });
+        }
+
+        TEST_METHOD(Broadcast)
+        {
+            ForEachWideBackend([&](auto backend) {
+                using Backend = decltype(backend);
+
+                const Vector4 value{1.0f, -2.0f, 3.0f, -4.0f};
+                const Vector4x8T<Backend> wide(value);
+                const Vector3x8T<Backend> wide3{Vector3(value)};
+                for (size_t i = 0; i < gs_WideLaneCount; ++i)
+                {
+                    Assert::IsTrue(wide.GetLane(i) == value);
+                    Assert::IsTrue(wide3.GetLane(i) == Vector3(value));
+                }
+
+                Assert::AreEqual(0u, Float8T<Backend>().GetSignMask());
+                Assert::AreEqual(0xFFu, Float8T<Backend>(-1.0f).GetSignMask());
+                Assert::AreEqual(0xFFu, Int8T<Backend>(-1).GetSignMask());
+                Assert::AreEqual(5, Int8T<Backend>(5)[7]);
+            });
+        }
+    };
+}
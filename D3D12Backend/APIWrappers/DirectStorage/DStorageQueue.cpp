@@ -124,6 +124,22 @@ namespace Boolka
         m_Queue->EnqueueRequest(&request);
     }
 
+    void DStorageQueue::EnququeRead(DStorageFile& file, size_t srcOffset, size_t srcSize,
+                                    void* destination)
+    {
+        BLK_ASSERT(m_Queue != nullptr);
+        DSTORAGE_REQUEST request{};
+        request.Options.SourceType = DSTORAGE_REQUEST_SOURCE_FILE;
+        request.Options.DestinationType = DSTORAGE_REQUEST_DESTINATION_MEMORY;
+        request.Source.File.Source = file.Get();
+        request.Source.File.Offset = srcOffset;
+        request.Source.File.Size = checked_narrowing_cast<UINT32>(srcSize);
+        request.Destination.Memory.Buffer = destination;
+        request.Destination.Memory.Size = checked_narrowing_cast<UINT32>(srcSize);
+        request.UncompressedSize = checked_narrowing_cast<UINT32>(srcSize);
+        m_Queue->EnqueueRequest(&request);
+    }
+
     void DStorageQueue::EnququeRead(DStorageFile& file, size_t srcOffset, size_t srcSize,
                                     Texture2D& texture, UINT subresourceIndex, UINT right,
                                     UINT bottom, UINT left /*= 0*/, UINT top /*= 0*/)
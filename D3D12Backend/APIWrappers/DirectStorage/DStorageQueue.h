@@ -33,6 +33,7 @@ namespace Boolka
         void EnququeRead(const MemoryBlock& memory, Buffer& buffer, size_t dstOffset = 0);
         void EnququeRead(DStorageFile& file, size_t srcOffset, size_t srcSize, Buffer& buffer,
                          size_t dstOffset);
+        void EnququeRead(DStorageFile& file, size_t srcOffset, size_t srcSize, void* destination);
         void EnququeRead(DStorageFile& file, size_t srcOffset, size_t srcSize, Texture2D& texture,
                          UINT subresourceIndex, UINT right, UINT bottom, UINT left = 0,
                          UINT top = 0);
@@ -7,7 +7,8 @@
 namespace Boolka
 {
     void BottomLevelAS::GetSizes(Device& device, UINT vertexCount, UINT vertexStride,
-                                 UINT indexCount, UINT64& outScratchSize, UINT64& outBLASSize)
+                                 const UINT* indexCounts, UINT geometryCount,
+                                 UINT64& outScratchSize, UINT64& outBLASSize)
     {
         // ID3D12Device5::GetRaytracingAccelerationStructurePrebuildInfo may check which pointers
         // are NULL when calculating required size, but it's not allowed to actually use that
@@ -16,24 +17,28 @@ namespace Boolka
         // https://docs.microsoft.com/en-us/windows/win32/api/d3d12/nf-d3d12-id3d12device5-getraytracingaccelerationstructureprebuildinfo
         const D3D12_GPU_VIRTUAL_ADDRESS dummyNotNullPointer = 0x1;
 
-        D3D12_RAYTRACING_GEOMETRY_DESC geometryDesc = {};
-        geometryDesc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
-        geometryDesc.Triangles.IndexBuffer = dummyNotNullPointer;
-        geometryDesc.Triangles.IndexCount = indexCount;
-        geometryDesc.Triangles.IndexFormat = DXGI_FORMAT_R16_UINT;
-        geometryDesc.Triangles.Transform3x4 = 0;
-        geometryDesc.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
-        geometryDesc.Triangles.VertexCount = vertexCount;
-        geometryDesc.Triangles.VertexBuffer.StartAddress = dummyNotNullPointer;
-        geometryDesc.Triangles.VertexBuffer.StrideInBytes = vertexStride;
+        std::vector<D3D12_RAYTRACING_GEOMETRY_DESC> geometryDescs(geometryCount);
+        for (UINT i = 0; i < geometryCount; ++i)
+        {
+            D3D12_RAYTRACING_GEOMETRY_DESC& geometryDesc = geometryDescs[i];
+            geometryDesc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
+            geometryDesc.Triangles.IndexBuffer = dummyNotNullPointer;
+            geometryDesc.Triangles.IndexCount = indexCounts[i];
+            geometryDesc.Triangles.IndexFormat = DXGI_FORMAT_R16_UINT;
+            geometryDesc.Triangles.Transform3x4 = 0;
+            geometryDesc.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+            geometryDesc.Triangles.VertexCount = vertexCount;
+            geometryDesc.Triangles.VertexBuffer.StartAddress = dummyNotNullPointer;
+            geometryDesc.Triangles.VertexBuffer.StrideInBytes = vertexStride;
+        }
 
         D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS inputsDesc = {};
         inputsDesc.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
         inputsDesc.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE |
                            D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION;
-        inputsDesc.NumDescs = 1;
+        inputsDesc.NumDescs = geometryCount;
         inputsDesc.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL;
-        inputsDesc.pGeometryDescs = &geometryDesc;
+        inputsDesc.pGeometryDescs = geometryDescs.data();
 
         D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO prebuiltInfo = {};
 
@@ -51,29 +56,32 @@ namespace Boolka
                                    D3D12_GPU_VIRTUAL_ADDRESS destination,
                                    D3D12_GPU_VIRTUAL_ADDRESS scratchBuffer,
                                    D3D12_GPU_VIRTUAL_ADDRESS vertexBuffer, UINT vertexCount,
-                                   UINT vertexStride, D3D12_GPU_VIRTUAL_ADDRESS indexBuffer,
-                                   UINT indexCount,
+                                   UINT vertexStride, const D3D12_GPU_VIRTUAL_ADDRESS* indexBuffers,
+                                   const UINT* indexCounts, UINT geometryCount,
                                    D3D12_GPU_VIRTUAL_ADDRESS postBuildDataBuffer /*= NULL*/)
     {
-
-        D3D12_RAYTRACING_GEOMETRY_DESC geometryDesc = {};
-        geometryDesc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
-        geometryDesc.Triangles.IndexBuffer = indexBuffer;
-        geometryDesc.Triangles.IndexCount = indexCount;
-        geometryDesc.Triangles.IndexFormat = DXGI_FORMAT_R32_UINT;
-        geometryDesc.Triangles.Transform3x4 = 0;
-        geometryDesc.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
-        geometryDesc.Triangles.VertexCount = vertexCount;
-        geometryDesc.Triangles.VertexBuffer.StartAddress = vertexBuffer;
-        geometryDesc.Triangles.VertexBuffer.StrideInBytes = vertexStride;
+        std::vector<D3D12_RAYTRACING_GEOMETRY_DESC> geometryDescs(geometryCount);
+        for (UINT i = 0; i < geometryCount; ++i)
+        {
+            D3D12_RAYTRACING_GEOMETRY_DESC& geometryDesc = geometryDescs[i];
+            geometryDesc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
+            geometryDesc.Triangles.IndexBuffer = indexBuffers[i];
+            geometryDesc.Triangles.IndexCount = indexCounts[i];
+            geometryDesc.Triangles.IndexFormat = DXGI_FORMAT_R32_UINT;
+            geometryDesc.Triangles.Transform3x4 = 0;
+            geometryDesc.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+            geometryDesc.Triangles.VertexCount = vertexCount;
+            geometryDesc.Triangles.VertexBuffer.StartAddress = vertexBuffer;
+            geometryDesc.Triangles.VertexBuffer.StrideInBytes = vertexStride;
+        }
 
         D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS inputsDesc = {};
         inputsDesc.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
         inputsDesc.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE |
                            D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION;
-        inputsDesc.NumDescs = 1;
+        inputsDesc.NumDescs = geometryCount;
         inputsDesc.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL;
-        inputsDesc.pGeometryDescs = &geometryDesc;
+        inputsDesc.pGeometryDescs = geometryDescs.data();
 
         D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC buildDesc = {};
         buildDesc.DestAccelerationStructureData = destination;
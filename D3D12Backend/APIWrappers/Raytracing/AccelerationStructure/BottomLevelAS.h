@@ -8,14 +8,16 @@ namespace Boolka
     class BottomLevelAS
     {
     public:
-        static void GetSizes(Device& device, UINT vertexCount, UINT vertexStride, UINT indexCount,
-                             UINT64& outScratchSize, UINT64& outBLASSize);
+        // Every geometry shares vertex buffer and has its own index buffer range
+        static void GetSizes(Device& device, UINT vertexCount, UINT vertexStride,
+                             const UINT* indexCounts, UINT geometryCount, UINT64& outScratchSize,
+                             UINT64& outBLASSize);
         static void Initialize(ComputeCommandList& commandList,
                                D3D12_GPU_VIRTUAL_ADDRESS destination,
                                D3D12_GPU_VIRTUAL_ADDRESS scratchBuffer,
                                D3D12_GPU_VIRTUAL_ADDRESS vertexBuffer, UINT vertexCount,
-                               UINT vertexStride, D3D12_GPU_VIRTUAL_ADDRESS indexBuffer,
-                               UINT indexCount,
+                               UINT vertexStride, const D3D12_GPU_VIRTUAL_ADDRESS* indexBuffers,
+                               const UINT* indexCounts, UINT geometryCount,
                                D3D12_GPU_VIRTUAL_ADDRESS postBuildDataBuffer = NULL);
     };
 
@@ -5,6 +5,7 @@
 #include "APIWrappers/CommandList/CommandList.h"
 #include "BoolkaCommon/Structures/Frustum.h"
 #include "Containers/Scene.h"
+#include "Containers/Streaming/SceneData.h"
 #include "Contexts/RenderFrameContext.h"
 
 namespace Boolka
@@ -13,30 +14,45 @@ namespace Boolka
     BLK_DEFINE_ENUM_OPERATORS(BatchManager::BatchType);
     BLK_DEFINE_ENUM_OPERATORS(BatchManager::ViewType);
 
+    // Same layout as GPUCulling buffer, per view visible object count, meshlet counter and pairs
+    // of object index and distance to near plane
+    static const UINT gs_CulledObjectsViewElements = (Scene::MaxObjectCount + 1) * 2;
+    static const UINT64 gs_CulledObjectsUploadBufferSize =
+        sizeof(uint) * gs_CulledObjectsViewElements * BLK_RENDER_VIEW_COUNT;
+
     bool BatchManager::Initialize(Device& device, const Scene& scene,
+                                  const SceneData::CPUObjectHeader* cpuObjects,
                                   RenderEngineContext& engineContext)
     {
-        const UINT opaqueOffset = 0;
+        const UINT objectCount = scene.GetObjectCount();
         const UINT opaqueCount = scene.GetOpaqueObjectCount();
-        const UINT transparentOffset = opaqueCount;
-        const UINT trasparentCount = scene.GetObjectCount() - opaqueCount;
+        BLK_ASSERT(objectCount <= Scene::MaxObjectCount);
 
-        for (BatchType batch = BatchType::Opaque; batch < BatchType::Count; ++batch)
+        std::vector<AABB> boundingBoxes(objectCount);
+        std::vector<Vector4> boundingSpheres(objectCount);
+        for (UINT i = 0; i < objectCount; ++i)
         {
-            auto& batchData = m_Batches[static_cast<size_t>(batch)];
-
-            // switch (batch)
-            //{
-            // case BatchType::Transparent:
-            //     batchData.objectCount = trasparentCount;
-            //     batchData.objectOffset = transparentOffset;
-            //     break;
-            // default:
-            batchData.objectCount = opaqueCount;
-            batchData.objectOffset = opaqueOffset;
-            //    break;
-            //}
+            const SceneData::CPUObjectHeader& cpuObject = cpuObjects[i];
+            boundingBoxes[i] = AABB(Vector4(cpuObject.boundingBoxMin[0],
+                                            cpuObject.boundingBoxMin[1],
+                                            cpuObject.boundingBoxMin[2], 1.0f),
+                                    Vector4(cpuObject.boundingBoxMax[0],
+                                            cpuObject.boundingBoxMax[1],
+                                            cpuObject.boundingBoxMax[2], 1.0f));
+            boundingSpheres[i] =
+                Vector4(std::begin(cpuObject.boundingSphere), std::end(cpuObject.boundingSphere));
         }
+        m_Culling.Initialize(boundingBoxes.data(), boundingSpheres.data(), objectCount,
+                             opaqueCount);
+
+        BLK_INITIALIZE_ARRAY(m_CulledObjectsUploadBuffers, device,
+                             gs_CulledObjectsUploadBufferSize);
+
+        // Batches are filled by PrepareBatches every frame
+        for (BatchType batch = BatchType::Opaque; batch < BatchType::Count; ++batch)
+            m_Batches[static_cast<size_t>(batch)].objectCount = 0;
+        m_ViewCount = 0;
+        m_MaxVisibleObjectCount = 0;
 
         D3D12_INDIRECT_ARGUMENT_DESC arguments[2]{};
 
@@ -63,10 +79,73 @@ namespace Boolka
     void BatchManager::Unload()
     {
         m_CommandSignature.Unload();
+        BLK_UNLOAD_ARRAY(m_CulledObjectsUploadBuffers);
+        m_Culling.Unload();
+        m_ViewCount = 0;
+        m_MaxVisibleObjectCount = 0;
     }
 
-    bool BatchManager::PrepareBatches(const RenderFrameContext& frameContext, const Scene& scene)
+    bool BatchManager::PrepareBatches(const RenderFrameContext& frameContext)
     {
+        BLK_CPU_SCOPE("BatchManager::PrepareBatches");
+
+        const LightContainer& lightContainer = frameContext.GetLightContainer();
+        const auto& lights = lightContainer.GetLights();
+        const auto& lightViewProjMatricies = lightContainer.GetViewProjMatrices();
+        BLK_ASSERT(lightViewProjMatricies.size() == lights.size());
+
+        const size_t viewCount = static_cast<size_t>(ViewType::ShadowMapLight0) +
+                                 lights.size() * BLK_TEXCUBE_FACE_COUNT;
+        BLK_ASSERT(viewCount <= static_cast<size_t>(ViewType::Count));
+
+        Frustum views[static_cast<size_t>(ViewType::Count)];
+        views[static_cast<size_t>(ViewType::MainView)] = Frustum(frameContext.GetViewProjMatrix());
+        views[static_cast<size_t>(ViewType::ShadowMapSun)] =
+            Frustum(lightContainer.GetSunViewProj());
+
+        // Faces of point light share light range, objects outside of it can't cast shadows on
+        // lit surfaces
+        MultiViewCulling::ViewGroup lightGroups[BLK_MAX_LIGHT_COUNT];
+        for (size_t i = 0; i < lights.size(); ++i)
+        {
+            const size_t firstView =
+                static_cast<size_t>(ViewType::ShadowMapLight0) + i * BLK_TEXCUBE_FACE_COUNT;
+            for (size_t j = 0; j < BLK_TEXCUBE_FACE_COUNT; ++j)
+                views[firstView + j] = Frustum(lightViewProjMatricies[i][j]);
+
+            lightGroups[i] = MultiViewCulling::ViewGroup{
+                Vector4(lights[i].worldPos, lights[i].farZ), firstView, BLK_TEXCUBE_FACE_COUNT};
+        }
+
+        m_Culling.Cull(views, viewCount, lightGroups, lights.size());
+
+        // Only opaque objects are drawn for now, transparent lists are kept in m_Culling
+        auto* uploadData =
+            static_cast<uint*>(m_CulledObjectsUploadBuffers[frameContext.GetFrameIndex()].Map());
+        m_MaxVisibleObjectCount = 0;
+        for (size_t view = 0; view < viewCount; ++view)
+        {
+            const UINT visibleCount = m_Culling.GetOpaqueCount(view);
+            const uint32_t* objects = m_Culling.GetOpaqueObjects(view);
+            const float* distances = m_Culling.GetOpaqueDistances(view);
+
+            uint* viewData = uploadData + view * gs_CulledObjectsViewElements;
+            viewData[0] = visibleCount;
+            viewData[1] = 0;
+            for (UINT i = 0; i < visibleCount; ++i)
+            {
+                viewData[2 + i * 2] = objects[i];
+                viewData[2 + i * 2 + 1] = asuint(distances[i]);
+            }
+
+            m_Batches[view].objectCount = visibleCount;
+            m_MaxVisibleObjectCount = std::max(m_MaxVisibleObjectCount, visibleCount);
+        }
+        m_CulledObjectsUploadBuffers[frameContext.GetFrameIndex()].Unmap();
+        for (size_t view = viewCount; view < static_cast<size_t>(ViewType::Count); ++view)
+            m_Batches[view].objectCount = 0;
+        m_ViewCount = static_cast<UINT>(viewCount);
+
         return true;
     }
 
@@ -85,8 +164,10 @@ namespace Boolka
         UINT64 viewIndex = static_cast<UINT64>(batch);
         UINT64 commandBufferOffset = (((Scene::Limits::MaxObjectCount + 31) / 32) * viewIndex) *
                                      sizeof(HLSLShared::CullingCommandSignature);
-        UINT objectCount = engineContext.GetScene().GetOpaqueObjectCount();
-        UINT callCount = BLK_INT_DIVIDE_CEIL(objectCount, 32);
+        // Commands are only generated for visible objects
+        UINT callCount = BLK_INT_DIVIDE_CEIL(batchData.objectCount, 32);
+        if (callCount == 0)
+            return true;
 
         commandList->ExecuteIndirect(m_CommandSignature.Get(), callCount, commandBuffer.Get(),
                                      commandBufferOffset, nullptr, 0);
@@ -94,4 +175,41 @@ namespace Boolka
         return true;
     }
 
+    UploadBuffer& BatchManager::GetCulledObjectsUploadBuffer(UINT frameIndex)
+    {
+        BLK_ASSERT(frameIndex < BLK_IN_FLIGHT_FRAMES);
+        return m_CulledObjectsUploadBuffers[frameIndex];
+    }
+
+    UINT BatchManager::GetCulledObjectsViewSize() const
+    {
+        return sizeof(uint) * gs_CulledObjectsViewElements;
+    }
+
+    UINT BatchManager::GetViewCount() const
+    {
+        return m_ViewCount;
+    }
+
+    UINT BatchManager::GetVisibleObjectCount(ViewType view) const
+    {
+        BLK_ASSERT(view < ViewType::Count);
+        return m_Batches[static_cast<size_t>(view)].objectCount;
+    }
+
+    UINT BatchManager::GetMaxVisibleObjectCount() const
+    {
+        return m_MaxVisibleObjectCount;
+    }
+
+    UINT BatchManager::GetTransparentCount(ViewType view) const
+    {
+        return m_Culling.GetTransparentCount(static_cast<size_t>(view));
+    }
+
+    const UINT* BatchManager::GetTransparentObjects(ViewType view) const
+    {
+        return m_Culling.GetTransparentObjects(static_cast<size_t>(view));
+    }
+
 } // namespace Boolka
@@ -1,8 +1,16 @@
 #pragma once
 
+#include "APIWrappers/Resources/Buffers/UploadBuffer.h"
+#include "BoolkaCommon/Algorithms/BatchCulling.h"
+
 namespace Boolka
 {
 
+    namespace SceneData
+    {
+        struct CPUObjectHeader;
+    }
+
     class CommandList;
     class Scene;
     class RenderFrameContext;
@@ -30,29 +38,41 @@ namespace Boolka
         BatchManager() = default;
         ~BatchManager() = default;
 
-        bool Initialize(Device& device, const Scene& scene, RenderEngineContext& engineContext);
+        bool Initialize(Device& device, const Scene& scene,
+                        const SceneData::CPUObjectHeader* cpuObjects,
+                        RenderEngineContext& engineContext);
         void Unload();
 
-        bool PrepareBatches(const RenderFrameContext& frameContext, const Scene& scene);
+        // Culls objects against every view on CPU and uploads sorted visible opaque objects in
+        // GPUCulling buffer layout, so that GPU only generates commands for visible objects
+        bool PrepareBatches(const RenderFrameContext& frameContext);
 
         bool Render(CommandList& commandList, RenderContext& renderContext, BatchType batch);
 
+        // Culled objects of current frame, to be copied to GPUCulling buffer
+        [[nodiscard]] UploadBuffer& GetCulledObjectsUploadBuffer(UINT frameIndex);
+        [[nodiscard]] UINT GetCulledObjectsViewSize() const;
+        [[nodiscard]] UINT GetViewCount() const;
+        [[nodiscard]] UINT GetVisibleObjectCount(ViewType view) const;
+        [[nodiscard]] UINT GetMaxVisibleObjectCount() const;
+
+        // Visible transparent objects of view sorted back to front
+        [[nodiscard]] UINT GetTransparentCount(ViewType view) const;
+        [[nodiscard]] const UINT* GetTransparentObjects(ViewType view) const;
+
     private:
         struct [[nodiscard]] DrawData
         {
-            UINT objectOffset;
             UINT objectCount;
         };
 
-        // used to sort objects by distance
-        struct [[nodiscard]] SortingData
-        {
-            UINT objectIndex;
-            float distance;
-        };
-
         DrawData m_Batches[static_cast<size_t>(BatchType::Count)];
         CommandSignature m_CommandSignature;
+
+        BatchCulling m_Culling;
+        UploadBuffer m_CulledObjectsUploadBuffers[BLK_IN_FLIGHT_FRAMES];
+        UINT m_ViewCount;
+        UINT m_MaxVisibleObjectCount;
     };
 
     BLK_DECLARE_ENUM_OPERATORS(BatchManager::BatchType);
@@ -2,6 +2,8 @@
 
 #include "LightContainer.h"
 
+#include "BoolkaCommon/Structures/FastMath.h"
+
 namespace Boolka
 {
 
@@ -59,7 +61,8 @@ namespace Boolka
 
     void LightContainer::Update(float deltaTime)
     {
-        m_CurrentRotation += deltaTime * 0.25f;
+        // Kept in one period, so that FastMath::SinCos argument stays within its error bound
+        m_CurrentRotation = fmod(m_CurrentRotation + deltaTime * 0.25f, 2.0f * BLK_FLOAT_PI);
         UpdateLights();
         UpdateSun();
     }
@@ -86,7 +89,9 @@ namespace Boolka
         for (size_t i = 0; i < m_Lights.size(); ++i)
         {
             float rotation = m_CurrentRotation + BLK_FLOAT_PI / 2.0f * i;
-            Vector3 fromCenter = {distance * sin(rotation), distance * cos(rotation), 0.0f};
+            float sinRotation, cosRotation;
+            FastMath::SinCos(rotation, sinRotation, cosRotation);
+            Vector3 fromCenter = {distance * sinRotation, distance * cosRotation, 0.0f};
             Vector3 worldPos = center + fromCenter;
             m_Lights[i].worldPos = worldPos;
             m_Lights[i].color = colors[i];
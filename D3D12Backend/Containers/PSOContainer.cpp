@@ -100,12 +100,6 @@ namespace Boolka
         DebugFileReader::FreeMemory(AS);
         DebugFileReader::FreeMemory(MS);
 
-        CS = DebugFileReader::ReadFile("ObjectCullingComputeShader.cso");
-        res = GetPSO(ComputePSO::ObjectCulling)
-                  .Initialize(device, L"ComputePSO::ObjectCulling", defaultRootSig, CS);
-        BLK_ASSERT_VAR(res);
-        DebugFileReader::FreeMemory(CS);
-
         CS = DebugFileReader::ReadFile("CullingCommandBufferGenerateComputeShader.cso");
         res = GetPSO(ComputePSO::CullingCommandBufferGeneration)
                   .Initialize(device, L"ComputePSO::CullingCommandBufferGeneration", defaultRootSig,
@@ -26,7 +26,6 @@ namespace Boolka
 
         enum class ComputePSO
         {
-            ObjectCulling,
             CullingCommandBufferGeneration,
 #ifdef BLK_ENABLE_STATS
             CullingDebugReadback,
@@ -16,9 +16,16 @@ namespace Boolka
     {
         BLK_CPU_SCOPE("RTASContainer::Initialize");
 
-        m_ScratchBufferOffsets.resize(headerWrapper.header->opaqueCount);
-        m_BuildOffsets.resize(headerWrapper.header->opaqueCount);
-        m_CopyOffsets.resize(headerWrapper.header->opaqueCount);
+        const auto& dataHeader = *headerWrapper.header;
+        const size_t blasCount = dataHeader.rtBLASCount;
+
+        g_WDebugOutput << "BLAS count: " << blasCount
+                       << ", geometry count: " << dataHeader.rtGeometryCount
+                       << ", instance count: " << dataHeader.rtInstanceCount << std::endl;
+
+        m_ScratchBufferOffsets.resize(blasCount);
+        m_BuildOffsets.resize(blasCount);
+        m_CopyOffsets.resize(blasCount);
 
 #ifdef BLK_ENABLE_RTAS_CACHE
         MemoryBlock rtCacheheaderWrapper{};
@@ -99,22 +106,62 @@ namespace Boolka
         }
     }
 
+    // BLAS grouping is computed by converter, every TLAS instance points to the first geometry of
+    // its BLAS through InstanceID
+    void RTASContainer::InitializeInstanceDescs(
+        D3D12_RAYTRACING_INSTANCE_DESC* instanceDescs,
+        const SceneDataReader::HeaderWrapper& headerWrapper)
+    {
+        const auto* objects = headerWrapper.cpuObjectHeaders;
+        const auto* blases = headerWrapper.rtBLASHeaders;
+        const auto* instances = headerWrapper.rtInstanceHeaders;
+        const UINT instanceCount = headerWrapper.header->rtInstanceCount;
+
+        for (UINT i = 0; i < instanceCount; ++i)
+        {
+            const auto& instance = instances[i];
+            const auto& object = objects[instance.objectIndex];
+
+            D3D12_RAYTRACING_INSTANCE_DESC& instanceDesc = instanceDescs[i];
+            instanceDesc = {};
+            static_assert(sizeof(instanceDesc.Transform) == sizeof(object.instanceTransform));
+            memcpy(instanceDesc.Transform, object.instanceTransform,
+                   sizeof(instanceDesc.Transform));
+
+            instanceDesc.InstanceID = blases[instance.blasIndex].firstGeometry;
+            instanceDesc.InstanceMask = 1;
+            instanceDesc.InstanceContributionToHitGroupIndex = 0;
+            instanceDesc.Flags = D3D12_RAYTRACING_INSTANCE_FLAG_TRIANGLE_FRONT_COUNTERCLOCKWISE;
+            instanceDesc.AccelerationStructure = m_CopyOffsets[instance.blasIndex];
+        }
+    }
+
     void RTASContainer::PrecalculateAS(Device& device,
                                        const SceneDataReader::HeaderWrapper& headerWrapper)
     {
-        const auto* objects = headerWrapper.cpuObjectHeaders;
+        const auto* geometries = headerWrapper.rtGeometryHeaders;
+        const auto* blases = headerWrapper.rtBLASHeaders;
         const auto& dataHeader = *headerWrapper.header;
-        const UINT objectCount = dataHeader.opaqueCount;
+        const UINT instanceCount = dataHeader.rtInstanceCount;
+        const size_t blasCount = dataHeader.rtBLASCount;
 
         UINT64 scratchSize = 0;
         UINT64 asSize = 0;
-        for (size_t i = 0; i < objectCount; ++i)
+        std::vector<UINT> indexCounts;
+        for (size_t i = 0; i < blasCount; ++i)
         {
             UINT vertexSize = 16;
             UINT64 currentScratchSize = 0;
             UINT64 currentASSize = 0;
+            const auto& blas = blases[i];
+            indexCounts.resize(blas.geometryCount);
+            for (UINT j = 0; j < blas.geometryCount; ++j)
+            {
+                indexCounts[j] = geometries[blas.firstGeometry + j].rtIndexCount;
+            }
             BottomLevelAS::GetSizes(device, dataHeader.vertex1Size / vertexSize, vertexSize,
-                                    objects[i].rtIndexCount, currentScratchSize, currentASSize);
+                                    indexCounts.data(), blas.geometryCount, currentScratchSize,
+                                    currentASSize);
             m_ScratchBufferOffsets[i] = scratchSize;
             m_BuildOffsets[i] = asSize;
             scratchSize += currentScratchSize;
@@ -123,10 +170,10 @@ namespace Boolka
 
         UINT64 tlasScratchSize;
         UINT64 tlasSize;
-        TopLevelAS::GetSizes(device, objectCount, tlasScratchSize, tlasSize);
+        TopLevelAS::GetSizes(device, instanceCount, tlasScratchSize, tlasSize);
         scratchSize = std::max(scratchSize, tlasScratchSize);
 
-        UINT64 tlasParametersSize = sizeof(D3D12_RAYTRACING_INSTANCE_DESC) * objectCount;
+        UINT64 tlasParametersSize = sizeof(D3D12_RAYTRACING_INSTANCE_DESC) * instanceCount;
 
         m_TLASParametersUploadBuffer.Initialize(device, tlasParametersSize);
         m_TLASParametersBuffer.Initialize(device, tlasParametersSize, D3D12_HEAP_TYPE_DEFAULT,
@@ -158,7 +205,7 @@ namespace Boolka
             sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC);
 #endif
 
-        static const size_t postBuildInfoSize = postBuildInfoElementSize * objectCount;
+        const size_t postBuildInfoSize = postBuildInfoElementSize * blasCount;
         m_PostBuildDataBuffer.Initialize(device, postBuildInfoSize, D3D12_HEAP_TYPE_DEFAULT,
                                          D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
                                          D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
@@ -177,8 +224,9 @@ namespace Boolka
         BLK_CPU_SCOPE("RTASContainer::BuildAS");
 
         const auto& dataHeader = *headerWrapper.header;
-        const UINT objectCount = dataHeader.opaqueCount;
-        const auto* objects = headerWrapper.cpuObjectHeaders;
+        const size_t blasCount = dataHeader.rtBLASCount;
+        const auto* geometries = headerWrapper.rtGeometryHeaders;
+        const auto* blases = headerWrapper.rtBLASHeaders;
         UINT64 buildBufferAddress = m_BuildBuffer->GetGPUVirtualAddress();
         UINT64 scratchBufferAddress = m_ASBuildScratchBuffer->GetGPUVirtualAddress();
         UINT64 vertexBufferAddress = vertexBuffer->GetGPUVirtualAddress();
@@ -188,27 +236,36 @@ namespace Boolka
         {
             BLK_GPU_SCOPE(initCommandList, "Scene::BuildAS");
             {
-                for (size_t i = 0; i < objectCount; ++i)
+                std::vector<UINT64> indexBufferAddresses;
+                std::vector<UINT> indexCounts;
+                for (size_t i = 0; i < blasCount; ++i)
                 {
                     UINT64 postBuildDataOffset =
                         sizeof(
                             D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC) *
                         i;
+                    const auto& blas = blases[i];
+                    indexBufferAddresses.resize(blas.geometryCount);
+                    indexCounts.resize(blas.geometryCount);
+                    for (UINT j = 0; j < blas.geometryCount; ++j)
+                    {
+                        const auto& geometry = geometries[blas.firstGeometry + j];
+                        indexBufferAddresses[j] =
+                            indexBufferAddress + geometry.rtIndexOffset * sizeof(uint32_t);
+                        indexCounts[j] = geometry.rtIndexCount;
+                    }
                     BottomLevelAS::Initialize(
                         initCommandList, buildBufferAddress + m_BuildOffsets[i],
                         scratchBufferAddress + m_ScratchBufferOffsets[i], vertexBufferAddress,
                         dataHeader.vertex1Size / vertexSize, vertexSize,
-                        indexBufferAddress + objects[i].rtIndexOffset * sizeof(uint32_t),
-                        objects[i].rtIndexCount, postBuildDataAddress + postBuildDataOffset);
+                        indexBufferAddresses.data(), indexCounts.data(), blas.geometryCount,
+                        postBuildDataAddress + postBuildDataOffset);
                 }
             }
 
             ResourceTransition::Transition(initCommandList, m_PostBuildDataBuffer,
                                            D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
                                            D3D12_RESOURCE_STATE_COPY_SOURCE);
-            size_t postBuildInfoSize =
-                sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC) *
-                objectCount;
             initCommandList->CopyResource(m_PostBuildDataReadbackBuffer.Get(),
                                           m_PostBuildDataBuffer.Get());
         }
@@ -222,8 +279,8 @@ namespace Boolka
 
         BLK_GPU_SCOPE(initCommandList, "Scene::CompactAS");
         const auto& dataHeader = *headerWrapper.header;
-        const UINT objectCount = dataHeader.opaqueCount;
-        const auto* objects = headerWrapper.cpuObjectHeaders;
+        const UINT instanceCount = dataHeader.rtInstanceCount;
+        const size_t blasCount = dataHeader.rtBLASCount;
 
         ResourceContainer& resourceContainer = engineContext.GetResourceContainer();
         DescriptorHeap& mainSRVHeap =
@@ -236,14 +293,14 @@ namespace Boolka
 
         void* postBuildData = m_PostBuildDataReadbackBuffer.Map(
             0, sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC) *
-                   objectCount);
+                   blasCount);
         auto* postBuildDescs = static_cast<
             D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC*>(
             postBuildData);
 
         UINT64 asFinalSize = 0;
 
-        for (size_t i = 0; i < objectCount; ++i)
+        for (size_t i = 0; i < blasCount; ++i)
         {
             asFinalSize +=
                 BLK_CEIL_TO_POWER_OF_TWO(postBuildDescs[i].CompactedSizeInBytes,
@@ -255,7 +312,7 @@ namespace Boolka
 
         UINT64 scratchSize;
         UINT64 tlasSize;
-        TopLevelAS::GetSizes(device, objectCount, scratchSize, tlasSize);
+        TopLevelAS::GetSizes(device, instanceCount, scratchSize, tlasSize);
         asFinalSize += tlasSize;
 
         g_WDebugOutput << "TLAS size: " << tlasSize / 1024.0f / 1024.0f << "MB" << std::endl;
@@ -271,7 +328,7 @@ namespace Boolka
         UINT64 currentBlasDestAddress = blasDestAddress;
         {
             BLK_GPU_SCOPE(initCommandList, "CopyAndCompactBLAS");
-            for (size_t i = 0; i < objectCount; ++i)
+            for (size_t i = 0; i < blasCount; ++i)
             {
                 initCommandList->CopyRaytracingAccelerationStructure(
                     currentBlasDestAddress, buildBufferAddress + m_BuildOffsets[i],
@@ -283,30 +340,10 @@ namespace Boolka
             }
         }
 
-        currentBlasDestAddress = blasDestAddress;
-
         {
             void* tlasParametersData = m_TLASParametersUploadBuffer.Map();
             auto* tlasParameters = static_cast<D3D12_RAYTRACING_INSTANCE_DESC*>(tlasParametersData);
-
-            for (size_t i = 0; i < objectCount; ++i)
-            {
-                D3D12_RAYTRACING_INSTANCE_DESC& param = tlasParameters[i];
-                // Identity transform matrix
-                param = {};
-                param.Transform[0][0] = 1.0f;
-                param.Transform[1][1] = 1.0f;
-                param.Transform[2][2] = 1.0f;
-
-                param.InstanceID = objects[i].materialIndex; // Material index
-                param.InstanceMask = 1;
-                param.InstanceContributionToHitGroupIndex = 0;
-                param.Flags = D3D12_RAYTRACING_INSTANCE_FLAG_TRIANGLE_FRONT_COUNTERCLOCKWISE;
-                param.AccelerationStructure = currentBlasDestAddress;
-                currentBlasDestAddress += BLK_CEIL_TO_POWER_OF_TWO(
-                    postBuildDescs[i].CompactedSizeInBytes,
-                    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT);
-            }
+            InitializeInstanceDescs(tlasParameters, headerWrapper);
             m_TLASParametersUploadBuffer.Unmap();
         }
 
@@ -321,7 +358,7 @@ namespace Boolka
         UINT64 tlasParametersAddress = m_TLASParametersBuffer->GetGPUVirtualAddress();
 
         TopLevelAS::Initialize(initCommandList, asDestAddress, scratchBufferAddress,
-                               tlasParametersAddress, objectCount);
+                               tlasParametersAddress, instanceCount);
 
         ShaderResourceView::InitializeAccelerationStructure(
             device, asDestAddress,
@@ -366,8 +403,8 @@ namespace Boolka
         BLK_CPU_SCOPE("RTASContainer::DeserializeAS");
 
         const auto& dataHeader = *headerWrapper.header;
-        const UINT objectCount = dataHeader.opaqueCount;
-        const auto* objects = headerWrapper.cpuObjectHeaders;
+        const UINT instanceCount = dataHeader.rtInstanceCount;
+        const size_t blasCount = dataHeader.rtBLASCount;
 
         ResourceContainer& resourceContainer = engineContext.GetResourceContainer();
         DescriptorHeap& mainSRVHeap =
@@ -387,7 +424,7 @@ namespace Boolka
         UINT64 scratchSize = 0;
         UINT64 tlasSize = 0;
 
-        TopLevelAS::GetSizes(device, objectCount, scratchSize, tlasSize);
+        TopLevelAS::GetSizes(device, instanceCount, scratchSize, tlasSize);
 
         m_ASBuffer.Initialize(device, rtCacheHeader->deserializedSize + tlasSize,
                               D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
@@ -417,19 +454,18 @@ namespace Boolka
 
         BLK_GPU_SCOPE(initCommandList, "Scene::DeserializeAS");
         {
-            for (size_t i = 0; i < objectCount; ++i)
+            for (size_t i = 0; i < blasCount; ++i)
             {
                 initCommandList->CopyRaytracingAccelerationStructure(
                     currentDeserializedData, currentSerializedData,
                     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_DESERIALIZE);
+                m_CopyOffsets[i] = currentDeserializedData;
                 currentSerializedData += objectSerializedData[i].serializedBLASSize;
                 currentDeserializedData += objectSerializedData[i].deserializedBLASSize;
             }
         }
 
-        currentDeserializedData = m_ASBuffer->GetGPUVirtualAddress() + tlasSize;
-
-        UINT64 tlasParametersSize = sizeof(D3D12_RAYTRACING_INSTANCE_DESC) * objectCount;
+        UINT64 tlasParametersSize = sizeof(D3D12_RAYTRACING_INSTANCE_DESC) * instanceCount;
 
         m_TLASParametersUploadBuffer.Initialize(device, tlasParametersSize);
         m_TLASParametersBuffer.Initialize(device, tlasParametersSize, D3D12_HEAP_TYPE_DEFAULT,
@@ -442,23 +478,7 @@ namespace Boolka
 
         void* tlasParametersData = m_TLASParametersUploadBuffer.Map();
         auto* tlasParameters = static_cast<D3D12_RAYTRACING_INSTANCE_DESC*>(tlasParametersData);
-
-        for (size_t i = 0; i < objectCount; ++i)
-        {
-            D3D12_RAYTRACING_INSTANCE_DESC& param = tlasParameters[i];
-            // Identity transform matrix
-            param = {};
-            param.Transform[0][0] = 1.0f;
-            param.Transform[1][1] = 1.0f;
-            param.Transform[2][2] = 1.0f;
-
-            param.InstanceID = objects[i].materialIndex; // Material index
-            param.InstanceMask = 1;
-            param.InstanceContributionToHitGroupIndex = 0;
-            param.Flags = D3D12_RAYTRACING_INSTANCE_FLAG_TRIANGLE_FRONT_COUNTERCLOCKWISE;
-            param.AccelerationStructure = currentDeserializedData;
-            currentDeserializedData += objectSerializedData[i].deserializedBLASSize;
-        }
+        InitializeInstanceDescs(tlasParameters, headerWrapper);
         m_TLASParametersUploadBuffer.Unmap();
 
         initCommandList->CopyResource(m_TLASParametersBuffer.Get(),
@@ -469,7 +489,7 @@ namespace Boolka
 
         TopLevelAS::Initialize(initCommandList, m_ASBuffer->GetGPUVirtualAddress(),
                                m_ASBuildScratchBuffer->GetGPUVirtualAddress(),
-                               m_TLASParametersBuffer->GetGPUVirtualAddress(), objectCount);
+                               m_TLASParametersBuffer->GetGPUVirtualAddress(), instanceCount);
 
         ShaderResourceView::InitializeAccelerationStructure(
             device, m_ASBuffer->GetGPUVirtualAddress(),
@@ -485,7 +505,7 @@ namespace Boolka
         BLK_CPU_SCOPE("RTASContainer::SerializeAS");
 
         const auto& dataHeader = *headerWrapper.header;
-        const UINT objectCount = dataHeader.opaqueCount;
+        const UINT blasCount = dataHeader.rtBLASCount;
 
         UINT64 postBuildInfoAddress = m_PostBuildDataBuffer->GetGPUVirtualAddress();
 
@@ -498,7 +518,7 @@ namespace Boolka
         postBuildInfoDesc.InfoType =
             D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_SERIALIZATION;
         initCommandList->EmitRaytracingAccelerationStructurePostbuildInfo(
-            &postBuildInfoDesc, objectCount, m_CopyOffsets.data());
+            &postBuildInfoDesc, blasCount, m_CopyOffsets.data());
 
         ResourceTransition::Transition(initCommandList, m_PostBuildDataBuffer,
                                        D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
@@ -507,19 +527,19 @@ namespace Boolka
         initCommandList->CopyBufferRegion(
             m_PostBuildDataReadbackBuffer.Get(), 0, m_PostBuildDataBuffer.Get(), 0,
             sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_SERIALIZATION_DESC) *
-                objectCount);
+                blasCount);
 
         engineContext.FlushInitializationCommandList(device);
 
         void* postBuildData = m_PostBuildDataReadbackBuffer.Map(
             0, sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_SERIALIZATION_DESC) *
-                   objectCount);
+                   blasCount);
         D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_SERIALIZATION_DESC*
             serializationInfo = ptr_static_cast<
                 D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_SERIALIZATION_DESC*>(
                 postBuildData);
         UINT64 serializedSize = 0;
-        for (UINT i = 0; i < objectCount; ++i)
+        for (UINT i = 0; i < blasCount; ++i)
         {
             serializedSize +=
                 BLK_CEIL_TO_POWER_OF_TWO(serializationInfo[i].SerializedSizeInBytes,
@@ -539,7 +559,7 @@ namespace Boolka
 
         UINT64 serializedDest = m_SerializedBLASes->GetGPUVirtualAddress();
 
-        for (UINT i = 0; i < objectCount; ++i)
+        for (UINT i = 0; i < blasCount; ++i)
         {
             initCommandList->CopyRaytracingAccelerationStructure(
                 serializedDest, m_CopyOffsets[i],
@@ -565,7 +585,7 @@ namespace Boolka
         UINT64 deserializedSize = 0;
         const char* currentSerializedHeader = static_cast<const char*>(serializedData.m_Data);
 
-        for (size_t i = 0; i < objectCount; ++i)
+        for (size_t i = 0; i < blasCount; ++i)
         {
             auto* currentSerializedASHeader =
                 ptr_static_cast<const D3D12_SERIALIZED_RAYTRACING_ACCELERATION_STRUCTURE_HEADER*>(
@@ -592,7 +612,7 @@ namespace Boolka
         currentSerializedHeader = static_cast<const char*>(serializedData.m_Data);
 
         headerWriter.Write(&serializedDataHeader, sizeof(serializedDataHeader));
-        for (size_t i = 0; i < objectCount; ++i)
+        for (size_t i = 0; i < blasCount; ++i)
         {
             auto* currentSerializedASHeader =
                 ptr_static_cast<const D3D12_SERIALIZED_RAYTRACING_ACCELERATION_STRUCTURE_HEADER*>(
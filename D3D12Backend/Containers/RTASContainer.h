@@ -25,6 +25,8 @@ namespace Boolka
         void FinishInitialization();
 
     private:
+        void InitializeInstanceDescs(D3D12_RAYTRACING_INSTANCE_DESC* instanceDescs,
+                                     const SceneDataReader::HeaderWrapper& headerWrapper);
         void PrecalculateAS(Device& device, const SceneDataReader::HeaderWrapper& headerWrapper);
         void BuildAS(GraphicCommandListImpl& initCommandList, Device& device,
                      RenderEngineContext& engineContext,
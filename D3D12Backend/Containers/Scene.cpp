@@ -5,6 +5,7 @@
 #include "APIWrappers/Device.h"
 #include "APIWrappers/RenderDebug.h"
 #include "APIWrappers/Resources/Buffers/UploadBuffer.h"
+#include "BoolkaCommon/Algorithms/GeometryCodec.h"
 #include "BoolkaCommon/DebugHelpers/DebugProfileTimer.h"
 #include "Contexts/RenderEngineContext.h"
 
@@ -50,7 +51,7 @@ namespace Boolka
         m_ObjectCount = headerWrapper.header->objectCount;
         m_OpaqueObjectCount = headerWrapper.header->opaqueCount;
 
-        m_BatchManager.Initialize(device, *this, engineContext);
+        m_BatchManager.Initialize(device, *this, headerWrapper.cpuObjectHeaders, engineContext);
 
         InitializeBuffers(device, sceneHeader, mainSRVHeap, mainSRVHeapOffset);
 
@@ -72,7 +73,7 @@ namespace Boolka
 
         UINT64 sourceOffset = 0;
 
-        UploadBuffers(device, sceneHeader, sourceOffset);
+        UploadBuffers(device, engineContext, sceneHeader, sourceOffset);
 
         m_RTASContainer.Initialize(device, engineContext, headerWrapper, m_VertexBuffer1,
                                    m_RTIndexBuffer);
@@ -105,7 +106,7 @@ namespace Boolka
         m_ObjectBuffer.Unload();
         m_MaterialsBuffer.Unload();
         m_RTIndexBuffer.Unload();
-        m_RTObjectIndexOffsetBuffer.Unload();
+        m_RTGeometryBuffer.Unload();
 
         m_ObjectCount = 0;
         m_OpaqueObjectCount = 0;
@@ -195,12 +196,11 @@ namespace Boolka
         BLK_ASSERT_VAR(res);
         RenderDebug::SetDebugName(m_RTIndexBuffer.Get(), L"Scene::m_RTIndexBuffer");
 
-        res = m_RTObjectIndexOffsetBuffer.Initialize(
-            device, sceneHeader.rtObjectIndexOffsetSize, D3D12_HEAP_TYPE_DEFAULT,
-            D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COMMON);
+        res = m_RTGeometryBuffer.Initialize(device, sceneHeader.rtGeometrySize,
+                                            D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_FLAG_NONE,
+                                            D3D12_RESOURCE_STATE_COMMON);
         BLK_ASSERT_VAR(res);
-        RenderDebug::SetDebugName(m_RTObjectIndexOffsetBuffer.Get(),
-                                  L"Scene::m_RTObjectIndexOffsetBuffer");
+        RenderDebug::SetDebugName(m_RTGeometryBuffer.Get(), L"Scene::m_RTGeometryBuffer");
 
         UINT srvSlot = MeshletSRVOffset;
         ShaderResourceView::Initialize(device, m_VertexBuffer1,
@@ -250,10 +250,11 @@ namespace Boolka
             device, m_RTIndexBuffer, sceneHeader.rtIndiciesSize / sizeof(uint32_t),
             sizeof(uint32_t), mainSRVHeap.GetCPUHandle(mainSRVHeapOffset + srvSlot++));
 
-        ShaderResourceView::Initialize(device, m_RTObjectIndexOffsetBuffer,
-                                       sceneHeader.rtObjectIndexOffsetSize / sizeof(uint32_t),
-                                       sizeof(uint32_t),
-                                       mainSRVHeap.GetCPUHandle(mainSRVHeapOffset + srvSlot++));
+        ShaderResourceView::Initialize(
+            device, m_RTGeometryBuffer,
+            sceneHeader.rtGeometrySize / sizeof(HLSLShared::RTGeometryData),
+            sizeof(HLSLShared::RTGeometryData),
+            mainSRVHeap.GetCPUHandle(mainSRVHeapOffset + srvSlot++));
 
         BLK_ASSERT(srvSlot == RaytracingASOffset);
     }
@@ -429,29 +430,57 @@ namespace Boolka
         }
     }
 
-    void Scene::UploadBuffers(Device& device, const SceneData::SceneHeader& sceneHeader,
-                              UINT64& sourceOffset)
+    void Scene::UploadBuffers(Device& device, RenderEngineContext& engineContext,
+                              const SceneData::SceneHeader& sceneHeader, UINT64& sourceOffset)
     {
         BLK_CPU_SCOPE("Scene::UploadBuffers");
 
         DStorageQueue& dstorageQueue = device.GetDStorageQueue();
         DStorageFile& sourceFile = m_DataReader.GetSceneDataFile();
 
-        dstorageQueue.EnququeRead(sourceFile, sourceOffset, sceneHeader.vertex1Size,
-                                  m_VertexBuffer1, 0);
-        sourceOffset += sceneHeader.vertex1Size;
-
-        dstorageQueue.EnququeRead(sourceFile, sourceOffset, sceneHeader.vertex2Size,
-                                  m_VertexBuffer2, 0);
-        sourceOffset += sceneHeader.vertex2Size;
-
-        dstorageQueue.EnququeRead(sourceFile, sourceOffset, sceneHeader.vertexIndirectionSize,
-                                  m_VertexIndirectionBuffer, 0);
-        sourceOffset += sceneHeader.vertexIndirectionSize;
+        // Geometry sections stored with GeometryCodec are read to CPU memory, decoded into
+        // upload buffer and copied to GPU
+        struct EncodedSection
+        {
+            Buffer* buffer;
+            UINT size;
+            UINT encodedSize;
+            size_t encodedOffset;
+            size_t uploadOffset;
+        };
+
+        std::vector<unsigned char> encodedData(
+            sceneHeader.vertex1EncodedSize + sceneHeader.vertex2EncodedSize +
+            sceneHeader.vertexIndirectionEncodedSize + sceneHeader.indexEncodedSize);
+        std::vector<EncodedSection> encodedSections;
+        size_t encodedOffset = 0;
+        size_t uploadSize = 0;
+
+        auto enqueueGeometrySection = [&](Buffer& buffer, UINT size, UINT encodedSize) {
+            if (encodedSize == 0)
+            {
+                dstorageQueue.EnququeRead(sourceFile, sourceOffset, size, buffer, 0);
+                sourceOffset += size;
+                return;
+            }
 
-        dstorageQueue.EnququeRead(sourceFile, sourceOffset, sceneHeader.indexSize, m_IndexBuffer,
-                                  0);
-        sourceOffset += sceneHeader.indexSize;
+            dstorageQueue.EnququeRead(sourceFile, sourceOffset, encodedSize,
+                                      encodedData.data() + encodedOffset);
+            encodedSections.push_back(
+                EncodedSection{&buffer, size, encodedSize, encodedOffset, uploadSize});
+            sourceOffset += encodedSize;
+            encodedOffset += encodedSize;
+            uploadSize += size;
+        };
+
+        enqueueGeometrySection(m_VertexBuffer1, sceneHeader.vertex1Size,
+                               sceneHeader.vertex1EncodedSize);
+        enqueueGeometrySection(m_VertexBuffer2, sceneHeader.vertex2Size,
+                               sceneHeader.vertex2EncodedSize);
+        enqueueGeometrySection(m_VertexIndirectionBuffer, sceneHeader.vertexIndirectionSize,
+                               sceneHeader.vertexIndirectionEncodedSize);
+        enqueueGeometrySection(m_IndexBuffer, sceneHeader.indexSize,
+                               sceneHeader.indexEncodedSize);
 
         dstorageQueue.EnququeRead(sourceFile, sourceOffset, sceneHeader.meshletsSize,
                                   m_MeshletBuffer, 0);
@@ -473,9 +502,41 @@ namespace Boolka
                                   m_RTIndexBuffer, 0);
         sourceOffset += sceneHeader.rtIndiciesSize;
 
-        dstorageQueue.EnququeRead(sourceFile, sourceOffset, sceneHeader.rtObjectIndexOffsetSize,
-                                  m_RTObjectIndexOffsetBuffer, 0);
-        sourceOffset += sceneHeader.rtObjectIndexOffsetSize;
+        dstorageQueue.EnququeRead(sourceFile, sourceOffset, sceneHeader.rtGeometrySize,
+                                  m_RTGeometryBuffer, 0);
+        sourceOffset += sceneHeader.rtGeometrySize;
+
+        if (encodedSections.empty())
+            return;
+
+        BLK_CPU_SCOPE("Scene::DecodeGeometry");
+
+        dstorageQueue.Flush();
+
+        UploadBuffer uploadBuffer;
+        bool res = uploadBuffer.Initialize(device, uploadSize);
+        BLK_ASSERT_VAR(res);
+        RenderDebug::SetDebugName(uploadBuffer.Get(), L"Scene::DecodeGeometry::uploadBuffer");
+
+        auto* uploadData = static_cast<unsigned char*>(uploadBuffer.Map());
+        std::for_each(std::execution::par, std::begin(encodedSections), std::end(encodedSections),
+                      [&](const EncodedSection& section) {
+                          bool decoded = GeometryCodec::Decode(
+                              encodedData.data() + section.encodedOffset, section.encodedSize,
+                              uploadData + section.uploadOffset, section.size);
+                          BLK_CRITICAL_ASSERT(decoded);
+                      });
+        uploadBuffer.Unmap();
+
+        auto& initCommandList = engineContext.GetInitializationCommandList();
+        for (const auto& section : encodedSections)
+        {
+            initCommandList->CopyBufferRegion(section.buffer->Get(), 0, uploadBuffer.Get(),
+                                              section.uploadOffset, section.size);
+        }
+        engineContext.FlushInitializationCommandList(device);
+
+        uploadBuffer.Unload();
     }
 
 } // namespace Boolka
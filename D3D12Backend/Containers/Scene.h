@@ -81,8 +81,8 @@ namespace Boolka
                                 const SceneDataReader::HeaderWrapper& headerWrapper,
                                 const std::vector<size_t>& textureOffsets,
                                 DescriptorHeap& mainSRVHeap, UINT mainSRVHeapOffset);
-        void UploadBuffers(Device& device, const SceneData::SceneHeader& sceneHeader,
-                           UINT64& sourceOffset);
+        void UploadBuffers(Device& device, RenderEngineContext& engineContext,
+                           const SceneData::SceneHeader& sceneHeader, UINT64& sourceOffset);
         void UploadSkyBox(Device& device, const SceneData::SceneHeader& sceneHeader,
                           UINT64& sourceOffset);
         void UploadTextures(Device& device, const SceneData::SceneHeader& sceneHeader,
@@ -100,7 +100,7 @@ namespace Boolka
         Buffer m_ObjectBuffer;
         Buffer m_MaterialsBuffer;
         Buffer m_RTIndexBuffer;
-        Buffer m_RTObjectIndexOffsetBuffer;
+        Buffer m_RTGeometryBuffer;
         ResourceHeap m_ResourceHeap;
         BatchManager m_BatchManager;
         Texture2D m_SkyBoxCubemap;
@@ -3,7 +3,10 @@
 // Data that always needed to be loaded for rendering
 #define BLK_SCENE_HEADER_FILENAME L"SceneHeader.blkeng"
 #define BLK_SCENE_DATA_FILENAME L"SceneData.blkeng"
-#define BLK_SCENE_VERSION 2
+// Scenes of any other version fail FormatHeader::IsValid on load and have to be reconverted,
+// there is no upgrade path. Version 6 replaced 10 bit packed meshlet triangles with byte
+// indices and 32 bit vertex indirection with 16 bit offsets from per meshlet base vertex
+#define BLK_SCENE_VERSION 9
 
 #define BLK_CACHE_RT_HEADER_FILENAME L"RaytracingCacheHeader.blktmp"
 #define BLK_CACHE_RT_FILENAME L"RaytracingCache.blktmp"
@@ -27,6 +30,36 @@ namespace Boolka
             uint32_t rtIndexOffset;
             uint32_t rtIndexCount;
             uint32_t materialIndex;
+            // Object that owns geometry, equal to own index for non instanced objects
+            uint32_t prototypeIndex;
+            // Same layout as D3D12_RAYTRACING_INSTANCE_DESC::Transform
+            float instanceTransform[3][4];
+            // World space bounds, same as in HLSLShared::ObjectData, used for CPU culling
+            float boundingBoxMin[3];
+            float boundingBoxMax[3];
+            // xyz - center, w - radius
+            float boundingSphere[4];
+        };
+
+        // Range of RT index buffer, BLAS can be built from several of them
+        struct [[nodiscard]] RTGeometryHeader
+        {
+            uint32_t rtIndexOffset;
+            uint32_t rtIndexCount;
+        };
+
+        // BLAS is built from consecutive geometries, computed by converter
+        struct [[nodiscard]] RTBLASHeader
+        {
+            uint32_t firstGeometry;
+            uint32_t geometryCount;
+        };
+
+        // TLAS instance, transform is taken from object
+        struct [[nodiscard]] RTInstanceHeader
+        {
+            uint32_t blasIndex;
+            uint32_t objectIndex;
         };
 
         struct [[nodiscard]] FormatHeader
@@ -51,12 +84,21 @@ namespace Boolka
             UINT objectsSize;
             UINT materialsSize;
             UINT rtIndiciesSize;
-            UINT rtObjectIndexOffsetSize;
+            UINT rtGeometrySize;
             UINT objectCount;
             UINT opaqueCount;
             UINT skyBoxResolution;
             UINT skyBoxMipCount;
             UINT textureCount;
+            UINT rtGeometryCount;
+            UINT rtBLASCount;
+            UINT rtInstanceCount;
+            // Sizes in data file of sections stored with GeometryCodec, 0 if section is stored
+            // raw. Decoded sizes are in fields above
+            UINT vertex1EncodedSize;
+            UINT vertex2EncodedSize;
+            UINT vertexIndirectionEncodedSize;
+            UINT indexEncodedSize;
         };
 
     } // namespace SceneData
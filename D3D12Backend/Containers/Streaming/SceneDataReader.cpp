@@ -42,12 +42,15 @@ namespace Boolka
         BLK_CRITICAL_ASSERT(sceneHeader.objectsSize != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.materialsSize != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.rtIndiciesSize != 0);
-        BLK_CRITICAL_ASSERT(sceneHeader.rtObjectIndexOffsetSize != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtGeometrySize != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.objectCount != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.opaqueCount != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.skyBoxResolution != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.skyBoxMipCount != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.textureCount != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtGeometryCount != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtBLASCount != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtInstanceCount != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.objectCount < Scene::MaxObjectCount);
 
         DStorageQueue& queue = device.GetDStorageQueue();
@@ -84,7 +87,23 @@ namespace Boolka
         const SceneData::CPUObjectHeader* cpuObjectHeader =
             ptr_static_cast<const SceneData::CPUObjectHeader*>(data);
 
-        return HeaderWrapper{sceneHeader, textureHeader, cpuObjectHeader};
+        data += sizeof(SceneData::CPUObjectHeader) * sceneHeader->objectCount;
+
+        const SceneData::RTGeometryHeader* rtGeometryHeader =
+            ptr_static_cast<const SceneData::RTGeometryHeader*>(data);
+
+        data += sizeof(SceneData::RTGeometryHeader) * sceneHeader->rtGeometryCount;
+
+        const SceneData::RTBLASHeader* rtBLASHeader =
+            ptr_static_cast<const SceneData::RTBLASHeader*>(data);
+
+        data += sizeof(SceneData::RTBLASHeader) * sceneHeader->rtBLASCount;
+
+        const SceneData::RTInstanceHeader* rtInstanceHeader =
+            ptr_static_cast<const SceneData::RTInstanceHeader*>(data);
+
+        return HeaderWrapper{sceneHeader,      textureHeader, cpuObjectHeader,
+                             rtGeometryHeader, rtBLASHeader,  rtInstanceHeader};
     }
 
     DStorageFile& SceneDataReader::GetSceneDataFile()
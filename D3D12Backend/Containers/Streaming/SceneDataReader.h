@@ -22,6 +22,9 @@ namespace Boolka
             const SceneData::SceneHeader* header;
             const SceneData::TextureHeader* textureHeaders;
             const SceneData::CPUObjectHeader* cpuObjectHeaders;
+            const SceneData::RTGeometryHeader* rtGeometryHeaders;
+            const SceneData::RTBLASHeader* rtBLASHeaders;
+            const SceneData::RTInstanceHeader* rtInstanceHeaders;
         };
 
         HeaderWrapper GetHeaderWrapper();
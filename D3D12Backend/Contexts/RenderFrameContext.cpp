@@ -3,6 +3,7 @@
 #include "RenderFrameContext.h"
 
 #include "BoolkaCommon/DebugHelpers/DebugOutputStream.h"
+#include "BoolkaCommon/Structures/HighResolutionClock.h"
 #include "Contexts/RenderEngineContext.h"
 
 namespace Boolka
@@ -11,8 +12,7 @@ namespace Boolka
     RenderFrameContext::RenderFrameContext()
         : m_DeltaTime(0.0f)
         , m_FrameIndex(0)
-        , m_LastTimestamp{}
-        , m_Frequency()
+        , m_LastTimestamp(0)
 #ifdef BLK_ENABLE_STATS
         , m_FraneStats()
 #endif
@@ -23,18 +23,14 @@ namespace Boolka
     {
         BLK_ASSERT(m_DeltaTime == 0.0f);
         BLK_ASSERT(m_FrameIndex == 0);
-        BLK_ASSERT(m_LastTimestamp.QuadPart == 0);
-        BLK_ASSERT(m_Frequency.QuadPart == 0);
+        BLK_ASSERT(m_LastTimestamp == 0);
     }
 
     bool RenderFrameContext::Initialize(Device& device)
     {
         BLK_CPU_SCOPE("RenderFrameContext::Initialize");
 
-        BOOL res = ::QueryPerformanceFrequency(&m_Frequency);
-        BLK_CRITICAL_ASSERT(res);
-        res = ::QueryPerformanceCounter(&m_LastTimestamp);
-        BLK_CRITICAL_ASSERT(res);
+        m_LastTimestamp = HighResolutionClock::GetTimestamp();
 
         return true;
     }
@@ -43,8 +39,7 @@ namespace Boolka
     {
         m_DeltaTime = 0.0f;
         m_FrameIndex = 0;
-        m_LastTimestamp = {};
-        m_Frequency = {};
+        m_LastTimestamp = 0;
     }
 
     const Matrix4x4& RenderFrameContext::GetProjMatrix() const
@@ -156,15 +151,13 @@ namespace Boolka
     {
         m_FrameIndex = frameIndex;
 
-        LARGE_INTEGER currentTimestamp;
-        BOOL res = ::QueryPerformanceCounter(&currentTimestamp);
-        BLK_ASSERT_VAR(res);
+        uint64_t currentTimestamp = HighResolutionClock::GetTimestamp();
 
-        LARGE_INTEGER timestampDifference = currentTimestamp - m_LastTimestamp;
+        uint64_t timestampDifference = currentTimestamp - m_LastTimestamp;
 
         m_LastTimestamp = currentTimestamp;
 
-        m_DeltaTime = timestampDifference / m_Frequency;
+        m_DeltaTime = static_cast<float>(HighResolutionClock::TicksToSeconds(timestampDifference));
 
 #ifdef BLK_ENABLE_STATS
         m_FraneStats.frameTime = m_DeltaTime;
@@ -186,9 +179,8 @@ namespace Boolka
         m_EyeRayCoeficients[4] = m_EyeRayCoeficients[1] * 2.0f / static_cast<float>(height);
 
         m_ViewProjMatrix = m_ViewMatrix * m_ProjMatrix;
+        m_InvViewMatrix = m_ViewMatrix.InverseRigid();
         bool isSuccessfull;
-        m_InvViewMatrix = m_ViewMatrix.Inverse(isSuccessfull);
-        BLK_ASSERT(isSuccessfull);
         m_InvProjMatrix = m_ProjMatrix.Inverse(isSuccessfull);
         BLK_ASSERT(isSuccessfull);
         m_InvViewProjMatrix = m_ViewProjMatrix.Inverse(isSuccessfull);
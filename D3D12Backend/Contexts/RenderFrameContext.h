@@ -63,8 +63,7 @@ namespace Boolka
         float m_DeltaTime;
         UINT m_FrameIndex;
 
-        LARGE_INTEGER m_LastTimestamp;
-        LARGE_INTEGER m_Frequency;
+        uint64_t m_LastTimestamp;
 
 #ifdef BLK_ENABLE_STATS
         // Allow to write stats in places which otherwise would get const RenderFrameContext
@@ -25,10 +25,6 @@ namespace Boolka
             resourceContainer.GetBuffer(ResourceContainer::Buf::GPUCullingCommand);
         Buffer& gpuCullingMeshletIndiciesBuf =
             resourceContainer.GetBuffer(ResourceContainer::Buf::GPUCullingMeshletIndices);
-        D3D12_GPU_DESCRIPTOR_HANDLE gpuCullingUAVBufGPUDescriptor =
-            resourceContainer.GetGPUDescriptor(ResourceContainer::Buf::GPUCulling);
-        D3D12_CPU_DESCRIPTOR_HANDLE gpuCullingUAVBufCPUDescriptor =
-            resourceContainer.GetCPUVisibleCPUDescriptor(ResourceContainer::Buf::GPUCulling);
         D3D12_GPU_DESCRIPTOR_HANDLE gpuCullingCommandUINTUAVBufGPUDescriptor =
             resourceContainer.GetDescriptorHeap(ResourceContainer::DescHeap::MainHeap)
                 .GetGPUHandle(static_cast<size_t>(
@@ -53,34 +49,43 @@ namespace Boolka
             static_cast<UINT>(ResourceContainer::DefaultRootSigBindPoints::PassConstantBuffer),
             passConstantBuffer->GetGPUVirtualAddress());
 
-        const LightContainer& lightContainer = frameContext.GetLightContainer();
-        UINT viewCount =
-            static_cast<UINT>(BatchManager::ViewType::ShadowMapLight0) +
-            BLK_TEXCUBE_FACE_COUNT * static_cast<UINT>(lightContainer.GetLights().size());
-        UINT objectCount = engineContext.GetScene().GetOpaqueObjectCount();
+        // Objects are culled and sorted on CPU by BatchManager::PrepareBatches, only visible
+        // objects are copied to GPU
+        BatchManager& batchManager = engineContext.GetScene().GetBatchManager();
+        UploadBuffer& culledObjectsUploadBuf =
+            batchManager.GetCulledObjectsUploadBuffer(frameIndex);
+        UINT viewCount = batchManager.GetViewCount();
+        UINT viewSize = batchManager.GetCulledObjectsViewSize();
+        UINT maxVisibleObjectCount = batchManager.GetMaxVisibleObjectCount();
+
+        resourceTracker.Transition(gpuCullingUAVBuf, commandList, D3D12_RESOURCE_STATE_COPY_DEST);
+        for (UINT view = 0; view < viewCount; ++view)
+        {
+            // Count, meshlet counter and visible object pairs
+            UINT visibleObjectCount =
+                batchManager.GetVisibleObjectCount(static_cast<BatchManager::ViewType>(view));
+            UINT64 copySize = sizeof(uint) * 2 * (visibleObjectCount + 1);
+            commandList->CopyBufferRegion(gpuCullingUAVBuf.Get(), view * viewSize,
+                                          culledObjectsUploadBuf.Get(), view * viewSize, copySize);
+        }
+        resourceTracker.Transition(gpuCullingUAVBuf, commandList,
+                                   D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 
         const UINT clearValues[4] = {};
 
-        UAVBarrier::Barrier(commandList, gpuCullingUAVBuf);
-        commandList->ClearUnorderedAccessViewUint(gpuCullingUAVBufGPUDescriptor,
-                                                  gpuCullingUAVBufCPUDescriptor,
-                                                  gpuCullingUAVBuf.Get(), clearValues, 0, nullptr);
         commandList->ClearUnorderedAccessViewUint(
             gpuCullingCommandUINTUAVBufGPUDescriptor, gpuCullingCommandUAVBufCPUDescriptor,
             gpuCullingCommmandBuf.Get(), clearValues, 0, nullptr);
 
-        UAVBarrier::Barrier(commandList, gpuCullingUAVBuf);
-        commandList->SetPipelineState(
-            engineContext.GetPSOContainer().GetPSO(PSOContainer::ComputePSO::ObjectCulling).Get());
-        commandList->Dispatch(BLK_INT_DIVIDE_CEIL(objectCount, 32), viewCount, 1);
-
-        UAVBarrier::Barrier(commandList, gpuCullingUAVBuf);
         UAVBarrier::Barrier(commandList, gpuCullingCommmandBuf);
-        commandList->SetPipelineState(
-            engineContext.GetPSOContainer()
-                .GetPSO(PSOContainer::ComputePSO::CullingCommandBufferGeneration)
-                .Get());
-        commandList->Dispatch(BLK_INT_DIVIDE_CEIL(objectCount, 32), viewCount, 1);
+        if (maxVisibleObjectCount != 0)
+        {
+            commandList->SetPipelineState(
+                engineContext.GetPSOContainer()
+                    .GetPSO(PSOContainer::ComputePSO::CullingCommandBufferGeneration)
+                    .Get());
+            commandList->Dispatch(BLK_INT_DIVIDE_CEIL(maxVisibleObjectCount, 32), viewCount, 1);
+        }
 
         resourceTracker.Transition(gpuCullingCommmandBuf, commandList,
                                    D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
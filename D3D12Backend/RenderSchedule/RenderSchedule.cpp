@@ -124,7 +124,7 @@ namespace Boolka
     bool RenderSchedule::PrepareFrame()
     {
         Scene& scene = m_RenderContext.GetRenderEngineContext().GetScene();
-        scene.GetBatchManager().PrepareBatches(m_FrameContext, scene);
+        scene.GetBatchManager().PrepareBatches(m_FrameContext);
 
         return true;
     }
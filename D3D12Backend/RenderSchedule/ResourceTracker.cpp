@@ -9,44 +9,44 @@ namespace Boolka
 
     ResourceTracker::~ResourceTracker()
     {
-        BLK_ASSERT(m_TrackedResources.empty());
+        BLK_ASSERT(m_TrackedResources.IsEmpty());
     }
 
     bool ResourceTracker::Initialize(Device& device, size_t expectedResources)
     {
-        m_TrackedResources.reserve(expectedResources);
+        m_TrackedResources.Reserve(expectedResources);
 
         return true;
     }
 
     void ResourceTracker::Unload()
     {
-        m_TrackedResources.clear();
+        m_TrackedResources.Clear();
     }
 
     void ResourceTracker::RegisterResource(Resource& resource, D3D12_RESOURCE_STATES initialState)
     {
-        auto [resourceIterator, isInserted] = m_TrackedResources.insert({&resource, initialState});
+        auto [trackedState, isInserted] = m_TrackedResources.Emplace(&resource, initialState);
         BLK_ASSERT_VAR(isInserted);
     }
 
     bool ResourceTracker::Transition(Resource& resource, CommandList& commandList,
                                      D3D12_RESOURCE_STATES targetState)
     {
-        auto iterator = m_TrackedResources.find(&resource);
-        BLK_ASSERT(iterator != m_TrackedResources.end());
+        D3D12_RESOURCE_STATES* trackedState = m_TrackedResources.Find(&resource);
+        BLK_ASSERT(trackedState != nullptr);
 
         // TODO decide if need to handle unknown resource
-        if (iterator == m_TrackedResources.end())
+        if (trackedState == nullptr)
             return false;
 
-        D3D12_RESOURCE_STATES sourceState = iterator->second;
+        D3D12_RESOURCE_STATES sourceState = *trackedState;
 
         if (!ResourceTransition::NeedTransition(sourceState, targetState))
             return false;
         if (!ResourceTransition::CanPromote(sourceState, targetState))
             ResourceTransition::Transition(commandList, resource, sourceState, targetState);
-        iterator->second = targetState;
+        *trackedState = targetState;
 
         return true;
     }
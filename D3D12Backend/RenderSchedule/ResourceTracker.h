@@ -1,5 +1,6 @@
 #pragma once
 #include "APIWrappers/RootSignature.h"
+#include "BoolkaCommon/Structures/FlatHashMap.h"
 
 namespace Boolka
 {
@@ -30,7 +31,7 @@ namespace Boolka
         void Decay();
 
     private:
-        std::unordered_map<Resource*, D3D12_RESOURCE_STATES> m_TrackedResources;
+        FlatHashMap<Resource*, D3D12_RESOURCE_STATES> m_TrackedResources;
     };
 
 } // namespace Boolka
@@ -51,4 +51,19 @@ void DebugSetData(uint marker, float data)
 
 #include "ResourceBindings.hlsli"
 
+uint PackMeshletIndex(uint objectIndex, uint meshletIndex)
+{
+    return (objectIndex << BLK_MESHLET_INDEX_BITS) | meshletIndex;
+}
+
+uint UnpackObjectIndex(uint packedMeshletIndex)
+{
+    return packedMeshletIndex >> BLK_MESHLET_INDEX_BITS;
+}
+
+uint UnpackMeshletIndex(uint packedMeshletIndex)
+{
+    return packedMeshletIndex & ((1u << BLK_MESHLET_INDEX_BITS) - 1);
+}
+
 #endif
@@ -31,6 +31,10 @@ struct AABB
 #define BLK_MAX_SCENE_TEXTURE_COUNT 512
 #define BLK_MAX_OBJECT_COUNT 2048
 #define BLK_MAX_MESHLETS 262144
+// Culled meshlet lists store object index in high bits, so instances can share meshlets
+#define BLK_MESHLET_INDEX_BITS 18
+// Meshlet vertex indirection stores 32 bit vertex indices instead of base vertex and 16 bit offsets
+#define BLK_MESHLET_FLAG_WIDE_VERTEX_INDICES 1
 
 #define BLK_RT_MAX_RECURSION_DEPTH 4
 
@@ -131,9 +135,11 @@ struct MeshletData
 {
     uint16_t MaterialID;
     uint16_t VertCount;
+    // Offset in 32 bit words of vertex indirection buffer
     uint VertOffset;
-    uint16_t unused;
+    uint16_t Flags;
     uint16_t PrimCount;
+    // Offset in triangles, each triangle is 3 bytes of index buffer
     uint PrimOffset;
 };
 
@@ -148,10 +154,22 @@ struct MeshletCullData
 struct ObjectData
 {
     AABB boundingBox;
+    // Minimal bounding sphere, xyz - center, w - radius
+    float4 boundingSphere;
 
     uint meshletOffset;
     uint meshletCount;
     uint2 unused;
+
+    // Instances share meshlets with prototype, bounding box is already in world space
+    float4x4 worldMatrix;
+};
+
+// Geometry of raytracing BLAS, indexed by InstanceID() + GeometryIndex()
+struct RTGeometryData
+{
+    uint indexOffset;
+    uint materialIndex;
 };
 
 struct CullingCommandSignature
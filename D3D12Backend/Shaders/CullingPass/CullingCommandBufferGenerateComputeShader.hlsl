@@ -21,19 +21,21 @@ void main(uint3 DTid : SV_DispatchThreadID, uint3 Gid : SV_GroupID, uint3 GTid :
     uint remappedIndex = gpuCullingUAV[objectUAVOffset + 2 + objectIndex * 2];
     ObjectData objectData = objectBuffer[remappedIndex];
 
-    // round up to multiple of 32 since we process batches of 32 in amplification shader
+    // Meshlets of all objects in a wave are packed together without per object padding
+    // Only the tail of the wave range is rounded up to multiple of 32, since we process
+    // batches of 32 in amplification shader
     uint meshletCount = objectData.meshletCount;
-    uint roundedMeshletCount = (objectData.meshletCount + 31) & ~uint(31);
-    uint totalMeshletCount = WaveActiveSum(roundedMeshletCount);
-    uint localMeshletDestOffset = WavePrefixSum(roundedMeshletCount);
+    uint totalMeshletCount = WaveActiveSum(meshletCount);
+    uint roundedTotalMeshletCount = (totalMeshletCount + 31) & ~uint(31);
+    uint localMeshletDestOffset = WavePrefixSum(meshletCount);
     
     if (GTid.x == 0)
     {
-        InterlockedAdd(gpuCullingUAV[objectUAVOffset + 1], totalMeshletCount, meshletBufferOffset);
+        InterlockedAdd(gpuCullingUAV[objectUAVOffset + 1], roundedTotalMeshletCount, meshletBufferOffset);
         meshletBufferOffset += viewIndex * BLK_MAX_MESHLETS;
 
         Command.meshletOffset = meshletBufferOffset;
-        Command.amplificationShaderGroups.x = totalMeshletCount / 32;
+        Command.amplificationShaderGroups.x = roundedTotalMeshletCount / 32;
         Command.amplificationShaderGroups.yz = uint2(1, 1);
 
         gpuCullingCommandUAV[commandBufferIndex] = Command;
@@ -44,11 +46,17 @@ void main(uint3 DTid : SV_DispatchThreadID, uint3 Gid : SV_GroupID, uint3 GTid :
     uint i;
     for (i = 0; i < meshletCount; i++)
     {
-        gpuCullingMeshletIndiciesUAV[globalMeshDestOffset + i] = objectData.meshletOffset + i;
+        gpuCullingMeshletIndiciesUAV[globalMeshDestOffset + i] =
+            PackMeshletIndex(remappedIndex, objectData.meshletOffset + i);
     }
-    for (i = meshletCount; i < roundedMeshletCount; i++)
+
+    // Partial last batch is filled with invalid indices, spread across active lanes
+    uint activeLaneIndex = WavePrefixCountBits(true);
+    uint activeLaneCount = WaveActiveCountBits(true);
+    uint tailOffset = meshletBufferOffset + totalMeshletCount;
+    for (i = activeLaneIndex; i < roundedTotalMeshletCount - totalMeshletCount; i += activeLaneCount)
     {
-        gpuCullingMeshletIndiciesUAV[globalMeshDestOffset + i] = -1;
+        gpuCullingMeshletIndiciesUAV[tailOffset + i] = -1;
     }
 
 }
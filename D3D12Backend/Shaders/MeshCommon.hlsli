@@ -23,6 +23,7 @@ struct Vertex
 
 struct Payload
 {
+    // Packed object and meshlet indices, see PackMeshletIndex
     uint meshletIndicies[32];
 };
 
@@ -46,24 +47,23 @@ float4 UnpackCone(uint normalCone)
     return result;
 }
 
-bool IsMeshletVisible(in uint meshletIndex, in uint viewIndex)
+bool IsMeshletVisible(in uint packedMeshletIndex, in uint viewIndex)
 {
-    if (meshletIndex == -1)
+    // Tail of partially filled batch
+    if (packedMeshletIndex == -1)
     {
         return false;
     }
 
+    uint meshletIndex = UnpackMeshletIndex(packedMeshletIndex);
+    float4x4 worldMatrix = objectBuffer[UnpackObjectIndex(packedMeshletIndex)].worldMatrix;
+
     MeshletCullData cullData = meshletCullBuffer[meshletIndex];
     Frustum viewFrustum = GPUCulling.views[viewIndex];
     float3 cameraPos = GPUCulling.cameraPos[viewIndex].xyz;
     float4 boundingSphere = cullData.BoundingSphere;
-
-    // Only empty meshlets should have such bounding sphere
-    // And we currently have empty meshlets as padding
-    if (all(boundingSphere == float4(0.0f, 0.0f, 0.0f, 1.0f)))
-    {
-        return false;
-    }
+    // Instance transforms are rigid, so radius stays the same
+    boundingSphere.xyz = mul(float4(boundingSphere.xyz, 1.0f), worldMatrix).xyz;
 
     // Frustum culling
     if (!IntersectionFrustumSphere(viewFrustum, boundingSphere))
@@ -77,7 +77,7 @@ bool IsMeshletVisible(in uint meshletIndex, in uint viewIndex)
         return true;
 
     float4 normalCone = UnpackCone(cullData.NormalCone);
-    float3 axis = normalCone.xyz;
+    float3 axis = mul(normalCone.xyz, (float3x3)worldMatrix);
     float angle = normalCone.w;
 
     float3 sphereCenter = boundingSphere.xyz;
@@ -99,24 +99,46 @@ MeshletData GetMeshletData(in const Payload payload, in uint groupID)
 {
     MeshletData Out = (MeshletData)0;
 
-    uint meshletIndex = payload.meshletIndicies[groupID];
+    uint meshletIndex = UnpackMeshletIndex(payload.meshletIndicies[groupID]);
 
     Out = meshletBuffer[meshletIndex];
 
     return Out;
 }
 
-Vertex GetVertex(in const Payload payload, in const MeshletData meshletData, in uint vertexIndex)
+float4x4 GetWorldMatrix(in const Payload payload, in uint groupID)
+{
+    uint objectIndex = UnpackObjectIndex(payload.meshletIndicies[groupID]);
+
+    return objectBuffer[objectIndex].worldMatrix;
+}
+
+// Compact meshlets store base vertex followed by pairs of 16 bit offsets
+uint GetGlobalVertexIndex(in const MeshletData meshletData, in uint vertexIndex)
+{
+    if (meshletData.Flags & BLK_MESHLET_FLAG_WIDE_VERTEX_INDICES)
+        return vertexIndirectionBuffer[meshletData.VertOffset + vertexIndex];
+
+    uint baseVertex = vertexIndirectionBuffer[meshletData.VertOffset];
+    uint packedOffsets = vertexIndirectionBuffer[meshletData.VertOffset + 1 + vertexIndex / 2];
+    return baseVertex + ((packedOffsets >> ((vertexIndex & 1) * 16)) & 0xFFFF);
+}
+
+Vertex GetVertex(in const Payload payload, in const MeshletData meshletData,
+                 in const float4x4 worldMatrix, in uint vertexIndex)
 {
     Vertex Out = (Vertex)0;
 
-    uint remappedVertexIndex = vertexIndirectionBuffer[meshletData.VertOffset + vertexIndex];
+    uint remappedVertexIndex = GetGlobalVertexIndex(meshletData, vertexIndex);
     VertexData1 vertexData1 = vertexBuffer1[remappedVertexIndex];
     VertexData2 vertexData2 = vertexBuffer2[remappedVertexIndex];
 
+    float4 worldPos = mul(float4(vertexData1.position, 1.0f), worldMatrix);
+    float3 worldNormal = mul(normalize(vertexData2.normal), (float3x3)worldMatrix);
+
     Out.materialID = meshletData.MaterialID;
-    Out.position = mul(float4(vertexData1.position, 1.0f), Frame.viewProjMatrix);
-    Out.normal = normalize(mul(normalize(vertexData2.normal), (float3x3)Frame.viewMatrix));
+    Out.position = mul(worldPos, Frame.viewProjMatrix);
+    Out.normal = normalize(mul(worldNormal, (float3x3)Frame.viewMatrix));
     Out.texcoord = float2(vertexData1.texCoordX, vertexData2.texCoordY);
 
     return Out;
@@ -124,13 +146,22 @@ Vertex GetVertex(in const Payload payload, in const MeshletData meshletData, in
 
 uint3 UnpackPrimitive(uint primitive)
 {
-    return uint3(primitive & 0x3FF, (primitive >> 10) & 0x3FF, (primitive >> 20) & 0x3FF);
+    return uint3(primitive & 0xFF, (primitive >> 8) & 0xFF, (primitive >> 16) & 0xFF);
 }
 
+// Triangles are 3 consecutive bytes, so they can straddle 32 bit words
 uint3 GetPrimitive(in const Payload payload, in const MeshletData meshletData,
                    in uint primitiveIndex)
 {
-    return UnpackPrimitive(indexBuffer[meshletData.PrimOffset + primitiveIndex]);
+    uint byteOffset = (meshletData.PrimOffset + primitiveIndex) * 3;
+    uint wordIndex = byteOffset / 4;
+    uint shift = (byteOffset % 4) * 8;
+
+    uint primitive = indexBuffer[wordIndex] >> shift;
+    if (shift > 8)
+        primitive |= indexBuffer[wordIndex + 1] << (32 - shift);
+
+    return UnpackPrimitive(primitive);
 }
 
 #endif
\ No newline at end of file
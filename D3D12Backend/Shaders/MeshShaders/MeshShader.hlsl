@@ -9,12 +9,13 @@ void main(uint gtid : SV_GroupThreadID,
           out indices uint3 triangles[126])
 {
     MeshletData meshletData = GetMeshletData(payload, gid);
+    float4x4 worldMatrix = GetWorldMatrix(payload, gid);
 
     SetMeshOutputCounts(meshletData.VertCount, meshletData.PrimCount);
     
     if (gtid < meshletData.VertCount)
     {
-        vertices[gtid] = GetVertex(payload, meshletData, gtid);
+        vertices[gtid] = GetVertex(payload, meshletData, worldMatrix, gtid);
     }
     
     if (gtid < meshletData.PrimCount)
@@ -312,13 +312,17 @@ Vertex CombineVertexData(VertexData1 data1, VertexData2 data2)
     return Out;
 }
 
+RTGeometryData GetGeometryData()
+{
+    // BLASes can contain several geometries, InstanceID points to the first one
+    return rtGeometryBuffer[InstanceID() + GeometryIndex()];
+}
+
 void GetVertices(out Vertex outVertices[3])
 {
-    uint objectIndex = InstanceIndex();
     uint primitiveIndex = PrimitiveIndex();
 
-    uint ojectIndexOffset = rtObjectIndexOffsetBuffer[objectIndex];
-    uint indexOffset = ojectIndexOffset + primitiveIndex * 3;
+    uint indexOffset = GetGeometryData().indexOffset + primitiveIndex * 3;
 
     uint indexes[3] = {rtIndexBuffer[indexOffset], rtIndexBuffer[indexOffset + 1],
                        rtIndexBuffer[indexOffset + 2]};
@@ -329,9 +333,16 @@ void GetVertices(out Vertex outVertices[3])
     VertexData2 vertexData2[] = {vertexBuffer2[indexes[0]], vertexBuffer2[indexes[1]],
                                  vertexBuffer2[indexes[2]]};
 
-    outVertices[0] = CombineVertexData(vertexData1[0], vertexData2[0]);
-    outVertices[1] = CombineVertexData(vertexData1[1], vertexData2[1]);
-    outVertices[2] = CombineVertexData(vertexData1[2], vertexData2[2]);
+    // Instances share geometry with their prototype, so vertices are in object space
+    float3x4 objectToWorld = ObjectToWorld3x4();
+
+    [unroll]
+    for (uint i = 0; i < 3; ++i)
+    {
+        outVertices[i] = CombineVertexData(vertexData1[i], vertexData2[i]);
+        outVertices[i].position = mul(objectToWorld, float4(outVertices[i].position, 1.0f));
+        outVertices[i].normal = mul((float3x3)objectToWorld, outVertices[i].normal);
+    }
 }
 
 // Interpolates vertex, calculated ddx/ddy, updates RayDifferential's dO for recursive raytracing
@@ -418,7 +429,7 @@ void UpdateRayDifferentialsRefraction(inout float3 dDdx, inout float3 dDdy, floa
 
 [shader("closesthit")]
 void ClosestHit(inout RaytracePayload payload, in BuiltInTriangleIntersectionAttributes attr) {
-    uint materialID = InstanceID();
+    uint materialID = GetGeometryData().materialIndex;
 
     Vertex interpolatedVertex = (Vertex)0;
     float2 ddxRes, ddyRes;
@@ -46,7 +46,7 @@ StructuredBuffer<MaterialData> materialsData : register(t7, space1);
 
 // RT data
 StructuredBuffer<uint> rtIndexBuffer : register(t0, space2);
-StructuredBuffer<uint> rtObjectIndexOffsetBuffer : register(t1, space2);
+StructuredBuffer<RTGeometryData> rtGeometryBuffer : register(t1, space2);
 RaytracingAccelerationStructure sceneAS : register(t2, space2);
 
 // Skybox
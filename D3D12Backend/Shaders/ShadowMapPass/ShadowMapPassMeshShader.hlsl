@@ -1,15 +1,16 @@
 #include "../MeshCommon.hlsli"
 
 Vertex GetVertexShadow(in const Payload payload, in const MeshletData meshletData,
-                                   in uint vertexIndex)
+                       in const float4x4 worldMatrix, in uint vertexIndex)
 {
     Vertex Out = (Vertex)0;
 
-    uint remappedVertexIndex = vertexIndirectionBuffer[meshletData.VertOffset + vertexIndex];
+    uint remappedVertexIndex = GetGlobalVertexIndex(meshletData, vertexIndex);
     VertexData1 vertexData1 = vertexBuffer1[remappedVertexIndex];
 
     uint viewIndex = viewIndexParam;
-    Out.position = mul(float4(vertexData1.position, 1.0f), GPUCulling.viewProjMatrix[viewIndex]);
+    float4 worldPos = mul(float4(vertexData1.position, 1.0f), worldMatrix);
+    Out.position = mul(worldPos, GPUCulling.viewProjMatrix[viewIndex]);
 
     return Out;
 }
@@ -23,12 +24,13 @@ void main(uint gtid : SV_GroupThreadID,
           out indices uint3 triangles[126])
 {
     MeshletData meshletData = GetMeshletData(payload, gid);
+    float4x4 worldMatrix = GetWorldMatrix(payload, gid);
 
     SetMeshOutputCounts(meshletData.VertCount, meshletData.PrimCount);
 
     if (gtid < meshletData.VertCount)
     {
-        vertices[gtid] = GetVertexShadow(payload, meshletData, gtid);
+        vertices[gtid] = GetVertexShadow(payload, meshletData, worldMatrix, gtid);
     }
 
     if (gtid < meshletData.PrimCount)
@@ -5,9 +5,16 @@
 #include <DirectXMath.h>
 #include <d3d12.h>
 
+#include "BoolkaCommon/Algorithms/BLASGrouping.h"
+#include "BoolkaCommon/Algorithms/BatchTransform.h"
+#include "BoolkaCommon/Algorithms/GeometryCodec.h"
+#include "BoolkaCommon/Algorithms/Hashing.h"
+#include "BoolkaCommon/Algorithms/MeshCleanup.h"
 #include "BoolkaCommon/DebugHelpers/DebugFileWriter.h"
 #include "BoolkaCommon/DebugHelpers/DebugTimer.h"
+#include "BoolkaCommon/Structures/FlatHashMap.h"
 #include "BoolkaCommon/Structures/MemoryBlock.h"
+#include "BoolkaCommon/Structures/ScratchArena.h"
 #include "BoolkaCommon/Structures/Sphere.h"
 #include "D3D12Backend/Containers/Streaming/SceneData.h"
 #include "D3D12Backend/HLSLShared.h"
@@ -19,6 +26,12 @@ namespace Boolka
     static const size_t gs_PitchAlignment = D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
     static const size_t gs_CubeMapFaces = 6;
 
+    // Geometry cleanup thresholds, scene relative ones are multiplied by scene bounds diagonal
+    static const float gs_WeldPositionTolerance = 1e-6f;
+    static const float gs_WeldNormalTolerance = 1e-3f;
+    static const float gs_WeldTexcoordTolerance = 1e-5f;
+    static const float gs_MinShapeSize = 1e-5f;
+
     struct [[nodiscard]] BoolkaMaterial
     {
         BoolkaMaterial()
@@ -53,16 +66,11 @@ namespace Boolka
     {
         size_t operator()(const Boolka::BoolkaMaterial& k) const
         {
-            size_t currentHash = std::hash<std::string>()(k.diffuseTexName);
-
-            const unsigned char* gpuMatData = ptr_static_cast<const unsigned char*>(&k.gpuMatData);
-            for (size_t i = 0; i < sizeof(Boolka::HLSLShared::MaterialData); ++i)
-            {
-                currentHash = BLK_SHIFT_LEFT_WITH_CARRY(size_t, currentHash);
-                currentHash ^= std::hash<unsigned char>()(gpuMatData[i]);
-            }
-
-            return currentHash;
+            const uint64_t nameHash = std::hash<std::string>()(k.diffuseTexName);
+            const MemoryBlock gpuMatData = {
+                const_cast<Boolka::HLSLShared::MaterialData*>(&k.gpuMatData),
+                sizeof(Boolka::HLSLShared::MaterialData)};
+            return static_cast<size_t>(Hashing::Hash64(gpuMatData, nameHash));
         }
     };
 
@@ -72,7 +80,8 @@ namespace Boolka
         ObjConverterImpl();
         ~ObjConverterImpl() = default;
 
-        bool Convert(const std::wstring& inFile, const std::wstring& outFolder);
+        bool Convert(const std::wstring& inFile, const std::wstring& outFolder,
+                     bool cleanupGeometry);
 
     private:
         bool Build();
@@ -89,21 +98,82 @@ namespace Boolka
             bool operator<(const UniqueVertexKey& other) const;
         };
 
+        // Shape data in form that can be compared between rigidly transformed copies
+        struct CanonicalShape
+        {
+            // Corner to local vertex index, local vertices are numbered in first use order
+            std::vector<uint32_t> topology;
+            std::vector<Vector4> positions;
+            std::vector<Vector4> normals;
+            std::vector<Vector2> texcoords;
+            int materialIndex;
+            // Doesn't change under rigid transform
+            uint32_t hash;
+        };
+
+        struct ShapeInstance
+        {
+            size_t prototypeShape;
+            // Transforms prototype shape to this shape
+            Matrix4x4 transform;
+        };
+
+        // Temporary buffers of one meshlet processing worker, reused between shapes
+        struct ShapeScratch
+        {
+            ScratchArena arena;
+            // DirectXMesh outputs to std::vector, so these are reused instead of arena memory
+            std::vector<DirectX::Meshlet> meshlets;
+            std::vector<uint8_t> uniqueVertexIB;
+            std::vector<DirectX::MeshletTriangle> primitiveIndices;
+            size_t vectorRequestCount = 0;
+            // Counts capacity changes of reused vectors, DirectXMesh internal allocations are not
+            // visible here
+            size_t vectorGrowthCount = 0;
+
+            [[nodiscard]] size_t GetVectorCapacity() const
+            {
+                return meshlets.capacity() + uniqueVertexIB.capacity() +
+                       primitiveIndices.capacity();
+            }
+        };
+
         // Loads OBJ
         bool Load(std::wstring inFile);
 
         // Geometry
         void ProcessGeometry();
+        void CleanupGeometry();
+        void WeldAttributes(float positionTolerance);
+        void FilterShapeTriangles(float minTriangleArea);
+        void MergeTinyShapes(float minShapeSize);
+        void FindShapeInstances();
+        void BuildCanonicalShape(const tinyobj::shape_t& shape, CanonicalShape& canonicalShape);
+        [[nodiscard]] static bool FitRigidTransform(const CanonicalShape& prototype,
+                                                    const CanonicalShape& instance,
+                                                    Matrix4x4& transform);
+        [[nodiscard]] bool IsShapeInstance(size_t shapeIndex) const;
         void ProcessVerticesIndices();
         void RemapVertices(std::map<UniqueVertexKey, uint32_t>& verticesMap);
+        void OptimizeVertexFetchOrder();
+        [[nodiscard]] size_t CountMeshletVertexCacheLines() const;
+        void PackMeshletVertexIndirection();
+        void BuildBLASGroups();
 
         // Parses textures
         void RemapMaterials();
+        [[nodiscard]] int GetMaterialIndex(const BoolkaMaterial& material) const;
         [[nodiscard]] bool IsTransparent(const tinyobj::material_t& material);
 
         // SkyBox
         void PrepareSkyBox();
 
+        // Compression
+        void EncodeGeometrySections();
+        template <typename T>
+        static void EncodeSection(GeometryCodec::Method method, const std::vector<T>& dataVector,
+                                  const char* name, std::vector<unsigned char>& encoded);
+
         // Serialization
         void WriteHeader(DebugFileWriter& fileWriter);
         void WriteTextureHeaders(DebugFileWriter& fileWriter);
@@ -113,23 +183,33 @@ namespace Boolka
         template <typename T>
         void WriteVector(DebugFileWriter& fileWriter, const std::vector<T>& vertexDataVector,
                          size_t alignment);
+        template <typename T>
+        void WriteGeometrySection(DebugFileWriter& fileWriter, const std::vector<T>& dataVector,
+                                  const std::vector<unsigned char>& encoded);
+        [[nodiscard]] static UINT GetEncodedSectionSize(const std::vector<unsigned char>& encoded);
         template <typename pixelType, typename sumType = pixelType>
         void WriteMIPChain(DebugFileWriter& fileWriter, const unsigned char* textureData, int width,
                            int height);
 
         static const char* const ms_SkyBoxTexNames[gs_CubeMapFaces];
 
+        bool m_CleanupGeometry;
+
         // Loaded OBJ
         tinyobj::attrib_t m_Attrib;
         std::vector<tinyobj::shape_t> m_Shapes;
         std::vector<tinyobj::material_t> m_Materials;
 
+        // Instancing
+        std::vector<ShapeInstance> m_ShapeInstances;
+
         // Geometry
         std::vector<HLSLShared::VertexData1> m_VertexData1;
         std::vector<HLSLShared::VertexData2> m_VertexData2;
         // Contains uint32_t data, but declared as uint8_t since DirectXMesh requires uint8_t vector
         std::vector<uint8_t> m_VertexIndirection;
-        std::vector<DirectX::MeshletTriangle> m_IndexData;
+        // 3 bytes per triangle, each byte is index of vertex inside meshlet
+        std::vector<uint8_t> m_IndexData;
         std::vector<HLSLShared::MeshletData> m_Meshlets;
         std::vector<HLSLShared::MeshletCullData> m_MeshletsCull;
         std::vector<HLSLShared::ObjectData> m_Objects;
@@ -138,16 +218,26 @@ namespace Boolka
         // Materials
         std::vector<BoolkaMaterial> m_RemappedMaterials;
         std::vector<HLSLShared::MaterialData> m_MaterialData;
-        std::unordered_map<BoolkaMaterial, int, BoolkaMaterialHash> m_MaterialsMap;
+        FlatHashMap<BoolkaMaterial, int, BoolkaMaterialHash> m_MaterialsMap;
 
         // SkyBox
         UINT m_SkyBoxTextureResolution;
         UINT m_SkyBoxMipCount;
 
+        // Geometry sections encoded with GeometryCodec, empty if section is written raw
+        std::vector<unsigned char> m_EncodedVertexData1;
+        std::vector<unsigned char> m_EncodedVertexData2;
+        std::vector<unsigned char> m_EncodedVertexIndirection;
+        std::vector<unsigned char> m_EncodedIndexData;
+
         // Raytracing data
         std::vector<uint32_t> m_RTIndexData;
-        std::vector<uint32_t> m_RTOjbectIndexOffsetData;
+        // Indexed by InstanceID() + GeometryIndex() in shaders
+        std::vector<HLSLShared::RTGeometryData> m_RTGeometryData;
         std::vector<SceneData::CPUObjectHeader> m_CpuObjects;
+        std::vector<SceneData::RTGeometryHeader> m_RTGeometries;
+        std::vector<SceneData::RTBLASHeader> m_RTBLASes;
+        std::vector<SceneData::RTInstanceHeader> m_RTInstances;
     };
 
     const char* const ObjConverterImpl::ms_SkyBoxTexNames[gs_CubeMapFaces] = {
@@ -155,6 +245,7 @@ namespace Boolka
         "skybox\\ny.hdr", "skybox\\pz.hdr", "skybox\\nz.hdr"};
 
     ObjConverterImpl::ObjConverterImpl()
+        : m_CleanupGeometry(false)
     {
         Reset();
     }
@@ -165,6 +256,8 @@ namespace Boolka
 
         std::wcout << "Processing geometry" << std::endl;
         ProcessGeometry();
+        std::wcout << "Encoding geometry" << std::endl;
+        EncodeGeometrySections();
         std::wcout << "Processing skybox" << std::endl;
         PrepareSkyBox();
 
@@ -199,20 +292,25 @@ namespace Boolka
         WriteTextureHeaders(headerFileWriter);
 
         WriteVector(headerFileWriter, m_CpuObjects, 0);
-        std::cout << "Written rt index buffer 1" << std::endl;
+        std::cout << "Written CPU objects" << std::endl;
+
+        WriteVector(headerFileWriter, m_RTGeometries, 0);
+        WriteVector(headerFileWriter, m_RTBLASes, 0);
+        WriteVector(headerFileWriter, m_RTInstances, 0);
+        std::cout << "Written BLAS grouping" << std::endl;
 
         headerFileWriter.Close(BLK_FILE_BLOCK_SIZE);
 
-        WriteVector(dataFileWriter, m_VertexData1, gs_ResourceAlignment);
+        WriteGeometrySection(dataFileWriter, m_VertexData1, m_EncodedVertexData1);
         std::cout << "Written vertex buffer 1" << std::endl;
 
-        WriteVector(dataFileWriter, m_VertexData2, gs_ResourceAlignment);
+        WriteGeometrySection(dataFileWriter, m_VertexData2, m_EncodedVertexData2);
         std::cout << "Written vertex buffer 2" << std::endl;
 
-        WriteVector(dataFileWriter, m_VertexIndirection, gs_ResourceAlignment);
+        WriteGeometrySection(dataFileWriter, m_VertexIndirection, m_EncodedVertexIndirection);
         std::cout << "Written vertex indirection buffer" << std::endl;
 
-        WriteVector(dataFileWriter, m_IndexData, gs_ResourceAlignment);
+        WriteGeometrySection(dataFileWriter, m_IndexData, m_EncodedIndexData);
         std::cout << "Written index buffer" << std::endl;
 
         WriteVector(dataFileWriter, m_Meshlets, gs_ResourceAlignment);
@@ -230,8 +328,8 @@ namespace Boolka
         WriteVector(dataFileWriter, m_RTIndexData, gs_ResourceAlignment);
         std::cout << "Written RT index buffer" << std::endl;
 
-        WriteVector(dataFileWriter, m_RTOjbectIndexOffsetData, gs_ResourceAlignment);
-        std::cout << "Written RT object index offset buffer" << std::endl;
+        WriteVector(dataFileWriter, m_RTGeometryData, gs_ResourceAlignment);
+        std::cout << "Written RT geometry buffer" << std::endl;
 
         WriteSkyBoxTextures(dataFileWriter);
         std::cout << "Written skybox textures" << std::endl;
@@ -259,6 +357,8 @@ namespace Boolka
         m_Shapes.clear();
         m_Materials.clear();
 
+        m_ShapeInstances.clear();
+
         m_VertexData1.clear();
         m_VertexData2.clear();
         m_VertexIndirection.clear();
@@ -268,11 +368,116 @@ namespace Boolka
 
         m_OpaqueObjectCount = 0;
 
+        m_RTIndexData.clear();
+        m_RTGeometryData.clear();
+        m_CpuObjects.clear();
+        m_RTGeometries.clear();
+        m_RTBLASes.clear();
+        m_RTInstances.clear();
+
         m_RemappedMaterials.clear();
 
         m_SkyBoxTextureResolution = 0;
 
-        m_MaterialsMap.clear();
+        m_EncodedVertexData1.clear();
+        m_EncodedVertexData2.clear();
+        m_EncodedVertexIndirection.clear();
+        m_EncodedIndexData.clear();
+
+        m_MaterialsMap.Clear();
+    }
+
+    // Replaces sizes with offsets, returns total size
+    static size_t ParallelExclusiveScan(std::vector<size_t>& values)
+    {
+        if (values.empty())
+            return 0;
+
+        const size_t lastSize = values.back();
+        std::exclusive_scan(std::execution::par, std::begin(values), std::end(values),
+                            std::begin(values), size_t(0));
+        return values.back() + lastSize;
+    }
+
+    // D3D12 instance transform is 3x4 matrix that is applied to column vectors
+    static void SetInstanceTransform(SceneData::CPUObjectHeader& cpuObject,
+                                     const Matrix4x4& transform)
+    {
+        Matrix4x4 columnMajor = transform.Transpose();
+        for (size_t row = 0; row < 3; ++row)
+        {
+            for (size_t column = 0; column < 4; ++column)
+            {
+                cpuObject.instanceTransform[row][column] = columnMajor[row][column];
+            }
+        }
+    }
+
+    static void SetObjectBounds(SceneData::CPUObjectHeader& cpuObject,
+                                const HLSLShared::ObjectData& object)
+    {
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            cpuObject.boundingBoxMin[axis] = object.boundingBox.GetMin()[axis];
+            cpuObject.boundingBoxMax[axis] = object.boundingBox.GetMax()[axis];
+        }
+        for (size_t i = 0; i < 4; ++i)
+            cpuObject.boundingSphere[i] = object.boundingSphere[i];
+    }
+
+    // Replaces DirectXMesh bounding sphere with minimal one, apex offset is recalculated since it
+    // is relative to sphere center
+    static void RefineMeshletCullData(const DirectX::Meshlet& meshlet, DirectX::CullData& cullData,
+                                      const DirectX::XMFLOAT3* verticies,
+                                      const uint32_t* vertexIndirection,
+                                      const DirectX::MeshletTriangle* meshletTriangles)
+    {
+        Vector4 localVertices[BLK_MESHLET_MAX_VERTS];
+
+        for (size_t i = 0; i < meshlet.VertCount; ++i)
+        {
+            const auto& vertex = verticies[vertexIndirection[meshlet.VertOffset + i]];
+            localVertices[i] = Vector4(vertex.x, vertex.y, vertex.z, 1.0f);
+        }
+
+        Sphere sphere = Sphere::BuildMinimalBoundingSphere(localVertices, meshlet.VertCount);
+        const Vector4& center = sphere.GetData();
+
+        cullData.BoundingSphere.Center = DirectX::XMFLOAT3(center.x(), center.y(), center.z());
+        cullData.BoundingSphere.Radius = sphere.GetRadius();
+
+        if (((cullData.NormalCone.v >> 24) & 0xFF) == 0xFF)
+            return;
+
+        Vector4 axis;
+        axis.x() = float((cullData.NormalCone.v >> 0) & 0xFF);
+        axis.y() = float((cullData.NormalCone.v >> 8) & 0xFF);
+        axis.z() = float((cullData.NormalCone.v >> 16) & 0xFF);
+        axis = axis / 255.0f * 2.0f - Vector4(1.0f, 1.0f, 1.0f, 0.0f);
+
+        // Apex must lie behind every triangle plane
+        float apexOffset = 0.0f;
+        for (size_t j = 0; j < meshlet.PrimCount; ++j)
+        {
+            const auto& triangle = meshletTriangles[meshlet.PrimOffset + j];
+            const Vector4& p0 = localVertices[triangle.i0];
+            const Vector4& p1 = localVertices[triangle.i1];
+            const Vector4& p2 = localVertices[triangle.i2];
+
+            Vector4 normal = (p1 - p0).Cross(p2 - p0);
+            float normalLength = normal.Length3Slow();
+            if (normalLength == 0.0f)
+                continue;
+            normal /= normalLength;
+
+            float axisDot = axis.Dot(normal);
+            if (axisDot <= 0.0f)
+                continue;
+
+            apexOffset = std::max(apexOffset, (center - p0).Dot(normal) / axisDot);
+        }
+
+        cullData.ApexOffset = apexOffset;
     }
 
 #ifdef BLK_DEBUG
@@ -362,8 +567,11 @@ namespace Boolka
                          const DirectX::MeshletTriangle* meshletTriangles){};
 #endif
 
-    bool ObjConverterImpl::Convert(const std::wstring& inFile, const std::wstring& outFolder)
+    bool ObjConverterImpl::Convert(const std::wstring& inFile, const std::wstring& outFolder,
+                                   bool cleanupGeometry)
     {
+        m_CleanupGeometry = cleanupGeometry;
+
         std::wcout << "Loading file:" << inFile << std::endl;
 
         if (!Load(inFile))
@@ -418,25 +626,496 @@ namespace Boolka
 
     void ObjConverterImpl::ProcessGeometry()
     {
+        if (m_CleanupGeometry)
+            CleanupGeometry();
         RemapMaterials();
+        FindShapeInstances();
         ProcessVerticesIndices();
     }
 
+    // Per face attributes are optional in tinyobj, so they are only touched when present
+    template <typename T>
+    static void KeepFaceAttributes(std::vector<T>& attributes, size_t faceCount,
+                                   const std::vector<uint32_t>& keptFaces)
+    {
+        if (attributes.size() != faceCount)
+            return;
+
+        std::vector<T> result(keptFaces.size());
+        for (size_t i = 0; i < keptFaces.size(); ++i)
+        {
+            result[i] = attributes[keptFaces[i]];
+        }
+        attributes = std::move(result);
+    }
+
+    template <typename T>
+    static void AppendFaceAttributes(std::vector<T>& target, size_t targetFaceCount,
+                                     const std::vector<T>& source, size_t sourceFaceCount)
+    {
+        if (target.size() != targetFaceCount)
+            return;
+
+        if (source.size() == sourceFaceCount)
+            target.insert(target.end(), source.begin(), source.end());
+        else
+            target.resize(targetFaceCount + sourceFaceCount, target.empty() ? T{} : target[0]);
+    }
+
+    void ObjConverterImpl::CleanupGeometry()
+    {
+        const auto& positions = m_Attrib.vertices;
+        if (positions.empty())
+            return;
+
+        Vector4 sceneMin{FLT_MAX, FLT_MAX, FLT_MAX, 0.0f};
+        Vector4 sceneMax{-FLT_MAX, -FLT_MAX, -FLT_MAX, 0.0f};
+        for (size_t i = 0; i < positions.size(); i += 3)
+        {
+            Vector4 position{positions[i], positions[i + 1], positions[i + 2], 0.0f};
+            sceneMin = Min(sceneMin, position);
+            sceneMax = Max(sceneMax, position);
+        }
+        const float sceneSize = (sceneMax - sceneMin).Length3Slow();
+
+        const float positionTolerance = sceneSize * gs_WeldPositionTolerance;
+        WeldAttributes(positionTolerance);
+        // Triangles that collapse at welding precision
+        FilterShapeTriangles(positionTolerance * positionTolerance);
+        MergeTinyShapes(sceneSize * gs_MinShapeSize);
+    }
+
+    void ObjConverterImpl::WeldAttributes(float positionTolerance)
+    {
+        std::vector<uint32_t> positionRemap;
+        std::vector<uint32_t> normalRemap;
+        std::vector<uint32_t> texcoordRemap;
+
+        const size_t positionCount = m_Attrib.vertices.size() / 3;
+        const size_t normalCount = m_Attrib.normals.size() / 3;
+        const size_t texcoordCount = m_Attrib.texcoords.size() / 2;
+
+        const size_t uniquePositionCount = MeshCleanup::Weld(
+            m_Attrib.vertices.data(), positionCount, 3, positionTolerance, positionRemap);
+        const size_t uniqueNormalCount = MeshCleanup::Weld(
+            m_Attrib.normals.data(), normalCount, 3, gs_WeldNormalTolerance, normalRemap);
+        const size_t uniqueTexcoordCount = MeshCleanup::Weld(
+            m_Attrib.texcoords.data(), texcoordCount, 2, gs_WeldTexcoordTolerance, texcoordRemap);
+
+        // Unused attributes are left in place, only referenced ones end up in scene
+        auto remapIndex = [](int& index, const std::vector<uint32_t>& remap) {
+            if (index >= 0)
+                index = static_cast<int>(remap[index]);
+        };
+
+        std::for_each(std::execution::par_unseq, std::begin(m_Shapes), std::end(m_Shapes),
+                      [&](tinyobj::shape_t& shape) {
+                          for (auto& index : shape.mesh.indices)
+                          {
+                              remapIndex(index.vertex_index, positionRemap);
+                              remapIndex(index.normal_index, normalRemap);
+                              remapIndex(index.texcoord_index, texcoordRemap);
+                          }
+                      });
+
+        std::cout << "Welded positions " << positionCount << " -> " << uniquePositionCount
+                  << ", normals " << normalCount << " -> " << uniqueNormalCount << ", texcoords "
+                  << texcoordCount << " -> " << uniqueTexcoordCount << std::endl;
+    }
+
+    void ObjConverterImpl::FilterShapeTriangles(float minTriangleArea)
+    {
+        std::vector<MeshCleanup::TriangleStats> shapeStats(m_Shapes.size());
+
+        std::for_each(
+            std::execution::par_unseq, std::begin(m_Shapes), std::end(m_Shapes),
+            [&](tinyobj::shape_t& shape) {
+                size_t shapeIndex = &shape - &m_Shapes[0];
+                auto& mesh = shape.mesh;
+
+                BLK_CRITICAL_ASSERT(mesh.indices.size() % 3 == 0);
+                const size_t faceCount = mesh.indices.size() / 3;
+
+                std::vector<uint32_t> triangles(mesh.indices.size());
+                for (size_t i = 0; i < triangles.size(); ++i)
+                {
+                    BLK_ASSERT(mesh.indices[i].vertex_index >= 0);
+                    triangles[i] = static_cast<uint32_t>(mesh.indices[i].vertex_index);
+                }
+
+                std::vector<uint32_t> keptFaces =
+                    MeshCleanup::FilterTriangles(triangles.data(), faceCount,
+                                                 m_Attrib.vertices.data(), minTriangleArea,
+                                                 shapeStats[shapeIndex]);
+                if (keptFaces.size() == faceCount)
+                    return;
+
+                std::vector<tinyobj::index_t> indices(keptFaces.size() * 3);
+                for (size_t i = 0; i < keptFaces.size(); ++i)
+                {
+                    for (size_t corner = 0; corner < 3; ++corner)
+                        indices[i * 3 + corner] = mesh.indices[keptFaces[i] * 3 + corner];
+                }
+                mesh.indices = std::move(indices);
+
+                KeepFaceAttributes(mesh.material_ids, faceCount, keptFaces);
+                KeepFaceAttributes(mesh.smoothing_group_ids, faceCount, keptFaces);
+                KeepFaceAttributes(mesh.num_face_vertices, faceCount, keptFaces);
+            });
+
+        MeshCleanup::TriangleStats stats;
+        for (const auto& shapeStat : shapeStats)
+        {
+            stats.degenerateCount += shapeStat.degenerateCount;
+            stats.zeroAreaCount += shapeStat.zeroAreaCount;
+            stats.duplicateCount += shapeStat.duplicateCount;
+        }
+
+        const size_t shapeCount = m_Shapes.size();
+        std::erase_if(m_Shapes,
+                      [](const tinyobj::shape_t& shape) { return shape.mesh.indices.empty(); });
+
+        std::cout << "Removed " << stats.degenerateCount << " degenerate, " << stats.zeroAreaCount
+                  << " zero area and " << stats.duplicateCount << " duplicate triangles, "
+                  << shapeCount - m_Shapes.size() << " shapes became empty" << std::endl;
+    }
+
+    void ObjConverterImpl::MergeTinyShapes(float minShapeSize)
+    {
+        const auto& positions = m_Attrib.vertices;
+
+        std::vector<AABB> shapeBounds(m_Shapes.size());
+        std::for_each(std::execution::par_unseq, std::begin(m_Shapes), std::end(m_Shapes),
+                      [&](const tinyobj::shape_t& shape) {
+                          size_t shapeIndex = &shape - &m_Shapes[0];
+                          Vector4 min{FLT_MAX, FLT_MAX, FLT_MAX, 0.0f};
+                          Vector4 max{-FLT_MAX, -FLT_MAX, -FLT_MAX, 0.0f};
+                          for (const auto& index : shape.mesh.indices)
+                          {
+                              const float* position = &positions[3ll * index.vertex_index];
+                              Vector4 xyz{position[0], position[1], position[2], 0.0f};
+                              min = Min(min, xyz);
+                              max = Max(max, xyz);
+                          }
+                          shapeBounds[shapeIndex] = AABB{min, max};
+                      });
+
+        auto isTiny = [&](size_t shapeIndex) {
+            const AABB& bounds = shapeBounds[shapeIndex];
+            return (bounds.GetMax() - bounds.GetMin()).Length3Slow() < minShapeSize;
+        };
+
+        std::unordered_map<int, std::vector<size_t>> regularShapesByMaterial;
+        for (size_t i = 0; i < m_Shapes.size(); ++i)
+        {
+            if (!isTiny(i))
+                regularShapesByMaterial[m_Shapes[i].mesh.material_ids[0]].push_back(i);
+        }
+
+        // Tiny shapes are usually details glued to bigger shape, merging keeps them while
+        // saving an object. Ones that don't touch shape with same material are dropped
+        std::vector<bool> removed(m_Shapes.size(), false);
+        size_t mergedCount = 0;
+        size_t prunedCount = 0;
+        size_t removedTriangleCount = 0;
+        for (size_t i = 0; i < m_Shapes.size(); ++i)
+        {
+            if (!isTiny(i))
+                continue;
+
+            auto& tinyMesh = m_Shapes[i].mesh;
+            const AABB& tinyBounds = shapeBounds[i];
+            const Vector4 center = (tinyBounds.GetMin() + tinyBounds.GetMax()) * 0.5f;
+
+            size_t target = m_Shapes.size();
+            float targetSize = FLT_MAX;
+            for (size_t candidate : regularShapesByMaterial[tinyMesh.material_ids[0]])
+            {
+                const AABB& bounds = shapeBounds[candidate];
+                bool inside = true;
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    inside &= center[axis] >= bounds.GetMin()[axis] - minShapeSize &&
+                              center[axis] <= bounds.GetMax()[axis] + minShapeSize;
+                }
+                const float size = (bounds.GetMax() - bounds.GetMin()).Length3Slow();
+                // Smallest enclosing shape is most likely the one tiny shape belongs to
+                if (inside && size < targetSize)
+                {
+                    target = candidate;
+                    targetSize = size;
+                }
+            }
+
+            removed[i] = true;
+            if (target == m_Shapes.size())
+            {
+                ++prunedCount;
+                removedTriangleCount += tinyMesh.indices.size() / 3;
+                continue;
+            }
+
+            ++mergedCount;
+            auto& targetMesh = m_Shapes[target].mesh;
+            const size_t targetFaceCount = targetMesh.indices.size() / 3;
+            const size_t tinyFaceCount = tinyMesh.indices.size() / 3;
+            AppendFaceAttributes(targetMesh.material_ids, targetFaceCount, tinyMesh.material_ids,
+                                 tinyFaceCount);
+            AppendFaceAttributes(targetMesh.smoothing_group_ids, targetFaceCount,
+                                 tinyMesh.smoothing_group_ids, tinyFaceCount);
+            AppendFaceAttributes(targetMesh.num_face_vertices, targetFaceCount,
+                                 tinyMesh.num_face_vertices, tinyFaceCount);
+            targetMesh.indices.insert(targetMesh.indices.end(), tinyMesh.indices.begin(),
+                                      tinyMesh.indices.end());
+        }
+
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < m_Shapes.size(); ++i)
+        {
+            if (removed[i])
+                continue;
+            if (writeIndex != i)
+                m_Shapes[writeIndex] = std::move(m_Shapes[i]);
+            ++writeIndex;
+        }
+        m_Shapes.resize(writeIndex);
+
+        std::cout << "Merged " << mergedCount << " and pruned " << prunedCount
+                  << " tiny shapes, pruned shapes had " << removedTriangleCount << " triangles"
+                  << std::endl;
+    }
+
+    void ObjConverterImpl::FindShapeInstances()
+    {
+        std::vector<CanonicalShape> canonicalShapes(m_Shapes.size());
+
+        std::for_each(std::execution::par_unseq, std::begin(m_Shapes), std::end(m_Shapes),
+                      [&](const tinyobj::shape_t& shape) {
+                          size_t shapeIndex = &shape - &m_Shapes[0];
+                          BuildCanonicalShape(shape, canonicalShapes[shapeIndex]);
+                      });
+
+        m_ShapeInstances.resize(m_Shapes.size());
+
+        // Hash only narrows down candidates, actual match is verified by fitting transform
+        std::unordered_map<uint32_t, std::vector<size_t>> prototypesByHash;
+        size_t instanceCount = 0;
+        for (size_t i = 0; i < m_Shapes.size(); ++i)
+        {
+            ShapeInstance& instance = m_ShapeInstances[i];
+            instance.prototypeShape = i;
+            instance.transform = Matrix4x4::GetIdentity();
+
+            auto& candidates = prototypesByHash[canonicalShapes[i].hash];
+            for (size_t prototype : candidates)
+            {
+                if (FitRigidTransform(canonicalShapes[prototype], canonicalShapes[i],
+                                      instance.transform))
+                {
+                    instance.prototypeShape = prototype;
+                    break;
+                }
+            }
+
+            if (instance.prototypeShape == i)
+            {
+                candidates.push_back(i);
+            }
+            else
+            {
+                ++instanceCount;
+            }
+        }
+
+        std::cout << "Found " << m_Shapes.size() - instanceCount << " unique shapes and "
+                  << instanceCount << " instances" << std::endl;
+    }
+
+    void ObjConverterImpl::BuildCanonicalShape(const tinyobj::shape_t& shape,
+                                               CanonicalShape& canonicalShape)
+    {
+        const auto& positions = m_Attrib.vertices;
+        const auto& normals = m_Attrib.normals;
+        const auto& texcoords = m_Attrib.texcoords;
+        const auto& indices = shape.mesh.indices;
+
+        canonicalShape.materialIndex = GetMaterialIndex(m_Materials[shape.mesh.material_ids[0]]);
+
+        std::map<UniqueVertexKey, uint32_t> localVertices;
+        canonicalShape.topology.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            const auto& index = indices[i];
+            auto [iter, inserted] = localVertices.insert(std::pair(
+                UniqueVertexKey{index.vertex_index, index.normal_index, index.texcoord_index},
+                checked_narrowing_cast<uint32_t>(localVertices.size())));
+            canonicalShape.topology[i] = iter->second;
+
+            if (!inserted)
+                continue;
+
+            // Same axis conventions as RemapVertices
+            Vector4 position{0.0f, 0.0f, 0.0f, 1.0f};
+            if (index.vertex_index >= 0)
+            {
+                position = {positions[3ll * index.vertex_index],
+                            positions[3ll * index.vertex_index + 2],
+                            positions[3ll * index.vertex_index + 1], 1.0f};
+            }
+            Vector4 normal{};
+            if (index.normal_index >= 0)
+            {
+                normal = {normals[3ll * index.normal_index], normals[3ll * index.normal_index + 2],
+                          normals[3ll * index.normal_index + 1], 0.0f};
+            }
+            Vector2 texcoord{};
+            if (index.texcoord_index >= 0)
+            {
+                texcoord = {texcoords[2ll * index.texcoord_index],
+                            texcoords[2ll * index.texcoord_index + 1]};
+            }
+
+            canonicalShape.positions.push_back(position);
+            canonicalShape.normals.push_back(normal);
+            canonicalShape.texcoords.push_back(texcoord);
+        }
+
+        Vector4 centroid{};
+        for (const auto& position : canonicalShape.positions)
+        {
+            centroid += position;
+        }
+        centroid /= static_cast<float>(canonicalShape.positions.size());
+
+        float inertia = 0.0f;
+        for (const auto& position : canonicalShape.positions)
+        {
+            inertia += (position - centroid).Length3Sqr();
+        }
+
+        std::vector<uint32_t> hashData;
+        hashData.reserve(3 + canonicalShape.topology.size() + canonicalShape.texcoords.size() * 2);
+        hashData.push_back(static_cast<uint32_t>(canonicalShape.materialIndex));
+        hashData.push_back(static_cast<uint32_t>(canonicalShape.positions.size()));
+        // Coarsely quantized, so float noise between copies doesn't change hash
+        hashData.push_back(static_cast<uint32_t>(std::lround(std::log2(inertia + 1.0f) * 64.0f)));
+        hashData.insert(hashData.end(), canonicalShape.topology.begin(),
+                        canonicalShape.topology.end());
+        for (const auto& texcoord : canonicalShape.texcoords)
+        {
+            hashData.push_back(asuint(texcoord.x()));
+            hashData.push_back(asuint(texcoord.y()));
+        }
+
+        canonicalShape.hash =
+            Hashing::CRC32(MemoryBlock{hashData.data(), hashData.size() * sizeof(uint32_t)});
+    }
+
+    bool ObjConverterImpl::FitRigidTransform(const CanonicalShape& prototype,
+                                             const CanonicalShape& instance, Matrix4x4& transform)
+    {
+        if (prototype.materialIndex != instance.materialIndex ||
+            prototype.topology != instance.topology || prototype.texcoords != instance.texcoords)
+        {
+            return false;
+        }
+
+        const auto& source = prototype.positions;
+        const auto& dest = instance.positions;
+        const size_t vertexCount = source.size();
+
+        // Build well conditioned frame from 3 vertices that are far from each other
+        size_t index0 = 0;
+        size_t index1 = 0;
+        float maxDistanceSqr = 0.0f;
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            float distanceSqr = (source[i] - source[index0]).Length3Sqr();
+            if (distanceSqr > maxDistanceSqr)
+            {
+                maxDistanceSqr = distanceSqr;
+                index1 = i;
+            }
+        }
+        if (maxDistanceSqr == 0.0f)
+        {
+            return false;
+        }
+
+        // Normalize3 uses approximate rsqrt, which isn't precise enough here
+        auto normalize = [](const Vector4& vector) { return vector / vector.Length3Slow(); };
+
+        const Vector4 sourceAxis = normalize(source[index1] - source[index0]);
+        size_t index2 = 0;
+        float maxAxisDistanceSqr = 0.0f;
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            Vector4 offset = source[i] - source[index0];
+            float axisDistanceSqr = (offset - sourceAxis * offset.Dot(sourceAxis)).Length3Sqr();
+            if (axisDistanceSqr > maxAxisDistanceSqr)
+            {
+                maxAxisDistanceSqr = axisDistanceSqr;
+                index2 = i;
+            }
+        }
+        // Degenerate shapes (lines) have no unique rotation
+        if (maxAxisDistanceSqr < maxDistanceSqr * 1e-6f)
+        {
+            return false;
+        }
+
+        auto buildFrame = [&](const std::vector<Vector4>& points) {
+            Vector4 axisX = normalize(points[index1] - points[index0]);
+            Vector4 axisY = points[index2] - points[index0];
+            axisY = normalize(axisY - axisX * axisY.Dot(axisX));
+            Vector4 axisZ = axisX.Cross(axisY);
+            return Matrix4x4{Vector4{axisX.x(), axisX.y(), axisX.z(), 0.0f},
+                             Vector4{axisY.x(), axisY.y(), axisY.z(), 0.0f},
+                             Vector4{axisZ.x(), axisZ.y(), axisZ.z(), 0.0f},
+                             Vector4{0.0f, 0.0f, 0.0f, 1.0f}};
+        };
+
+        // Row vector convention: dest = source * transform
+        Matrix4x4 rotation = buildFrame(source).Transpose() * buildFrame(dest);
+        Vector4 translation = dest[index0] - source[index0] * rotation;
+        Matrix4x4 candidate = rotation;
+        candidate[3] = Vector4{translation.x(), translation.y(), translation.z(), 1.0f};
+
+        const float positionToleranceSqr = maxDistanceSqr * 1e-6f;
+        static const float normalToleranceSqr = 1e-6f;
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            if ((source[i] * candidate - dest[i]).Length3Sqr() > positionToleranceSqr)
+                return false;
+            if ((prototype.normals[i] * rotation - instance.normals[i]).Length3Sqr() >
+                normalToleranceSqr)
+                return false;
+        }
+
+        transform = candidate;
+        return true;
+    }
+
+    bool ObjConverterImpl::IsShapeInstance(size_t shapeIndex) const
+    {
+        return m_ShapeInstances[shapeIndex].prototypeShape != shapeIndex;
+    }
+
     void ObjConverterImpl::RemapMaterials()
     {
-        m_MaterialsMap.reserve(m_Materials.size());
+        m_MaterialsMap.Reserve(m_Materials.size());
         int currentMaterialIndex = 0;
 
         for (const auto& material : m_Materials)
         {
-            if (m_MaterialsMap.find(material) == m_MaterialsMap.end())
+            if (m_MaterialsMap.Emplace(material, currentMaterialIndex).second)
             {
-                m_MaterialsMap[material] = currentMaterialIndex++;
+                ++currentMaterialIndex;
             }
         }
 
-        m_RemappedMaterials.resize(m_MaterialsMap.size());
-        m_MaterialData.resize(m_MaterialsMap.size());
+        m_RemappedMaterials.resize(m_MaterialsMap.GetSize());
+        m_MaterialData.resize(m_MaterialsMap.GetSize());
         for (const auto& [boolkaMaterial, materialIndex] : m_MaterialsMap)
         {
             m_RemappedMaterials[materialIndex] = boolkaMaterial;
@@ -446,6 +1125,14 @@ namespace Boolka
         std::cout << "Remapped materials" << std::endl;
     }
 
+    int ObjConverterImpl::GetMaterialIndex(const BoolkaMaterial& material) const
+    {
+        // Every OBJ material is added by RemapMaterials
+        const int* materialIndex = m_MaterialsMap.Find(material);
+        BLK_ASSERT(materialIndex != nullptr);
+        return *materialIndex;
+    }
+
     // TODO find better way to determine whether material have transparency
     bool ObjConverterImpl::IsTransparent(const tinyobj::material_t& material)
     {
@@ -459,12 +1146,12 @@ namespace Boolka
             return false;
         }
 
-        static std::unordered_map<std::string, bool> s_calculated;
+        static FlatHashMap<std::string, bool> s_calculated;
 
-        auto iter = s_calculated.find(filename);
-        if (iter != s_calculated.end())
+        const bool* calculated = s_calculated.Find(filename);
+        if (calculated != nullptr)
         {
-            return iter->second;
+            return *calculated;
         }
 
         int width, height, bitsPerPixel;
@@ -535,232 +1222,720 @@ namespace Boolka
             m_Shapes.size());
         std::vector<HLSLShared::ObjectData> processedObjects(m_Shapes.size());
         std::vector<std::vector<uint32_t>> processedRtIndicies(m_Shapes.size());
+        // Sum of cubed radii of DirectXMesh and minimal meshlet spheres
+        std::vector<std::pair<double, double>> meshletSphereVolumes(m_Shapes.size());
 
-        // Calculating all required data
-        std::for_each(
-            std::execution::par_unseq, std::begin(m_Shapes), std::end(m_Shapes),
-            [&](tinyobj::shape_t& shape) {
-                size_t shapeIndex = &shape - &m_Shapes[0];
+        auto processShape = [&](tinyobj::shape_t& shape, ShapeScratch& scratch) {
+            size_t shapeIndex = &shape - &m_Shapes[0];
 
-                HLSLShared::ObjectData& object = processedObjects[shapeIndex];
+            // Instances reuse geometry of their prototype
+            if (IsShapeInstance(shapeIndex))
+                return;
 
-                const auto& material = m_Materials[shape.mesh.material_ids[0]];
+            HLSLShared::ObjectData& object = processedObjects[shapeIndex];
+            object.worldMatrix = Matrix4x4::GetIdentity();
 
-                int materialIndex = m_MaterialsMap[material];
+            const auto& material = m_Materials[shape.mesh.material_ids[0]];
 
-                const auto& indices = shape.mesh.indices;
-                BLK_CRITICAL_ASSERT(indices.size() % 3 == 0);
-                size_t nFaces = indices.size() / 3;
+            int materialIndex = GetMaterialIndex(material);
 
-                std::vector<uint32_t> dxIndices(indices.size());
-                for (size_t i = 0; i < dxIndices.size(); ++i)
+            const auto& indices = shape.mesh.indices;
+            BLK_CRITICAL_ASSERT(indices.size() % 3 == 0);
+            size_t nFaces = indices.size() / 3;
+
+            uint32_t* dxIndices = scratch.arena.Allocate<uint32_t>(indices.size());
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                const auto& index = indices[i];
+                UniqueVertexKey remappedVertexKey = {index.vertex_index, index.normal_index,
+                                                     index.texcoord_index};
+                dxIndices[i] = verticesMap[remappedVertexKey];
+            }
+
+            object.boundingBox.GetMax() = {-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.0f};
+            object.boundingBox.GetMin() = {FLT_MAX, FLT_MAX, FLT_MAX, 1.0f};
+
+            auto& positions = m_Attrib.vertices;
+
+            for (size_t i = 0; i < indices.size(); i++)
+            {
+                auto& index = indices[i];
+                int vertexIndex = index.vertex_index;
+                Vector4 xyz = {positions[3 * vertexIndex], positions[3 * vertexIndex + 2],
+                               positions[3 * vertexIndex + 1], 1.0f};
+                object.boundingBox.GetMax() = Max(object.boundingBox.GetMax(), xyz);
+                object.boundingBox.GetMin() = Min(object.boundingBox.GetMin(), xyz);
+            }
+
+            uint32_t* adjacency = scratch.arena.Allocate<uint32_t>(nFaces * 3);
+            HRESULT hr = DirectX::GenerateAdjacencyAndPointReps(
+                dxIndices, nFaces, dxVertices.data(), nVerts, 0.0f, nullptr, adjacency);
+
+            BLK_ASSERT_VAR2(SUCCEEDED(hr), hr);
+
+            {
+                std::vector<DirectX::Meshlet>& meshlets = scratch.meshlets;
+
+                // DirectXMesh appends to output vectors, so results of previous shape are cleared,
+                // capacity is kept
+                meshlets.clear();
+                scratch.uniqueVertexIB.clear();
+                scratch.primitiveIndices.clear();
+
+                const size_t vectorCapacity = scratch.GetVectorCapacity();
+                HRESULT hr = DirectX::ComputeMeshlets(
+                    dxIndices, nFaces, dxVertices.data(), nVerts, adjacency, meshlets,
+                    scratch.uniqueVertexIB, scratch.primitiveIndices, BLK_MESHLET_MAX_VERTS,
+                    BLK_MESHLET_MAX_PRIMS);
+                // Capacity only changes when reused vectors weren't big enough
+                scratch.vectorRequestCount += 3;
+                if (scratch.GetVectorCapacity() != vectorCapacity)
+                    ++scratch.vectorGrowthCount;
+
+                BLK_ASSERT(SUCCEEDED(hr));
+
+                // Outputs are kept until flattening, so they are copied with exact size
+                processedMeshletVertexIndirection[shapeIndex].assign(
+                    scratch.uniqueVertexIB.begin(), scratch.uniqueVertexIB.end());
+                processedMeshletTriangles[shapeIndex].assign(
+                    scratch.primitiveIndices.begin(), scratch.primitiveIndices.end());
+
+                DirectX::CullData* cullDataVector =
+                    scratch.arena.Allocate<DirectX::CullData>(meshlets.size());
+
+                hr = DirectX::ComputeCullData(
+                    dxVertices.data(), nVerts, meshlets.data(), meshlets.size(),
+                    ptr_static_cast<uint32_t*>(
+                        processedMeshletVertexIndirection[shapeIndex].data()),
+                    processedMeshletVertexIndirection[shapeIndex].size() /
+                        (sizeof(uint32_t) / sizeof(uint8_t)),
+                    processedMeshletTriangles[shapeIndex].data(),
+                    processedMeshletTriangles[shapeIndex].size(), cullDataVector);
+
+                uint32_t* vertexIndirection2 = reinterpret_cast<uint32_t*>(
+                    processedMeshletVertexIndirection[shapeIndex].data());
+
+                for (size_t i = 0; i < meshlets.size(); i++)
                 {
-                    const auto& index = indices[i];
-                    UniqueVertexKey remappedVertexKey = {index.vertex_index, index.normal_index,
-                                                         index.texcoord_index};
-                    dxIndices[i] = verticesMap[remappedVertexKey];
+                    const auto& meshlet = meshlets[i];
+                    auto& cullData = cullDataVector[i];
+
+                    float approximateRadius = cullData.BoundingSphere.Radius;
+                    RefineMeshletCullData(meshlet, cullData, dxVertices.data(), vertexIndirection2,
+                                          processedMeshletTriangles[shapeIndex].data());
+                    meshletSphereVolumes[shapeIndex].first +=
+                        std::pow(double(approximateRadius), 3.0);
+                    meshletSphereVolumes[shapeIndex].second +=
+                        std::pow(double(cullData.BoundingSphere.Radius), 3.0);
+
+                    ValidateMeshlet(meshlet, cullData, dxVertices.data(),
+                                    ptr_static_cast<uint32_t*>(
+                                        processedMeshletVertexIndirection[shapeIndex].data()),
+                                    processedMeshletTriangles[shapeIndex].data());
                 }
 
-                object.boundingBox.GetMax() = {-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.0f};
-                object.boundingBox.GetMin() = {FLT_MAX, FLT_MAX, FLT_MAX, 1.0f};
+                BLK_ASSERT_VAR2(SUCCEEDED(hr), hr);
 
-                auto& positions = m_Attrib.vertices;
+                object.meshletCount = static_cast<uint32_t>(meshlets.size());
 
-                for (size_t i = 0; i < indices.size(); i++)
                 {
-                    auto& index = indices[i];
-                    int vertexIndex = index.vertex_index;
-                    Vector4 xyz = {positions[3 * vertexIndex], positions[3 * vertexIndex + 2],
-                                   positions[3 * vertexIndex + 1], 1.0f};
-                    object.boundingBox.GetMax() = Max(object.boundingBox.GetMax(), xyz);
-                    object.boundingBox.GetMin() = Min(object.boundingBox.GetMin(), xyz);
+                    const size_t indirectionCount =
+                        processedMeshletVertexIndirection[shapeIndex].size() / sizeof(uint32_t);
+                    Vector4* objectVertices = scratch.arena.Allocate<Vector4>(indirectionCount);
+                    for (size_t i = 0; i < indirectionCount; ++i)
+                    {
+                        const auto& vertex = dxVertices[vertexIndirection2[i]];
+                        objectVertices[i] = Vector4(vertex.x, vertex.y, vertex.z, 1.0f);
+                    }
+
+                    Sphere sphere =
+                        Sphere::BuildMinimalBoundingSphere(objectVertices, indirectionCount);
+                    object.boundingSphere = Vector4(Vector3(sphere.GetData()), sphere.GetRadius());
                 }
 
-                std::vector<uint32_t> adjacency(nFaces * 3);
-                HRESULT hr = DirectX::GenerateAdjacencyAndPointReps(dxIndices.data(), nFaces,
-                                                                    dxVertices.data(), nVerts, 0.0f,
-                                                                    nullptr, adjacency.data());
+                std::vector<HLSLShared::MeshletData>& processedMeshletVector =
+                    processedMeshlets[shapeIndex];
+                std::vector<HLSLShared::MeshletCullData>& processedMeshletCullVector =
+                    processedMeshletsCull[shapeIndex];
 
-                BLK_ASSERT_VAR2(SUCCEEDED(hr), hr);
+                processedMeshletVector.resize(meshlets.size());
+                processedMeshletCullVector.resize(meshlets.size());
 
+                for (size_t i = 0; i < meshlets.size(); ++i)
                 {
-                    std::vector<DirectX::Meshlet> meshlets;
-
-                    HRESULT hr = DirectX::ComputeMeshlets(
-                        dxIndices.data(), nFaces, dxVertices.data(), nVerts, adjacency.data(),
-                        meshlets, processedMeshletVertexIndirection[shapeIndex],
-                        processedMeshletTriangles[shapeIndex], BLK_MESHLET_MAX_VERTS,
-                        BLK_MESHLET_MAX_PRIMS);
+                    HLSLShared::MeshletData& processedMeshlet = processedMeshletVector[i];
+                    const auto& dxMeshlet = meshlets[i];
+
+                    processedMeshlet.MaterialID = checked_narrowing_cast<uint16_t>(materialIndex);
+                    processedMeshlet.VertCount =
+                        checked_narrowing_cast<uint16_t>(dxMeshlet.VertCount);
+                    processedMeshlet.VertOffset = dxMeshlet.VertOffset;
+                    processedMeshlet.PrimCount =
+                        checked_narrowing_cast<uint16_t>(dxMeshlet.PrimCount);
+                    processedMeshlet.PrimOffset = dxMeshlet.PrimOffset;
+
+                    HLSLShared::MeshletCullData& processedMeshletCull =
+                        processedMeshletCullVector[i];
+                    const DirectX::CullData& cullData = cullDataVector[i];
+
+                    processedMeshletCull.BoundingSphere = Vector4(
+                        cullData.BoundingSphere.Center.x, cullData.BoundingSphere.Center.y,
+                        cullData.BoundingSphere.Center.z, cullData.BoundingSphere.Radius);
+                    processedMeshletCull.NormalCone = cullData.NormalCone.v;
+                    processedMeshletCull.ApexOffset = cullData.ApexOffset;
+                }
+            }
 
-                    BLK_ASSERT(SUCCEEDED(hr));
+            {
+                uint32_t* faceReorder = scratch.arena.Allocate<uint32_t>(nFaces);
+                HRESULT hr = DirectX::OptimizeFaces(dxIndices, nFaces, adjacency, faceReorder);
 
-                    std::vector<DirectX::CullData> cullDataVector(meshlets.size());
+                BLK_ASSERT_VAR2(SUCCEEDED(hr), hr);
 
-                    hr = DirectX::ComputeCullData(
-                        dxVertices.data(), nVerts, meshlets.data(), meshlets.size(),
-                        ptr_static_cast<uint32_t*>(
-                            processedMeshletVertexIndirection[shapeIndex].data()),
-                        processedMeshletVertexIndirection[shapeIndex].size() /
-                            (sizeof(uint32_t) / sizeof(uint8_t)),
-                        processedMeshletTriangles[shapeIndex].data(),
-                        processedMeshletTriangles[shapeIndex].size(), cullDataVector.data());
+                auto& processedRtIndiciesVector = processedRtIndicies[shapeIndex];
+                processedRtIndiciesVector.resize(nFaces * 3);
 
-                    uint32_t* vertexIndirection2 = reinterpret_cast<uint32_t*>(
-                        processedMeshletVertexIndirection[shapeIndex].data());
+                for (size_t i = 0; i < nFaces; ++i)
+                {
+                    uint32_t face = faceReorder[i];
+                    processedRtIndiciesVector[3 * i] = dxIndices[3 * face];
+                    processedRtIndiciesVector[3 * i + 1] = dxIndices[3 * face + 1];
+                    processedRtIndiciesVector[3 * i + 2] = dxIndices[3 * face + 2];
+                }
+            }
+        };
 
-                    for (size_t i = 0; i < meshlets.size(); i++)
-                    {
-                        const auto& meshlet = meshlets[i];
-                        const auto& cullData = cullDataVector[i];
+        DebugTimer timer;
+        timer.Start();
 
-                        ValidateMeshlet(meshlet, cullData, dxVertices.data(),
-                                        ptr_static_cast<uint32_t*>(
-                                            processedMeshletVertexIndirection[shapeIndex].data()),
-                                        processedMeshletTriangles[shapeIndex].data());
-                    }
+        // Calculating all required data
+        // Each worker owns its scratch memory, shapes are handed out one by one since their sizes
+        // vary a lot
+        const size_t workerCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1,
+                                                      std::max<size_t>(m_Shapes.size(), 1));
+        std::vector<ShapeScratch> workerScratch(workerCount);
+        std::atomic<size_t> nextShape = 0;
+        std::for_each(std::execution::par, std::begin(workerScratch), std::end(workerScratch),
+                      [&](ShapeScratch& scratch) {
+                          for (size_t shapeIndex = nextShape++; shapeIndex < m_Shapes.size();
+                               shapeIndex = nextShape++)
+                          {
+                              processShape(m_Shapes[shapeIndex], scratch);
+                              scratch.arena.Reset();
+                          }
+                      });
 
-                    size_t roundedSize = BLK_CEIL_TO_POWER_OF_TWO(meshlets.size(), 32);
-                    meshlets.resize(roundedSize);
-                    cullDataVector.resize(roundedSize);
+        float seconds = timer.Stop();
+        {
+            size_t requestCount = 0;
+            size_t heapAllocationCount = 0;
+            size_t vectorGrowthCount = 0;
+            size_t scratchCapacity = 0;
+            for (const ShapeScratch& scratch : workerScratch)
+            {
+                requestCount += scratch.arena.GetAllocationCount() + scratch.vectorRequestCount;
+                heapAllocationCount += scratch.arena.GetHeapAllocationCount();
+                vectorGrowthCount += scratch.vectorGrowthCount;
+                scratchCapacity += scratch.arena.GetCapacity();
+            }
+            std::cout << "Processed meshlets in " << seconds << "s, " << workerCount
+                      << " workers served " << requestCount << " scratch buffers with "
+                      << heapAllocationCount << " arena heap allocations and "
+                      << vectorGrowthCount << " output vector capacity growths, "
+                      << scratchCapacity / (1024 * 1024) << "MB of scratch memory" << std::endl;
+        }
 
-                    BLK_ASSERT_VAR2(SUCCEEDED(hr), hr);
+        {
+            std::pair<double, double> totalVolume = std::accumulate(
+                meshletSphereVolumes.begin(), meshletSphereVolumes.end(),
+                std::pair<double, double>{}, [](const auto& left, const auto& right) {
+                    return std::pair{left.first + right.first, left.second + right.second};
+                });
+            if (totalVolume.first > 0.0)
+            {
+                std::cout << "Minimal meshlet bounding spheres volume: "
+                          << 100.0 * totalVolume.second / totalVolume.first
+                          << "% of DirectXMesh spheres" << std::endl;
+            }
+        }
 
-                    object.meshletCount = static_cast<uint32_t>(meshlets.size());
+        // Flattening data to prepare it for writing to disk
+        DebugTimer flattenTimer;
+        flattenTimer.Start();
+
+        // Order is decided serially, opaque objects go first
+        // Prototypes are always flattened before their instances, since they come first in shape
+        // order and have same material
+        std::vector<size_t> flattenedShapes;
+        flattenedShapes.reserve(m_Shapes.size());
+        std::vector<size_t> flattenedObjectIndex(m_Shapes.size());
+        for (size_t processTransparent = 0; processTransparent < 2; ++processTransparent)
+        {
+            for (size_t i = 0; i < m_Shapes.size(); ++i)
+            {
+                const auto& material = m_Materials[m_Shapes[i].mesh.material_ids[0]];
+                if (IsTransparent(material) != bool(processTransparent))
+                    continue;
 
-                    std::vector<HLSLShared::MeshletData>& processedMeshletVector =
-                        processedMeshlets[shapeIndex];
-                    std::vector<HLSLShared::MeshletCullData>& processedMeshletCullVector =
-                        processedMeshletsCull[shapeIndex];
+                flattenedObjectIndex[i] = flattenedShapes.size();
+                flattenedShapes.push_back(i);
+            }
 
-                    processedMeshletVector.resize(meshlets.size());
-                    processedMeshletCullVector.resize(meshlets.size());
+            if (processTransparent == 0)
+            {
+                m_OpaqueObjectCount = flattenedShapes.size();
+            }
+        }
 
-                    for (size_t i = 0; i < meshlets.size(); ++i)
-                    {
-                        HLSLShared::MeshletData& processedMeshlet = processedMeshletVector[i];
-                        const auto& dxMeshlet = meshlets[i];
-
-                        processedMeshlet.MaterialID =
-                            checked_narrowing_cast<uint16_t>(materialIndex);
-                        processedMeshlet.VertCount =
-                            checked_narrowing_cast<uint16_t>(dxMeshlet.VertCount);
-                        processedMeshlet.VertOffset = dxMeshlet.VertOffset;
-                        processedMeshlet.PrimCount =
-                            checked_narrowing_cast<uint16_t>(dxMeshlet.PrimCount);
-                        processedMeshlet.PrimOffset = dxMeshlet.PrimOffset;
-
-                        HLSLShared::MeshletCullData& processedMeshletCull =
-                            processedMeshletCullVector[i];
-                        const DirectX::CullData& cullData = cullDataVector[i];
-
-                        processedMeshletCull.BoundingSphere = Vector4(
-                            cullData.BoundingSphere.Center.x, cullData.BoundingSphere.Center.y,
-                            cullData.BoundingSphere.Center.z, cullData.BoundingSphere.Radius);
-                        processedMeshletCull.NormalCone = cullData.NormalCone.v;
-                        processedMeshletCull.ApexOffset = cullData.ApexOffset;
-                    }
+        // Instances reuse prototype geometry, so they take no space
+        const size_t flattenedObjects = flattenedShapes.size();
+        std::vector<size_t> meshletOffsets(flattenedObjects);
+        std::vector<size_t> vertexIndirectionOffsets(flattenedObjects);
+        std::vector<size_t> triangleOffsets(flattenedObjects);
+        std::vector<size_t> rtIndexOffsets(flattenedObjects);
+        std::for_each(std::execution::par, std::begin(flattenedShapes), std::end(flattenedShapes),
+                      [&](const size_t& shapeIndex) {
+                          if (IsShapeInstance(shapeIndex))
+                              return;
+
+                          const size_t objectIndex = &shapeIndex - &flattenedShapes[0];
+                          meshletOffsets[objectIndex] = processedMeshlets[shapeIndex].size();
+                          vertexIndirectionOffsets[objectIndex] =
+                              processedMeshletVertexIndirection[shapeIndex].size();
+                          triangleOffsets[objectIndex] =
+                              processedMeshletTriangles[shapeIndex].size();
+                          rtIndexOffsets[objectIndex] = processedRtIndicies[shapeIndex].size();
+                      });
+
+        const size_t totalMeshletCount = ParallelExclusiveScan(meshletOffsets);
+        const size_t totalVertexIndirectionSize = ParallelExclusiveScan(vertexIndirectionOffsets);
+        const size_t totalTriangleCount = ParallelExclusiveScan(triangleOffsets);
+        const size_t totalRtIndexCount = ParallelExclusiveScan(rtIndexOffsets);
+
+        BLK_ASSERT(m_Meshlets.empty() && m_Objects.empty() && m_CpuObjects.empty());
+        m_Meshlets.resize(totalMeshletCount);
+        m_MeshletsCull.resize(totalMeshletCount);
+        m_VertexIndirection.resize(totalVertexIndirectionSize);
+        m_IndexData.resize(totalTriangleCount * 3);
+        m_RTIndexData.resize(totalRtIndexCount);
+        m_Objects.resize(flattenedObjects);
+        m_CpuObjects.resize(flattenedObjects);
+
+        // Prototypes are copied first, instances copy their object data afterwards
+        std::for_each(
+            std::execution::par, std::begin(flattenedShapes), std::end(flattenedShapes),
+            [&](const size_t& shapeIndex) {
+                if (IsShapeInstance(shapeIndex))
+                    return;
+
+                const size_t objectIndex = &shapeIndex - &flattenedShapes[0];
+                const size_t meshletOffset = meshletOffsets[objectIndex];
+                const size_t vertexIndirectionOffset = vertexIndirectionOffsets[objectIndex];
+                const size_t triangleOffset = triangleOffsets[objectIndex];
+                const size_t rtIndexOffset = rtIndexOffsets[objectIndex];
+
+                HLSLShared::ObjectData& currentObject = m_Objects[objectIndex];
+                currentObject = processedObjects[shapeIndex];
+                currentObject.meshletOffset = checked_narrowing_cast<uint32_t>(meshletOffset);
+
+                const uint32_t additionalVertOffset = checked_narrowing_cast<uint32_t>(
+                    vertexIndirectionOffset * sizeof(uint8_t) / sizeof(uint32_t));
+                const uint32_t additionalPrimOffset =
+                    checked_narrowing_cast<uint32_t>(triangleOffset);
+                const auto& meshlets = processedMeshlets[shapeIndex];
+                for (size_t i = 0; i < meshlets.size(); ++i)
+                {
+                    HLSLShared::MeshletData& currentMeshlet = m_Meshlets[meshletOffset + i];
+                    currentMeshlet = meshlets[i];
+                    currentMeshlet.VertOffset += additionalVertOffset;
+                    currentMeshlet.PrimOffset += additionalPrimOffset;
                 }
 
+                std::copy(std::begin(processedMeshletsCull[shapeIndex]),
+                          std::end(processedMeshletsCull[shapeIndex]),
+                          std::begin(m_MeshletsCull) + meshletOffset);
+
+                const auto& material = m_Materials[m_Shapes[shapeIndex].mesh.material_ids[0]];
+                SceneData::CPUObjectHeader& currentCPUObject = m_CpuObjects[objectIndex];
+                currentCPUObject = {};
+                currentCPUObject.rtIndexOffset = checked_narrowing_cast<uint32_t>(rtIndexOffset);
+                currentCPUObject.rtIndexCount =
+                    checked_narrowing_cast<uint32_t>(processedRtIndicies[shapeIndex].size());
+                currentCPUObject.materialIndex = GetMaterialIndex(material);
+                currentCPUObject.prototypeIndex = checked_narrowing_cast<uint32_t>(objectIndex);
+                SetInstanceTransform(currentCPUObject, Matrix4x4::GetIdentity());
+                SetObjectBounds(currentCPUObject, currentObject);
+
+                std::copy(std::begin(processedMeshletVertexIndirection[shapeIndex]),
+                          std::end(processedMeshletVertexIndirection[shapeIndex]),
+                          std::begin(m_VertexIndirection) + vertexIndirectionOffset);
+                uint8_t* indexData = m_IndexData.data() + triangleOffset * 3;
+                for (const auto& triangle : processedMeshletTriangles[shapeIndex])
                 {
-                    std::vector<uint32_t> faceReorder(nFaces);
-                    HRESULT hr = DirectX::OptimizeFaces(dxIndices.data(), nFaces, adjacency.data(),
-                                                        faceReorder.data());
+                    *indexData++ = checked_narrowing_cast<uint8_t>(triangle.i0);
+                    *indexData++ = checked_narrowing_cast<uint8_t>(triangle.i1);
+                    *indexData++ = checked_narrowing_cast<uint8_t>(triangle.i2);
+                }
+                std::copy(std::begin(processedRtIndicies[shapeIndex]),
+                          std::end(processedRtIndicies[shapeIndex]),
+                          std::begin(m_RTIndexData) + rtIndexOffset);
+            });
 
-                    BLK_ASSERT_VAR2(SUCCEEDED(hr), hr);
+        std::for_each(
+            std::execution::par, std::begin(flattenedShapes), std::end(flattenedShapes),
+            [&](const size_t& shapeIndex) {
+                if (!IsShapeInstance(shapeIndex))
+                    return;
+
+                const size_t objectIndex = &shapeIndex - &flattenedShapes[0];
+                const ShapeInstance& instance = m_ShapeInstances[shapeIndex];
+                const size_t prototypeIndex = flattenedObjectIndex[instance.prototypeShape];
+
+                HLSLShared::ObjectData currentObject = m_Objects[prototypeIndex];
+                BatchTransform::TransformAABBs(instance.transform, &currentObject.boundingBox,
+                                               &currentObject.boundingBox, 1);
+                // Instance transforms are rigid, so radius stays the same
+                Vector4 sphereCenter = Vector4(Vector3(currentObject.boundingSphere), 1.0f);
+                currentObject.boundingSphere = Vector4(Vector3(sphereCenter * instance.transform),
+                                                       currentObject.boundingSphere.w());
+                // HLSL matrices are column major
+                currentObject.worldMatrix = instance.transform.Transpose();
+                m_Objects[objectIndex] = currentObject;
+
+                SceneData::CPUObjectHeader currentCPUObject = m_CpuObjects[prototypeIndex];
+                currentCPUObject.prototypeIndex = checked_narrowing_cast<uint32_t>(prototypeIndex);
+                SetInstanceTransform(currentCPUObject, instance.transform);
+                SetObjectBounds(currentCPUObject, currentObject);
+                m_CpuObjects[objectIndex] = currentCPUObject;
+            });
 
-                    auto& processedRtIndiciesVector = processedRtIndicies[shapeIndex];
-                    processedRtIndiciesVector.resize(nFaces * 3);
+        std::cout << "Flattened geometry data in " << flattenTimer.Stop() << "s" << std::endl;
 
-                    for (size_t i = 0; i < nFaces; ++i)
-                    {
-                        uint32_t face = faceReorder[i];
-                        processedRtIndiciesVector[3 * i] = dxIndices[3 * face];
-                        processedRtIndiciesVector[3 * i + 1] = dxIndices[3 * face + 1];
-                        processedRtIndiciesVector[3 * i + 2] = dxIndices[3 * face + 2];
-                    }
+        // Meshlets are stored compactly, previously every object was padded to multiple of 32
+        size_t paddedMeshletCount = 0;
+        for (size_t i = 0; i < m_Objects.size(); ++i)
+        {
+            if (m_CpuObjects[i].prototypeIndex != i)
+                continue;
+            paddedMeshletCount += BLK_CEIL_TO_POWER_OF_TWO(m_Objects[i].meshletCount, 32);
+        }
+        const size_t reclaimedMeshletCount = paddedMeshletCount - m_Meshlets.size();
+        const size_t reclaimedBytes =
+            reclaimedMeshletCount *
+            (sizeof(HLSLShared::MeshletData) + sizeof(HLSLShared::MeshletCullData));
+        std::cout << "Meshlets: " << m_Meshlets.size() << " (" << paddedMeshletCount
+                  << " with per object padding), reclaimed " << reclaimedMeshletCount
+                  << " meshlets / " << reclaimedBytes << " bytes" << std::endl;
+
+        OptimizeVertexFetchOrder();
+        PackMeshletVertexIndirection();
+        BuildBLASGroups();
+    }
+
+    // Gives every object contiguous range of vertices, ordered by first use in its meshlets
+    // Vertices shared between objects get duplicated
+    void ObjConverterImpl::OptimizeVertexFetchOrder()
+    {
+        const size_t cacheLinesBefore = CountMeshletVertexCacheLines();
+        const size_t vertexCountBefore = m_VertexData1.size();
+
+        uint32_t* vertexIndirection = ptr_static_cast<uint32_t*>(m_VertexIndirection.data());
+
+        std::vector<HLSLShared::VertexData1> remappedVertexData1;
+        std::vector<HLSLShared::VertexData2> remappedVertexData2;
+        remappedVertexData1.reserve(vertexCountBefore);
+        remappedVertexData2.reserve(vertexCountBefore);
+
+        static const uint32_t unassignedVertex = UINT32_MAX;
+        std::vector<uint32_t> vertexRemap(vertexCountBefore, unassignedVertex);
+        std::vector<uint32_t> assignedVertices;
+
+        auto remapVertex = [&](uint32_t& vertexIndex) {
+            uint32_t& remappedIndex = vertexRemap[vertexIndex];
+            if (remappedIndex == unassignedVertex)
+            {
+                remappedIndex = checked_narrowing_cast<uint32_t>(remappedVertexData1.size());
+                remappedVertexData1.push_back(m_VertexData1[vertexIndex]);
+                remappedVertexData2.push_back(m_VertexData2[vertexIndex]);
+                assignedVertices.push_back(vertexIndex);
+            }
+            vertexIndex = remappedIndex;
+        };
+
+        BLK_ASSERT(m_Objects.size() == m_CpuObjects.size());
+        for (size_t objectIndex = 0; objectIndex < m_Objects.size(); ++objectIndex)
+        {
+            const HLSLShared::ObjectData& object = m_Objects[objectIndex];
+            const SceneData::CPUObjectHeader& cpuObject = m_CpuObjects[objectIndex];
+
+            // Instances share geometry with their prototype, which is already remapped
+            if (cpuObject.prototypeIndex != objectIndex)
+                continue;
+
+            // Meshlet order defines fetch order
+            for (uint32_t i = 0; i < object.meshletCount; ++i)
+            {
+                const HLSLShared::MeshletData& meshlet = m_Meshlets[object.meshletOffset + i];
+                for (uint32_t j = 0; j < meshlet.VertCount; ++j)
+                {
+                    remapVertex(vertexIndirection[meshlet.VertOffset + j]);
                 }
-            });
+            }
 
-        std::cout << "Processed meshlets" << std::endl;
+            // All RT vertices should already be referenced by meshlets, but remap them the same
+            // way in case they aren't
+            for (uint32_t i = 0; i < cpuObject.rtIndexCount; ++i)
+            {
+                remapVertex(m_RTIndexData[cpuObject.rtIndexOffset + i]);
+            }
 
-        // Flattening data to prepare it for writing to disk
-        const size_t totalMeshletCount = NestedVectorSize(processedMeshlets);
-        m_Meshlets.reserve(totalMeshletCount);
-        m_MeshletsCull.reserve(totalMeshletCount);
-        m_VertexIndirection.reserve(NestedVectorSize(processedMeshletVertexIndirection));
-        m_IndexData.reserve(NestedVectorSize(processedMeshletTriangles));
-        m_Objects.reserve(m_Shapes.size());
-        m_RTIndexData.reserve(NestedVectorSize(processedRtIndicies));
-        m_RTOjbectIndexOffsetData.reserve(m_Shapes.size());
-        m_CpuObjects.reserve(m_Shapes.size());
-
-        size_t flattenedObjects = 0;
-        for (size_t processTransparent = 0; processTransparent < 2; ++processTransparent)
+            // Only reset what was assigned, so pass stays linear in vertex count
+            for (uint32_t vertexIndex : assignedVertices)
+            {
+                vertexRemap[vertexIndex] = unassignedVertex;
+            }
+            assignedVertices.clear();
+        }
+
+        m_VertexData1 = std::move(remappedVertexData1);
+        m_VertexData2 = std::move(remappedVertexData2);
+
+        const size_t cacheLinesAfter = CountMeshletVertexCacheLines();
+
+        std::cout << "Optimized vertex fetch order: " << vertexCountBefore << " -> "
+                  << m_VertexData1.size() << " vertices, meshlet vertex cache lines "
+                  << cacheLinesBefore << " -> " << cacheLinesAfter << std::endl;
+    }
+
+    // Sum of unique vertex buffer cache lines touched by each meshlet
+    size_t ObjConverterImpl::CountMeshletVertexCacheLines() const
+    {
+        static const size_t cacheLineSize = 64;
+        static const size_t verticesPerCacheLine = cacheLineSize / sizeof(HLSLShared::VertexData1);
+
+        const uint32_t* vertexIndirection =
+            ptr_static_cast<const uint32_t*>(m_VertexIndirection.data());
+
+        size_t result = 0;
+        std::vector<size_t> cacheLines;
+        cacheLines.reserve(BLK_MESHLET_MAX_VERTS);
+        for (const auto& meshlet : m_Meshlets)
         {
-            for (size_t i = 0; i < m_Shapes.size(); ++i)
+            cacheLines.clear();
+            for (uint32_t i = 0; i < meshlet.VertCount; ++i)
             {
-                const auto& shape = m_Shapes[i];
-                const auto& material = m_Materials[shape.mesh.material_ids[0]];
-                bool isCurrentTransparent = IsTransparent(material);
+                cacheLines.push_back(vertexIndirection[meshlet.VertOffset + i] /
+                                     verticesPerCacheLine);
+            }
+            std::sort(cacheLines.begin(), cacheLines.end());
+            result += std::unique(cacheLines.begin(), cacheLines.end()) - cacheLines.begin();
+        }
 
-                if (isCurrentTransparent != bool(processTransparent))
-                    continue;
+        return result;
+    }
+
+    // Replaces 32 bit vertex indices with base vertex followed by 16 bit offsets, meshlets
+    // which span more than 16 bit range of vertices keep 32 bit indices
+    void ObjConverterImpl::PackMeshletVertexIndirection()
+    {
+        const uint32_t* vertexIndirection =
+            ptr_static_cast<const uint32_t*>(m_VertexIndirection.data());
 
-                ++flattenedObjects;
+        std::vector<uint32_t> packedIndirection;
+        packedIndirection.reserve(m_VertexIndirection.size() / sizeof(uint32_t));
 
-                HLSLShared::ObjectData currentObject = processedObjects[i];
-                currentObject.meshletOffset = checked_narrowing_cast<uint32_t>(m_Meshlets.size());
-                m_Objects.push_back(currentObject);
+        size_t wideMeshletCount = 0;
+        for (auto& meshlet : m_Meshlets)
+        {
+            const uint32_t* meshletVertices = vertexIndirection + meshlet.VertOffset;
+            const auto [minVertex, maxVertex] =
+                std::minmax_element(meshletVertices, meshletVertices + meshlet.VertCount);
+            const uint32_t baseVertex = *minVertex;
+
+            meshlet.VertOffset = checked_narrowing_cast<uint32_t>(packedIndirection.size());
 
-                size_t additionalVertOffset =
-                    m_VertexIndirection.size() * sizeof(uint8_t) / sizeof(uint32_t);
-                size_t additionalPrimOffset = m_IndexData.size();
-                for (const auto& meshlet : processedMeshlets[i])
+            if (*maxVertex - baseVertex > UINT16_MAX)
+            {
+                meshlet.Flags = BLK_MESHLET_FLAG_WIDE_VERTEX_INDICES;
+                packedIndirection.insert(std::end(packedIndirection), meshletVertices,
+                                         meshletVertices + meshlet.VertCount);
+                ++wideMeshletCount;
+                continue;
+            }
+
+            meshlet.Flags = 0;
+            packedIndirection.push_back(baseVertex);
+            for (uint32_t i = 0; i < meshlet.VertCount; i += 2)
+            {
+                uint32_t low = meshletVertices[i] - baseVertex;
+                uint32_t high =
+                    (i + 1 < meshlet.VertCount) ? meshletVertices[i + 1] - baseVertex : 0;
+                packedIndirection.push_back(low | (high << 16));
+            }
+        }
+
+        const size_t indirectionBytesBefore = m_VertexIndirection.size();
+        const uint8_t* packedBytes = ptr_static_cast<const uint8_t*>(packedIndirection.data());
+        m_VertexIndirection.assign(packedBytes,
+                                   packedBytes + packedIndirection.size() * sizeof(uint32_t));
+
+        const size_t triangleCount = m_IndexData.size() / 3;
+        std::cout << "Packed meshlet indices: vertex indirection " << indirectionBytesBefore
+                  << " -> " << m_VertexIndirection.size() << " bytes (" << wideMeshletCount
+                  << " of " << m_Meshlets.size() << " meshlets need 32 bit indices), triangles "
+                  << triangleCount * sizeof(DirectX::MeshletTriangle) << " -> "
+                  << m_IndexData.size() << " bytes" << std::endl;
+    }
+
+    // Distributes opaque geometry between BLASes offline, so runtime only builds what converter
+    // decided. Instanced prototypes keep own BLAS, big objects get split, small ones get merged
+    void ObjConverterImpl::BuildBLASGroups()
+    {
+        const uint32_t opaqueCount = checked_narrowing_cast<uint32_t>(m_OpaqueObjectCount);
+
+        std::vector<bool> hasInstances(opaqueCount, false);
+        for (uint32_t i = 0; i < opaqueCount; ++i)
+        {
+            const uint32_t prototype = m_CpuObjects[i].prototypeIndex;
+            if (prototype != i)
+                hasInstances[prototype] = true;
+        }
+
+        AABB sceneBounds = m_Objects[0].boundingBox;
+        for (uint32_t i = 0; i < opaqueCount; ++i)
+        {
+            sceneBounds = BLASGrouping::Union(sceneBounds, m_Objects[i].boundingBox);
+        }
+
+        const BLASGrouping::Settings settings{};
+
+        auto addGeometry = [&](uint32_t rtIndexOffset, uint32_t rtIndexCount,
+                               uint32_t materialIndex) {
+            m_RTGeometries.push_back(SceneData::RTGeometryHeader{rtIndexOffset, rtIndexCount});
+            m_RTGeometryData.push_back(HLSLShared::RTGeometryData{rtIndexOffset, materialIndex});
+        };
+        auto addBLAS = [&](uint32_t firstGeometry) {
+            const uint32_t geometryCount =
+                checked_narrowing_cast<uint32_t>(m_RTGeometries.size()) - firstGeometry;
+            m_RTBLASes.push_back(SceneData::RTBLASHeader{firstGeometry, geometryCount});
+            return checked_narrowing_cast<uint32_t>(m_RTBLASes.size() - 1);
+        };
+
+        // Prototype object index to its BLAS
+        std::unordered_map<uint32_t, uint32_t> prototypeBLAS;
+        std::vector<BLASGrouping::ObjectDesc> mergeCandidates;
+        std::vector<uint32_t> mergeCandidateObjects;
+        size_t splitObjectCount = 0;
+
+        std::vector<AABB> triangleBounds;
+        std::vector<uint32_t> triangleOrder;
+        std::vector<uint32_t> reorderedIndices;
+        for (uint32_t i = 0; i < opaqueCount; ++i)
+        {
+            const SceneData::CPUObjectHeader& cpuObject = m_CpuObjects[i];
+            if (cpuObject.prototypeIndex != i)
+                continue;
+
+            const uint32_t triangleCount = cpuObject.rtIndexCount / 3;
+            if (hasInstances[i] || triangleCount < settings.minSplitTriangleCount)
+            {
+                if (hasInstances[i])
                 {
-                    HLSLShared::MeshletData currentMeshlet = meshlet;
-                    currentMeshlet.VertOffset += static_cast<uint32_t>(additionalVertOffset);
-                    currentMeshlet.PrimOffset += static_cast<uint32_t>(additionalPrimOffset);
+                    const uint32_t firstGeometry =
+                        checked_narrowing_cast<uint32_t>(m_RTGeometries.size());
+                    addGeometry(cpuObject.rtIndexOffset, cpuObject.rtIndexCount,
+                                cpuObject.materialIndex);
+                    prototypeBLAS[i] = addBLAS(firstGeometry);
+                    continue;
+                }
+
+                mergeCandidates.push_back(
+                    BLASGrouping::ObjectDesc{m_Objects[i].boundingBox, triangleCount, true});
+                mergeCandidateObjects.push_back(i);
+                continue;
+            }
 
-                    m_Meshlets.push_back(currentMeshlet);
+            uint32_t* indices = m_RTIndexData.data() + cpuObject.rtIndexOffset;
+            triangleBounds.resize(triangleCount);
+            for (uint32_t j = 0; j < triangleCount; ++j)
+            {
+                Vector4 position[3];
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    position[k] = Vector4(m_VertexData1[indices[j * 3 + k]].position, 1.0f);
                 }
+                triangleBounds[j] = AABB{Min(Min(position[0], position[1]), position[2]),
+                                         Max(Max(position[0], position[1]), position[2])};
+            }
 
-                for (const auto& meshletCull : processedMeshletsCull[i])
+            auto ranges = BLASGrouping::SplitObject(settings, sceneBounds, triangleBounds.data(),
+                                                    triangleCount, triangleOrder);
+
+            // Pieces have to be contiguous in RT index buffer
+            reorderedIndices.resize(cpuObject.rtIndexCount);
+            for (uint32_t j = 0; j < triangleCount; ++j)
+            {
+                for (uint32_t k = 0; k < 3; ++k)
                 {
-                    m_MeshletsCull.push_back(meshletCull);
+                    reorderedIndices[j * 3 + k] = indices[triangleOrder[j] * 3 + k];
                 }
+            }
+            std::copy(reorderedIndices.begin(), reorderedIndices.end(), indices);
 
-                SceneData::CPUObjectHeader currentCPUObject{};
-                currentCPUObject.rtIndexOffset =
-                    checked_narrowing_cast<uint32_t>(m_RTIndexData.size());
-                currentCPUObject.rtIndexCount =
-                    checked_narrowing_cast<uint32_t>(processedRtIndicies[i].size());
-                int materialIndex = m_MaterialsMap[material];
-                currentCPUObject.materialIndex = materialIndex;
-                m_CpuObjects.push_back(currentCPUObject);
-                m_RTOjbectIndexOffsetData.push_back(currentCPUObject.rtIndexOffset);
-
-                m_VertexIndirection.insert(std::end(m_VertexIndirection),
-                                           std::begin(processedMeshletVertexIndirection[i]),
-                                           std::end(processedMeshletVertexIndirection[i]));
-                m_IndexData.insert(std::end(m_IndexData), std::begin(processedMeshletTriangles[i]),
-                                   std::end(processedMeshletTriangles[i]));
-                m_RTIndexData.insert(std::end(m_RTIndexData), std::begin(processedRtIndicies[i]),
-                                     std::end(processedRtIndicies[i]));
+            for (const auto& range : ranges)
+            {
+                const uint32_t firstGeometry =
+                    checked_narrowing_cast<uint32_t>(m_RTGeometries.size());
+                addGeometry(cpuObject.rtIndexOffset + range.firstTriangle * 3,
+                            range.triangleCount * 3, cpuObject.materialIndex);
+                const uint32_t blasIndex = addBLAS(firstGeometry);
+                m_RTInstances.push_back(SceneData::RTInstanceHeader{blasIndex, i});
+            }
+            splitObjectCount += ranges.size() > 1;
+        }
+
+        auto groups = BLASGrouping::MergeObjects(settings, sceneBounds, mergeCandidates.data(),
+                                                 mergeCandidates.size());
+        for (const auto& group : groups)
+        {
+            const uint32_t firstGeometry = checked_narrowing_cast<uint32_t>(m_RTGeometries.size());
+            for (uint32_t candidate : group)
+            {
+                const SceneData::CPUObjectHeader& cpuObject =
+                    m_CpuObjects[mergeCandidateObjects[candidate]];
+                addGeometry(cpuObject.rtIndexOffset, cpuObject.rtIndexCount,
+                            cpuObject.materialIndex);
             }
+            const uint32_t blasIndex = addBLAS(firstGeometry);
+            // Merged objects are never instanced, so identity transform of first one is used
+            m_RTInstances.push_back(
+                SceneData::RTInstanceHeader{blasIndex, mergeCandidateObjects[group[0]]});
+        }
 
-            if (processTransparent == 0)
+        for (uint32_t i = 0; i < opaqueCount; ++i)
+        {
+            const uint32_t prototype = m_CpuObjects[i].prototypeIndex;
+            if (hasInstances[prototype])
             {
-                m_OpaqueObjectCount = flattenedObjects;
+                m_RTInstances.push_back(
+                    SceneData::RTInstanceHeader{prototypeBLAS.at(prototype), i});
             }
         }
 
-        std::cout << "Flattened geometry data" << std::endl;
+        std::cout << "BLAS grouping: " << m_RTBLASes.size() << " BLASes, "
+                  << m_RTGeometries.size() << " geometries, " << m_RTInstances.size()
+                  << " instances; merged " << mergeCandidates.size() << " objects into "
+                  << groups.size() << " BLASes, split " << splitObjectCount << " objects"
+                  << std::endl;
     }
 
     void ObjConverterImpl::RemapVertices(std::map<UniqueVertexKey, uint32_t>& verticesMap)
     {
         for (const auto& shape : m_Shapes)
         {
+            if (IsShapeInstance(&shape - &m_Shapes[0]))
+                continue;
+
             for (unsigned char vertexesPerFace : shape.mesh.num_face_vertices)
             {
                 // Further code assume that there are only triangles
@@ -846,6 +2021,45 @@ namespace Boolka
         std::cout << "Processed vertices" << std::endl;
     }
 
+    // Every section is encoded, but only kept if it ends up smaller on disk
+    void ObjConverterImpl::EncodeGeometrySections()
+    {
+        EncodeSection(GeometryCodec::Method::Vertex, m_VertexData1, "Vertex buffer 1",
+                      m_EncodedVertexData1);
+        EncodeSection(GeometryCodec::Method::Vertex, m_VertexData2, "Vertex buffer 2",
+                      m_EncodedVertexData2);
+        EncodeSection(GeometryCodec::Method::Words, m_VertexIndirection,
+                      "Vertex indirection buffer", m_EncodedVertexIndirection);
+        EncodeSection(GeometryCodec::Method::Triangles, m_IndexData, "Index buffer",
+                      m_EncodedIndexData);
+    }
+
+    template <typename T>
+    void ObjConverterImpl::EncodeSection(GeometryCodec::Method method,
+                                         const std::vector<T>& dataVector, const char* name,
+                                         std::vector<unsigned char>& encoded)
+    {
+        const size_t size = dataVector.size() * sizeof(T);
+        encoded = GeometryCodec::Encode(method, dataVector.data(), size);
+
+        const size_t rawSize = BLK_CEIL_TO_POWER_OF_TWO(size, gs_ResourceAlignment);
+        const size_t encodedSize = BLK_CEIL_TO_POWER_OF_TWO(encoded.size(), gs_ResourceAlignment);
+        const bool keepEncoded = encodedSize < rawSize;
+
+        std::cout << name << ": " << size << " bytes, encoded " << encoded.size() << " bytes ("
+                  << 100.0 * encoded.size() / std::max<size_t>(size, 1) << "%), "
+                  << (keepEncoded ? "stored encoded" : "stored raw") << std::endl;
+
+        if (!keepEncoded)
+            encoded.clear();
+    }
+
+    UINT ObjConverterImpl::GetEncodedSectionSize(const std::vector<unsigned char>& encoded)
+    {
+        return checked_narrowing_cast<UINT>(
+            BLK_CEIL_TO_POWER_OF_TWO(encoded.size(), gs_ResourceAlignment));
+    }
+
     void ObjConverterImpl::WriteHeader(DebugFileWriter& fileWriter)
     {
         SceneData::FormatHeader formatHeader{};
@@ -874,14 +2088,20 @@ namespace Boolka
                 m_MaterialData.size() * sizeof(m_MaterialData[0]), gs_ResourceAlignment)),
             .rtIndiciesSize = checked_narrowing_cast<UINT>(BLK_CEIL_TO_POWER_OF_TWO(
                 m_RTIndexData.size() * sizeof(m_RTIndexData[0]), gs_ResourceAlignment)),
-            .rtObjectIndexOffsetSize = checked_narrowing_cast<UINT>(BLK_CEIL_TO_POWER_OF_TWO(
-                m_RTOjbectIndexOffsetData.size() * sizeof(m_RTOjbectIndexOffsetData[0]),
-                gs_ResourceAlignment)),
+            .rtGeometrySize = checked_narrowing_cast<UINT>(BLK_CEIL_TO_POWER_OF_TWO(
+                m_RTGeometryData.size() * sizeof(m_RTGeometryData[0]), gs_ResourceAlignment)),
             .objectCount = checked_narrowing_cast<UINT>(m_Objects.size()),
             .opaqueCount = checked_narrowing_cast<UINT>(m_OpaqueObjectCount),
             .skyBoxResolution = m_SkyBoxTextureResolution,
             .skyBoxMipCount = m_SkyBoxMipCount,
-            .textureCount = checked_narrowing_cast<UINT>(m_RemappedMaterials.size())};
+            .textureCount = checked_narrowing_cast<UINT>(m_RemappedMaterials.size()),
+            .rtGeometryCount = checked_narrowing_cast<UINT>(m_RTGeometries.size()),
+            .rtBLASCount = checked_narrowing_cast<UINT>(m_RTBLASes.size()),
+            .rtInstanceCount = checked_narrowing_cast<UINT>(m_RTInstances.size()),
+            .vertex1EncodedSize = GetEncodedSectionSize(m_EncodedVertexData1),
+            .vertex2EncodedSize = GetEncodedSectionSize(m_EncodedVertexData2),
+            .vertexIndirectionEncodedSize = GetEncodedSectionSize(m_EncodedVertexIndirection),
+            .indexEncodedSize = GetEncodedSectionSize(m_EncodedIndexData)};
 
         BLK_CRITICAL_ASSERT(sceneHeader.vertex1Size != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.vertex2Size != 0);
@@ -891,12 +2111,15 @@ namespace Boolka
         BLK_CRITICAL_ASSERT(sceneHeader.objectsSize != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.materialsSize != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.rtIndiciesSize != 0);
-        BLK_CRITICAL_ASSERT(sceneHeader.rtObjectIndexOffsetSize != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtGeometrySize != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.objectCount != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.opaqueCount != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.skyBoxResolution != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.skyBoxMipCount != 0);
         BLK_CRITICAL_ASSERT(sceneHeader.textureCount != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtGeometryCount != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtBLASCount != 0);
+        BLK_CRITICAL_ASSERT(sceneHeader.rtInstanceCount != 0);
 
         res = fileWriter.Write(&sceneHeader, sizeof(sceneHeader));
         BLK_ASSERT_VAR(res);
@@ -961,6 +2184,17 @@ namespace Boolka
         }
     }
 
+    template <typename T>
+    void ObjConverterImpl::WriteGeometrySection(DebugFileWriter& fileWriter,
+                                                const std::vector<T>& dataVector,
+                                                const std::vector<unsigned char>& encoded)
+    {
+        if (encoded.empty())
+            WriteVector(fileWriter, dataVector, gs_ResourceAlignment);
+        else
+            WriteVector(fileWriter, encoded, gs_ResourceAlignment);
+    }
+
     void ObjConverterImpl::WriteSkyBoxTextures(DebugFileWriter& fileWriter)
     {
         for (size_t i = 0; i < gs_CubeMapFaces; ++i)
@@ -1098,10 +2332,10 @@ namespace Boolka
         return texcoordIndex < other.texcoordIndex;
     }
 
-    bool OBJConverter::Convert(std::wstring inFile, std::wstring outFolder)
+    bool OBJConverter::Convert(std::wstring inFile, std::wstring outFolder, bool cleanupGeometry)
     {
         ObjConverterImpl converter;
-        return converter.Convert(inFile, outFolder);
+        return converter.Convert(inFile, outFolder, cleanupGeometry);
     }
 
 } // namespace Boolka
@@ -6,7 +6,8 @@ namespace Boolka
     class OBJConverter
     {
     public:
-        static bool Convert(std::wstring inFile, std::wstring outFolder);
+        // cleanupGeometry enables welding, degenerate triangle removal and tiny shape merging
+        static bool Convert(std::wstring inFile, std::wstring outFolder, bool cleanupGeometry);
     };
 
 } // namespace Boolka
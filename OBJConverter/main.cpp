@@ -25,9 +25,10 @@ void WinError()
 
 int wmain(int argc, wchar_t* argv[], wchar_t* envp[])
 {
-    if (argc != 4)
+    if (argc != 4 && argc != 5)
     {
-        std::cerr << "Expected 3 command line argument, Got " << argc - 1 << "\n";
+        std::cerr << "Expected 3 or 4 command line arguments, Got " << argc - 1 << "\n";
+        std::cerr << "Usage: OBJConverter directory objFile outFolder [--cleanup]\n";
         return -1;
     }
 
@@ -35,6 +36,17 @@ int wmain(int argc, wchar_t* argv[], wchar_t* envp[])
     wchar_t* objFile = argv[2];
     wchar_t* outFolder = argv[3];
 
+    bool cleanupGeometry = false;
+    if (argc == 5)
+    {
+        if (wcscmp(argv[4], L"--cleanup") != 0)
+        {
+            std::wcerr << L"Unknown option " << argv[4] << L"\n";
+            return -1;
+        }
+        cleanupGeometry = true;
+    }
+
     BOOL winSuccess = ::SetCurrentDirectoryW(directory);
     if (!winSuccess)
     {
@@ -44,7 +56,7 @@ int wmain(int argc, wchar_t* argv[], wchar_t* envp[])
 
     Boolka::DebugTimer timer;
     timer.Start();
-    bool res = Boolka::OBJConverter::Convert(objFile, outFolder);
+    bool res = Boolka::OBJConverter::Convert(objFile, outFolder, cleanupGeometry);
     float seconds = timer.Stop();
     std::cout << "Conversion took " << seconds << "s" << std::endl;
 
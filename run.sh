@@ -0,0 +1,2 @@
+R=/root/repo; SRC=${1:-$R/BoolkaCommon/Algorithms/RadixSort.cpp}
+g++ -std=c++20 -O2 -msse4.2 -fpermissive -w -I/tmp/harness/shim -I$R -I$R/BoolkaCommon /tmp/rsb/bench.cpp $SRC $R/BoolkaCommon/Structures/ScratchArena.cpp -o /tmp/rsb/bench -ltbb -lpthread 2>&1 | head; /tmp/rsb/bench